@@ -27,13 +27,28 @@ __revision__ = '$Format:%H$'
 
 from qgis.testing import start_app, unittest
 
-from qgis.core import (QgsProcessingModelAlgorithm,
+from qgis.PyQt.QtCore import QVariant
+from qgis.core import (QgsApplication,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsProcessingContext,
+                       QgsProcessingFeedback,
+                       QgsProcessingModelAlgorithm,
+                       QgsProcessingModelChildAlgorithm,
+                       QgsProcessingModelChildParameterSource,
+                       QgsProcessingModelOutput,
                        QgsProcessingModelParameter,
+                       QgsProcessingParameterFeatureSource,
                        QgsProcessingParameterString,
                        QgsProcessingParameterNumber,
                        QgsProcessingParameterDistance,
                        QgsProcessingParameterField,
-                       QgsProcessingParameterFile)
+                       QgsProcessingParameterFile,
+                       QgsProcessingUtils,
+                       QgsProject,
+                       QgsVectorLayer)
+from qgis.analysis import QgsNativeAlgorithms
 from processing.modeler.ModelerParametersDialog import (ModelerParametersDialog)
 start_app()
 
@@ -73,6 +88,60 @@ class ModelerTest(unittest.TestCase):
         self.assertEqual(set(p.parameterName() for p in dlg.getAvailableValuesOfType([QgsProcessingParameterString, QgsProcessingParameterNumber, QgsProcessingParameterFile])),
                          set(['string', 'string2', 'number', 'file']))
 
+    def testRefactorFieldsFollowedByFeatureBasedAlgorithm(self):
+        """
+        Refactor fields prepares its expressions in processAlgorithm(), so its output
+        must be materialized rather than streamed to the next child
+        """
+        from processing.core.Processing import Processing
+        Processing.initialize()
+        if QgsApplication.processingRegistry().providerById('native') is None:
+            QgsApplication.processingRegistry().addProvider(QgsNativeAlgorithms())
+
+        layer = QgsVectorLayer('Point?crs=epsg:4326&field=name:string', 'points', 'memory')
+        features = []
+        for i in range(5):
+            f = QgsFeature(layer.fields())
+            f.setAttributes(['p{}'.format(i)])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i, 2 * i)))
+            features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+        QgsProject.instance().addMapLayer(layer)
+
+        m = QgsProcessingModelAlgorithm()
+        m.addModelParameter(QgsProcessingParameterFeatureSource('SOURCE'), QgsProcessingModelParameter('SOURCE'))
+
+        refactor = QgsProcessingModelChildAlgorithm('qgis:refactorfields')
+        refactor.setChildId('refactor')
+        refactor.addParameterSources('INPUT', [QgsProcessingModelChildParameterSource.fromModelParameter('SOURCE')])
+        refactor.addParameterSources('FIELDS_MAPPING', [QgsProcessingModelChildParameterSource.fromStaticValue(
+            [{'name': 'name', 'type': QVariant.String, 'length': 0, 'precision': 0, 'expression': '"name"'},
+             {'name': 'row', 'type': QVariant.Int, 'length': 0, 'precision': 0, 'expression': '@row_number'}])])
+        m.addChildAlgorithm(refactor)
+
+        translate = QgsProcessingModelChildAlgorithm('native:translategeometry')
+        translate.setChildId('translate')
+        translate.addParameterSources('INPUT', [QgsProcessingModelChildParameterSource.fromChildOutput('refactor', 'OUTPUT')])
+        translate.addParameterSources('DELTA_X', [QgsProcessingModelChildParameterSource.fromStaticValue(1)])
+        output = QgsProcessingModelOutput('OUT')
+        output.setChildOutputName('OUTPUT')
+        translate.setModelOutputs({'OUT': output})
+        m.addChildAlgorithm(translate)
+
+        context = QgsProcessingContext()
+        context.setProject(QgsProject.instance())
+        feedback = QgsProcessingFeedback()
+        results, ok = m.run({'SOURCE': layer.id(), 'translate:OUT': 'memory:'}, context, feedback)
+        QgsProject.instance().removeMapLayer(layer.id())
+        self.assertTrue(ok)
+
+        result = QgsProcessingUtils.mapLayerFromString(results['translate:OUT'], context)
+        self.assertEqual(result.fields().names(), ['name', 'row'])
+        self.assertEqual([f.attributes() for f in result.getFeatures()],
+                         [['p{}'.format(i), i] for i in range(5)])
+        self.assertEqual([f.geometry().asWkt() for f in result.getFeatures()],
+                         ['Point ({} {})'.format(i + 1, 2 * i) for i in range(5)])
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -18,6 +18,8 @@
 #include <QElapsedTimer>
 #include <QVector4D>
 
+#include <limits>
+
 #include "qgs3dutils.h"
 #include "qgschunkboundsentity_p.h"
 #include "qgschunklist_p.h"
@@ -79,7 +81,7 @@ QgsChunkedEntity::~QgsChunkedEntity()
   // derived classes have to make sure that any pending active job has finished / been canceled
   // before getting to this destructor - here it would be too late to cancel them
   // (e.g. objects required for loading/updating have been deleted already)
-  Q_ASSERT( !mActiveJob );
+  Q_ASSERT( mActiveJobs.isEmpty() );
 
   // clean up any pending load requests
   while ( !mChunkLoaderQueue->isEmpty() )
@@ -124,9 +126,13 @@ void QgsChunkedEntity::update( const SceneState &state )
   mActiveNodes.clear();
   mFrustumCulled = 0;
   mCurrentTime = QTime::currentTime();
+  mRequestedNodes.clear();
 
   update( mRootNode, state );
 
+  // no need to load chunks which have left the view
+  cancelUnrequestedLoads();
+
   int enabled = 0, disabled = 0, unloaded = 0;
 
   Q_FOREACH ( QgsChunkNode *node, mActiveNodes )
@@ -164,9 +170,8 @@ void QgsChunkedEntity::update( const SceneState &state )
     mBboxesEntity->setBoxes( bboxes );
   }
 
-  // start a job from queue if there is anything waiting
-  if ( !mActiveJob )
-    startJob();
+  // start jobs from queue if there is anything waiting
+  startJobs();
 
   mNeedsUpdate = false;  // just updated
 
@@ -203,24 +208,31 @@ void QgsChunkedEntity::updateNodes( const QList<QgsChunkNode *> &nodes, QgsChunk
     }
     else if ( node->state() == QgsChunkNode::Updating )
     {
-      cancelActiveJob();  // we have currently just one active job so that must be it
+      cancelActiveJob( node->updater() );
     }
 
     Q_ASSERT( node->state() == QgsChunkNode::Loaded );
 
     QgsChunkListEntry *entry = new QgsChunkListEntry( node );
+    // update the chunks in view first, and the other ones only once there is nothing else to load
+    entry->priority = mActiveNodes.contains( node ) ? std::numeric_limits<float>::max() : -1;
     node->setQueuedForUpdate( entry, updateJobFactory );
     mChunkLoaderQueue->insertLast( entry );
   }
 
   // trigger update
-  if ( !mActiveJob )
-    startJob();
+  startJobs();
 }
 
 int QgsChunkedEntity::pendingJobsCount() const
 {
-  return mChunkLoaderQueue->count() + ( mActiveJob ? 1 : 0 );
+  return mChunkLoaderQueue->count() + mActiveJobs.count();
+}
+
+void QgsChunkedEntity::setMaxConcurrentJobs( int count )
+{
+  mMaxConcurrentJobs = std::max( 1, count );
+  startJobs();
 }
 
 
@@ -234,9 +246,11 @@ void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
 
   node->ensureAllChildrenExist();
 
+  const float sse = screenSpaceError( node, state );
+
   // make sure all nodes leading to children are always loaded
   // so that zooming out does not create issues
-  requestResidency( node );
+  requestResidency( node, sse );
 
   if ( !node->entity() )
   {
@@ -246,7 +260,7 @@ void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
 
   //qDebug() << node->x << "|" << node->y << "|" << node->z << "  " << tau << "  " << screenSpaceError(node, state);
 
-  if ( screenSpaceError( node, state ) <= mTau )
+  if ( sse <= mTau )
   {
     // acceptable error for the current chunk - let's render it
 
@@ -270,14 +284,16 @@ void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
     {
       QgsChunkNode *const *children = node->children();
       for ( int i = 0; i < 4; ++i )
-        requestResidency( children[i] );
+        requestResidency( children[i], screenSpaceError( children[i], state ) );
     }
   }
 }
 
 
-void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
+void QgsChunkedEntity::requestResidency( QgsChunkNode *node, float priority )
 {
+  mRequestedNodes.insert( node );
+
   if ( node->state() == QgsChunkNode::Loaded || node->state() == QgsChunkNode::QueuedForUpdate || node->state() == QgsChunkNode::Updating )
   {
     Q_ASSERT( node->replacementQueueEntry() );
@@ -290,6 +306,7 @@ void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
     // move to the front of loading queue
     Q_ASSERT( node->loaderQueueEntry() );
     Q_ASSERT( !node->loader() );
+    node->loaderQueueEntry()->priority = priority;
     if ( node->loaderQueueEntry()->prev || node->loaderQueueEntry()->next )
     {
       mChunkLoaderQueue->takeEntry( node->loaderQueueEntry() );
@@ -307,6 +324,7 @@ void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
 
     // add to the loading queue
     QgsChunkListEntry *entry = new QgsChunkListEntry( node );
+    entry->priority = priority;
     node->setQueuedForLoad( entry );
     mChunkLoaderQueue->insertFirst( entry );
   }
@@ -315,13 +333,37 @@ void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
 }
 
 
+void QgsChunkedEntity::cancelUnrequestedLoads()
+{
+  const QList<QgsChunkQueueJob *> activeJobs = mActiveJobs;
+  for ( QgsChunkQueueJob *job : activeJobs )
+  {
+    if ( qobject_cast<QgsChunkLoader *>( job ) && !mRequestedNodes.contains( job->chunk() ) )
+      cancelActiveJob( job );
+  }
+
+  QgsChunkListEntry *entry = mChunkLoaderQueue->first();
+  while ( entry )
+  {
+    QgsChunkListEntry *next = entry->next;
+    QgsChunkNode *node = entry->chunk;
+    if ( node->state() == QgsChunkNode::QueuedForLoad && !mRequestedNodes.contains( node ) )
+    {
+      mChunkLoaderQueue->takeEntry( entry );
+      node->cancelQueuedForLoad();  // also deletes the entry
+    }
+    entry = next;
+  }
+}
+
+
 void QgsChunkedEntity::onActiveJobFinished()
 {
   int oldJobsCount = pendingJobsCount();
 
   QgsChunkQueueJob *job = qobject_cast<QgsChunkQueueJob *>( sender() );
   Q_ASSERT( job );
-  Q_ASSERT( job == mActiveJob );
+  Q_ASSERT( mActiveJobs.contains( job ) );
 
   QgsChunkNode *node = job->chunk();
 
@@ -356,23 +398,35 @@ void QgsChunkedEntity::onActiveJobFinished()
   }
 
   // cleanup the job that has just finished
-  mActiveJob->deleteLater();
-  mActiveJob = nullptr;
+  mActiveJobs.removeOne( job );
+  job->deleteLater();
 
-  // start another job - if any
-  startJob();
+  // start other jobs - if any
+  startJobs();
 
   if ( pendingJobsCount() != oldJobsCount )
     emit pendingJobsCountChanged();
 }
 
-void QgsChunkedEntity::startJob()
+void QgsChunkedEntity::startJobs()
 {
-  Q_ASSERT( !mActiveJob );
-  if ( mChunkLoaderQueue->isEmpty() )
-    return;
+  while ( mActiveJobs.count() < mMaxConcurrentJobs && !mChunkLoaderQueue->isEmpty() )
+  {
+    // among entries with the same priority, the first one was requested most recently
+    QgsChunkListEntry *entry = mChunkLoaderQueue->first();
+    for ( QgsChunkListEntry *e = entry->next; e; e = e->next )
+    {
+      if ( e->priority > entry->priority )
+        entry = e;
+    }
+
+    mChunkLoaderQueue->takeEntry( entry );
+    startJob( entry );
+  }
+}
 
-  QgsChunkListEntry *entry = mChunkLoaderQueue->takeFirst();
+void QgsChunkedEntity::startJob( QgsChunkListEntry *entry )
+{
   Q_ASSERT( entry );
   QgsChunkNode *node = entry->chunk;
   delete entry;
@@ -382,25 +436,26 @@ void QgsChunkedEntity::startJob()
     QgsChunkLoader *loader = mChunkLoaderFactory->createChunkLoader( node );
     connect( loader, &QgsChunkQueueJob::finished, this, &QgsChunkedEntity::onActiveJobFinished );
     node->setLoading( loader );
-    mActiveJob = loader;
+    mActiveJobs << loader;
   }
   else if ( node->state() == QgsChunkNode::QueuedForUpdate )
   {
     node->setUpdating();
     connect( node->updater(), &QgsChunkQueueJob::finished, this, &QgsChunkedEntity::onActiveJobFinished );
-    mActiveJob = node->updater();
+    mActiveJobs << node->updater();
   }
   else
     Q_ASSERT( false );  // not possible
 }
 
-void QgsChunkedEntity::cancelActiveJob()
+void QgsChunkedEntity::cancelActiveJob( QgsChunkQueueJob *job )
 {
-  Q_ASSERT( mActiveJob );
+  Q_ASSERT( job );
+  Q_ASSERT( mActiveJobs.contains( job ) );
 
-  QgsChunkNode *node = mActiveJob->chunk();
+  QgsChunkNode *node = job->chunk();
 
-  if ( qobject_cast<QgsChunkLoader *>( mActiveJob ) )
+  if ( qobject_cast<QgsChunkLoader *>( job ) )
   {
     // return node back to skeleton
     node->cancelLoading();
@@ -411,9 +466,15 @@ void QgsChunkedEntity::cancelActiveJob()
     node->cancelUpdating();
   }
 
-  mActiveJob->cancel();
-  mActiveJob->deleteLater();
-  mActiveJob = nullptr;
+  job->cancel();
+  mActiveJobs.removeOne( job );
+  job->deleteLater();
+}
+
+void QgsChunkedEntity::cancelActiveJobs()
+{
+  while ( !mActiveJobs.isEmpty() )
+    cancelActiveJob( mActiveJobs.first() );
 }
 
 /// @endcond
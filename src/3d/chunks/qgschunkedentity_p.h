@@ -32,6 +32,7 @@
 class QgsAABB;
 class QgsChunkNode;
 class QgsChunkList;
+struct QgsChunkListEntry;
 class QgsChunkQueueJob;
 class QgsChunkLoaderFactory;
 class QgsChunkBoundsEntity;
@@ -40,6 +41,7 @@ class QgsChunkQueueJobFactory;
 #include <QVector3D>
 #include <QMatrix4x4>
 
+#include <QSet>
 #include <QTime>
 
 /**
@@ -85,19 +87,37 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! Returns number of jobs pending for this entity until it is fully loaded/updated in the current view
     int pendingJobsCount() const;
 
+    //! Returns the maximum number of jobs which may run at the same time
+    int maxConcurrentJobs() const { return mMaxConcurrentJobs; }
+
+    //! Sets the maximum number of jobs which may run at the same time
+    void setMaxConcurrentJobs( int count );
+
   protected:
-    //! Cancels the background job that is currently in progress
-    void cancelActiveJob();
+    //! Cancels a background job that is currently in progress
+    void cancelActiveJob( QgsChunkQueueJob *job );
+    //! Cancels all background jobs that are currently in progress
+    void cancelActiveJobs();
     //! Sets whether the entity needs to get active nodes updated
     void setNeedsUpdate( bool needsUpdate ) { mNeedsUpdate = needsUpdate; }
 
   private:
     void update( QgsChunkNode *node, const SceneState &state );
 
-    //! make sure that the chunk will be loaded soon (if not loaded yet) and not unloaded anytime soon (if loaded already)
-    void requestResidency( QgsChunkNode *node );
+    /**
+     * make sure that the chunk will be loaded soon (if not loaded yet) and not unloaded anytime soon (if loaded already).
+     * Chunks waiting in the loading queue with a higher priority (their screen space error) get loaded first.
+     */
+    void requestResidency( QgsChunkNode *node, float priority );
+
+    //! Cancels loading of the chunks which were not requested by the last update, i.e. which left the view
+    void cancelUnrequestedLoads();
 
-    void startJob();
+    //! Starts jobs from the queue, with the highest priority first, until the maximum number of concurrent jobs is reached
+    void startJobs();
+
+    //! Starts a job for the chunk of a queue entry (the entry gets deleted)
+    void startJob( QgsChunkListEntry *entry );
 
   private slots:
     void onActiveJobFinished();
@@ -136,8 +156,14 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! Entity that shows bounding boxes of active chunks (null if not enabled)
     QgsChunkBoundsEntity *mBboxesEntity = nullptr;
 
-    //! job that is currently being processed (asynchronously in a worker thread)
-    QgsChunkQueueJob *mActiveJob = nullptr;
+    //! jobs that are currently being processed (asynchronously in worker threads)
+    QList<QgsChunkQueueJob *> mActiveJobs;
+
+    //! max. number of jobs processed at the same time
+    int mMaxConcurrentJobs = 4;
+
+    //! chunks requested by the last update - chunks which are not in the set have left the view
+    QSet<QgsChunkNode *> mRequestedNodes;
 };
 
 /// @endcond
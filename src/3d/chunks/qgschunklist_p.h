@@ -45,6 +45,7 @@ struct QgsChunkListEntry
   QgsChunkListEntry *prev = nullptr;
   QgsChunkListEntry *next = nullptr;
   QgsChunkNode *chunk;   //!< TODO: shared pointer
+  float priority = 0;    //!< Used in the loader queue: entries with higher priority are processed first
 };
 
 
@@ -133,7 +133,6 @@ void QgsDemTerrainTileLoader::onHeightMapReady( int jobId, const QByteArray &hei
 
 QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const QgsTilingScheme &tilingScheme, int resolution )
   : mDtm( dtm )
-  , mClonedProvider( ( QgsRasterDataProvider * )dtm->dataProvider()->clone() )
   , mTilingScheme( tilingScheme )
   , mResolution( resolution )
   , mLastJobId( 0 )
@@ -142,7 +141,14 @@ QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const Q
 
 QgsDemHeightMapGenerator::~QgsDemHeightMapGenerator()
 {
-  delete mClonedProvider;
+  // wait for the jobs still running as they use the cloned providers
+  for ( auto it = mJobs.constBegin(); it != mJobs.constEnd(); ++it )
+  {
+    it->future.waitForFinished();
+    delete it->provider;
+    delete it.key();
+  }
+  qDeleteAll( mIdleProviders );
 }
 
 #include <QElapsedTimer>
@@ -189,8 +195,6 @@ static QByteArray _readDtmData( QgsRasterDataProvider *provider, const QgsRectan
 
 int QgsDemHeightMapGenerator::render( int x, int y, int z )
 {
-  Q_ASSERT( mJobs.isEmpty() );  // should be always just one active job...
-
   // extend the rect by half-pixel on each side? to get the values in "corners"
   QgsRectangle extent = mTilingScheme.tileToExtent( x, y, z );
   float mapUnitsPerPixel = extent.width() / mResolution;
@@ -203,10 +207,12 @@ int QgsDemHeightMapGenerator::render( int x, int y, int z )
   jd.jobId = ++mLastJobId;
   jd.extent = extent;
   jd.timer.start();
-  // make a clone of the data provider so it is safe to use in worker thread
-  jd.future = QtConcurrent::run( _readDtmData, mClonedProvider, extent, mResolution, mTilingScheme.crs() );
+  // make a clone of the data provider so it is safe to use in worker thread, jobs may run concurrently
+  jd.provider = !mIdleProviders.isEmpty() ? mIdleProviders.takeLast() : static_cast<QgsRasterDataProvider *>( mDtm->dataProvider()->clone() );
+  jd.future = QtConcurrent::run( _readDtmData, jd.provider, extent, mResolution, mTilingScheme.crs() );
 
   QFutureWatcher<QByteArray> *fw = new QFutureWatcher<QByteArray>( nullptr );
+  jd.fw = fw;
   fw->setFuture( jd.future );
   connect( fw, &QFutureWatcher<QByteArray>::finished, this, &QgsDemHeightMapGenerator::onFutureFinished );
 
@@ -269,6 +275,7 @@ void QgsDemHeightMapGenerator::onFutureFinished()
 
   mJobs.remove( fw );
   fw->deleteLater();
+  mIdleProviders << jobData.provider;
 
   QByteArray data = jobData.future.result();
   emit heightMapReady( jobData.jobId, data );
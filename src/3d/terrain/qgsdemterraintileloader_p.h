@@ -31,6 +31,7 @@
 #include <QFutureWatcher>
 #include <QElapsedTimer>
 
+#include "qgis_3d.h"
 #include "qgsrectangle.h"
 #include "qgsterraintileloader_p.h"
 #include "qgstilingscheme.h"
@@ -70,7 +71,7 @@ class QgsDemTerrainTileLoader : public QgsTerrainTileLoader
  * Utility class to asynchronously create heightmaps from DEM raster for given tiles of terrain.
  * \since QGIS 3.0
  */
-class QgsDemHeightMapGenerator : public QObject
+class _3D_EXPORT QgsDemHeightMapGenerator : public QObject
 {
     Q_OBJECT
   public:
@@ -105,8 +106,8 @@ class QgsDemHeightMapGenerator : public QObject
     //! raster used to build terrain
     QgsRasterLayer *mDtm = nullptr;
 
-    //! cloned provider to be used in worker thread
-    QgsRasterDataProvider *mClonedProvider = nullptr;
+    //! cloned providers to be used in worker threads, which are not used by any job at the moment (each job needs its own)
+    QList<QgsRasterDataProvider *> mIdleProviders;
 
     QgsTilingScheme mTilingScheme;
 
@@ -120,6 +121,7 @@ class QgsDemHeightMapGenerator : public QObject
       QgsRectangle extent;
       QFuture<QByteArray> future;
       QFutureWatcher<QByteArray> *fw;
+      QgsRasterDataProvider *provider;
       QElapsedTimer timer;
     };
 
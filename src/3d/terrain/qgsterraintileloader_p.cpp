@@ -61,6 +61,15 @@ QgsTerrainTileLoader::QgsTerrainTileLoader( QgsTerrainEntity *terrain, QgsChunkN
   mTileDebugText = QString( "%1 | %2 | %3" ).arg( tx ).arg( ty ).arg( tz );
 }
 
+void QgsTerrainTileLoader::cancel()
+{
+  if ( mTextureJobId != -1 )
+  {
+    mTerrain->textureGenerator()->cancelJob( mTextureJobId );
+    mTextureJobId = -1;
+  }
+}
+
 void QgsTerrainTileLoader::loadTexture()
 {
   connect( mTerrain->textureGenerator(), &QgsTerrainTextureGenerator::tileReady, this, &QgsTerrainTileLoader::onImageReady );
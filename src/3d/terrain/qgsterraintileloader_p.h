@@ -48,6 +48,9 @@ class QgsTerrainTileLoader : public QgsChunkLoader
     //! Constructs loader for a chunk node
     QgsTerrainTileLoader( QgsTerrainEntity *terrain, QgsChunkNode *mNode );
 
+    //! Cancels rendering of the map texture if it is in progress
+    void cancel() override;
+
   protected:
     //! Starts asynchronous rendering of map texture
     void loadTexture();
@@ -95,6 +95,16 @@ QgsWkbTypes::Type QgsBoundaryAlgorithm::outputWkbType( QgsWkbTypes::Type inputWk
   return outputWkb;
 }
 
+bool QgsBoundaryAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsBoundaryAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsBoundaryAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature outFeature = feature;
@@ -48,6 +48,8 @@ class QgsBoundaryAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString outputName() const override;
     QgsWkbTypes::Type outputWkbType( QgsWkbTypes::Type inputWkbType ) const override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelProcessing() const override;
+    bool supportsStreaming() const override;
 };
 
 ///@endcond PRIVATE
@@ -83,6 +83,16 @@ bool QgsCentroidAlgorithm::prepareAlgorithm( const QVariantMap &parameters, QgsP
   return true;
 }
 
+bool QgsCentroidAlgorithm::supportsParallelProcessing() const
+{
+  return !mDynamicAllParts;
+}
+
+bool QgsCentroidAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsCentroidAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QgsFeatureList list;
@@ -53,6 +53,8 @@ class QgsCentroidAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelProcessing() const override;
+    bool supportsStreaming() const override;
 
   private:
 
@@ -69,6 +69,16 @@ QgsFields QgsConvexHullAlgorithm::outputFields( const QgsFields &inputFields ) c
   return fields;
 }
 
+bool QgsConvexHullAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsConvexHullAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsConvexHullAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature f = feature;
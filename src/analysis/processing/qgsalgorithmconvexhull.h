@@ -50,6 +50,8 @@ class QgsConvexHullAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QgsWkbTypes::Type outputWkbType( QgsWkbTypes::Type ) const override { return QgsWkbTypes::Polygon; }
     QgsFields outputFields( const QgsFields &inputFields ) const override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelProcessing() const override;
+    bool supportsStreaming() const override;
 
 };
 
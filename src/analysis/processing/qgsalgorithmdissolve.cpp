@@ -16,9 +16,90 @@
  ***************************************************************************/
 
 #include "qgsalgorithmdissolve.h"
+#include "qgsprocessingfeedback.h"
+
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
 
 ///@cond PRIVATE
 
+//! Maximum number of geometries which are combined by a single unaryUnion call when dissolving
+static const int DISSOLVE_PARTITION_SIZE = 500;
+
+static QgsGeometry unionPartition( const QVector< QgsGeometry > &partition )
+{
+  return QgsGeometry::unaryUnion( partition );
+}
+
+/**
+ * Unions a large set of geometries in a cascaded way: geometries are sorted into spatially
+ * compact partitions (sort-tile-recursive packing of their bounding box centers), partitions are
+ * unioned in parallel and the partial results are merged level by level until a single
+ * unaryUnion call remains. This keeps each GEOS union small and lets neighboring geometries
+ * dissolve early, instead of handing everything to one huge single-threaded union.
+ */
+static QgsGeometry cascadedUnion( QVector< QgsGeometry > geometries, QgsProcessingFeedback *feedback )
+{
+  // geometries of partitions whose union failed, left for the final union
+  QVector< QgsGeometry > unpartitioned;
+  while ( geometries.size() > DISSOLVE_PARTITION_SIZE )
+  {
+    struct Item
+    {
+      QgsPointXY center;
+      QgsGeometry geometry;
+    };
+    QVector< Item > items;
+    items.reserve( geometries.size() );
+    for ( const QgsGeometry &geometry : qgis::as_const( geometries ) )
+      items.append( { geometry.boundingBox().center(), geometry } );
+    geometries.clear();
+
+    // sort into vertical slices by x, then each slice by y
+    const int partitionCount = static_cast< int >( std::ceil( items.size() / static_cast< double >( DISSOLVE_PARTITION_SIZE ) ) );
+    const int sliceCount = static_cast< int >( std::ceil( std::sqrt( static_cast< double >( partitionCount ) ) ) );
+    const int sliceSize = sliceCount * DISSOLVE_PARTITION_SIZE;
+    std::sort( items.begin(), items.end(), []( const Item & a, const Item & b ) { return a.center.x() < b.center.x(); } );
+    for ( int sliceStart = 0; sliceStart < items.size(); sliceStart += sliceSize )
+    {
+      auto sliceEnd = items.begin() + std::min( sliceStart + sliceSize, items.size() );
+      std::sort( items.begin() + sliceStart, sliceEnd, []( const Item & a, const Item & b ) { return a.center.y() < b.center.y(); } );
+    }
+
+    QVector< QVector< QgsGeometry > > partitions;
+    partitions.reserve( partitionCount );
+    for ( int i = 0; i < items.size(); ++i )
+    {
+      if ( i % DISSOLVE_PARTITION_SIZE == 0 )
+      {
+        partitions.append( QVector< QgsGeometry >() );
+        partitions.last().reserve( DISSOLVE_PARTITION_SIZE );
+      }
+      partitions.last().append( items.at( i ).geometry );
+    }
+    items.clear();
+
+    const QVector< QgsGeometry > results = QtConcurrent::blockingMapped< QVector< QgsGeometry > >( partitions, unionPartition );
+    for ( int i = 0; i < results.size(); ++i )
+    {
+      if ( !results.at( i ).isNull() )
+      {
+        geometries.append( results.at( i ) );
+      }
+      else
+      {
+        feedback->reportError( QObject::tr( "Could not union a partition of %1 geometries, they will be unioned with the final result instead." ).arg( partitions.at( i ).size() ) );
+        unpartitioned << partitions.at( i );
+      }
+    }
+    partitions.clear();
+  }
+
+  geometries << unpartitioned;
+  return QgsGeometry::unaryUnion( geometries );
+}
+
 //
 // QgsCollectorAlgorithm
 //
@@ -120,7 +201,15 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
 
       if ( f.hasGeometry() && f.geometry() )
       {
-        geometryHash[ indexAttributes ].append( f.geometry() );
+        QVector< QgsGeometry > &geomQueue = geometryHash[ indexAttributes ];
+        geomQueue.append( f.geometry() );
+        if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
+        {
+          // queue too long, combine it
+          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          geomQueue.clear();
+          geomQueue << tempOutputGeometry;
+        }
       }
     }
 
@@ -212,9 +301,9 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts )->QgsGeometry
+  return processCollection( parameters, context, feedback, [feedback]( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
-    return QgsGeometry::unaryUnion( parts );
+    return cascadedUnion( parts, feedback );
   }, 10000 );
 }
 
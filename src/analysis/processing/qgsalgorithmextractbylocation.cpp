@@ -16,7 +16,8 @@
  ***************************************************************************/
 
 #include "qgsalgorithmextractbylocation.h"
-#include "qgsgeometryengine.h"
+#include "qgsgeos.h"
+#include "qgspreparedgeometrycache.h"
 
 ///@cond PRIVATE
 
@@ -100,7 +101,36 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
   double step = intersectSource->featureCount() > 0 ? 100.0 / intersectSource->featureCount() : 1;
   int current = 0;
   QgsFeature f;
-  std::unique_ptr< QgsGeometryEngine > engine;
+  std::unique_ptr< QgsGeos > engine;
+  int engineCoordinates = 0;
+
+  // target features are usually tested against several features, so keep their GEOS geometries
+  QgsPreparedGeometryCache targetCache;
+
+  auto testPredicate = []( const QgsGeos & geometry, Predicate predicate, const QgsGeos & other ) -> bool
+  {
+    switch ( predicate )
+    {
+      case Intersects:
+        return geometry.intersects( other );
+      case Contains:
+        return geometry.contains( other );
+      case Disjoint:
+        return geometry.disjoint( other );
+      case IsEqual:
+        return geometry.isEqual( other );
+      case Touches:
+        return geometry.touches( other );
+      case Overlaps:
+        return geometry.overlaps( other );
+      case Within:
+        return geometry.within( other );
+      case Crosses:
+        return geometry.crosses( other );
+    }
+    return false;
+  };
+
   while ( fIt.nextFeature( f ) )
   {
     if ( feedback->isCanceled() )
@@ -133,45 +163,41 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
         // calculating only the disjoint set, and we've already eliminated this feature so no need for further tests
         continue;
       }
+      if ( !testFeature.hasGeometry() )
+        continue;
 
       if ( !engine )
       {
-        engine.reset( QgsGeometry::createGeometryEngine( f.geometry().constGet() ) );
+        engine = qgis::make_unique< QgsGeos >( f.geometry().constGet() );
         engine->prepareGeometry();
+        engineCoordinates = f.geometry().constGet()->nCoordinates();
       }
 
+      // the predicates are tested from the side of the larger geometry, which is the one worth preparing
+      const bool testFromTarget = testFeature.geometry().constGet()->nCoordinates() > engineCoordinates;
+      const QgsGeos *testEngine = targetCache.engine( targetSource, testFeature.id(), testFeature.geometry(), testFromTarget );
+
+      // the predicates are expressed from the point of view of the intersect feature
+      auto holds = [&]( Predicate predicate ) -> bool
+      {
+        if ( testFromTarget )
+          return testPredicate( *testEngine, reversePredicate( predicate ), *engine );
+        return testPredicate( *engine, predicate, *testEngine );
+      };
+
       for ( Predicate predicate : qgis::as_const( predicates ) )
       {
         bool isMatch = false;
-        switch ( predicate )
+        if ( predicate == Disjoint )
+        {
+          if ( holds( Intersects ) )
+          {
+            disjointSet.remove( testFeature.id() );
+          }
+        }
+        else
         {
-          case Intersects:
-            isMatch = engine->intersects( testFeature.geometry().constGet() );
-            break;
-          case Contains:
-            isMatch = engine->contains( testFeature.geometry().constGet() );
-            break;
-          case Disjoint:
-            if ( engine->intersects( testFeature.geometry().constGet() ) )
-            {
-              disjointSet.remove( testFeature.id() );
-            }
-            break;
-          case IsEqual:
-            isMatch = engine->isEqual( testFeature.geometry().constGet() );
-            break;
-          case Touches:
-            isMatch = engine->touches( testFeature.geometry().constGet() );
-            break;
-          case Overlaps:
-            isMatch = engine->overlaps( testFeature.geometry().constGet() );
-            break;
-          case Within:
-            isMatch = engine->within( testFeature.geometry().constGet() );
-            break;
-          case Crosses:
-            isMatch = engine->crosses( testFeature.geometry().constGet() );
-            break;
+          isMatch = holds( predicate );
         }
         if ( isMatch )
         {
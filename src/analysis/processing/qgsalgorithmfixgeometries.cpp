@@ -72,6 +72,16 @@ QgsFixGeometriesAlgorithm *QgsFixGeometriesAlgorithm::createInstance() const
   return new QgsFixGeometriesAlgorithm();
 }
 
+bool QgsFixGeometriesAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsFixGeometriesAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsFixGeometriesAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   if ( !feature.hasGeometry() )
@@ -82,6 +82,16 @@ bool QgsPointOnSurfaceAlgorithm::prepareAlgorithm( const QVariantMap &parameters
   return true;
 }
 
+bool QgsPointOnSurfaceAlgorithm::supportsParallelProcessing() const
+{
+  return !mDynamicAllParts;
+}
+
+bool QgsPointOnSurfaceAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsPointOnSurfaceAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QgsFeatureList list;
@@ -75,6 +75,16 @@ QgsProcessingFeatureSource::Flag QgsPromoteToMultipartAlgorithm::sourceFlags() c
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
 }
 
+bool QgsPromoteToMultipartAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsPromoteToMultipartAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsPromoteToMultipartAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback * )
 {
   QgsFeature f = feature;
@@ -100,6 +100,16 @@ bool QgsSimplifyAlgorithm::prepareAlgorithm( const QVariantMap &parameters, QgsP
   return true;
 }
 
+bool QgsSimplifyAlgorithm::supportsParallelProcessing() const
+{
+  return !mDynamicTolerance;
+}
+
+bool QgsSimplifyAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsSimplifyAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback * )
 {
   QgsFeature f = feature;
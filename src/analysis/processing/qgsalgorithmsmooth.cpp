@@ -129,6 +129,16 @@ bool QgsSmoothAlgorithm::prepareAlgorithm( const QVariantMap &parameters, QgsPro
   return true;
 }
 
+bool QgsSmoothAlgorithm::supportsParallelProcessing() const
+{
+  return !mDynamicIterations && !mDynamicOffset && !mDynamicMaxAngle;
+}
+
+bool QgsSmoothAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsSmoothAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QgsFeature f = feature;
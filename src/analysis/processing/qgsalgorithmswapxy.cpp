@@ -66,6 +66,16 @@ QgsProcessingFeatureSource::Flag QgsSwapXYAlgorithm::sourceFlags() const
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
 }
 
+bool QgsSwapXYAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsSwapXYAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsSwapXYAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback * )
 {
   QgsFeatureList list;
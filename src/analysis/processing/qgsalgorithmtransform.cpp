@@ -84,14 +84,23 @@ bool QgsTransformAlgorithm::prepareAlgorithm( const QVariantMap &parameters, Qgs
   return true;
 }
 
+bool QgsTransformAlgorithm::supportsParallelProcessing() const
+{
+  return true;
+}
+
+bool QgsTransformAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature feature = f;
-  if ( !mCreatedTransform )
+  std::call_once( mCreatedTransform, [this]
   {
-    mCreatedTransform = true;
     mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
-  }
+  } );
 
   if ( feature.hasGeometry() )
   {
@@ -23,6 +23,8 @@
 #include "qgis.h"
 #include "qgsprocessingalgorithm.h"
 
+#include <mutex>
+
 ///@cond PRIVATE
 
 /**
@@ -51,10 +53,13 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelProcessing() const override;
+    bool supportsStreaming() const override;
 
   private:
 
-    bool mCreatedTransform = false;
+    //! Features may be processed in parallel, the transform is created by the first one
+    std::once_flag mCreatedTransform;
     QgsCoordinateReferenceSystem mDestCrs;
     QgsCoordinateTransform mTransform;
     QgsCoordinateTransformContext mTransformContext;
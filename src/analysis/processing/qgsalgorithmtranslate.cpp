@@ -121,6 +121,16 @@ bool QgsTranslateAlgorithm::prepareAlgorithm( const QVariantMap &parameters, Qgs
   return true;
 }
 
+bool QgsTranslateAlgorithm::supportsParallelProcessing() const
+{
+  return !mDynamicDeltaX && !mDynamicDeltaY && !mDynamicDeltaZ && !mDynamicDeltaM;
+}
+
+bool QgsTranslateAlgorithm::supportsStreaming() const
+{
+  return true;
+}
+
 QgsFeatureList QgsTranslateAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback * )
 {
   QgsFeature f = feature;
@@ -18,6 +18,9 @@
 #include "qgsgeometryengine.h"
 #include "qgsprocessingalgorithm.h"
 
+#include <QtConcurrentMap>
+#include <algorithm>
+
 ///@cond PRIVATE
 
 bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes::GeometryType geometryType )
@@ -74,6 +77,70 @@ static bool sanitizeDifferenceResult( QgsGeometry &geom )
 }
 
 
+//! Number of features from the first source which are processed together by the worker threads
+static const int OVERLAY_BATCH_SIZE = 1000;
+
+//! A feature from the first source together with what the workers computed for it
+struct OverlayBatchItem
+{
+  QgsFeature feature;
+  //! IDs of features from the second source with intersecting bounding boxes, in ascending order
+  QList<QgsFeatureId> candidates;
+  //! Result of difference - only valid if hasResult is true
+  QgsGeometry result;
+  bool hasResult = false;
+  //! Results of intersection, with the ID of the feature from the second source they come from
+  QVector< QPair< QgsGeometry, QgsFeatureId > > intersections;
+  //! Error message of a failed geometry operation
+  QString error;
+};
+
+/**
+ * Reads the next batch of features from \a fitA and fetches all features from \a sourceB which
+ * are candidates for overlay with them into \a featuresB. Reading is done serially on the calling thread,
+ * so that only geometry operations are distributed to worker threads. An empty batch is returned
+ * at the end of the iteration.
+ */
+static void readOverlayBatch( QgsFeatureIterator &fitA, const QgsSpatialIndex &indexB, const QgsFeatureSource &sourceB, QgsFeatureRequest requestB,
+                              QVector<OverlayBatchItem> &batch, QHash<QgsFeatureId, QgsFeature> &featuresB, QgsProcessingFeedback *feedback )
+{
+  batch.clear();
+  featuresB.clear();
+
+  QgsFeatureIds candidateIds;
+  QgsFeature f;
+  while ( batch.size() < OVERLAY_BATCH_SIZE && fitA.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      return;
+
+    OverlayBatchItem item;
+    item.feature = f;
+    if ( f.hasGeometry() )
+    {
+      item.candidates = indexB.intersects( f.geometry().boundingBox() );
+      std::sort( item.candidates.begin(), item.candidates.end() );
+      for ( QgsFeatureId id : qgis::as_const( item.candidates ) )
+        candidateIds.insert( id );
+    }
+    batch << item;
+  }
+
+  if ( candidateIds.isEmpty() )
+    return;
+
+  requestB.setFilterFids( candidateIds );
+  QgsFeatureIterator fitB = sourceB.getFeatures( requestB );
+  while ( fitB.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      return;
+
+    featuresB.insert( f.id(), f );
+  }
+}
+
+
 void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, int &count, int totalCount, QgsOverlayUtils::DifferenceOutput outputAttrs )
 {
   QgsFeatureRequest requestB;
@@ -90,85 +157,106 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
   QgsFeatureRequest requestA;
   if ( outputAttrs == OutputBA )
     requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
   QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
-    if ( featA.hasGeometry() )
-    {
-      QgsGeometry geom( featA.geometry() );
-      QgsFeatureIds intersects = indexB.intersects( geom.boundingBox() ).toSet();
+  QVector<OverlayBatchItem> batch;
+  QHash<QgsFeatureId, QgsFeature> featuresB;
+  const QHash<QgsFeatureId, QgsFeature> &constFeaturesB = featuresB;
 
-      QgsFeatureRequest request;
-      request.setFilterFids( intersects );
-      request.setSubsetOfAttributes( QgsAttributeList() );
-      if ( outputAttrs != OutputBA )
-        request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+  // runs in worker threads: each of them uses its own prepared geometry
+  auto computeDifference = [&constFeaturesB, feedback]( OverlayBatchItem & item )
+  {
+    if ( feedback->isCanceled() || !item.feature.hasGeometry() )
+      return;
 
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
+    try
+    {
+      QgsGeometry geom( item.feature.geometry() );
+      if ( !item.candidates.isEmpty() )
       {
         // use prepared geometries for faster intersection tests
-        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+        std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( geom.constGet() ) );
         engine->prepareGeometry();
+
+        QVector<QgsGeometry> geometriesB;
+        for ( QgsFeatureId id : qgis::as_const( item.candidates ) )
+        {
+          const QgsGeometry geomB = constFeaturesB.value( id ).geometry();
+          if ( engine->intersects( geomB.constGet() ) )
+            geometriesB << geomB;
+        }
+
+        if ( !geometriesB.isEmpty() )
+        {
+          QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
+          geom = geom.difference( geomB );
+        }
       }
 
-      QVector<QgsGeometry> geometriesB;
-      QgsFeature featB;
-      QgsFeatureIterator fitB = sourceB.getFeatures( request );
-      while ( fitB.nextFeature( featB ) )
-      {
-        if ( feedback->isCanceled() )
-          break;
+      item.hasResult = sanitizeDifferenceResult( geom );
+      item.result = geom;
+    }
+    catch ( QgsProcessingException &e )
+    {
+      item.error = e.what();
+    }
+  };
 
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
-      }
+  while ( !feedback->isCanceled() )
+  {
+    readOverlayBatch( fitA, indexB, sourceB, requestB, batch, featuresB, feedback );
+    if ( batch.isEmpty() || feedback->isCanceled() )
+      break;
 
-      if ( !geometriesB.isEmpty() )
-      {
-        QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
-        geom = geom.difference( geomB );
-      }
+    QtConcurrent::blockingMap( batch, computeDifference );
+    if ( feedback->isCanceled() )
+      break;
 
-      if ( !sanitizeDifferenceResult( geom ) )
-        continue;
+    // write out results in the order of the input features
+    for ( const OverlayBatchItem &item : qgis::as_const( batch ) )
+    {
+      if ( !item.error.isEmpty() )
+        throw QgsProcessingException( item.error );
 
-      const QgsAttributes attrsA( featA.attributes() );
-      switch ( outputAttrs )
+      if ( item.feature.hasGeometry() )
       {
-        case OutputA:
-          attrs = attrsA;
-          break;
-        case OutputAB:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i] = attrsA[i];
-          break;
-        case OutputBA:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i + fieldsCountB] = attrsA[i];
-          break;
+        if ( !item.hasResult )
+          continue;
+
+        const QgsAttributes attrsA( item.feature.attributes() );
+        switch ( outputAttrs )
+        {
+          case OutputA:
+            attrs = attrsA;
+            break;
+          case OutputAB:
+            for ( int i = 0; i < fieldsCountA; ++i )
+              attrs[i] = attrsA[i];
+            break;
+          case OutputBA:
+            for ( int i = 0; i < fieldsCountA; ++i )
+              attrs[i + fieldsCountB] = attrsA[i];
+            break;
+        }
+
+        QgsFeature outFeat;
+        outFeat.setGeometry( item.result );
+        outFeat.setAttributes( attrs );
+        sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+      }
+      else
+      {
+        // TODO: should we write out features that do not have geometry?
+        QgsFeature featA( item.feature );
+        sink.addFeature( featA, QgsFeatureSink::FastInsert );
       }
 
-      QgsFeature outFeat;
-      outFeat.setGeometry( geom );
-      outFeat.setAttributes( attrs );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
-    }
-    else
-    {
-      // TODO: should we write out features that do not have geometry?
-      sink.addFeature( featA, QgsFeatureSink::FastInsert );
+      ++count;
+      feedback->setProgress( count / ( double ) totalCount * 100. );
     }
-
-    ++count;
-    feedback->setProgress( count / ( double ) totalCount * 100. );
   }
 }
 
@@ -188,63 +276,96 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
-  QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
+  QgsFeatureRequest requestB;
+  requestB.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+  requestB.setSubsetOfAttributes( fieldIndicesB );
 
-    if ( !featA.hasGeometry() )
-      continue;
+  QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
 
-    QgsGeometry geom( featA.geometry() );
-    QgsFeatureIds intersects = indexB.intersects( geom.boundingBox() ).toSet();
+  QVector<OverlayBatchItem> batch;
+  QHash<QgsFeatureId, QgsFeature> featuresB;
+  const QHash<QgsFeatureId, QgsFeature> &constFeaturesB = featuresB;
 
-    QgsFeatureRequest request;
-    request.setFilterFids( intersects );
-    request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-    request.setSubsetOfAttributes( fieldIndicesB );
+  // runs in worker threads: each of them uses its own prepared geometry
+  auto computeIntersections = [&constFeaturesB, geometryType, feedback]( OverlayBatchItem & item )
+  {
+    if ( feedback->isCanceled() || item.candidates.isEmpty() )
+      return;
 
-    std::unique_ptr< QgsGeometryEngine > engine;
-    if ( !intersects.isEmpty() )
+    try
     {
+      const QgsGeometry geom( item.feature.geometry() );
+
       // use prepared geometries for faster intersection tests
-      engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+      std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( geom.constGet() ) );
       engine->prepareGeometry();
+
+      for ( QgsFeatureId id : qgis::as_const( item.candidates ) )
+      {
+        if ( feedback->isCanceled() )
+          break;
+
+        const QgsGeometry tmpGeom( constFeaturesB.value( id ).geometry() );
+        if ( !engine->intersects( tmpGeom.constGet() ) )
+          continue;
+
+        // the engine already holds the GEOS geometry of the feature, so it is not converted again for each candidate
+        QString error;
+        std::unique_ptr< QgsAbstractGeometry > intersection( engine->intersection( tmpGeom.constGet(), &error ) );
+        if ( !intersection )
+          throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: intersection failed." ), error ) );
+
+        QgsGeometry intGeom( std::move( intersection ) );
+        if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
+          continue;
+
+        item.intersections << qMakePair( intGeom, id );
+      }
     }
+    catch ( QgsProcessingException &e )
+    {
+      item.error = e.what();
+    }
+  };
+
+  while ( !feedback->isCanceled() )
+  {
+    readOverlayBatch( fitA, indexB, sourceB, requestB, batch, featuresB, feedback );
+    if ( batch.isEmpty() || feedback->isCanceled() )
+      break;
 
-    QgsAttributes outAttributes( attrCount );
-    const QgsAttributes attrsA( featA.attributes() );
-    for ( int i = 0; i < fieldIndicesA.count(); ++i )
-      outAttributes[i] = attrsA[fieldIndicesA[i]];
+    QtConcurrent::blockingMap( batch, computeIntersections );
+    if ( feedback->isCanceled() )
+      break;
 
-    QgsFeature featB;
-    QgsFeatureIterator fitB = sourceB.getFeatures( request );
-    while ( fitB.nextFeature( featB ) )
+    // write out results in the order of the input features
+    for ( const OverlayBatchItem &item : qgis::as_const( batch ) )
     {
-      if ( feedback->isCanceled() )
-        break;
+      if ( !item.error.isEmpty() )
+        throw QgsProcessingException( item.error );
 
-      QgsGeometry tmpGeom( featB.geometry() );
-      if ( !engine->intersects( tmpGeom.constGet() ) )
+      if ( !item.feature.hasGeometry() )
         continue;
 
-      QgsGeometry intGeom = geom.intersection( tmpGeom );
-      if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
-        continue;
+      QgsAttributes outAttributes( attrCount );
+      const QgsAttributes attrsA( item.feature.attributes() );
+      for ( int i = 0; i < fieldIndicesA.count(); ++i )
+        outAttributes[i] = attrsA[fieldIndicesA[i]];
 
-      const QgsAttributes attrsB( featB.attributes() );
-      for ( int i = 0; i < fieldIndicesB.count(); ++i )
-        outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
+      for ( const QPair< QgsGeometry, QgsFeatureId > &intersection : item.intersections )
+      {
+        const QgsAttributes attrsB( featuresB.value( intersection.second ).attributes() );
+        for ( int i = 0; i < fieldIndicesB.count(); ++i )
+          outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
 
-      outFeat.setGeometry( intGeom );
-      outFeat.setAttributes( outAttributes );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
-    }
+        outFeat.setGeometry( intersection.first );
+        outFeat.setAttributes( outAttributes );
+        sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+      }
 
-    ++count;
-    feedback->setProgress( count / ( double ) totalCount * 100. );
+      ++count;
+      feedback->setProgress( count / ( double ) totalCount * 100. );
+    }
   }
 }
 
@@ -0,0 +1,102 @@
+/***************************************************************************
+  qgspreparedgeometrycache.cpp
+  ---------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspreparedgeometrycache.h"
+#include "qgsgeos.h"
+#include "qgslogger.h"
+
+#include <algorithm>
+#include <limits>
+
+///@cond PRIVATE
+
+QgsPreparedGeometryCache::QgsPreparedGeometryCache( int maxMemoryKb )
+{
+  mCache.setMaxCost( maxMemoryKb );
+}
+
+QgsPreparedGeometryCache::~QgsPreparedGeometryCache()
+{
+  QgsDebugMsgLevel( QStringLiteral( "Prepared geometry cache: %1 hits, %2 misses" ).arg( mHits ).arg( mMisses ), 2 );
+}
+
+const QgsGeos *QgsPreparedGeometryCache::engine( const QgsFeatureSource *source, QgsFeatureId id, const QgsGeometry &geometry, bool prepare )
+{
+  if ( geometry.isNull() )
+    return nullptr;
+
+  mUncachedEntry.reset();
+
+  const Key key( source, id );
+  if ( Entry *entry = mCache.object( key ) )
+  {
+    if ( prepare && !entry->prepared )
+    {
+      // keep the GEOS geometry, only the prepared geometry must be built
+      entry->engine->prepareGeometry();
+      entry->prepared = true;
+      const int cost = estimatedMemoryKb( entry->geometry, true );
+      std::unique_ptr< Entry > preparedEntry( mCache.take( key ) );
+      if ( cost > mCache.maxCost() )
+      {
+        mUncachedEntry = std::move( preparedEntry );
+        ++mHits;
+        return mUncachedEntry->engine.get();
+      }
+      entry = preparedEntry.get();
+      mCache.insert( key, preparedEntry.release(), cost );
+    }
+    ++mHits;
+    return entry->engine.get();
+  }
+
+  ++mMisses;
+  std::unique_ptr< Entry > entry = qgis::make_unique< Entry >();
+  entry->geometry = geometry;
+  entry->engine = qgis::make_unique< QgsGeos >( entry->geometry.constGet() );
+  if ( prepare )
+  {
+    entry->engine->prepareGeometry();
+    entry->prepared = true;
+  }
+
+  const int cost = estimatedMemoryKb( entry->geometry, prepare );
+  if ( cost > mCache.maxCost() )
+  {
+    mUncachedEntry = std::move( entry );
+    return mUncachedEntry->engine.get();
+  }
+
+  const QgsGeos *result = entry->engine.get();
+  mCache.insert( key, entry.release(), cost );
+  return result;
+}
+
+void QgsPreparedGeometryCache::clear()
+{
+  mCache.clear();
+  mUncachedEntry.reset();
+  mHits = 0;
+  mMisses = 0;
+}
+
+int QgsPreparedGeometryCache::estimatedMemoryKb( const QgsGeometry &geometry, bool prepared )
+{
+  // GEOS stores coordinates as 3 doubles, and prepared geometries build indexes of about the same size
+  const qint64 coordinateBytes = static_cast< qint64 >( geometry.constGet()->nCoordinates() ) * 3 * sizeof( double );
+  const qint64 bytes = prepared ? 2 * coordinateBytes : coordinateBytes;
+  return static_cast< int >( std::min< qint64 >( bytes / 1024 + 1, std::numeric_limits< int >::max() ) );
+}
+
+///@endcond
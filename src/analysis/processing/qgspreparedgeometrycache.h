@@ -0,0 +1,103 @@
+/***************************************************************************
+  qgspreparedgeometrycache.h
+  ---------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPREPAREDGEOMETRYCACHE_H
+#define QGSPREPAREDGEOMETRYCACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsfeature.h"
+#include "qgsgeometry.h"
+
+#include <QCache>
+#include <QPair>
+#include <memory>
+
+class QgsFeatureSource;
+class QgsGeos;
+
+///@cond PRIVATE
+
+/**
+ * Least recently used cache of GEOS engines for the geometries of features, keyed by
+ * source and feature ID, so that algorithms testing spatial predicates repeatedly
+ * against the same features only convert and prepare their geometries once.
+ *
+ * The cache is limited by the estimated memory used by the GEOS geometries. It is
+ * not thread safe, and neither are the prepared geometries it returns.
+ */
+class ANALYSIS_EXPORT QgsPreparedGeometryCache
+{
+  public:
+
+    //! Default memory limit, in kilobytes
+    static const int DEFAULT_MAX_MEMORY_KB = 256 * 1024;
+
+    /**
+     * Constructor for QgsPreparedGeometryCache, holding GEOS geometries up to an estimated
+     * size of \a maxMemoryKb kilobytes.
+     */
+    explicit QgsPreparedGeometryCache( int maxMemoryKb = DEFAULT_MAX_MEMORY_KB );
+    ~QgsPreparedGeometryCache();
+
+    /**
+     * Returns a GEOS engine for the feature with ID \a id from \a source, converting
+     * \a geometry to GEOS if it is not cached yet. If \a prepare is true, the engine
+     * has a prepared geometry.
+     *
+     * Returns nullptr if the geometry is null. The engine is owned by the cache and
+     * may be deleted by the next call.
+     */
+    const QgsGeos *engine( const QgsFeatureSource *source, QgsFeatureId id, const QgsGeometry &geometry, bool prepare = true );
+
+    //! Returns the number of requests served from the cache
+    int hits() const { return mHits; }
+
+    //! Returns the number of requests which required a conversion
+    int misses() const { return mMisses; }
+
+    //! Returns the estimated memory used by the cached engines, in kilobytes
+    int memoryKb() const { return mCache.totalCost(); }
+
+    //! Removes all engines from the cache and resets the counters
+    void clear();
+
+  private:
+
+    struct Entry
+    {
+      //! Geometry of the engine, which keeps a pointer to it
+      QgsGeometry geometry;
+      std::unique_ptr< QgsGeos > engine;
+      bool prepared = false;
+    };
+
+    typedef QPair< const QgsFeatureSource *, QgsFeatureId > Key;
+
+    //! Returns the estimated memory used by the GEOS conversion of \a geometry, in kilobytes
+    static int estimatedMemoryKb( const QgsGeometry &geometry, bool prepared );
+
+    QCache< Key, Entry > mCache;
+
+    //! Entry too large to be cached, kept until the next call
+    std::unique_ptr< Entry > mUncachedEntry;
+
+    int mHits = 0;
+    int mMisses = 0;
+};
+
+///@endcond
+
+#endif // QGSPREPAREDGEOMETRYCACHE_H
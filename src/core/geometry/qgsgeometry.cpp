@@ -16,8 +16,12 @@ email                : morb at ozemail dot com dot au
 #include <limits>
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 #include <cmath>
 
+#include <QAtomicPointer>
+#include <QMutex>
+
 #include "qgis.h"
 #include "qgsgeometry.h"
 #include "qgsgeometryeditutils.h"
@@ -47,13 +51,275 @@ email                : morb at ozemail dot com dot au
 #include "qgscircle.h"
 #include "qgscurve.h"
 
+///@cond PRIVATE
+
+/**
+ * Geometry of a QgsGeometryPrivate.
+ *
+ * Geometries created from WKB keep this WKB and only parse it to a QgsAbstractGeometry
+ * on the first access to the geometry itself. The type, bounding box and WKB of features
+ * which are only filtered or passed through, e.g. from a provider to a writer, are
+ * available without building the geometry.
+ *
+ * Only WKB in the native byte order, of the simple feature types and which parses back
+ * to exactly the same bytes is kept, other WKB is parsed immediately.
+ */
+class QgsLazyGeometry
+{
+  public:
+
+    QgsLazyGeometry() = default;
+    ~QgsLazyGeometry()
+    {
+      delete mGeometry.load();
+    }
+
+    QgsLazyGeometry( const QgsLazyGeometry &other ) = delete;
+    QgsLazyGeometry &operator=( const QgsLazyGeometry &other ) = delete;
+
+    QgsLazyGeometry &operator=( std::unique_ptr< QgsAbstractGeometry > geometry )
+    {
+      reset( geometry.release() );
+      return *this;
+    }
+
+    //! Returns the geometry, parsing the WKB if required
+    QgsAbstractGeometry *get() const
+    {
+      QgsAbstractGeometry *geometry = mGeometry.loadAcquire();
+      if ( !geometry && !mWkb.isEmpty() )
+        geometry = parseWkb();
+      return geometry;
+    }
+
+    QgsAbstractGeometry *operator->() const { return get(); }
+    QgsAbstractGeometry &operator*() const { return *get(); }
+    explicit operator bool() const { return mGeometry.loadAcquire() || !mWkb.isEmpty(); }
+
+    void reset( QgsAbstractGeometry *geometry = nullptr )
+    {
+      delete mGeometry.fetchAndStoreOrdered( geometry );
+      mWkb.clear();
+      mWkbBoundingBox = QgsRectangle();
+    }
+
+    QgsAbstractGeometry *release()
+    {
+      QgsAbstractGeometry *geometry = get();
+      mGeometry.storeRelease( nullptr );
+      mWkb.clear();
+      return geometry;
+    }
+
+    /**
+     * Stores \a wkb to be parsed on first access to the geometry. Returns false if the WKB
+     * cannot be kept, in which case it must be parsed by the caller.
+     */
+    bool setWkb( const QByteArray &wkb )
+    {
+      const char *p = wkb.constData();
+      const char *end = p + wkb.size();
+      QgsRectangle boundingBox;
+      if ( !scanGeometry( p, end, QgsWkbTypes::Unknown, boundingBox ) || p != end )
+        return false;
+
+      reset();
+      mWkb = wkb;
+      mWkbBoundingBox = boundingBox;
+      return true;
+    }
+
+    //! Returns true if the geometry is still identical to the stored WKB
+    bool hasWkb() const { return !mWkb.isEmpty(); }
+
+    //! Returns the stored WKB
+    QByteArray wkb() const { return mWkb; }
+
+    //! Returns the type of the stored WKB
+    QgsWkbTypes::Type wkbType() const
+    {
+      quint32 type = 0;
+      memcpy( &type, mWkb.constData() + 1, sizeof( type ) );
+      return static_cast< QgsWkbTypes::Type >( type );
+    }
+
+    //! Returns the bounding box of the stored WKB
+    QgsRectangle wkbBoundingBox() const { return mWkbBoundingBox; }
+
+    /**
+     * Discards the stored WKB, keeping the geometry. Must be called before
+     * the geometry is modified.
+     */
+    void discardWkb()
+    {
+      if ( mWkb.isEmpty() )
+        return;
+
+      get();
+      mWkb.clear();
+      mWkbBoundingBox = QgsRectangle();
+    }
+
+  private:
+
+    QgsAbstractGeometry *parseWkb() const
+    {
+      // the private data may be shared with geometries used from other threads
+      QMutexLocker locker( &mMutex );
+      QgsAbstractGeometry *geometry = mGeometry.loadAcquire();
+      if ( !geometry )
+      {
+        QgsConstWkbPtr ptr( mWkb );
+        geometry = QgsGeometryFactory::geomFromWkb( ptr ).release();
+        mGeometry.storeRelease( geometry );
+      }
+      return geometry;
+    }
+
+    template <typename T> static bool read( const char *&p, const char *end, T &value )
+    {
+      if ( end - p < static_cast< std::ptrdiff_t >( sizeof( T ) ) )
+        return false;
+      memcpy( &value, p, sizeof( T ) );
+      p += sizeof( T );
+      return true;
+    }
+
+    /**
+     * Skips a point sequence, computing its bounding box the same way
+     * QgsLineString does.
+     */
+    static bool scanPoints( const char *&p, const char *end, int dimensions, QgsRectangle &boundingBox )
+    {
+      qint32 count = 0;
+      const std::ptrdiff_t stride = dimensions * sizeof( double );
+      if ( !read( p, end, count ) || count < 0 || ( end - p ) / stride < count )
+        return false;
+
+      double xmin = std::numeric_limits<double>::max();
+      double ymin = std::numeric_limits<double>::max();
+      double xmax = -std::numeric_limits<double>::max();
+      double ymax = -std::numeric_limits<double>::max();
+      for ( qint32 i = 0; i < count; ++i, p += stride )
+      {
+        double x;
+        double y;
+        memcpy( &x, p, sizeof( double ) );
+        memcpy( &y, p + sizeof( double ), sizeof( double ) );
+        if ( x < xmin )
+          xmin = x;
+        if ( x > xmax )
+          xmax = x;
+        if ( y < ymin )
+          ymin = y;
+        if ( y > ymax )
+          ymax = y;
+      }
+      boundingBox = QgsRectangle( xmin, ymin, xmax, ymax );
+      return true;
+    }
+
+    /**
+     * Skips a geometry of the \a expectedType (or of any type if Unknown), computing its
+     * bounding box the same way as the geometry classes. Returns false if the geometry
+     * must not be kept as WKB.
+     */
+    static bool scanGeometry( const char *&p, const char *end, QgsWkbTypes::Type expectedType, QgsRectangle &boundingBox )
+    {
+      char endian = 0;
+      quint32 rawType = 0;
+      if ( !read( p, end, endian ) || endian != QgsApplication::endian() || !read( p, end, rawType ) )
+        return false;
+
+      // 2.5D types are converted to Z types when parsing collections, so they would not round-trip
+      if ( rawType & 0x80000000 )
+        return false;
+
+      const QgsWkbTypes::Type type = static_cast< QgsWkbTypes::Type >( rawType );
+      if ( expectedType != QgsWkbTypes::Unknown && type != expectedType )
+        return false;
+
+      const int dimensions = 2 + QgsWkbTypes::hasZ( type ) + QgsWkbTypes::hasM( type );
+      switch ( QgsWkbTypes::flatType( type ) )
+      {
+        case QgsWkbTypes::Point:
+        {
+          double x;
+          double y;
+          if ( end - p < static_cast< std::ptrdiff_t >( dimensions * sizeof( double ) ) )
+            return false;
+          memcpy( &x, p, sizeof( double ) );
+          memcpy( &y, p + sizeof( double ), sizeof( double ) );
+          p += dimensions * sizeof( double );
+          boundingBox = QgsRectangle( x, y, x, y );
+          return true;
+        }
+
+        case QgsWkbTypes::LineString:
+          return scanPoints( p, end, dimensions, boundingBox );
+
+        case QgsWkbTypes::Polygon:
+        {
+          qint32 ringCount = 0;
+          if ( !read( p, end, ringCount ) || ringCount < 0 )
+            return false;
+
+          // the bounding box of a polygon is the one of its exterior ring
+          boundingBox = QgsRectangle();
+          for ( qint32 i = 0; i < ringCount; ++i )
+          {
+            QgsRectangle ringBoundingBox;
+            if ( !scanPoints( p, end, dimensions, ringBoundingBox ) )
+              return false;
+            if ( i == 0 )
+              boundingBox = ringBoundingBox;
+          }
+          return true;
+        }
+
+        case QgsWkbTypes::MultiPoint:
+        case QgsWkbTypes::MultiLineString:
+        case QgsWkbTypes::MultiPolygon:
+        {
+          qint32 partCount = 0;
+          if ( !read( p, end, partCount ) || partCount < 0 )
+            return false;
+
+          boundingBox = QgsRectangle();
+          const QgsWkbTypes::Type partType = QgsWkbTypes::singleType( type );
+          for ( qint32 i = 0; i < partCount; ++i )
+          {
+            QgsRectangle partBoundingBox;
+            if ( !scanGeometry( p, end, partType, partBoundingBox ) )
+              return false;
+            if ( i == 0 )
+              boundingBox = partBoundingBox;
+            else
+              boundingBox.combineExtentWith( partBoundingBox );
+          }
+          return true;
+        }
+
+        default:
+          return false;
+      }
+    }
+
+    mutable QAtomicPointer< QgsAbstractGeometry > mGeometry;
+    mutable QMutex mMutex;
+    QByteArray mWkb;
+    QgsRectangle mWkbBoundingBox;
+};
+
 struct QgsGeometryPrivate
 {
   QgsGeometryPrivate(): ref( 1 ) {}
   QAtomicInt ref;
-  std::unique_ptr< QgsAbstractGeometry > geometry;
+  QgsLazyGeometry geometry;
 };
 
+///@endcond
+
 QgsGeometry::QgsGeometry()
   : d( new QgsGeometryPrivate() )
 {
@@ -102,7 +368,11 @@ QgsGeometry &QgsGeometry::operator=( QgsGeometry const &other )
 void QgsGeometry::detach()
 {
   if ( d->ref <= 1 )
+  {
+    // the geometry is about to be modified, so it will no longer match its WKB
+    d->geometry.discardWkb();
     return;
+  }
 
   std::unique_ptr< QgsAbstractGeometry > cGeom;
   if ( d->geometry )
@@ -317,13 +587,17 @@ QgsGeometry QgsGeometry::createWedgeBuffer( const QgsPoint &center, const double
 
 void QgsGeometry::fromWkb( unsigned char *wkb, int length )
 {
-  QgsConstWkbPtr ptr( wkb, length );
-  reset( QgsGeometryFactory::geomFromWkb( ptr ) );
+  fromWkb( QByteArray( reinterpret_cast< const char * >( wkb ), length ) );
   delete [] wkb;
 }
 
 void QgsGeometry::fromWkb( const QByteArray &wkb )
 {
+  reset( nullptr );
+  // parsing is deferred until the geometry itself is accessed
+  if ( d->geometry.setWkb( wkb ) )
+    return;
+
   QgsConstWkbPtr ptr( wkb );
   reset( QgsGeometryFactory::geomFromWkb( ptr ) );
 }
@@ -334,6 +608,10 @@ QgsWkbTypes::Type QgsGeometry::wkbType() const
   {
     return QgsWkbTypes::Unknown;
   }
+  else if ( d->geometry.hasWkb() )
+  {
+    return d->geometry.wkbType();
+  }
   else
   {
     return d->geometry->wkbType();
@@ -347,7 +625,7 @@ QgsWkbTypes::GeometryType QgsGeometry::type() const
   {
     return QgsWkbTypes::UnknownGeometry;
   }
-  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( d->geometry->wkbType() ) );
+  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( wkbType() ) );
 }
 
 bool QgsGeometry::isEmpty() const
@@ -366,7 +644,7 @@ bool QgsGeometry::isMultipart() const
   {
     return false;
   }
-  return QgsWkbTypes::isMultiType( d->geometry->wkbType() );
+  return QgsWkbTypes::isMultiType( wkbType() );
 }
 
 QgsPointXY QgsGeometry::closestVertex( const QgsPointXY &point, int &atVertex, int &beforeVertex, int &afterVertex, double &sqrDist ) const
@@ -931,7 +1209,11 @@ QgsGeometry QgsGeometry::makeDifference( const QgsGeometry &other ) const
 
 QgsRectangle QgsGeometry::boundingBox() const
 {
-  if ( d->geometry )
+  if ( d->geometry.hasWkb() )
+  {
+    return d->geometry.wkbBoundingBox();
+  }
+  else if ( d->geometry )
   {
     return d->geometry->boundingBox();
   }
@@ -1111,8 +1393,36 @@ bool QgsGeometry::removeDuplicateNodes( double epsilon, bool useZValues )
   return d->geometry->removeDuplicateNodes( epsilon, useZValues );
 }
 
+//! Returns true if the bounding box of \a geometry also contains its GEOS representation
+static bool hasExactBoundingBox( const QgsLazyGeometry &geometry )
+{
+  // geometries stored as WKB have no curves. The bounding box of a curve is computed from its arcs,
+  // which may differ slightly from the segments of its GEOS representation
+  return geometry.hasWkb() || !geometry->hasCurvedSegments();
+}
+
+/**
+ * Locates \a point in \a polygon without GEOS, if they are a single point and a polygon
+ * or multipolygon with linear rings.
+ */
+static QgsInternalGeometryEngine::PointLocation locatePointInPolygon( const QgsAbstractGeometry *point, const QgsAbstractGeometry *polygon )
+{
+  const QgsPoint *p = qgsgeometry_cast< const QgsPoint * >( point );
+  if ( !p )
+    return QgsInternalGeometryEngine::PointUndecided;
+
+  return QgsInternalGeometryEngine::locatePoint( polygon, p->x(), p->y() );
+}
+
 bool QgsGeometry::intersects( const QgsRectangle &r ) const
 {
+  // a geometry within the rectangle intersects it
+  if ( d->geometry && !r.isEmpty() && hasExactBoundingBox( d->geometry ) && r.contains( boundingBox() ) && !isEmpty() )
+  {
+    mLastError.clear();
+    return true;
+  }
+
   QgsGeometry g = fromRect( r );
   return intersects( g );
 }
@@ -1124,8 +1434,22 @@ bool QgsGeometry::intersects( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+
+  // simple cases are decided without converting the geometries to GEOS
+  if ( hasExactBoundingBox( d->geometry ) && hasExactBoundingBox( geometry.d->geometry ) && !boundingBox().intersects( geometry.boundingBox() ) )
+  {
+    return false;
+  }
+  QgsInternalGeometryEngine::PointLocation location = locatePointInPolygon( d->geometry.get(), geometry.d->geometry.get() );
+  if ( location == QgsInternalGeometryEngine::PointUndecided )
+    location = locatePointInPolygon( geometry.d->geometry.get(), d->geometry.get() );
+  if ( location != QgsInternalGeometryEngine::PointUndecided )
+  {
+    return location == QgsInternalGeometryEngine::PointInterior;
+  }
+
+  QgsGeos geos( d->geometry.get() );
   return geos.intersects( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1136,7 +1460,7 @@ bool QgsGeometry::boundingBoxIntersects( const QgsRectangle &rectangle ) const
     return false;
   }
 
-  return d->geometry->boundingBox().intersects( rectangle );
+  return boundingBox().intersects( rectangle );
 }
 
 bool QgsGeometry::boundingBoxIntersects( const QgsGeometry &geometry ) const
@@ -1146,7 +1470,7 @@ bool QgsGeometry::boundingBoxIntersects( const QgsGeometry &geometry ) const
     return false;
   }
 
-  return d->geometry->boundingBox().intersects( geometry.constGet()->boundingBox() );
+  return boundingBox().intersects( geometry.boundingBox() );
 }
 
 bool QgsGeometry::contains( const QgsPointXY *p ) const
@@ -1156,9 +1480,25 @@ bool QgsGeometry::contains( const QgsPointXY *p ) const
     return false;
   }
 
+  mLastError.clear();
+
+  // simple cases are decided without converting the geometry to GEOS
+  if ( hasExactBoundingBox( d->geometry ) && !boundingBox().contains( *p ) )
+  {
+    return false;
+  }
+  switch ( QgsInternalGeometryEngine::locatePoint( d->geometry.get(), p->x(), p->y() ) )
+  {
+    case QgsInternalGeometryEngine::PointInterior:
+      return true;
+    case QgsInternalGeometryEngine::PointExterior:
+      return false;
+    case QgsInternalGeometryEngine::PointUndecided:
+      break;
+  }
+
   QgsPoint pt( p->x(), p->y() );
   QgsGeos geos( d->geometry.get() );
-  mLastError.clear();
   return geos.contains( &pt, &mLastError );
 }
 
@@ -1169,8 +1509,20 @@ bool QgsGeometry::contains( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+
+  // simple cases are decided without converting the geometries to GEOS
+  if ( hasExactBoundingBox( d->geometry ) && hasExactBoundingBox( geometry.d->geometry ) && !boundingBox().contains( geometry.boundingBox() ) )
+  {
+    return false;
+  }
+  const QgsInternalGeometryEngine::PointLocation location = locatePointInPolygon( geometry.d->geometry.get(), d->geometry.get() );
+  if ( location != QgsInternalGeometryEngine::PointUndecided )
+  {
+    return location == QgsInternalGeometryEngine::PointInterior;
+  }
+
+  QgsGeos geos( d->geometry.get() );
   return geos.contains( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1181,8 +1533,22 @@ bool QgsGeometry::disjoint( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+
+  // simple cases are decided without converting the geometries to GEOS
+  if ( hasExactBoundingBox( d->geometry ) && hasExactBoundingBox( geometry.d->geometry ) && !boundingBox().intersects( geometry.boundingBox() ) )
+  {
+    return true;
+  }
+  QgsInternalGeometryEngine::PointLocation location = locatePointInPolygon( d->geometry.get(), geometry.d->geometry.get() );
+  if ( location == QgsInternalGeometryEngine::PointUndecided )
+    location = locatePointInPolygon( geometry.d->geometry.get(), d->geometry.get() );
+  if ( location != QgsInternalGeometryEngine::PointUndecided )
+  {
+    return location == QgsInternalGeometryEngine::PointExterior;
+  }
+
+  QgsGeos geos( d->geometry.get() );
   return geos.disjoint( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1232,8 +1598,20 @@ bool QgsGeometry::within( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+
+  // simple cases are decided without converting the geometries to GEOS
+  if ( hasExactBoundingBox( d->geometry ) && hasExactBoundingBox( geometry.d->geometry ) && !geometry.boundingBox().contains( boundingBox() ) )
+  {
+    return false;
+  }
+  const QgsInternalGeometryEngine::PointLocation location = locatePointInPolygon( d->geometry.get(), geometry.d->geometry.get() );
+  if ( location != QgsInternalGeometryEngine::PointUndecided )
+  {
+    return location == QgsInternalGeometryEngine::PointInterior;
+  }
+
+  QgsGeos geos( d->geometry.get() );
   return geos.within( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -2229,6 +2607,8 @@ QgsGeometry QgsGeometry::extrude( double x, double y )
 
 QByteArray QgsGeometry::asWkb() const
 {
+  if ( d->geometry.hasWkb() )
+    return d->geometry.wkb();
   return d->geometry ? d->geometry->asWkb() : QByteArray();
 }
 
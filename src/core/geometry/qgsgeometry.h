@@ -276,6 +276,9 @@ class CORE_EXPORT QgsGeometry
 
     /**
      * Set the geometry, feeding in the buffer containing OGC Well-Known Binary
+     *
+     * The WKB is only parsed on the first access to the geometry itself, so wkbType(),
+     * boundingBox() and asWkb() do not require it to be parsed.
      * \since QGIS 3.0
      */
     void fromWkb( const QByteArray &wkb );
@@ -223,6 +223,29 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
     bool isEmpty( QString *errorMsg = nullptr ) const override;
     bool isSimple( QString *errorMsg = nullptr ) const override;
 
+    /**
+     * Spatial predicates against the geometry of an \a other GEOS engine. Unlike the
+     * variants taking a QgsAbstractGeometry, the other geometry is not converted to
+     * GEOS again, so engines created once can be tested against each other repeatedly.
+     * The prepared geometry of this engine is used if prepareGeometry() was called.
+     * \since QGIS 3.4
+     */
+    bool intersects( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool touches( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool crosses( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool within( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool overlaps( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool contains( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool disjoint( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+    //! \see intersects( const QgsGeos &, QString * )
+    bool isEqual( const QgsGeos &other, QString *errorMsg = nullptr ) const;
+
     EngineOperationResult splitGeometry( const QgsLineString &splitLine,
                                          QVector<QgsGeometry> &newGeometries,
                                          bool topological,
@@ -387,6 +410,7 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
     void cacheGeos() const;
     std::unique_ptr< QgsAbstractGeometry > overlay( const QgsAbstractGeometry *geom, Overlay op, QString *errorMsg = nullptr ) const;
     bool relation( const QgsAbstractGeometry *geom, Relation r, QString *errorMsg = nullptr ) const;
+    bool relation( const GEOSGeometry *geosGeom, Relation r, QString *errorMsg = nullptr ) const;
     static GEOSCoordSequence *createCoordinateSequence( const QgsCurve *curve, double precision, bool forceClose = false );
     static std::unique_ptr< QgsLineString > sequenceToLinestring( const GEOSGeometry *geos, bool hasZ, bool hasM );
     static int numberOfGeometries( GEOSGeometry *g );
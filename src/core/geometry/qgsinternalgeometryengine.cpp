@@ -26,6 +26,8 @@
 #include "qgscircle.h"
 #include "qgslogger.h"
 #include <QTransform>
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -1034,3 +1036,115 @@ QgsGeometry QgsInternalGeometryEngine::variableWidthBufferByM( int segments ) co
 
   return variableWidthBuffer( segments, widthByM );
 }
+
+//! Relative error bound of orientation tests computed with doubles, slightly larger than in Shewchuk's robust predicates
+static const double ORIENTATION_ERROR_BOUND = 1e-15;
+
+/**
+ * Locates a point relative to a ring with the crossing number algorithm. Returns 1 if the point
+ * is inside, 0 if it is outside and -1 if it is too close to an edge to be decided.
+ */
+static int locatePointInRing( const QgsLineString *ring, double x, double y )
+{
+  const int numPoints = ring->numPoints();
+  const double *xData = ring->xData();
+  const double *yData = ring->yData();
+
+  bool inside = false;
+  // iterate the edges from the last vertex, which also closes unclosed rings like GEOS does
+  for ( int i = 0, j = numPoints - 1; i < numPoints; j = i++ )
+  {
+    const double ax = xData[j];
+    const double ay = yData[j];
+    const double bx = xData[i];
+    const double by = yData[i];
+    const double minX = std::min( ax, bx );
+    const double maxX = std::max( ax, bx );
+
+    double orientation = 0;
+    if ( x >= minX && x <= maxX && y >= std::min( ay, by ) && y <= std::max( ay, by ) )
+    {
+      // the point may lie on the edge, only trust the orientation if it exceeds its rounding error
+      const double left = ( bx - ax ) * ( y - ay );
+      const double right = ( by - ay ) * ( x - ax );
+      orientation = left - right;
+      if ( std::fabs( orientation ) <= ORIENTATION_ERROR_BOUND * ( std::fabs( left ) + std::fabs( right ) ) )
+        return -1;
+    }
+
+    if ( ( ay > y ) == ( by > y ) )
+      continue;
+
+    // the edge crosses the horizontal line through the point, count it if this is on the right of the point
+    if ( x < minX )
+      inside = !inside;
+    else if ( x <= maxX && ( orientation > 0 ) == ( by > ay ) )
+      inside = !inside;
+  }
+  return inside ? 1 : 0;
+}
+
+//! Locates a point relative to a polygon with linear rings
+static QgsInternalGeometryEngine::PointLocation locatePointInPolygon( const QgsPolygon *polygon, double x, double y )
+{
+  // GEOS refuses rings with less than 4 points, leave them to it
+  const QgsLineString *exterior = qgsgeometry_cast< const QgsLineString * >( polygon->exteriorRing() );
+  if ( !exterior || exterior->numPoints() < 4 )
+    return QgsInternalGeometryEngine::PointUndecided;
+
+  switch ( locatePointInRing( exterior, x, y ) )
+  {
+    case 0:
+      return QgsInternalGeometryEngine::PointExterior;
+    case -1:
+      return QgsInternalGeometryEngine::PointUndecided;
+  }
+
+  QgsInternalGeometryEngine::PointLocation location = QgsInternalGeometryEngine::PointInterior;
+  for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+  {
+    const QgsLineString *hole = qgsgeometry_cast< const QgsLineString * >( polygon->interiorRing( i ) );
+    if ( !hole || hole->numPoints() < 4 )
+      return QgsInternalGeometryEngine::PointUndecided;
+
+    switch ( locatePointInRing( hole, x, y ) )
+    {
+      case 1:
+        location = QgsInternalGeometryEngine::PointExterior;
+        break;
+      case -1:
+        return QgsInternalGeometryEngine::PointUndecided;
+    }
+  }
+  return location;
+}
+
+QgsInternalGeometryEngine::PointLocation QgsInternalGeometryEngine::locatePoint( const QgsAbstractGeometry *geometry, double x, double y )
+{
+  if ( !geometry || !std::isfinite( x ) || !std::isfinite( y ) )
+    return PointUndecided;
+
+  if ( const QgsPolygon *polygon = qgsgeometry_cast< const QgsPolygon * >( geometry ) )
+    return locatePointInPolygon( polygon, x, y );
+
+  const QgsMultiPolygon *multiPolygon = qgsgeometry_cast< const QgsMultiPolygon * >( geometry );
+  if ( !multiPolygon || multiPolygon->isEmpty() )
+    return PointUndecided;
+
+  // GEOS treats points on the boundary of any part as on the boundary, so all parts must be decided
+  PointLocation location = PointExterior;
+  for ( int i = 0; i < multiPolygon->numGeometries(); ++i )
+  {
+    switch ( locatePointInPolygon( static_cast< const QgsPolygon * >( multiPolygon->geometryN( i ) ), x, y ) )
+    {
+      case PointInterior:
+        location = PointInterior;
+        break;
+      case PointExterior:
+        break;
+      case PointUndecided:
+        return PointUndecided;
+    }
+  }
+  return location;
+}
@@ -146,6 +146,25 @@ class QgsInternalGeometryEngine
      */
     QgsGeometry variableWidthBufferByM( int segments ) const;
 
+    //! Location of a point relative to a polygonal geometry
+    enum PointLocation
+    {
+      PointInterior, //!< The point is in the interior of the geometry
+      PointExterior, //!< The point is outside of the geometry
+      PointUndecided, //!< The point is on or too close to the boundary of the geometry, or the geometry type is not supported
+    };
+
+    /**
+     * Locates the point at \a x, \a y relative to a polygon or multipolygon \a geometry
+     * directly on the coordinates of its rings, without converting it to GEOS.
+     *
+     * The result is only decided when floating point orientation tests are exact, so it
+     * always matches GEOS. Points on or very close to the boundary, as well as curved or
+     * degenerate polygons, are PointUndecided and must be located with GEOS.
+     * \since QGIS 3.4
+     */
+    static PointLocation locatePoint( const QgsAbstractGeometry *geometry, double x, double y );
+
   private:
     const QgsAbstractGeometry *mGeometry = nullptr;
 };
@@ -21,6 +21,8 @@
 #include "qgsprocessingutils.h"
 #include "qgsxmlutils.h"
 #include "qgsexception.h"
+#include "qgsmessagelog.h"
+#include "qgsprocessingfeaturestream_p.h"
 #include <QFile>
 #include <QTextStream>
 
@@ -220,6 +222,120 @@ bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId,
   return false;
 }
 
+QMap< QString, QString > QgsProcessingModelAlgorithm::streamedChildInputs( const QSet< QString > &childIds ) const
+{
+  // count the links to the outputs of each child, and collect the expressions which could refer to them
+  QMap< QString, int > outputUses;
+  QStringList expressions;
+  for ( const QString &childId : childIds )
+  {
+    const QMap<QString, QgsProcessingModelChildParameterSources> childParams = mChildAlgorithms.value( childId ).parameterSources();
+    for ( const QgsProcessingModelChildParameterSources &sources : childParams )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : sources )
+      {
+        switch ( source.source() )
+        {
+          case QgsProcessingModelChildParameterSource::ChildOutput:
+            outputUses[ source.outputChildId() ]++;
+            break;
+          case QgsProcessingModelChildParameterSource::Expression:
+            expressions << source.expression();
+            break;
+          case QgsProcessingModelChildParameterSource::ExpressionText:
+            expressions << source.expressionText();
+            break;
+          case QgsProcessingModelChildParameterSource::StaticValue:
+            if ( source.staticValue().canConvert< QgsProperty >() )
+              expressions << source.staticValue().value< QgsProperty >().asExpression();
+            break;
+          case QgsProcessingModelChildParameterSource::ModelParameter:
+            break;
+        }
+      }
+    }
+  }
+
+  QMap< QString, QString > inputs;
+  for ( const QString &childId : childIds )
+  {
+    const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+    const QgsProcessingFeatureBasedAlgorithm *childAlg = dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( child.algorithm() );
+    if ( !childAlg || !childAlg->supportsStreaming() )
+      continue;
+
+    const QgsProcessingModelChildParameterSources sources = child.parameterSources().value( QStringLiteral( "INPUT" ) );
+    if ( sources.count() != 1
+         || sources.at( 0 ).source() != QgsProcessingModelChildParameterSource::ChildOutput
+         || sources.at( 0 ).outputName() != QLatin1String( "OUTPUT" )
+         || !childIds.contains( sources.at( 0 ).outputChildId() ) )
+      continue;
+
+    // the intermediate output must only be read by this child
+    const QString upstreamId = sources.at( 0 ).outputChildId();
+    const QgsProcessingModelChildAlgorithm &upstream = mChildAlgorithms[ upstreamId ];
+    const QgsProcessingFeatureBasedAlgorithm *upstreamAlg = dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( upstream.algorithm() );
+    if ( !upstreamAlg
+         || !upstreamAlg->supportsStreaming()
+         || upstream.algorithm()->outputDefinitions().count() != 1
+         || upstream.algorithm()->destinationParameterDefinitions().count() != 1
+         || !upstream.modelOutputs().isEmpty()
+         || outputUses.value( upstreamId ) != 1 )
+      continue;
+
+    // nor through the variables created for it, see variablesForChildAlgorithm()
+    QString variableName = QStringLiteral( "%1_OUTPUT" ).arg( upstream.description().isEmpty() ? upstreamId : upstream.description() );
+    variableName.replace( QRegularExpression( QStringLiteral( "[\\s'\"\\(\\):]" ) ), QStringLiteral( "_" ) );
+    bool usedInExpression = false;
+    for ( const QString &expression : qgis::as_const( expressions ) )
+    {
+      if ( expression.contains( variableName ) )
+      {
+        usedInExpression = true;
+        break;
+      }
+    }
+    if ( usedInExpression )
+      continue;
+
+    inputs.insert( childId, upstreamId );
+  }
+
+  // a chain is run at once, so it cannot wait for another child which depends on a child of the chain
+  QSet< QString > upstreamIds;
+  for ( const QString &upstreamId : qgis::as_const( inputs ) )
+    upstreamIds.insert( upstreamId );
+  const QStringList downstreamIds = inputs.keys();
+  for ( const QString &tailId : downstreamIds )
+  {
+    if ( upstreamIds.contains( tailId ) )
+      continue;
+
+    QSet< QString > chain;
+    for ( QString id = tailId; !id.isEmpty(); id = inputs.value( id ) )
+      chain.insert( id );
+
+    bool deadlock = false;
+    const QSet< QString > dependencies = dependsOnChildAlgorithms( tailId );
+    for ( const QString &dependency : dependencies )
+    {
+      if ( !chain.contains( dependency ) && dependsOnChildAlgorithms( dependency ).intersects( chain ) )
+      {
+        deadlock = true;
+        break;
+      }
+    }
+
+    if ( deadlock )
+    {
+      for ( const QString &id : qgis::as_const( chain ) )
+        inputs.remove( id );
+    }
+  }
+
+  return inputs;
+}
+
 QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QSet< QString > toExecute;
@@ -236,6 +352,12 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
   QgsProcessingMultiStepFeedback modelFeedback( toExecute.count(), feedback );
   QgsExpressionContext baseContext = createExpressionContext( parameters, context );
 
+  // chains of feature based children are run at once, streaming features from one child to the next one
+  const QMap< QString, QString > streamedInputs = streamedChildInputs( toExecute );
+  QSet< QString > streamedOutputs;
+  for ( const QString &upstreamId : streamedInputs )
+    streamedOutputs.insert( upstreamId );
+
   QVariantMap childResults;
   QVariantMap finalResults;
   QSet< QString > executed;
@@ -248,13 +370,18 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       if ( feedback && feedback->isCanceled() )
         break;
 
-      if ( executed.contains( childId ) )
+      // children streaming their features are run together with the last child of their chain
+      if ( executed.contains( childId ) || streamedOutputs.contains( childId ) )
         continue;
 
+      QStringList chain;
+      for ( QString id = childId; !id.isEmpty(); id = streamedInputs.value( id ) )
+        chain.prepend( id );
+
       bool canExecute = true;
       Q_FOREACH ( const QString &dependency, dependsOnChildAlgorithms( childId ) )
       {
-        if ( !executed.contains( dependency ) )
+        if ( !executed.contains( dependency ) && !chain.contains( dependency ) )
         {
           canExecute = false;
           break;
@@ -265,50 +392,112 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
         continue;
 
       executedAlg = true;
-      if ( feedback )
-        feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( childId ) );
 
-      const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+      QTime childTime;
+      childTime.start();
 
-      QgsExpressionContext expContext = baseContext;
-      expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
-                 << createExpressionContextScopeForChildAlgorithm( childId, context, parameters, childResults );
+      std::unique_ptr< QgsFeatureSource > stream;
+      QVariantMap results;
+      for ( int i = 0; i < chain.count(); ++i )
+      {
+        const QString &memberId = chain.at( i );
+        const bool isStreamed = i < chain.count() - 1;
 
-      QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext );
-      if ( feedback )
-        feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + 1 ).arg( toExecute.count() ) );
+        if ( feedback )
+          feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( memberId ) );
 
-      QStringList params;
-      for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
-      {
-        params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
-               child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
-      }
+        const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ memberId ];
 
-      if ( feedback )
-      {
-        feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
-        feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QStringLiteral( ", " ) ) ) );
-      }
+        QgsExpressionContext expContext = baseContext;
+        expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
+                   << createExpressionContextScopeForChildAlgorithm( memberId, context, parameters, childResults );
 
-      QTime childTime;
-      childTime.start();
+        QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext );
+        if ( feedback )
+          feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + i + 1 ).arg( toExecute.count() ) );
+
+        QStringList params;
+        for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
+        {
+          params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
+                 child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
+        }
 
-      bool ok = false;
-      std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
-      QVariantMap results = childAlg->run( childParams, context, &modelFeedback, &ok, child.configuration() );
-      childAlg.reset( nullptr );
-      if ( !ok )
-      {
-        QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
         if ( feedback )
-          feedback->reportError( error );
-        throw QgsProcessingException( error );
+        {
+          feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
+          feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QStringLiteral( ", " ) ) ) );
+        }
+
+        bool ok = false;
+        std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
+        if ( !stream )
+        {
+          if ( isStreamed )
+            ok = childAlg->prepare( childParams, context, &modelFeedback );
+          else
+            results = childAlg->run( childParams, context, &modelFeedback, &ok, child.configuration() );
+        }
+        else
+        {
+          // read features from the previous child of the chain instead of the INPUT parameter
+          static_cast< QgsProcessingFeatureBasedAlgorithm * >( childAlg.get() )->mInputStream = std::move( stream );
+          ok = childAlg->prepare( childParams, context, &modelFeedback );
+          if ( ok && !isStreamed )
+          {
+            try
+            {
+              results = childAlg->runPrepared( childParams, context, &modelFeedback );
+            }
+            catch ( QgsProcessingException &e )
+            {
+              QgsMessageLog::logMessage( e.what(), QObject::tr( "Processing" ), Qgis::Critical );
+              modelFeedback.reportError( e.what() );
+              ok = false;
+            }
+            if ( ok )
+            {
+              const QVariantMap ppRes = childAlg->postProcess( context, &modelFeedback );
+              if ( !ppRes.isEmpty() )
+                results = ppRes;
+            }
+          }
+        }
+
+        if ( ok && isStreamed )
+        {
+          try
+          {
+            stream = qgis::make_unique< QgsProcessingFeatureStreamSource >( static_cast< QgsProcessingFeatureBasedAlgorithm * >( childAlg.release() ), childParams, context, &modelFeedback );
+          }
+          catch ( QgsProcessingException &e )
+          {
+            modelFeedback.reportError( e.what() );
+            ok = false;
+          }
+        }
+        childAlg.reset( nullptr );
+
+        if ( !ok )
+        {
+          QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
+          if ( feedback )
+            feedback->reportError( error );
+          throw QgsProcessingException( error );
+        }
+
+        if ( isStreamed )
+        {
+          if ( feedback )
+            feedback->pushDebugInfo( QObject::tr( "Streaming features to %1" ).arg( chain.at( i + 1 ) ) );
+          childResults.insert( memberId, QVariantMap() );
+        }
       }
       childResults.insert( childId, results );
 
       // look through child alg's outputs to determine whether any of these should be copied
       // to the final model outputs
+      const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
       QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
       QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
       for ( ; outputIt != outputs.constEnd(); ++outputIt )
@@ -316,7 +505,8 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
         finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
       }
 
-      executed.insert( childId );
+      for ( const QString &memberId : qgis::as_const( chain ) )
+        executed.insert( memberId );
       modelFeedback.setCurrentStep( executed.count() );
       if ( feedback )
         feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%2 outputs)." ).arg( childTime.elapsed() / 1000.0 ).arg( results.count() ) );
@@ -405,6 +405,15 @@ class CORE_EXPORT QgsProcessingModelAlgorithm : public QgsProcessingAlgorithm
      */
     bool childOutputIsRequired( const QString &childId, const QString &outputName ) const;
 
+    /**
+     * Returns the links between feature based child algorithms from \a childIds which
+     * support streaming, see QgsProcessingFeatureBasedAlgorithm::supportsStreaming(), whose
+     * features can be streamed from one child to the next one, without materializing
+     * the intermediate output. The map keys are the ids of the children reading the
+     * streams and the values the ids of the children producing them.
+     */
+    QMap< QString, QString > streamedChildInputs( const QSet< QString > &childIds ) const;
+
     /**
      * Checks whether the output vector type given by \a outputType is compatible
      * with the list of acceptable data types specified by \a acceptableDataTypes.
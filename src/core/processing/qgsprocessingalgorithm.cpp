@@ -26,6 +26,10 @@
 #include "qgsexception.h"
 #include "qgsmessagelog.h"
 #include "qgsprocessingfeedback.h"
+#include "qgsfeaturesink.h"
+
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -831,11 +835,19 @@ QgsCoordinateReferenceSystem QgsProcessingFeatureBasedAlgorithm::sourceCrs() con
     return QgsCoordinateReferenceSystem();
 }
 
-QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+void QgsProcessingFeatureBasedAlgorithm::loadSource( const QVariantMap &parameters, QgsProcessingContext &context )
 {
-  mSource.reset( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
+  if ( mInputStream )
+    mSource = qgis::make_unique< QgsProcessingFeatureSource >( mInputStream.release(), context, true );
+  else
+    mSource.reset( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !mSource )
     throw QgsProcessingException( invalidSourceError( parameters, QStringLiteral( "INPUT" ) ) );
+}
+
+QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  loadSource( parameters, context );
 
   QString dest;
   std::unique_ptr< QgsFeatureSink > sink( parameterAsSink( parameters, QStringLiteral( "OUTPUT" ), context, dest,
@@ -857,24 +869,33 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
   QgsFeature f;
   QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
 
-  double step = count > 0 ? 100.0 / count : 1;
-  int current = 0;
-  while ( it.nextFeature( f ) )
+  if ( supportsParallelProcessing() && QThreadPool::globalInstance()->maxThreadCount() > 1 )
   {
-    if ( feedback->isCanceled() )
+    processFeaturesInParallel( it, sink.get(), context, feedback, count );
+  }
+  else
+  {
+    double step = count > 0 ? 100.0 / count : 1;
+    int current = 0;
+    while ( it.nextFeature( f ) )
     {
-      break;
-    }
+      if ( feedback->isCanceled() )
+      {
+        break;
+      }
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      context.expressionContext().setFeature( f );
+      const QgsFeatureList transformed = processFeature( f, context, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    feedback->setProgress( current * step );
-    current++;
+      feedback->setProgress( current * step );
+      current++;
+    }
   }
 
+  // the iterator may refer to a streamed source, so it must not outlive it
+  it = QgsFeatureIterator();
   mSource.reset();
 
   // probably not necessary - context's aren't usually recycled, but can't hurt
@@ -890,3 +911,193 @@ QgsFeatureRequest QgsProcessingFeatureBasedAlgorithm::request() const
   return QgsFeatureRequest();
 }
 
+bool QgsProcessingFeatureBasedAlgorithm::supportsParallelProcessing() const
+{
+  return false;
+}
+
+bool QgsProcessingFeatureBasedAlgorithm::supportsStreaming() const
+{
+  return false;
+}
+
+///@cond PRIVATE
+
+//! Number of chunks of a block of features per thread, so that threads finishing early can take more work
+static const int PARALLEL_CHUNKS_PER_THREAD = 4;
+//! Number of features in a chunk
+static const int PARALLEL_FEATURES_PER_CHUNK = 64;
+
+/**
+ * Feedback which stores the messages pushed from a worker thread, so that they can be
+ * reported later on from the thread running the algorithm.
+ */
+class QgsProcessingBufferedFeedback : public QgsProcessingFeedback
+{
+  public:
+
+    explicit QgsProcessingBufferedFeedback( QgsProcessingFeedback *feedback )
+    {
+      connect( feedback, &QgsFeedback::canceled, this, &QgsFeedback::cancel, Qt::DirectConnection );
+      if ( feedback->isCanceled() )
+        cancel();
+    }
+
+    void reportError( const QString &error, bool fatalError ) override { mMessages << Message( fatalError ? FatalError : Error, error ); }
+    void pushInfo( const QString &info ) override { mMessages << Message( Info, info ); }
+    void pushCommandInfo( const QString &info ) override { mMessages << Message( CommandInfo, info ); }
+    void pushDebugInfo( const QString &info ) override { mMessages << Message( DebugInfo, info ); }
+    void pushConsoleInfo( const QString &info ) override { mMessages << Message( ConsoleInfo, info ); }
+
+    //! Reports the stored messages to \a feedback and clears them
+    void flush( QgsProcessingFeedback *feedback )
+    {
+      for ( const Message &message : qgis::as_const( mMessages ) )
+      {
+        switch ( message.first )
+        {
+          case Error:
+            feedback->reportError( message.second, false );
+            break;
+          case FatalError:
+            feedback->reportError( message.second, true );
+            break;
+          case Info:
+            feedback->pushInfo( message.second );
+            break;
+          case CommandInfo:
+            feedback->pushCommandInfo( message.second );
+            break;
+          case DebugInfo:
+            feedback->pushDebugInfo( message.second );
+            break;
+          case ConsoleInfo:
+            feedback->pushConsoleInfo( message.second );
+            break;
+        }
+      }
+      mMessages.clear();
+    }
+
+  private:
+
+    enum MessageType
+    {
+      Error,
+      FatalError,
+      Info,
+      CommandInfo,
+      DebugInfo,
+      ConsoleInfo,
+    };
+    typedef QPair< MessageType, QString > Message;
+    QList< Message > mMessages;
+};
+
+//! A range of a block of features, processed by a single thread
+struct QgsProcessingFeatureChunk
+{
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingBufferedFeedback > feedback;
+  int begin = 0;
+  int end = 0;
+  QVector< QgsFeatureList > results;
+  bool failed = false;
+  QString error;
+};
+
+///@endcond
+
+void QgsProcessingFeatureBasedAlgorithm::processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long count )
+{
+  const int chunkCount = QThreadPool::globalInstance()->maxThreadCount() * PARALLEL_CHUNKS_PER_THREAD;
+  const int blockSize = chunkCount * PARALLEL_FEATURES_PER_CHUNK;
+
+  std::vector< QgsProcessingFeatureChunk > chunks( chunkCount );
+  for ( QgsProcessingFeatureChunk &chunk : chunks )
+  {
+    chunk.feedback = qgis::make_unique< QgsProcessingBufferedFeedback >( feedback );
+    chunk.context = qgis::make_unique< QgsProcessingContext >();
+    chunk.context->copyThreadSafeSettings( context );
+    chunk.context->setFeedback( chunk.feedback.get() );
+  }
+
+  auto processChunk = [this]( QgsProcessingFeatureChunk & chunk, const QVector< QgsFeature > &block )
+  {
+    try
+    {
+      for ( int i = chunk.begin; i < chunk.end; ++i )
+      {
+        if ( chunk.feedback->isCanceled() )
+          break;
+
+        const QgsFeature &feature = block.at( i );
+        chunk.context->expressionContext().setFeature( feature );
+        chunk.results[ i - chunk.begin ] = processFeature( feature, *chunk.context, chunk.feedback.get() );
+      }
+    }
+    catch ( QgsProcessingException &e )
+    {
+      chunk.failed = true;
+      chunk.error = e.what();
+    }
+  };
+
+  double step = count > 0 ? 100.0 / count : 1;
+  long current = 0;
+  QVector< QgsFeature > block;
+  block.reserve( blockSize );
+  QgsFeature f;
+  bool finished = false;
+  while ( !finished && !feedback->isCanceled() )
+  {
+    block.clear();
+    while ( block.size() < blockSize )
+    {
+      if ( !iterator.nextFeature( f ) )
+      {
+        finished = true;
+        break;
+      }
+      block << f;
+    }
+    if ( block.isEmpty() )
+      break;
+
+    const int chunkSize = ( block.size() + chunkCount - 1 ) / chunkCount;
+    for ( int i = 0; i < chunkCount; ++i )
+    {
+      QgsProcessingFeatureChunk &chunk = chunks[i];
+      chunk.begin = std::min( i * chunkSize, block.size() );
+      chunk.end = std::min( chunk.begin + chunkSize, block.size() );
+      chunk.results.clear();
+      chunk.results.resize( chunk.end - chunk.begin );
+    }
+
+    QtConcurrent::blockingMap( chunks, [&processChunk, &block]( QgsProcessingFeatureChunk & chunk ) { processChunk( chunk, block ); } );
+
+    for ( QgsProcessingFeatureChunk &chunk : chunks )
+    {
+      chunk.feedback->flush( feedback );
+      if ( chunk.failed )
+        throw QgsProcessingException( chunk.error );
+    }
+
+    if ( feedback->isCanceled() )
+      break;
+
+    // add the results in the order of the input features
+    for ( const QgsProcessingFeatureChunk &chunk : chunks )
+    {
+      for ( const QgsFeatureList &transformed : chunk.results )
+      {
+        for ( QgsFeature transformedFeature : transformed )
+          sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+
+        feedback->setProgress( current * step );
+        current++;
+      }
+    }
+  }
+}
+
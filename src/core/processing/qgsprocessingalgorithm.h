@@ -961,10 +961,62 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      */
     virtual QgsFeatureRequest request() const;
 
+    /**
+     * Returns true if processFeature() can be called for several features at the same time
+     * from different threads, with the parameter values of the current execution.
+     *
+     * If true, blocks of input features are distributed to a pool of threads. Each thread uses
+     * its own processing context, with a copy of the thread safe settings of the algorithm's
+     * context, and messages pushed to the feedback object are reported once the block is
+     * processed. The resulting features are added to the output sink in the order of the
+     * input features.
+     *
+     * This is called after prepareAlgorithm(), so algorithms can take their parameters into
+     * account, e.g. by returning false when a dynamic parameter requires the evaluation of
+     * an expression for every feature. Algorithms returning true must not modify their own
+     * state in processFeature().
+     *
+     * The default implementation returns false.
+     *
+     * \since QGIS 3.4
+     */
+    virtual bool supportsParallelProcessing() const;
+
+    /**
+     * Returns true if the algorithm can be chained with other feature based children
+     * of a model without materializing the intermediate layers.
+     *
+     * When its output is streamed, only prepareAlgorithm() and processFeature() are called,
+     * and when it reads a stream, its input is not available from the INPUT parameter.
+     * Algorithms returning true must therefore not read the INPUT parameter in
+     * prepareAlgorithm(), nor override processAlgorithm() or postProcessAlgorithm().
+     *
+     * The default implementation returns false.
+     *
+     * \since QGIS 3.4
+     */
+    virtual bool supportsStreaming() const;
+
   private:
 
+    //! Processes the features from \a iterator in parallel, adding the results to \a sink
+    void processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long count );
+
+    /**
+     * Loads the source of features to process, from the input stream if one was set
+     * or from the INPUT parameter otherwise.
+     */
+    void loadSource( const QVariantMap &parameters, QgsProcessingContext &context );
+
     std::unique_ptr< QgsProcessingFeatureSource > mSource;
 
+    //! Stream of features set by a model, processed instead of the INPUT parameter
+    std::unique_ptr< QgsFeatureSource > mInputStream;
+
+    friend class QgsProcessingModelAlgorithm;
+    friend class QgsProcessingFeatureStreamSource;
+    friend class QgsProcessingFeatureStreamIterator;
+
 };
 
 // clazy:excludeall=qstring-allocations
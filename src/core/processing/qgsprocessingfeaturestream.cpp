@@ -0,0 +1,210 @@
+/***************************************************************************
+                         qgsprocessingfeaturestream.cpp
+                         ------------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingfeaturestream_p.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingcontext.h"
+#include "qgsprocessingfeedback.h"
+#include "qgsexception.h"
+#include "qgsexpression.h"
+#include "qgsmessagelog.h"
+
+///@cond PRIVATE
+
+QgsProcessingFeatureStreamSource::QgsProcessingFeatureStreamSource( QgsProcessingFeatureBasedAlgorithm *algorithm, const QVariantMap &parameters,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+  : mAlgorithm( algorithm )
+  , mContext( qgis::make_unique< QgsProcessingContext >() )
+  , mFeedback( feedback )
+{
+  mAlgorithm->loadSource( parameters, context );
+  const QgsProcessingFeatureSource *source = mAlgorithm->mSource.get();
+
+  mFields = mAlgorithm->outputFields( source->fields() );
+  mWkbType = mAlgorithm->outputWkbType( source->wkbType() );
+  mCrs = mAlgorithm->outputCrs( source->sourceCrs() );
+
+  // same expression context as when the algorithm is run on its own
+  mContext->copyThreadSafeSettings( context );
+  mContext->setFeedback( mFeedback );
+  QgsExpressionContext expressionContext = context.expressionContext();
+  expressionContext.appendScopes( mAlgorithm->createExpressionContext( parameters, context, mAlgorithm->mSource.get() ).takeScopes() );
+  mContext->setExpressionContext( expressionContext );
+}
+
+QgsProcessingFeatureStreamSource::~QgsProcessingFeatureStreamSource() = default;
+
+QgsFeatureIterator QgsProcessingFeatureStreamSource::getFeatures( const QgsFeatureRequest &request ) const
+{
+  return QgsFeatureIterator( new QgsProcessingFeatureStreamIterator( this, request ) );
+}
+
+QString QgsProcessingFeatureStreamSource::sourceName() const
+{
+  return mAlgorithm->displayName();
+}
+
+QgsCoordinateReferenceSystem QgsProcessingFeatureStreamSource::sourceCrs() const
+{
+  return mCrs;
+}
+
+QgsFields QgsProcessingFeatureStreamSource::fields() const
+{
+  return mFields;
+}
+
+QgsWkbTypes::Type QgsProcessingFeatureStreamSource::wkbType() const
+{
+  return mWkbType;
+}
+
+long QgsProcessingFeatureStreamSource::featureCount() const
+{
+  // algorithms may skip or split features, but this is only used for progress reports
+  return mAlgorithm->mSource->featureCount();
+}
+
+
+QgsProcessingFeatureStreamIterator::QgsProcessingFeatureStreamIterator( const QgsProcessingFeatureStreamSource *source, const QgsFeatureRequest &request )
+  : QgsAbstractFeatureIterator( request )
+  , mSource( source )
+{
+  if ( mRequest.destinationCrs().isValid() && mRequest.destinationCrs() != mSource->mCrs )
+  {
+    mTransform = QgsCoordinateTransform( mSource->mCrs, mRequest.destinationCrs(), mRequest.transformContext() );
+  }
+  try
+  {
+    mFilterRect = filterRectToSourceCrs( mTransform );
+  }
+  catch ( QgsCsException & )
+  {
+    // can't reproject mFilterRect
+    close();
+    return;
+  }
+
+  if ( mRequest.filterType() == QgsFeatureRequest::FilterExpression )
+  {
+    mRequest.expressionContext()->setFields( mSource->mFields );
+    mRequest.filterExpression()->prepare( mRequest.expressionContext() );
+  }
+
+  const QgsProcessingFeatureBasedAlgorithm *algorithm = mSource->mAlgorithm.get();
+  mInputIterator = algorithm->mSource->getFeatures( algorithm->request(), algorithm->sourceFlags() );
+}
+
+QgsProcessingFeatureStreamIterator::~QgsProcessingFeatureStreamIterator()
+{
+  close();
+}
+
+bool QgsProcessingFeatureStreamIterator::rewind()
+{
+  if ( mClosed )
+    return false;
+
+  mPending.clear();
+  mPendingIndex = 0;
+  mNextId = 1;
+  return mInputIterator.rewind();
+}
+
+bool QgsProcessingFeatureStreamIterator::close()
+{
+  mClosed = true;
+  mPending.clear();
+  mInputIterator.close();
+  return true;
+}
+
+bool QgsProcessingFeatureStreamIterator::fetchFeature( QgsFeature &f )
+{
+  f.setValid( false );
+
+  while ( !mClosed )
+  {
+    if ( mPendingIndex >= mPending.size() )
+    {
+      QgsFeature input;
+      if ( !mInputIterator.nextFeature( input ) )
+        break;
+
+      mSource->mContext->expressionContext().setFeature( input );
+      mPending = mSource->mAlgorithm->processFeature( input, *mSource->mContext, mSource->mFeedback );
+      mPendingIndex = 0;
+      continue;
+    }
+
+    f = mPending.at( mPendingIndex++ );
+    f.setId( mNextId++ );
+    f.setFields( mSource->mFields, false );
+
+    if ( !mFilterRect.isNull() && ( !f.hasGeometry() || !f.geometry().intersects( mFilterRect ) ) )
+      continue;
+    if ( mRequest.filterType() == QgsFeatureRequest::FilterFid && f.id() != mRequest.filterFid() )
+      continue;
+    if ( mRequest.filterType() == QgsFeatureRequest::FilterFids && !mRequest.filterFids().contains( f.id() ) )
+      continue;
+    if ( mRequest.filterType() == QgsFeatureRequest::FilterExpression )
+    {
+      mRequest.expressionContext()->setFeature( f );
+      if ( !mRequest.filterExpression()->evaluate( mRequest.expressionContext() ).toBool() )
+        continue;
+    }
+    if ( !checkGeometryValidity( f ) )
+      continue;
+
+    geometryToDestinationCrs( f, mTransform );
+    f.setValid( true );
+    return true;
+  }
+
+  close();
+  return false;
+}
+
+bool QgsProcessingFeatureStreamIterator::checkGeometryValidity( const QgsFeature &feature )
+{
+  if ( !feature.hasGeometry() )
+    return true;
+
+  switch ( mRequest.invalidGeometryCheck() )
+  {
+    case QgsFeatureRequest::GeometryNoCheck:
+      return true;
+
+    case QgsFeatureRequest::GeometrySkipInvalid:
+    case QgsFeatureRequest::GeometryAbortOnInvalid:
+      if ( !feature.geometry().isGeosValid() )
+      {
+        QgsMessageLog::logMessage( QObject::tr( "Geometry error: One or more input features have invalid geometry." ), QString(), Qgis::Critical );
+        if ( mRequest.invalidGeometryCheck() == QgsFeatureRequest::GeometryAbortOnInvalid )
+          close();
+        if ( mRequest.invalidGeometryCallback() )
+        {
+          mRequest.invalidGeometryCallback()( feature );
+        }
+        return false;
+      }
+      break;
+  }
+
+  return true;
+}
+
+///@endcond
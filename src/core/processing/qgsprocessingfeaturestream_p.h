@@ -0,0 +1,135 @@
+/***************************************************************************
+                         qgsprocessingfeaturestream_p.h
+                         ------------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGFEATURESTREAM_PRIVATE_H
+#define QGSPROCESSINGFEATURESTREAM_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsfeaturesource.h"
+#include "qgsfeatureiterator.h"
+#include "qgscoordinatetransform.h"
+#include "qgsfields.h"
+
+#include <memory>
+
+class QgsProcessingContext;
+class QgsProcessingFeedback;
+class QgsProcessingFeatureBasedAlgorithm;
+
+/**
+ * \ingroup core
+ * Feature source which streams the output of a feature based algorithm, by passing the
+ * features of the algorithm's input through its processFeature() method while they are
+ * iterated. This is used by models to chain feature based child algorithms without
+ * materializing the intermediate layers.
+ */
+class CORE_EXPORT QgsProcessingFeatureStreamSource : public QgsFeatureSource
+{
+  public:
+
+    /**
+     * Constructor for QgsProcessingFeatureStreamSource. Ownership of \a algorithm, which must
+     * already be prepared with \a parameters, is transferred to the source.
+     *
+     * The algorithm's input is read from the INPUT parameter using \a context, unless an
+     * input stream has been set for the algorithm. Features are processed using a copy of
+     * the thread safe settings of \a context, and messages are pushed to \a feedback.
+     *
+     * \throws QgsProcessingException if the algorithm's input cannot be loaded
+     */
+    QgsProcessingFeatureStreamSource( QgsProcessingFeatureBasedAlgorithm *algorithm, const QVariantMap &parameters,
+                                      QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    ~QgsProcessingFeatureStreamSource() override;
+
+    QgsFeatureIterator getFeatures( const QgsFeatureRequest &request = QgsFeatureRequest() ) const override;
+    QString sourceName() const override;
+    QgsCoordinateReferenceSystem sourceCrs() const override;
+    QgsFields fields() const override;
+    QgsWkbTypes::Type wkbType() const override;
+    long featureCount() const override;
+
+  private:
+
+    std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > mAlgorithm;
+    std::unique_ptr< QgsProcessingContext > mContext;
+    QgsProcessingFeedback *mFeedback = nullptr;
+
+    QgsFields mFields;
+    QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    QgsCoordinateReferenceSystem mCrs;
+
+    friend class QgsProcessingFeatureStreamIterator;
+};
+
+/**
+ * \ingroup core
+ * Feature iterator for QgsProcessingFeatureStreamSource.
+ *
+ * Features are assigned consecutive ids starting at 1, like when they are written
+ * to a temporary layer. Filters of the request are applied to the processed features.
+ */
+class CORE_EXPORT QgsProcessingFeatureStreamIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    QgsProcessingFeatureStreamIterator( const QgsProcessingFeatureStreamSource *source, const QgsFeatureRequest &request );
+    ~QgsProcessingFeatureStreamIterator() override;
+
+    bool rewind() override;
+    bool close() override;
+
+  protected:
+
+    bool fetchFeature( QgsFeature &f ) override;
+
+    // fid and expression filters are applied by fetchFeature(), once features have their stream ids
+    bool nextFeatureFilterExpression( QgsFeature &f ) override { return fetchFeature( f ); }
+    bool nextFeatureFilterFids( QgsFeature &f ) override { return fetchFeature( f ); }
+
+  private:
+
+    //! Applies the invalid geometry check of the request, returns false if the feature must be skipped
+    bool checkGeometryValidity( const QgsFeature &feature );
+
+    const QgsProcessingFeatureStreamSource *mSource = nullptr;
+    QgsFeatureIterator mInputIterator;
+
+    //! Features returned by processFeature() for the last input feature
+    QgsFeatureList mPending;
+    int mPendingIndex = 0;
+
+    QgsFeatureId mNextId = 1;
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mFilterRect;
+};
+
+/// @endcond
+
+#endif // QGSPROCESSINGFEATURESTREAM_PRIVATE_H
@@ -618,6 +618,10 @@ void QgsCoordinateTransform::transformCoords( int numPoints, double *x, double *
     QgsDebugMsgLevel( "No QgsCoordinateTransformContext context set for transform", 4 );
 #endif
 
+  // common CRS pairs have closed-form implementations which are much faster than PROJ
+  if ( d->mKernel.isValid() && d->mKernel.transform( numPoints, x, y, direction == ReverseTransform ) )
+    return;
+
   // use proj4 to do the transform
 
   // if the source/destination projection is lat/long, convert the points to radians
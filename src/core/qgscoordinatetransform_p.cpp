@@ -209,6 +209,11 @@ bool QgsCoordinateTransformPrivate::initialize()
     mShortCircuit = false;
     QgsDebugMsgLevel( "Source/Dest CRS not equal, shortcircuit is not set.", 3 );
   }
+
+  // closed-form kernels know nothing about datum transformations
+  mKernel = mIsValid && !mShortCircuit && useDefaultDatumTransform
+            ? QgsCoordinateTransformKernel::create( mSourceCRS, mDestCRS ) : QgsCoordinateTransformKernel();
+
   return mIsValid;
 }
 
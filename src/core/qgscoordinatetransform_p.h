@@ -38,6 +38,7 @@
 #endif
 
 #include "qgscoordinatereferencesystem.h"
+#include "qgscoordinatetransformkernel_p.h"
 #include "qgscoordinatetransformcontext.h"
 
 typedef void *projPJ;
@@ -115,6 +116,12 @@ class QgsCoordinateTransformPrivate : public QSharedData
     int mSourceDatumTransform = -1;
     int mDestinationDatumTransform = -1;
 
+    /**
+     * Closed-form implementation of the transform, used instead of PROJ
+     * whenever it is valid for the points to transform.
+     */
+    QgsCoordinateTransformKernel mKernel;
+
     /**
      * Thread local proj context storage. A new proj context will be created
      * for every thread.
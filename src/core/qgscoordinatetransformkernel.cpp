@@ -0,0 +1,324 @@
+/***************************************************************************
+               qgscoordinatetransformkernel.cpp
+               --------------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgscoordinatetransformkernel_p.h"
+#include "qgscoordinatereferencesystem.h"
+
+#include <cmath>
+#include <algorithm>
+
+///@cond PRIVATE
+
+// same values as the PROJ macros, so that results match the PROJ code path
+static const double KERNEL_DEG_TO_RAD = .017453292519943296;
+static const double KERNEL_RAD_TO_DEG = 57.295779513082321;
+
+// WGS 84 ellipsoid
+static const double WGS84_A = 6378137.0;
+static const double WGS84_F = 1.0 / 298.257223563;
+
+// UTM parameters
+static const double UTM_SCALE_FACTOR = 0.9996;
+static const double UTM_FALSE_EASTING = 500000.0;
+
+// Domain of the UTM kernel: half a degree of overlap around the 6 degrees wide zones,
+// and the latitude range over which UTM is defined
+static const double UTM_MAX_LONGITUDE_OFFSET = 3.5;
+static const double UTM_MAX_EASTING_OFFSET = 400000.0;
+static const double UTM_MAX_LATITUDE = 84.0;
+static const double UTM_MAX_NORTHING = 9400000.0;
+
+/**
+ * Coefficients of the Krüger series for the transverse Mercator projection of
+ * the WGS 84 ellipsoid, to 6th order in the third flattening (see C.F.F. Karney,
+ * Transverse Mercator with an accuracy of a few nanometers, J. Geodesy 85, 2011).
+ */
+struct TransverseMercatorSeries
+{
+  TransverseMercatorSeries()
+  {
+    const double n = WGS84_F / ( 2.0 - WGS84_F );
+    const double n2 = n * n;
+    const double n3 = n2 * n;
+    const double n4 = n3 * n;
+    const double n5 = n4 * n;
+    const double n6 = n5 * n;
+
+    e = std::sqrt( WGS84_F * ( 2.0 - WGS84_F ) );
+    e2m = 1.0 - e * e;
+    scaledRectifyingRadius = UTM_SCALE_FACTOR * WGS84_A / ( 1.0 + n ) * ( 1.0 + n2 / 4.0 + n4 / 64.0 + n6 / 256.0 );
+
+    alpha[0] = n / 2.0 - 2.0 / 3.0 * n2 + 5.0 / 16.0 * n3 + 41.0 / 180.0 * n4 - 127.0 / 288.0 * n5 + 7891.0 / 37800.0 * n6;
+    alpha[1] = 13.0 / 48.0 * n2 - 3.0 / 5.0 * n3 + 557.0 / 1440.0 * n4 + 281.0 / 630.0 * n5 - 1983433.0 / 1935360.0 * n6;
+    alpha[2] = 61.0 / 240.0 * n3 - 103.0 / 140.0 * n4 + 15061.0 / 26880.0 * n5 + 167603.0 / 181440.0 * n6;
+    alpha[3] = 49561.0 / 161280.0 * n4 - 179.0 / 168.0 * n5 + 6601661.0 / 7257600.0 * n6;
+    alpha[4] = 34729.0 / 80640.0 * n5 - 3418889.0 / 1995840.0 * n6;
+    alpha[5] = 212378941.0 / 319334400.0 * n6;
+
+    beta[0] = n / 2.0 - 2.0 / 3.0 * n2 + 37.0 / 96.0 * n3 - 1.0 / 360.0 * n4 - 81.0 / 512.0 * n5 + 96199.0 / 604800.0 * n6;
+    beta[1] = 1.0 / 48.0 * n2 + 1.0 / 15.0 * n3 - 437.0 / 1440.0 * n4 + 46.0 / 105.0 * n5 - 1118711.0 / 3870720.0 * n6;
+    beta[2] = 17.0 / 480.0 * n3 - 37.0 / 840.0 * n4 - 209.0 / 4480.0 * n5 + 5569.0 / 90720.0 * n6;
+    beta[3] = 4397.0 / 161280.0 * n4 - 11.0 / 504.0 * n5 - 830251.0 / 7257600.0 * n6;
+    beta[4] = 4583.0 / 161280.0 * n5 - 108847.0 / 3991680.0 * n6;
+    beta[5] = 20648693.0 / 638668800.0 * n6;
+  }
+
+  //! Converts the tangent of the geodetic latitude to the tangent of the conformal latitude
+  double conformalTangent( double tau ) const
+  {
+    const double tau1 = std::hypot( 1.0, tau );
+    const double sig = std::sinh( e * std::atanh( e * tau / tau1 ) );
+    return std::hypot( 1.0, sig ) * tau - sig * tau1;
+  }
+
+  //! Converts the tangent of the conformal latitude back to the tangent of the geodetic latitude
+  double geodeticTangent( double taup ) const
+  {
+    double tau = taup / e2m;
+    for ( int i = 0; i < 5; ++i )
+    {
+      const double taupa = conformalTangent( tau );
+      const double dtau = ( taup - taupa ) * ( 1.0 + e2m * tau * tau ) /
+                          ( e2m * std::hypot( 1.0, tau ) * std::hypot( 1.0, taupa ) );
+      tau += dtau;
+      if ( std::fabs( dtau ) < 1e-14 * std::max( 1.0, std::fabs( tau ) ) )
+        break;
+    }
+    return tau;
+  }
+
+  double e;
+  double e2m;
+  double scaledRectifyingRadius;
+  double alpha[6];
+  double beta[6];
+};
+
+static const TransverseMercatorSeries &transverseMercatorSeries()
+{
+  static const TransverseMercatorSeries sSeries;
+  return sSeries;
+}
+
+//! Returns the UTM zone of a WGS 84 / UTM auth id (1 to 60), or 0 if \a authid is not such a CRS
+static int utmZone( const QString &authid, bool &south )
+{
+  if ( !authid.startsWith( QLatin1String( "EPSG:32" ) ) || authid.length() != 10 )
+    return 0;
+
+  bool ok = false;
+  const int code = authid.midRef( 5 ).toInt( &ok );
+  if ( !ok )
+    return 0;
+
+  if ( code >= 32601 && code <= 32660 )
+  {
+    south = false;
+    return code - 32600;
+  }
+  else if ( code >= 32701 && code <= 32760 )
+  {
+    south = true;
+    return code - 32700;
+  }
+  return 0;
+}
+
+QgsCoordinateTransformKernel QgsCoordinateTransformKernel::create( const QgsCoordinateReferenceSystem &source, const QgsCoordinateReferenceSystem &destination )
+{
+  QgsCoordinateTransformKernel kernel;
+
+  const QString sourceAuthId = source.authid();
+  const QString destAuthId = destination.authid();
+  const QString geographicAuthId = QStringLiteral( "EPSG:4326" );
+
+  QString projectedAuthId;
+  if ( sourceAuthId == geographicAuthId )
+  {
+    projectedAuthId = destAuthId;
+  }
+  else if ( destAuthId == geographicAuthId )
+  {
+    projectedAuthId = sourceAuthId;
+    kernel.mInverted = true;
+  }
+  else
+  {
+    return QgsCoordinateTransformKernel();
+  }
+
+  bool south = false;
+  if ( projectedAuthId == QLatin1String( "EPSG:3857" ) )
+  {
+    kernel.mType = WebMercator;
+  }
+  else if ( int zone = utmZone( projectedAuthId, south ) )
+  {
+    kernel.mType = TransverseMercator;
+    kernel.mCentralMeridian = -183.0 + 6.0 * zone;
+    kernel.mFalseNorthing = south ? 10000000.0 : 0.0;
+  }
+  else
+  {
+    return QgsCoordinateTransformKernel();
+  }
+
+  return kernel;
+}
+
+bool QgsCoordinateTransformKernel::transform( int numPoints, double *x, double *y, bool reverse ) const
+{
+  if ( mType == NoKernel )
+    return false;
+
+  if ( reverse != mInverted )
+    return unproject( numPoints, x, y );
+  else
+    return project( numPoints, x, y );
+}
+
+bool QgsCoordinateTransformKernel::project( int numPoints, double *x, double *y ) const
+{
+  switch ( mType )
+  {
+    case WebMercator:
+    {
+      // PROJ wraps longitudes outside [-180, 180] and fails at the poles
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        if ( !( std::fabs( x[i] ) <= 180.0 ) || !( std::fabs( y[i] ) < 90.0 ) )
+          return false;
+      }
+
+      const double fortPi = M_PI / 4.0;
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        x[i] = WGS84_A * ( x[i] * KERNEL_DEG_TO_RAD );
+        y[i] = WGS84_A * std::log( std::tan( fortPi + .5 * ( y[i] * KERNEL_DEG_TO_RAD ) ) );
+      }
+      return true;
+    }
+
+    case TransverseMercator:
+      return projectTransverseMercator( numPoints, x, y );
+
+    case NoKernel:
+      break;
+  }
+  return false;
+}
+
+bool QgsCoordinateTransformKernel::unproject( int numPoints, double *x, double *y ) const
+{
+  switch ( mType )
+  {
+    case WebMercator:
+    {
+      const double maxX = WGS84_A * M_PI;
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        if ( !( std::fabs( x[i] ) <= maxX ) || !std::isfinite( y[i] ) )
+          return false;
+      }
+
+      const double ra = 1.0 / WGS84_A;
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        x[i] = ( x[i] * ra ) * KERNEL_RAD_TO_DEG;
+        y[i] = ( M_PI_2 - 2. * std::atan( std::exp( -y[i] * ra ) ) ) * KERNEL_RAD_TO_DEG;
+      }
+      return true;
+    }
+
+    case TransverseMercator:
+      return unprojectTransverseMercator( numPoints, x, y );
+
+    case NoKernel:
+      break;
+  }
+  return false;
+}
+
+bool QgsCoordinateTransformKernel::projectTransverseMercator( int numPoints, double *x, double *y ) const
+{
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    if ( !( std::fabs( x[i] - mCentralMeridian ) <= UTM_MAX_LONGITUDE_OFFSET ) || !( std::fabs( y[i] ) <= UTM_MAX_LATITUDE ) )
+      return false;
+  }
+
+  const TransverseMercatorSeries &series = transverseMercatorSeries();
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    const double lambda = ( x[i] - mCentralMeridian ) * KERNEL_DEG_TO_RAD;
+    const double phi = y[i] * KERNEL_DEG_TO_RAD;
+
+    const double taup = series.conformalTangent( std::tan( phi ) );
+    const double cosLambda = std::cos( lambda );
+    const double xip = std::atan2( taup, cosLambda );
+    const double etap = std::asinh( std::sin( lambda ) / std::hypot( taup, cosLambda ) );
+
+    double xi = xip;
+    double eta = etap;
+    for ( int j = 0; j < 6; ++j )
+    {
+      const double k = 2.0 * ( j + 1 );
+      xi += series.alpha[j] * std::sin( k * xip ) * std::cosh( k * etap );
+      eta += series.alpha[j] * std::cos( k * xip ) * std::sinh( k * etap );
+    }
+
+    x[i] = UTM_FALSE_EASTING + series.scaledRectifyingRadius * eta;
+    y[i] = mFalseNorthing + series.scaledRectifyingRadius * xi;
+  }
+  return true;
+}
+
+bool QgsCoordinateTransformKernel::unprojectTransverseMercator( int numPoints, double *x, double *y ) const
+{
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    if ( !( std::fabs( x[i] - UTM_FALSE_EASTING ) <= UTM_MAX_EASTING_OFFSET ) || !( std::fabs( y[i] - mFalseNorthing ) <= UTM_MAX_NORTHING ) )
+      return false;
+  }
+
+  const TransverseMercatorSeries &series = transverseMercatorSeries();
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    const double xi = ( y[i] - mFalseNorthing ) / series.scaledRectifyingRadius;
+    const double eta = ( x[i] - UTM_FALSE_EASTING ) / series.scaledRectifyingRadius;
+
+    double xip = xi;
+    double etap = eta;
+    for ( int j = 0; j < 6; ++j )
+    {
+      const double k = 2.0 * ( j + 1 );
+      xip -= series.beta[j] * std::sin( k * xi ) * std::cosh( k * eta );
+      etap -= series.beta[j] * std::cos( k * xi ) * std::sinh( k * eta );
+    }
+
+    const double sinhEtap = std::sinh( etap );
+    const double cosXip = std::cos( xip );
+    const double taup = std::sin( xip ) / std::hypot( sinhEtap, cosXip );
+    const double lambda = std::atan2( sinhEtap, cosXip );
+    const double phi = std::atan( series.geodeticTangent( taup ) );
+
+    x[i] = mCentralMeridian + lambda * KERNEL_RAD_TO_DEG;
+    y[i] = phi * KERNEL_RAD_TO_DEG;
+  }
+  return true;
+}
+
+///@endcond
@@ -0,0 +1,107 @@
+/***************************************************************************
+               qgscoordinatetransformkernel_p.h
+               --------------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSCOORDINATETRANSFORMKERNEL_PRIVATE_H
+#define QGSCOORDINATETRANSFORMKERNEL_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+class QgsCoordinateReferenceSystem;
+
+/**
+ * \ingroup core
+ * Closed-form implementation of a transformation between a pair of very common
+ * coordinate reference systems, used by QgsCoordinateTransform instead of PROJ.
+ *
+ * Kernels exist for WGS 84 geographic coordinates (EPSG:4326) to and from
+ * Web Mercator (EPSG:3857) and WGS 84 / UTM zones (EPSG:326xx and EPSG:327xx).
+ * They only apply when no datum transformation is involved, and work on whole
+ * arrays of coordinates with tight loops.
+ *
+ * Each kernel has a validity domain. If any point of a batch falls outside of it
+ * (e.g. longitudes which PROJ would wrap, or points far away from a UTM zone), the
+ * batch is left untouched and must be transformed by PROJ, so that results and
+ * error reporting stay identical to the generic code path.
+ */
+class QgsCoordinateTransformKernel
+{
+  public:
+
+    //! Available kernels
+    enum Type
+    {
+      NoKernel, //!< No closed-form kernel applies, PROJ must be used
+      WebMercator, //!< EPSG:4326 to EPSG:3857
+      TransverseMercator, //!< EPSG:4326 to a WGS 84 / UTM zone
+    };
+
+    QgsCoordinateTransformKernel() = default;
+
+    /**
+     * Returns the kernel transforming from \a source to \a destination, or an
+     * invalid kernel if this pair of CRS has no closed-form implementation.
+     * New kernels are registered here.
+     */
+    static QgsCoordinateTransformKernel create( const QgsCoordinateReferenceSystem &source, const QgsCoordinateReferenceSystem &destination );
+
+    //! Returns true if the kernel can be used
+    bool isValid() const { return mType != NoKernel; }
+
+    //! Returns the kernel type
+    Type type() const { return mType; }
+
+    /**
+     * Transforms \a numPoints coordinates in place. Geographic coordinates are
+     * expressed in degrees. If \a reverse is true, coordinates are transformed
+     * from the destination to the source CRS.
+     * Returns false if any point is outside the domain of the kernel, in
+     * which case the coordinates are not modified.
+     */
+    bool transform( int numPoints, double *x, double *y, bool reverse ) const;
+
+  private:
+
+    bool project( int numPoints, double *x, double *y ) const;
+    bool unproject( int numPoints, double *x, double *y ) const;
+
+    bool projectTransverseMercator( int numPoints, double *x, double *y ) const;
+    bool unprojectTransverseMercator( int numPoints, double *x, double *y ) const;
+
+    Type mType = NoKernel;
+
+    //! True if the geographic CRS is the destination of the transform
+    bool mInverted = false;
+
+    //! Central meridian of the UTM zone, in degrees
+    double mCentralMeridian = 0.0;
+
+    //! False northing of the UTM zone
+    double mFalseNorthing = 0.0;
+};
+
+/// @endcond
+
+#endif // QGSCOORDINATETRANSFORMKERNEL_PRIVATE_H
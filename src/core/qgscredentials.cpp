@@ -38,6 +38,11 @@ QgsCredentials *QgsCredentials::instance()
   return new QgsCredentialsNone();
 }
 
+bool QgsCredentials::hasInstance()
+{
+  return sInstance != nullptr;
+}
+
 bool QgsCredentials::get( const QString &realm, QString &username, QString &password, const QString &message )
 {
   if ( mCredentialCache.contains( realm ) )
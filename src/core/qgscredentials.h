@@ -55,6 +55,14 @@ class CORE_EXPORT QgsCredentials
     //! retrieves instance
     static QgsCredentials *instance();
 
+    /**
+     * Returns true if an instance was registered to request credentials, e.g. the credentials
+     * dialog of the QGIS application. Without one, requests for credentials fail without
+     * any user interaction.
+     * \since QGIS 3.4
+     */
+    static bool hasInstance();
+
     /**
      * Lock the instance against access from multiple threads. This does not really lock access to get/put methds,
      * it will just prevent other threads to lock the instance and continue the execution. When the class is used
@@ -923,7 +923,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( parseMode == LowerCorner && isGMLNS && LOCALNAME_EQUALS( "lowerCorner" ) )
   {
-    QList<QgsPointXY> points;
+    QVector<QgsPointXY> points;
     pointsFromPosListString( points, mStringCash, 2 );
     if ( points.size() == 1 )
     {
@@ -934,7 +934,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( parseMode == UpperCorner && isGMLNS && LOCALNAME_EQUALS( "upperCorner" ) )
   {
-    QList<QgsPointXY> points;
+    QVector<QgsPointXY> points;
     pointsFromPosListString( points, mStringCash, 2 );
     if ( points.size() == 1 )
     {
@@ -979,7 +979,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( isGMLNS && LOCALNAME_EQUALS( "Point" ) )
   {
-    QList<QgsPointXY> pointList;
+    QVector<QgsPointXY> pointList;
     if ( pointsFromString( pointList, mStringCash ) != 0 )
     {
       //error
@@ -1023,7 +1023,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   {
     //add WKB point to the feature
 
-    QList<QgsPointXY> pointList;
+    QVector<QgsPointXY> pointList;
     if ( pointsFromString( pointList, mStringCash ) != 0 )
     {
       //error
@@ -1061,7 +1061,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   else if ( ( parseMode == Geometry || parseMode == MultiPolygon ) &&
             isGMLNS && LOCALNAME_EQUALS( "LinearRing" ) )
   {
-    QList<QgsPointXY> pointList;
+    QVector<QgsPointXY> pointList;
     if ( pointsFromString( pointList, mStringCash ) != 0 )
     {
       //error
@@ -1259,7 +1259,7 @@ QString QgsGmlStreamingParser::readAttribute( const QString &attributeName, cons
 
 bool QgsGmlStreamingParser::createBBoxFromCoordinateString( QgsRectangle &r, const QString &coordString ) const
 {
-  QList<QgsPointXY> points;
+  QVector<QgsPointXY> points;
   if ( pointsFromCoordinateString( points, coordString ) != 0 )
   {
     return false;
@@ -1275,29 +1275,122 @@ bool QgsGmlStreamingParser::createBBoxFromCoordinateString( QgsRectangle &r, con
   return true;
 }
 
-int QgsGmlStreamingParser::pointsFromCoordinateString( QList<QgsPointXY> &points, const QString &coordString ) const
+//! Powers of ten that are exactly representable as a double
+static const double POWERS_OF_TEN[] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Converts the [begin, end) range of characters to a double, always using
+ * the C locale. Numbers whose mantissa and exponent fit the exactly
+ * representable range are converted without any allocation, others fall
+ * back to QString::toDouble() so that the result is always correctly rounded.
+ */
+static bool parseCoordinate( const QChar *begin, const QChar *end, double &value )
+{
+  const QChar *ptr = begin;
+  bool negative = false;
+  if ( ptr != end && ( *ptr == '-' || *ptr == '+' ) )
+  {
+    negative = *ptr == '-';
+    ++ptr;
+  }
+
+  quint64 mantissa = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  bool exact = true;
+  while ( ptr != end && ptr->unicode() >= '0' && ptr->unicode() <= '9' )
+  {
+    hasDigits = true;
+    if ( mantissa < ( Q_UINT64_C( 1 ) << 53 ) / 10 )
+      mantissa = mantissa * 10 + ( ptr->unicode() - '0' );
+    else
+      exact = false;
+    ++ptr;
+  }
+  if ( ptr != end && *ptr == '.' )
+  {
+    ++ptr;
+    while ( ptr != end && ptr->unicode() >= '0' && ptr->unicode() <= '9' )
+    {
+      hasDigits = true;
+      if ( mantissa < ( Q_UINT64_C( 1 ) << 53 ) / 10 )
+      {
+        mantissa = mantissa * 10 + ( ptr->unicode() - '0' );
+        --exponent;
+      }
+      else if ( ptr->unicode() != '0' )
+      {
+        exact = false;
+      }
+      ++ptr;
+    }
+  }
+  if ( hasDigits && ptr != end && ( *ptr == 'e' || *ptr == 'E' ) )
+  {
+    ++ptr;
+    bool negativeExponent = false;
+    if ( ptr != end && ( *ptr == '-' || *ptr == '+' ) )
+    {
+      negativeExponent = *ptr == '-';
+      ++ptr;
+    }
+    if ( ptr == end )
+      hasDigits = false;
+    int explicitExponent = 0;
+    while ( ptr != end && ptr->unicode() >= '0' && ptr->unicode() <= '9' )
+    {
+      if ( explicitExponent < 10000 )
+        explicitExponent = explicitExponent * 10 + ( ptr->unicode() - '0' );
+      ++ptr;
+    }
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+
+  if ( hasDigits && exact && ptr == end && exponent >= -22 && exponent <= 22 )
+  {
+    value = static_cast< double >( mantissa );
+    value = exponent < 0 ? value / POWERS_OF_TEN[-exponent] : value * POWERS_OF_TEN[exponent];
+    if ( negative )
+      value = -value;
+    return true;
+  }
+
+  // uncommon syntax (nan, inf, ...) or too many significant digits
+  bool ok = false;
+  value = QString::fromRawData( begin, static_cast< int >( end - begin ) ).toDouble( &ok );
+  return ok;
+}
+
+static inline bool isCoordinateWhitespace( QChar c )
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+int QgsGmlStreamingParser::pointsFromCoordinateString( QVector<QgsPointXY> &points, const QString &coordString ) const
 {
   //tuples are separated by space, x/y by ','
-  QStringList tuples = coordString.split( mTupleSeparator, QString::SkipEmptyParts );
-  QStringList tuples_coordinates;
+  const QVector<QStringRef> tuples = coordString.splitRef( mTupleSeparator, QString::SkipEmptyParts );
+  points.reserve( points.size() + tuples.size() );
   double x, y;
-  bool conversionSuccess;
 
-  QStringList::const_iterator tupleIterator;
-  for ( tupleIterator = tuples.constBegin(); tupleIterator != tuples.constEnd(); ++tupleIterator )
+  for ( const QStringRef &tuple : tuples )
   {
-    tuples_coordinates = tupleIterator->split( mCoordinateSeparator, QString::SkipEmptyParts );
-    if ( tuples_coordinates.size() < 2 )
+    const QVector<QStringRef> tupleCoordinates = tuple.split( mCoordinateSeparator, QString::SkipEmptyParts );
+    if ( tupleCoordinates.size() < 2 )
     {
       continue;
     }
-    x = tuples_coordinates.at( 0 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    const QStringRef &xString = tupleCoordinates.at( 0 );
+    if ( !parseCoordinate( xString.unicode(), xString.unicode() + xString.size(), x ) )
     {
       continue;
     }
-    y = tuples_coordinates.at( 1 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    const QStringRef &yString = tupleCoordinates.at( 1 );
+    if ( !parseCoordinate( yString.unicode(), yString.unicode() + yString.size(), y ) )
     {
       continue;
     }
@@ -1306,36 +1399,53 @@ int QgsGmlStreamingParser::pointsFromCoordinateString( QList<QgsPointXY> &points
   return 0;
 }
 
-int QgsGmlStreamingParser::pointsFromPosListString( QList<QgsPointXY> &points, const QString &coordString, int dimension ) const
+int QgsGmlStreamingParser::pointsFromPosListString( QVector<QgsPointXY> &points, const QString &coordString, int dimension ) const
 {
-  // coordinates separated by spaces
-  QStringList coordinates = coordString.split( ' ', QString::SkipEmptyParts );
+  // coordinates separated by whitespace, scanned in place to avoid
+  // building a temporary string list for large posList elements
+  const QChar *ptr = coordString.constData();
+  const QChar *const end = ptr + coordString.size();
+
+  int coordinateIndex = 0;
+  bool pointValid = true;
+  double x = 0;
+  double y = 0;
+  while ( true )
+  {
+    while ( ptr != end && isCoordinateWhitespace( *ptr ) )
+      ++ptr;
+    if ( ptr == end )
+      break;
 
-  if ( coordinates.size() % dimension != 0 )
-  {
-    QgsDebugMsg( "Wrong number of coordinates" );
-  }
+    const QChar *tokenStart = ptr;
+    while ( ptr != end && !isCoordinateWhitespace( *ptr ) )
+      ++ptr;
 
-  int ncoor = coordinates.size() / dimension;
-  for ( int i = 0; i < ncoor; i++ )
-  {
-    bool conversionSuccess;
-    double x = coordinates.value( i * dimension ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    if ( coordinateIndex == 0 )
     {
-      continue;
+      pointValid = parseCoordinate( tokenStart, ptr, x );
     }
-    double y = coordinates.value( i * dimension + 1 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    else if ( coordinateIndex == 1 && pointValid )
     {
-      continue;
+      pointValid = parseCoordinate( tokenStart, ptr, y );
     }
-    points.append( ( mInvertAxisOrientation ) ? QgsPointXY( y, x ) : QgsPointXY( x, y ) );
+
+    if ( ++coordinateIndex == dimension )
+    {
+      if ( pointValid )
+        points.append( ( mInvertAxisOrientation ) ? QgsPointXY( y, x ) : QgsPointXY( x, y ) );
+      coordinateIndex = 0;
+    }
+  }
+
+  if ( coordinateIndex != 0 )
+  {
+    QgsDebugMsg( "Wrong number of coordinates" );
   }
   return 0;
 }
 
-int QgsGmlStreamingParser::pointsFromString( QList<QgsPointXY> &points, const QString &coordString ) const
+int QgsGmlStreamingParser::pointsFromString( QVector<QgsPointXY> &points, const QString &coordString ) const
 {
   if ( mCoorMode == QgsGmlStreamingParser::Coordinate )
   {
@@ -1359,7 +1469,7 @@ int QgsGmlStreamingParser::getPointWKB( QgsWkbPtr &wkbPtr, const QgsPointXY &poi
   return 0;
 }
 
-int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &lineCoordinates ) const
+int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const QVector<QgsPointXY> &lineCoordinates ) const
 {
   int wkbSize = 1 + 2 * sizeof( int ) + lineCoordinates.size() * 2 * sizeof( double );
   wkbPtr = QgsWkbPtr( new unsigned char[wkbSize], wkbSize );
@@ -1368,7 +1478,7 @@ int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY
 
   fillPtr << mEndian << QgsWkbTypes::LineString << lineCoordinates.size();
 
-  QList<QgsPointXY>::const_iterator iter;
+  QVector<QgsPointXY>::const_iterator iter;
   for ( iter = lineCoordinates.constBegin(); iter != lineCoordinates.constEnd(); ++iter )
   {
     fillPtr << iter->x() << iter->y();
@@ -1377,7 +1487,7 @@ int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY
   return 0;
 }
 
-int QgsGmlStreamingParser::getRingWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &ringCoordinates ) const
+int QgsGmlStreamingParser::getRingWKB( QgsWkbPtr &wkbPtr, const QVector<QgsPointXY> &ringCoordinates ) const
 {
   int wkbSize = sizeof( int ) + ringCoordinates.size() * 2 * sizeof( double );
   wkbPtr = QgsWkbPtr( new unsigned char[wkbSize], wkbSize );
@@ -1386,7 +1496,7 @@ int QgsGmlStreamingParser::getRingWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY
 
   fillPtr << ringCoordinates.size();
 
-  QList<QgsPointXY>::const_iterator iter;
+  QVector<QgsPointXY>::const_iterator iter;
   for ( iter = ringCoordinates.constBegin(); iter != ringCoordinates.constEnd(); ++iter )
   {
     fillPtr << iter->x() << iter->y();
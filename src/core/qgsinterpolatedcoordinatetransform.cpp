@@ -0,0 +1,195 @@
+/***************************************************************************
+  qgsinterpolatedcoordinatetransform.cpp
+  --------------------------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsinterpolatedcoordinatetransform.h"
+#include "qgsexception.h"
+#include "qgslogger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//! Grid sizes tried in turn, in cells per side
+static const int MIN_GRID_SIZE = 8;
+static const int MAX_GRID_SIZE = 64;
+
+QgsInterpolatedCoordinateTransform::QgsInterpolatedCoordinateTransform( const QgsCoordinateTransform &transform, const QgsRectangle &sourceExtent, double maxError )
+  : mTransform( transform )
+  , mExtent( sourceExtent )
+  , mMaxError( maxError )
+{
+  if ( !mTransform.isValid() || mTransform.isShortCircuited() || mExtent.isEmpty() || !( mMaxError > 0 ) )
+    return;
+
+  for ( int size = MIN_GRID_SIZE; size <= MAX_GRID_SIZE; size *= 2 )
+  {
+    if ( buildGrid( size ) )
+      break;
+  }
+
+  QgsDebugMsgLevel( QStringLiteral( "Interpolation grid of %1x%1 cells, %2 usable" ).arg( mGridSize ).arg( mValidCellCount ), 3 );
+}
+
+void QgsInterpolatedCoordinateTransform::transformControlPoints( QVector<double> &x, QVector<double> &y ) const
+{
+  const QVector<double> sourceX = x;
+  const QVector<double> sourceY = y;
+  QVector<double> z( x.size(), 0.0 );
+  try
+  {
+    mTransform.transformInPlace( x, y, z );
+    return;
+  }
+  catch ( QgsCsException & )
+  {
+  }
+
+  // some points failed, so retry one by one to find out which
+  x = sourceX;
+  y = sourceY;
+  for ( int i = 0; i < x.size(); ++i )
+  {
+    double pz = 0;
+    try
+    {
+      mTransform.transformInPlace( x[i], y[i], pz );
+    }
+    catch ( QgsCsException & )
+    {
+      x[i] = std::numeric_limits<double>::quiet_NaN();
+      y[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+}
+
+bool QgsInterpolatedCoordinateTransform::buildGrid( int size )
+{
+  mGridSize = size;
+  mCellWidth = mExtent.width() / size;
+  mCellHeight = mExtent.height() / size;
+
+  const int pointsPerRow = size + 1;
+  mControlX.resize( pointsPerRow * pointsPerRow );
+  mControlY.resize( pointsPerRow * pointsPerRow );
+  for ( int row = 0; row < pointsPerRow; ++row )
+  {
+    for ( int col = 0; col < pointsPerRow; ++col )
+    {
+      mControlX[row * pointsPerRow + col] = mExtent.xMinimum() + col * mCellWidth;
+      mControlY[row * pointsPerRow + col] = mExtent.yMinimum() + row * mCellHeight;
+    }
+  }
+  transformControlPoints( mControlX, mControlY );
+
+  // measure the interpolation error at the center of the cells
+  QVector<double> centerX( size * size );
+  QVector<double> centerY( size * size );
+  for ( int row = 0; row < size; ++row )
+  {
+    for ( int col = 0; col < size; ++col )
+    {
+      centerX[row * size + col] = mExtent.xMinimum() + ( col + 0.5 ) * mCellWidth;
+      centerY[row * size + col] = mExtent.yMinimum() + ( row + 0.5 ) * mCellHeight;
+    }
+  }
+  transformControlPoints( centerX, centerY );
+
+  mCellValid.fill( false, size * size );
+  mValidCellCount = 0;
+  for ( int row = 0; row < size; ++row )
+  {
+    for ( int col = 0; col < size; ++col )
+    {
+      const int idx = row * pointsPerRow + col;
+      const double interpolatedX = ( mControlX[idx] + mControlX[idx + 1] + mControlX[idx + pointsPerRow] + mControlX[idx + pointsPerRow + 1] ) / 4.0;
+      const double interpolatedY = ( mControlY[idx] + mControlY[idx + 1] + mControlY[idx + pointsPerRow] + mControlY[idx + pointsPerRow + 1] ) / 4.0;
+      const double error = std::hypot( interpolatedX - centerX[row * size + col], interpolatedY - centerY[row * size + col] );
+      // NaN coordinates make the comparison fail too
+      if ( error <= mMaxError )
+      {
+        mCellValid[row * size + col] = true;
+        ++mValidCellCount;
+      }
+    }
+  }
+
+  return mValidCellCount == size * size;
+}
+
+bool QgsInterpolatedCoordinateTransform::interpolate( double &x, double &y ) const
+{
+  if ( mValidCellCount == 0 )
+    return false;
+
+  const double fx = ( x - mExtent.xMinimum() ) / mCellWidth;
+  const double fy = ( y - mExtent.yMinimum() ) / mCellHeight;
+  if ( !( fx >= 0 && fx <= mGridSize && fy >= 0 && fy <= mGridSize ) )
+    return false;
+
+  const int col = std::min( static_cast< int >( fx ), mGridSize - 1 );
+  const int row = std::min( static_cast< int >( fy ), mGridSize - 1 );
+  if ( !mCellValid.at( row * mGridSize + col ) )
+    return false;
+
+  const double u = fx - col;
+  const double v = fy - row;
+  const int pointsPerRow = mGridSize + 1;
+  const int idx = row * pointsPerRow + col;
+  const double w00 = ( 1 - u ) * ( 1 - v );
+  const double w10 = u * ( 1 - v );
+  const double w01 = ( 1 - u ) * v;
+  const double w11 = u * v;
+  x = w00 * mControlX[idx] + w10 * mControlX[idx + 1] + w01 * mControlX[idx + pointsPerRow] + w11 * mControlX[idx + pointsPerRow + 1];
+  y = w00 * mControlY[idx] + w10 * mControlY[idx + 1] + w01 * mControlY[idx + pointsPerRow] + w11 * mControlY[idx + pointsPerRow + 1];
+  return true;
+}
+
+void QgsInterpolatedCoordinateTransform::transformPolygon( QPolygonF &polygon ) const
+{
+  QVector<int> exactIndices;
+  QPointF *ptr = polygon.data();
+  for ( int i = 0; i < polygon.size(); ++i, ++ptr )
+  {
+    if ( !interpolate( ptr->rx(), ptr->ry() ) )
+      exactIndices << i;
+  }
+
+  if ( exactIndices.isEmpty() )
+    return;
+
+  // fall back to the exact transform for the remaining points, in a single batch
+  QVector<double> x( exactIndices.size() );
+  QVector<double> y( exactIndices.size() );
+  QVector<double> z( exactIndices.size(), 0.0 );
+  for ( int i = 0; i < exactIndices.size(); ++i )
+  {
+    const QPointF &p = polygon.at( exactIndices.at( i ) );
+    x[i] = p.x();
+    y[i] = p.y();
+  }
+  mTransform.transformInPlace( x, y, z );
+  for ( int i = 0; i < exactIndices.size(); ++i )
+  {
+    polygon[ exactIndices.at( i ) ] = QPointF( x.at( i ), y.at( i ) );
+  }
+}
+
+void QgsInterpolatedCoordinateTransform::transformInPlace( double &x, double &y ) const
+{
+  if ( interpolate( x, y ) )
+    return;
+
+  double z = 0;
+  mTransform.transformInPlace( x, y, z );
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+  qgsinterpolatedcoordinatetransform.h
+  ------------------------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSINTERPOLATEDCOORDINATETRANSFORM_H
+#define QGSINTERPOLATEDCOORDINATETRANSFORM_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgscoordinatetransform.h"
+#include "qgsrectangle.h"
+
+#include <QPolygonF>
+#include <QVector>
+
+/**
+ * \ingroup core
+ * Approximates a coordinate transform within a source extent by bilinear interpolation
+ * in a grid of exactly transformed control points, similarly to the Approximate precision
+ * of QgsRasterProjector.
+ *
+ * The grid is refined until the interpolation error measured at the center of every cell
+ * is below a maximum error, up to a maximum grid size. Points in cells which still exceed
+ * the error bound, in cells touching control points which could not be transformed, or
+ * outside of the extent are transformed exactly with the underlying QgsCoordinateTransform.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.4
+ */
+class CORE_EXPORT QgsInterpolatedCoordinateTransform
+{
+  public:
+
+    /**
+     * Constructor for QgsInterpolatedCoordinateTransform, approximating the forward
+     * direction of \a transform for points within \a sourceExtent with an error of at most
+     * \a maxError destination CRS units.
+     */
+    QgsInterpolatedCoordinateTransform( const QgsCoordinateTransform &transform, const QgsRectangle &sourceExtent, double maxError );
+
+    /**
+     * Returns true if at least one cell of the grid can be used for interpolation.
+     */
+    bool isValid() const { return mValidCellCount > 0; }
+
+    /**
+     * Returns the number of cells along each side of the grid.
+     */
+    int gridSize() const { return mGridSize; }
+
+    /**
+     * Transforms a polygon in place from the source to the destination CRS.
+     * \throws QgsCsException if the exact transformation of points which cannot be
+     * interpolated fails
+     */
+    void transformPolygon( QPolygonF &polygon ) const;
+
+    /**
+     * Transforms a point in place from the source to the destination CRS.
+     * \throws QgsCsException if the point cannot be interpolated and its exact transformation fails
+     */
+    void transformInPlace( double &x, double &y ) const;
+
+  private:
+
+    //! Tries to interpolate the point, returns false if the exact transform must be used
+    bool interpolate( double &x, double &y ) const;
+
+    //! Builds a grid with \a size cells per side, returns true if all cells are within the error bound
+    bool buildGrid( int size );
+
+    //! Transforms points exactly, setting those which fail to NaN
+    void transformControlPoints( QVector<double> &x, QVector<double> &y ) const;
+
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mExtent;
+    double mMaxError = 0;
+
+    int mGridSize = 0;
+    double mCellWidth = 0;
+    double mCellHeight = 0;
+
+    //! Destination coordinates of the ( mGridSize + 1 ) * ( mGridSize + 1 ) control points, row by row
+    QVector<double> mControlX;
+    QVector<double> mControlY;
+
+    //! Whether each cell can be used for interpolation, row by row
+    QVector<bool> mCellValid;
+    int mValidCellCount = 0;
+};
+
+#endif // QGSINTERPOLATEDCOORDINATETRANSFORM_H
@@ -24,7 +24,9 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <QThread>
 #include <QUrl>
+#include <QtConcurrentRun>
 
 #include <sqlite3.h>
 
@@ -102,6 +104,7 @@ QgsMapLayer::QgsMapLayer( QgsMapLayer::LayerType type,
 
 QgsMapLayer::~QgsMapLayer()
 {
+  discardPreloadedProvider();
   delete m3DRenderer;
   delete mLegend;
   delete mStyleManager;
@@ -264,6 +267,7 @@ bool QgsMapLayer::readLayerXml( const QDomElement &layerElement,  QgsReadWriteCo
 
   // now let the children grab what they need from the Dom node.
   layerError = !readXml( layerElement, context );
+  discardPreloadedProvider();
 
   // overwrite CRS with what we read from project file before the raster/vector
   // file reading functions changed it. They will if projections is specified in the file.
@@ -393,6 +397,53 @@ bool QgsMapLayer::readLayerXml( const QDomElement &layerElement,  QgsReadWriteCo
 } // bool QgsMapLayer::readLayerXML
 
 
+void QgsMapLayer::preloadProvider( const QString &providerKey, const QString &dataSource, QThreadPool *pool )
+{
+  discardPreloadedProvider();
+
+  mPreloadedProviderKey = providerKey;
+  mPreloadedProviderSource = dataSource;
+
+  // the provider must live in the thread of the layer
+  QThread *thread = this->thread();
+  mPreloadedProvider = QtConcurrent::run( pool, [providerKey, dataSource, thread]() -> QgsDataProvider *
+  {
+    QgsDataProvider *provider = QgsProviderRegistry::instance()->createProvider( providerKey, dataSource, QgsDataProvider::ProviderOptions() );
+    if ( provider )
+      provider->moveToThread( thread );
+    return provider;
+  } );
+}
+
+QgsDataProvider *QgsMapLayer::takePreloadedProvider( const QString &providerKey, const QString &dataSource )
+{
+  if ( mPreloadedProviderKey != providerKey || mPreloadedProviderSource != dataSource )
+  {
+    discardPreloadedProvider();
+    return nullptr;
+  }
+
+  mPreloadedProvider.waitForFinished();
+  QgsDataProvider *provider = mPreloadedProvider.resultCount() > 0 ? mPreloadedProvider.result() : nullptr;
+  mPreloadedProvider = QFuture< QgsDataProvider * >();
+  mPreloadedProviderKey.clear();
+  mPreloadedProviderSource.clear();
+  return provider;
+}
+
+void QgsMapLayer::discardPreloadedProvider()
+{
+  if ( mPreloadedProviderKey.isEmpty() )
+    return;
+
+  mPreloadedProvider.waitForFinished();
+  if ( mPreloadedProvider.resultCount() > 0 )
+    delete mPreloadedProvider.result();
+  mPreloadedProvider = QFuture< QgsDataProvider * >();
+  mPreloadedProviderKey.clear();
+  mPreloadedProviderSource.clear();
+}
+
 bool QgsMapLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &context )
 {
   Q_UNUSED( layer_node );
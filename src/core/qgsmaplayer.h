@@ -21,6 +21,7 @@
 #include "qgis_core.h"
 #include <QDateTime>
 #include <QDomNode>
+#include <QFuture>
 #include <QImage>
 #include <QObject>
 #include <QPainter>
@@ -47,6 +48,7 @@ class QgsProject;
 class QDomDocument;
 class QKeyEvent;
 class QPainter;
+class QThreadPool;
 
 /*
  * Constants used to describe copy-paste MIME types
@@ -1251,6 +1253,18 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     void readCommonStyle( const QDomElement &layerElement, const QgsReadWriteContext &context );
 
+    /**
+     * Takes the data provider which was opened ahead of time for the layer while reading
+     * a project, so that subclasses do not have to create it again. The provider is only
+     * returned if it was created with the same \a providerKey and \a dataSource, otherwise
+     * nullptr is returned. Ownership of the provider is transferred to the caller.
+     *
+     * This blocks until the provider has finished opening.
+     *
+     * \since QGIS 3.4
+     */
+    QgsDataProvider *takePreloadedProvider( const QString &providerKey, const QString &dataSource ) SIP_SKIP;
+
 #ifndef SIP_RUN
 #if 0
     //! Debugging member - invoked when a connect() is made to this object
@@ -1313,6 +1327,15 @@ class CORE_EXPORT QgsMapLayer : public QObject
 
   private:
 
+    /**
+     * Starts opening the layer's data provider in \a pool, while the rest of the project is read.
+     * The provider is picked up by takePreloadedProvider().
+     */
+    void preloadProvider( const QString &providerKey, const QString &dataSource, QThreadPool *pool );
+
+    //! Deletes the preloaded provider if it was not used
+    void discardPreloadedProvider();
+
     virtual QString baseURI( PropertyType type ) const;
     QString saveNamedProperty( const QString &uri, QgsMapLayer::PropertyType type, bool &resultFlag );
     QString loadNamedProperty( const QString &uri, QgsMapLayer::PropertyType type, bool &resultFlag );
@@ -1372,6 +1395,14 @@ class CORE_EXPORT QgsMapLayer : public QObject
     //! Renderer for 3D views
     QgsAbstract3DRenderer *m3DRenderer = nullptr;
 
+    //! Provider being opened ahead of time, see preloadProvider()
+    QFuture< QgsDataProvider * > mPreloadedProvider;
+    QString mPreloadedProviderKey;
+    QString mPreloadedProviderSource;
+
+    friend class QgsProject;
+    friend class TestQgsProject;
+
 };
 
 Q_DECLARE_METATYPE( QgsMapLayer * )
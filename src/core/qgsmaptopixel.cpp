@@ -250,6 +250,30 @@ void QgsMapToPixel::transformInPlace( float &x, float &y ) const
   y = my;
 }
 
+void QgsMapToPixel::transformInPlace( QPolygonF &points ) const
+{
+  const int count = points.size();
+  if ( count == 0 )
+    return;
+
+  // map 2 pixel is always affine, so avoid the per point type dispatch of QTransform::map
+  const double m11 = mMatrix.m11();
+  const double m12 = mMatrix.m12();
+  const double m21 = mMatrix.m21();
+  const double m22 = mMatrix.m22();
+  const double dx = mMatrix.dx();
+  const double dy = mMatrix.dy();
+
+  QPointF *ptr = points.data();
+  for ( int i = 0; i < count; ++i, ++ptr )
+  {
+    const double x = ptr->x();
+    const double y = ptr->y();
+    ptr->setX( m11 * x + m21 * y + dx );
+    ptr->setY( m12 * x + m22 * y + dy );
+  }
+}
+
 QTransform QgsMapToPixel::transform() const
 {
   // NOTE: operations are done in the reverse order in which
@@ -20,6 +20,7 @@
 #include "qgis_core.h"
 #include "qgis_sip.h"
 #include <QTransform>
+#include <QPolygonF>
 #include <vector>
 #include "qgsunittypes.h"
 #include <cassert>
@@ -115,6 +116,16 @@ class CORE_EXPORT QgsMapToPixel
       for ( int i = 0; i < x.size(); ++i )
         transformInPlace( x[i], y[i] );
     }
+
+    /**
+     * Transforms all the \a points of a polygon from map to device coordinates in place.
+     * The affine coefficients are fetched once and applied in a single tight loop which the
+     * compiler can vectorize, so this is much faster than calling transformInPlace() for
+     * each point of a large polygon.
+     * \note not available in Python bindings
+     * \since QGIS 3.4
+     */
+    void transformInPlace( QPolygonF &points ) const SIP_SKIP;
 #endif
 
     QgsPointXY toMapCoordinates( int x, int y ) const;
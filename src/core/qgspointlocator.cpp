@@ -22,6 +22,8 @@
 #include "qgis.h"
 #include "qgslogger.h"
 #include "qgsrenderer.h"
+#include "qgspointlocatorinittask.h"
+#include "qgsapplication.h"
 
 #include <SpatialIndex.h>
 
@@ -672,15 +674,47 @@ void QgsPointLocator::setRenderContext( const QgsRenderContext *context )
 
 }
 
-bool QgsPointLocator::init( int maxFeaturesToIndex )
+bool QgsPointLocator::init( int maxFeaturesToIndex, bool relaxed )
 {
-  return hasIndex() ? true : rebuildIndex( maxFeaturesToIndex );
+  if ( mInitTask )
+  {
+    if ( !relaxed )
+      waitForIndexingFinished();
+    return relaxed || hasIndex();
+  }
+
+  if ( hasIndex() )
+    return true;
+
+  if ( !relaxed )
+    return rebuildIndex( maxFeaturesToIndex );
+
+  if ( mLayer->geometryType() == QgsWkbTypes::NullGeometry )
+    return true; // nothing to index
+
+  // queries are done on the features indexed so far until the task has finished
+  createEmptyIndex();
+  mInitTask = new QgsPointLocatorInitTask( this, maxFeaturesToIndex );
+  connect( mInitTask, &QgsTask::taskCompleted, this, &QgsPointLocator::onInitTaskFinished );
+  connect( mInitTask, &QgsTask::taskTerminated, this, &QgsPointLocator::onInitTaskFinished );
+  QgsApplication::taskManager()->addTask( mInitTask );
+  return true;
 }
 
 
 bool QgsPointLocator::hasIndex() const
 {
-  return mRTree || mIsEmptyLayer;
+  return static_cast< bool >( mRTree );
+}
+
+
+void QgsPointLocator::waitForIndexingFinished()
+{
+  if ( !mInitTask )
+    return;
+
+  mInitTask->waitForIndexingFinished();
+  onInitTaskFinished();
 }
 
 
@@ -688,98 +722,29 @@ bool QgsPointLocator::rebuildIndex( int maxFeaturesToIndex )
 {
   destroyIndex();
 
-  QLinkedList<RTree::Data *> dataList;
-  QgsFeature f;
   QgsWkbTypes::GeometryType geomType = mLayer->geometryType();
   if ( geomType == QgsWkbTypes::NullGeometry )
     return true; // nothing to index
 
-  QgsFeatureRequest request;
-  request.setSubsetOfAttributes( QgsAttributeList() );
+  // the geometries are fetched in this thread
+  QgsPointLocatorInitTask task( this, maxFeaturesToIndex );
+  if ( !task.run() )
+    return false;
 
-  if ( mExtent )
+  const QHash< QgsFeatureId, QgsGeometry > geometries = task.takeIndexedGeometries();
+  if ( geometries.isEmpty() )
   {
-    QgsRectangle rect = *mExtent;
-    if ( mTransform.isValid() )
-    {
-      try
-      {
-        rect = mTransform.transformBoundingBox( rect, QgsCoordinateTransform::ReverseTransform );
-      }
-      catch ( const QgsException &e )
-      {
-        Q_UNUSED( e );
-        // See https://issues.qgis.org/issues/12634
-        QgsDebugMsg( QString( "could not transform bounding box to map, skipping the snap filter (%1)" ).arg( e.what() ) );
-      }
-    }
-    request.setFilterRect( rect );
-  }
-
-  bool filter = false;
-  std::unique_ptr< QgsFeatureRenderer > renderer( mLayer->renderer() ? mLayer->renderer()->clone() : nullptr );
-  QgsRenderContext *ctx = nullptr;
-  if ( mContext )
-  {
-    mContext->expressionContext() << QgsExpressionContextUtils::layerScope( mLayer );
-    ctx = mContext.get();
-    if ( renderer )
-    {
-      // setup scale for scale dependent visibility (rule based)
-      renderer->startRender( *ctx, mLayer->fields() );
-      filter = renderer->capabilities() & QgsFeatureRenderer::Filter;
-      request.setSubsetOfAttributes( renderer->usedAttributes( *ctx ), mLayer->fields() );
-    }
+    // no features - new ones will be added to the empty index
+    createEmptyIndex();
+    return true;
   }
 
-  QgsFeatureIterator fi = mLayer->getFeatures( request );
-  int indexedCount = 0;
-
-  while ( fi.nextFeature( f ) )
+  QLinkedList<RTree::Data *> dataList;
+  for ( auto it = geometries.constBegin(); it != geometries.constEnd(); ++it )
   {
-    if ( !f.hasGeometry() )
-      continue;
-
-    if ( filter && ctx && renderer )
-    {
-      ctx->expressionContext().setFeature( f );
-      if ( !renderer->willRenderFeature( f, *ctx ) )
-      {
-        continue;
-      }
-    }
-
-    if ( mTransform.isValid() )
-    {
-      try
-      {
-        QgsGeometry transformedGeometry = f.geometry();
-        transformedGeometry.transform( mTransform );
-        f.setGeometry( transformedGeometry );
-      }
-      catch ( const QgsException &e )
-      {
-        Q_UNUSED( e );
-        // See https://issues.qgis.org/issues/12634
-        QgsDebugMsg( QStringLiteral( "could not transform geometry to map, skipping the snap for it (%1)" ).arg( e.what() ) );
-        continue;
-      }
-    }
-
-    SpatialIndex::Region r( rect2region( f.geometry().boundingBox() ) );
-    dataList << new RTree::Data( 0, nullptr, r, f.id() );
-
-    if ( mGeoms.contains( f.id() ) )
-      delete mGeoms.take( f.id() );
-    mGeoms[f.id()] = new QgsGeometry( f.geometry() );
-    ++indexedCount;
-
-    if ( maxFeaturesToIndex != -1 && indexedCount > maxFeaturesToIndex )
-    {
-      qDeleteAll( dataList );
-      destroyIndex();
-      return false;
-    }
+    SpatialIndex::Region r( rect2region( it.value().boundingBox() ) );
+    dataList << new RTree::Data( 0, nullptr, r, it.key() );
+    mGeoms[it.key()] = new QgsGeometry( it.value() );
   }
 
   // R-Tree parameters
@@ -790,29 +755,100 @@ bool QgsPointLocator::rebuildIndex( int maxFeaturesToIndex )
   RTree::RTreeVariant variant = RTree::RV_RSTAR;
   SpatialIndex::id_type indexId;
 
-  if ( dataList.isEmpty() )
-  {
-    mIsEmptyLayer = true;
-    return true; // no features
-  }
-
   QgsPointLocator_Stream stream( dataList );
   mRTree.reset( RTree::createAndBulkLoadNewRTree( RTree::BLM_STR, stream, *mStorage, fillFactor, indexCapacity,
                 leafCapacity, dimension, variant, indexId ) );
+  return true;
+}
+
+
+void QgsPointLocator::createEmptyIndex()
+{
+  // same parameters as when bulk loading
+  SpatialIndex::id_type indexId;
+  mRTree.reset( RTree::createNewRTree( *mStorage, 0.7, 10, 10, 2, RTree::RV_RSTAR, indexId ) );
+}
 
-  if ( ctx && renderer )
+
+void QgsPointLocator::indexGeometry( QgsFeatureId fid, const QgsGeometry &geometry )
+{
+  QgsRectangle bbox = geometry.boundingBox();
+  if ( bbox.isNull() )
+    return;
+
+  SpatialIndex::Region r( rect2region( bbox ) );
+  mRTree->insertData( 0, nullptr, r, fid );
+
+  if ( mGeoms.contains( fid ) )
+    delete mGeoms.take( fid );
+  mGeoms[fid] = new QgsGeometry( geometry );
+}
+
+
+void QgsPointLocator::addIndexedGeometries()
+{
+  if ( !mInitTask || !mRTree )
+    return;
+
+  const QHash< QgsFeatureId, QgsGeometry > geometries = mInitTask->takeIndexedGeometries();
+  for ( auto it = geometries.constBegin(); it != geometries.constEnd(); ++it )
   {
-    renderer->stopRender( *ctx );
+    // the changes made since the task has been started are already in the index
+    if ( mEditedWhileIndexing.contains( it.key() ) || mGeoms.contains( it.key() ) )
+      continue;
+
+    indexGeometry( it.key(), it.value() );
   }
-  return true;
+}
+
+
+void QgsPointLocator::onInitTaskFinished()
+{
+  if ( !mInitTask )
+    return;
+
+  // a task canceled by the user (e.g. from the task manager) leaves a partial index
+  const bool ok = mInitTask->indexingCompleted();
+  if ( ok )
+    addIndexedGeometries();
+  // the task may already have been waited for
+  disconnect( mInitTask, nullptr, this, nullptr );
+  mInitTask = nullptr;
+  mEditedWhileIndexing.clear();
+
+  if ( !ok )
+    destroyIndex();
+
+  emit initFinished( ok );
+}
+
+
+bool QgsPointLocator::prepare()
+{
+  if ( mInitTask )
+  {
+    addIndexedGeometries();
+    return true;
+  }
+
+  if ( !mRTree )
+    init();
+  return static_cast< bool >( mRTree );
 }
 
 
 void QgsPointLocator::destroyIndex()
 {
-  mRTree.reset();
+  if ( mInitTask )
+  {
+    // results of the task are outdated
+    disconnect( mInitTask, nullptr, this, nullptr );
+    mInitTask->cancel();
+    mInitTask = nullptr;
+    mEditedWhileIndexing.clear();
+  }
 
-  mIsEmptyLayer = false;
+  mRTree.reset();
 
   qDeleteAll( mGeoms );
 
@@ -822,11 +858,10 @@ void QgsPointLocator::destroyIndex()
 void QgsPointLocator::onFeatureAdded( QgsFeatureId fid )
 {
   if ( !mRTree )
-  {
-    if ( mIsEmptyLayer )
-      rebuildIndex(); // first feature - let's built the index
     return; // nothing to do if we are not initialized yet
-  }
+
+  if ( mInitTask )
+    mEditedWhileIndexing << fid;
 
   QgsFeature f;
   if ( mLayer->getFeatures( QgsFeatureRequest( fid ) ).nextFeature( f ) )
@@ -875,16 +910,7 @@ void QgsPointLocator::onFeatureAdded( QgsFeatureId fid )
       }
     }
 
-    QgsRectangle bbox = f.geometry().boundingBox();
-    if ( !bbox.isNull() )
-    {
-      SpatialIndex::Region r( rect2region( bbox ) );
-      mRTree->insertData( 0, nullptr, r, f.id() );
-
-      if ( mGeoms.contains( f.id() ) )
-        delete mGeoms.take( f.id() );
-      mGeoms[fid] = new QgsGeometry( f.geometry() );
-    }
+    indexGeometry( fid, f.geometry() );
   }
 }
 
@@ -893,6 +919,9 @@ void QgsPointLocator::onFeatureDeleted( QgsFeatureId fid )
   if ( !mRTree )
     return; // nothing to do if we are not initialized yet
 
+  if ( mInitTask )
+    mEditedWhileIndexing << fid;
+
   if ( mGeoms.contains( fid ) )
   {
     mRTree->deleteData( rect2region( mGeoms[fid]->boundingBox() ), fid );
@@ -922,12 +951,8 @@ void QgsPointLocator::onAttributeValueChanged( QgsFeatureId fid, int idx, const
 
 QgsPointLocator::Match QgsPointLocator::nearestVertex( const QgsPointXY &point, double tolerance, MatchFilter *filter )
 {
-  if ( !mRTree )
-  {
-    init();
-    if ( !mRTree ) // still invalid?
-      return Match();
-  }
+  if ( !prepare() )
+    return Match();
 
   Match m;
   QgsPointLocator_VisitorNearestVertex visitor( this, m, point, filter );
@@ -940,12 +965,8 @@ QgsPointLocator::Match QgsPointLocator::nearestVertex( const QgsPointXY &point,
 
 QgsPointLocator::Match QgsPointLocator::nearestEdge( const QgsPointXY &point, double tolerance, MatchFilter *filter )
 {
-  if ( !mRTree )
-  {
-    init();
-    if ( !mRTree ) // still invalid?
-      return Match();
-  }
+  if ( !prepare() )
+    return Match();
 
   QgsWkbTypes::GeometryType geomType = mLayer->geometryType();
   if ( geomType == QgsWkbTypes::PointGeometry )
@@ -962,12 +983,8 @@ QgsPointLocator::Match QgsPointLocator::nearestEdge( const QgsPointXY &point, do
 
 QgsPointLocator::Match QgsPointLocator::nearestArea( const QgsPointXY &point, double tolerance, MatchFilter *filter )
 {
-  if ( !mRTree )
-  {
-    init();
-    if ( !mRTree ) // still invalid?
-      return Match();
-  }
+  if ( !prepare() )
+    return Match();
 
   MatchList mlist = pointInPolygon( point );
   if ( mlist.count() && mlist.at( 0 ).isValid() )
@@ -996,12 +1013,8 @@ QgsPointLocator::Match QgsPointLocator::nearestArea( const QgsPointXY &point, do
 
 QgsPointLocator::MatchList QgsPointLocator::edgesInRect( const QgsRectangle &rect, QgsPointLocator::MatchFilter *filter )
 {
-  if ( !mRTree )
-  {
-    init();
-    if ( !mRTree ) // still invalid?
-      return MatchList();
-  }
+  if ( !prepare() )
+    return MatchList();
 
   QgsWkbTypes::GeometryType geomType = mLayer->geometryType();
   if ( geomType == QgsWkbTypes::PointGeometry )
@@ -1023,12 +1036,8 @@ QgsPointLocator::MatchList QgsPointLocator::edgesInRect( const QgsPointXY &point
 
 QgsPointLocator::MatchList QgsPointLocator::pointInPolygon( const QgsPointXY &point )
 {
-  if ( !mRTree )
-  {
-    init();
-    if ( !mRTree ) // still invalid?
-      return MatchList();
-  }
+  if ( !prepare() )
+    return MatchList();
 
   QgsWkbTypes::GeometryType geomType = mLayer->geometryType();
   if ( geomType == QgsWkbTypes::PointGeometry || geomType == QgsWkbTypes::LineGeometry )
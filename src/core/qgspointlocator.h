@@ -26,12 +26,15 @@ class QgsRenderContext;
 #include "qgspointxy.h"
 #include "qgscoordinatereferencesystem.h"
 #include "qgscoordinatetransform.h"
+#include <QPointer>
+#include <QSet>
 #include <memory>
 
 class QgsPointLocator_VisitorNearestVertex;
 class QgsPointLocator_VisitorNearestEdge;
 class QgsPointLocator_VisitorArea;
 class QgsPointLocator_VisitorEdgesInRect;
+class QgsPointLocatorInitTask;
 
 namespace SpatialIndex SIP_SKIP
 {
@@ -119,12 +122,36 @@ class CORE_EXPORT QgsPointLocator : public QObject
      * Prepare the index for queries. Does nothing if the index already exists.
      * If the number of features is greater than the value of maxFeaturesToIndex, creation of index is stopped
      * to make sure we do not run out of memory. If maxFeaturesToIndex is -1, no limits are used. Returns
-     * false if the creation of index has been prematurely stopped due to the limit of features, otherwise true */
-    bool init( int maxFeaturesToIndex = -1 );
+     * false if the creation of index has been prematurely stopped due to the limit of features, otherwise true
+     *
+     * If \a relaxed is true, the index is built in a background task and the method returns true
+     * immediately. Until the task has finished, queries only return the features which have already
+     * been indexed. The initFinished() signal is emitted once the task has finished. If \a relaxed is
+     * false while the index is being built in background, the method waits for the task to finish.
+     * The \a relaxed argument was added in QGIS 3.4.
+     */
+    bool init( int maxFeaturesToIndex = -1, bool relaxed = false );
 
-    //! Indicate whether the data have been already indexed
+    /**
+     * Indicate whether the data have been already indexed. This is also true while the index
+     * is being built in background, see isIndexing().
+     */
     bool hasIndex() const;
 
+    /**
+     * Returns true if the index is being built in a background task.
+     * \see init()
+     * \since QGIS 3.4
+     */
+    bool isIndexing() const { return !mInitTask.isNull(); }
+
+    /**
+     * Waits for the background task building the index, if any, to finish.
+     * \see init()
+     * \since QGIS 3.4
+     */
+    void waitForIndexingFinished();
+
     struct Match
     {
         //! construct invalid match
@@ -266,6 +293,15 @@ class CORE_EXPORT QgsPointLocator : public QObject
      */
     int cachedGeometryCount() const { return mGeoms.count(); }
 
+  signals:
+
+    /**
+     * Emitted when the background task started by init() has finished. \a ok is false
+     * if the creation of index has been stopped due to the limit of features.
+     * \since QGIS 3.4
+     */
+    void initFinished( bool ok );
+
   protected:
     bool rebuildIndex( int maxFeaturesToIndex = -1 );
   protected slots:
@@ -275,16 +311,36 @@ class CORE_EXPORT QgsPointLocator : public QObject
     void onFeatureDeleted( QgsFeatureId fid );
     void onGeometryChanged( QgsFeatureId fid, const QgsGeometry &geom );
     void onAttributeValueChanged( QgsFeatureId fid, int idx, const QVariant &value );
+    void onInitTaskFinished();
 
   private:
+
+    /**
+     * Makes sure the index can be queried, building it if needed. While the index is built
+     * in background, adds the features indexed so far. Returns false if there is no index.
+     */
+    bool prepare();
+
+    //! Creates an empty R-tree, to which geometries get inserted one by one
+    void createEmptyIndex();
+
+    //! Inserts a geometry in the index, which must be in the destination CRS
+    void indexGeometry( QgsFeatureId fid, const QgsGeometry &geometry );
+
+    //! Inserts the geometries fetched by the background task since the last call
+    void addIndexedGeometries();
+
     //! Storage manager
     std::unique_ptr< SpatialIndex::IStorageManager > mStorage;
 
     QHash<QgsFeatureId, QgsGeometry *> mGeoms;
     std::unique_ptr< SpatialIndex::ISpatialIndex > mRTree;
 
-    //! flag whether the layer is currently empty (i.e. mRTree is null but it is not necessary to rebuild it)
-    bool mIsEmptyLayer = false;
+    //! Task building the index in background, if any
+    QPointer< QgsPointLocatorInitTask > mInitTask;
+
+    //! Features edited while the index is built in background, whose fetched geometries are outdated
+    QSet< QgsFeatureId > mEditedWhileIndexing;
 
 
     //! R-tree containing spatial index
@@ -298,6 +354,7 @@ class CORE_EXPORT QgsPointLocator : public QObject
     friend class QgsPointLocator_VisitorNearestEdge;
     friend class QgsPointLocator_VisitorArea;
     friend class QgsPointLocator_VisitorEdgesInRect;
+    friend class QgsPointLocatorInitTask;
 };
 
 
@@ -0,0 +1,184 @@
+/***************************************************************************
+  qgspointlocatorinittask.cpp
+  --------------------------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspointlocatorinittask.h"
+#include "qgspointlocator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+#include "qgsrenderer.h"
+#include "qgsrendercontext.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexception.h"
+#include "qgslogger.h"
+
+///@cond PRIVATE
+
+//! Number of geometries fetched before they are made available to the locator
+static const int BATCH_SIZE = 1000;
+
+QgsPointLocatorInitTask::QgsPointLocatorInitTask( QgsPointLocator *locator, int maxFeaturesToIndex )
+  : QgsTask( tr( "Indexing %1" ).arg( locator->layer()->name() ), QgsTask::CanCancel )
+  , mSource( qgis::make_unique< QgsVectorLayerFeatureSource >( locator->layer() ) )
+  , mFields( locator->layer()->fields() )
+  , mTransform( locator->mTransform )
+  , mMaxFeaturesToIndex( maxFeaturesToIndex )
+  , mFeatureCount( locator->layer()->featureCount() )
+{
+  QgsVectorLayer *layer = locator->layer();
+
+  mRequest.setSubsetOfAttributes( QgsAttributeList() );
+
+  if ( locator->mExtent )
+  {
+    QgsRectangle rect = *locator->mExtent;
+    if ( mTransform.isValid() )
+    {
+      try
+      {
+        rect = mTransform.transformBoundingBox( rect, QgsCoordinateTransform::ReverseTransform );
+      }
+      catch ( const QgsException &e )
+      {
+        Q_UNUSED( e );
+        // See https://issues.qgis.org/issues/12634
+        QgsDebugMsg( QString( "could not transform bounding box to map, skipping the snap filter (%1)" ).arg( e.what() ) );
+      }
+    }
+    mRequest.setFilterRect( rect );
+  }
+
+  if ( locator->mContext )
+  {
+    mContext = qgis::make_unique< QgsRenderContext >( *locator->mContext );
+    mContext->expressionContext() << QgsExpressionContextUtils::layerScope( layer );
+    mRenderer.reset( layer->renderer() ? layer->renderer()->clone() : nullptr );
+  }
+}
+
+QgsPointLocatorInitTask::~QgsPointLocatorInitTask() = default;
+
+bool QgsPointLocatorInitTask::run()
+{
+  bool filter = false;
+  if ( mRenderer )
+  {
+    // setup scale for scale dependent visibility (rule based)
+    mRenderer->startRender( *mContext, mFields );
+    filter = mRenderer->capabilities() & QgsFeatureRenderer::Filter;
+    mRequest.setSubsetOfAttributes( mRenderer->usedAttributes( *mContext ), mFields );
+  }
+
+  QHash< QgsFeatureId, QgsGeometry > batch;
+  int indexedCount = 0;
+  int fetchedCount = 0;
+  bool ok = true;
+
+  QgsFeatureIterator fi = mSource->getFeatures( mRequest );
+  QgsFeature f;
+  while ( fi.nextFeature( f ) )
+  {
+    if ( isCanceled() )
+    {
+      ok = false;
+      break;
+    }
+
+    ++fetchedCount;
+    if ( mFeatureCount > 0 && fetchedCount % BATCH_SIZE == 0 )
+      setProgress( 100.0 * fetchedCount / mFeatureCount );
+
+    if ( !f.hasGeometry() )
+      continue;
+
+    if ( filter )
+    {
+      mContext->expressionContext().setFeature( f );
+      if ( !mRenderer->willRenderFeature( f, *mContext ) )
+      {
+        continue;
+      }
+    }
+
+    QgsGeometry geometry = f.geometry();
+    if ( mTransform.isValid() )
+    {
+      try
+      {
+        geometry.transform( mTransform );
+      }
+      catch ( const QgsException &e )
+      {
+        Q_UNUSED( e );
+        // See https://issues.qgis.org/issues/12634
+        QgsDebugMsg( QStringLiteral( "could not transform geometry to map, skipping the snap for it (%1)" ).arg( e.what() ) );
+        continue;
+      }
+    }
+
+    ++indexedCount;
+    if ( mMaxFeaturesToIndex != -1 && indexedCount > mMaxFeaturesToIndex )
+    {
+      mFeatureLimitReached = true;
+      ok = false;
+      break;
+    }
+
+    batch.insert( f.id(), geometry );
+    if ( batch.count() >= BATCH_SIZE )
+    {
+      QMutexLocker locker( &mMutex );
+      mGeometries.unite( batch );
+      batch.clear();
+    }
+  }
+
+  if ( mRenderer )
+  {
+    mRenderer->stopRender( *mContext );
+  }
+
+  QMutexLocker locker( &mMutex );
+  if ( ok )
+    mGeometries.unite( batch );
+  else
+    mGeometries.clear();
+  mFinished = true;
+  mCompleted = ok;
+  mFinishedCondition.wakeAll();
+  return ok;
+}
+
+QHash< QgsFeatureId, QgsGeometry > QgsPointLocatorInitTask::takeIndexedGeometries()
+{
+  QMutexLocker locker( &mMutex );
+  QHash< QgsFeatureId, QgsGeometry > geometries;
+  geometries.swap( mGeometries );
+  return geometries;
+}
+
+bool QgsPointLocatorInitTask::indexingCompleted()
+{
+  QMutexLocker locker( &mMutex );
+  return mFinished && mCompleted && !isCanceled();
+}
+
+void QgsPointLocatorInitTask::waitForIndexingFinished()
+{
+  QMutexLocker locker( &mMutex );
+  // a task canceled before it started never runs, so cancelation is polled
+  while ( !mFinished && !isCanceled() )
+    mFinishedCondition.wait( &mMutex, 100 );
+}
+
+///@endcond
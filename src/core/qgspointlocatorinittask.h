@@ -0,0 +1,109 @@
+/***************************************************************************
+  qgspointlocatorinittask.h
+  --------------------------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPOINTLOCATORINITTASK_H
+#define QGSPOINTLOCATORINITTASK_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+#include "qgis_core.h"
+#include "qgstaskmanager.h"
+#include "qgsfeaturerequest.h"
+#include "qgscoordinatetransform.h"
+#include "qgsgeometry.h"
+#include "qgsfields.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <memory>
+
+class QgsPointLocator;
+class QgsVectorLayerFeatureSource;
+class QgsFeatureRenderer;
+class QgsRenderContext;
+
+/**
+ * \ingroup core
+ * Task which fetches the geometries to index in a QgsPointLocator.
+ *
+ * The geometries are fetched from a snapshot of the locator's layer, taken when the task is
+ * created, and are reprojected to the destination CRS of the locator. The locator takes them
+ * with takeIndexedGeometries() while the task runs, so that it can be queried meanwhile.
+ *
+ * \since QGIS 3.4
+ */
+class CORE_EXPORT QgsPointLocatorInitTask : public QgsTask
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Constructor for QgsPointLocatorInitTask, fetching the geometries to index in \a locator.
+     * The task stops if more than \a maxFeaturesToIndex features must be indexed, unless it is -1.
+     */
+    QgsPointLocatorInitTask( QgsPointLocator *locator, int maxFeaturesToIndex = -1 );
+
+    ~QgsPointLocatorInitTask() override;
+
+    bool run() override;
+
+    /**
+     * Returns the geometries fetched since the last call, by feature id.
+     */
+    QHash< QgsFeatureId, QgsGeometry > takeIndexedGeometries();
+
+    /**
+     * Returns true if the task stopped because there are more features than
+     * the maximum number of features to index.
+     */
+    bool featureLimitReached() const { return mFeatureLimitReached; }
+
+    /**
+     * Returns true if run() has fetched all the geometries to index: it was not
+     * canceled, even after it has finished, and the feature limit was not reached.
+     */
+    bool indexingCompleted();
+
+    /**
+     * Blocks until run() has returned or the task is canceled. The task must have been
+     * added to the task manager.
+     */
+    void waitForIndexingFinished();
+
+  private:
+
+    std::unique_ptr< QgsVectorLayerFeatureSource > mSource;
+    QgsFeatureRequest mRequest;
+    QgsFields mFields;
+    QgsCoordinateTransform mTransform;
+    std::unique_ptr< QgsFeatureRenderer > mRenderer;
+    std::unique_ptr< QgsRenderContext > mContext;
+    int mMaxFeaturesToIndex = -1;
+    long mFeatureCount = 0;
+    bool mFeatureLimitReached = false;
+
+    QMutex mMutex;
+    QWaitCondition mFinishedCondition;
+    bool mFinished = false;
+    bool mCompleted = false;
+    QHash< QgsFeatureId, QgsGeometry > mGeometries;
+};
+
+/// @endcond
+
+#endif // QGSPOINTLOCATORINITTASK_H
@@ -18,6 +18,7 @@
 #include "qgsproject.h"
 
 #include "qgsdatasourceuri.h"
+#include "qgscredentials.h"
 #include "qgslabelingenginesettings.h"
 #include "qgslayertree.h"
 #include "qgslayertreeutils.h"
@@ -59,6 +60,8 @@
 #include <QObject>
 #include <QTextStream>
 #include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
 #include <QDir>
 #include <QUrl>
 
@@ -856,6 +859,17 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
 
   QVector<QDomNode> sortedLayerNodes = depSorter.sortedLayerNodes();
 
+  // providers are opened in parallel, while the layers are read one after another below -
+  // each layer picks up its provider when it gets to it
+  QThreadPool providerPool;
+  QHash< QString, QgsMapLayer * > preloadedLayers;
+  const int threads = QgsSettings().value( QStringLiteral( "qgis/projectLayerLoadingThreads" ), QThread::idealThreadCount() ).toInt();
+  if ( threads > 1 )
+  {
+    providerPool.setMaxThreadCount( threads );
+    preloadedLayers = preloadLayerProviders( sortedLayerNodes, &providerPool );
+  }
+
   int i = 0;
   Q_FOREACH ( const QDomNode &node, sortedLayerNodes )
   {
@@ -875,7 +889,7 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
       QgsReadWriteContext context;
       context.setPathResolver( pathResolver() );
       context.setProjectTranslator( this );
-      if ( !addLayer( element, brokenNodes, context ) )
+      if ( !addLayer( element, brokenNodes, context, preloadedLayers.take( element.namedItem( QStringLiteral( "id" ) ).toElement().text() ) ) )
       {
         returnStatus = false;
       }
@@ -889,10 +903,13 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
     i++;
   }
 
+  // all preloaded layers should have been read by now, but make sure none leaks
+  qDeleteAll( preloadedLayers );
+
   return returnStatus;
 }
 
-bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context )
+QgsMapLayer *QgsProject::createLayer( const QDomElement &layerElem ) const
 {
   QString type = layerElem.attribute( QStringLiteral( "type" ) );
   QgsDebugMsgLevel( "Layer type is " + type, 4 );
@@ -922,6 +939,88 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
     mapLayer = QgsApplication::pluginLayerRegistry()->createLayer( typeName );
   }
 
+  return mapLayer;
+}
+
+QHash< QString, QgsMapLayer * > QgsProject::preloadLayerProviders( const QVector<QDomNode> &layerNodes, QThreadPool *pool ) const
+{
+  // providers which only talk to their own data source when they are created, and which can be
+  // created outside of the main thread - unlike e.g. virtual layers, which look up other layers
+  static const QSet< QString > sParallelProviders
+  {
+    QStringLiteral( "ogr" ),
+    QStringLiteral( "gdal" ),
+    QStringLiteral( "postgres" ),
+    QStringLiteral( "spatialite" ),
+    QStringLiteral( "mssql" ),
+    QStringLiteral( "oracle" ),
+    QStringLiteral( "DB2" ),
+    QStringLiteral( "wms" ),
+    QStringLiteral( "WFS" ),
+    QStringLiteral( "wcs" )
+  };
+
+  // Providers may ask for credentials or for the master password while they are created. A registered
+  // credentials instance, such as the dialog of the application, prompts on the main thread, which
+  // waits for the providers - so in that case only local files read by OGR or GDAL are preloaded.
+  // Without one (e.g. QGIS Server or standalone scripts), requests for credentials fail without
+  // prompting and all the providers above are preloaded.
+  const bool interactive = QgsCredentials::hasInstance();
+
+  QgsReadWriteContext context;
+  context.setPathResolver( pathResolver() );
+
+  QHash< QString, QgsMapLayer * > layers;
+  for ( const QDomNode &node : layerNodes )
+  {
+    const QDomElement element = node.toElement();
+    if ( element.attribute( QStringLiteral( "embedded" ) ) == QLatin1String( "1" ) )
+      continue;
+
+    const QString providerKey = element.namedItem( QStringLiteral( "provider" ) ).toElement().text();
+    if ( !sParallelProviders.contains( providerKey ) )
+      continue;
+    if ( interactive && providerKey != QLatin1String( "ogr" ) && providerKey != QLatin1String( "gdal" ) )
+      continue;
+
+    const QString source = element.namedItem( QStringLiteral( "datasource" ) ).toElement().text();
+    if ( interactive && source.contains( QLatin1String( "authcfg=" ) ) )
+      continue;
+
+    const QString layerId = element.namedItem( QStringLiteral( "id" ) ).toElement().text();
+    if ( layers.contains( layerId ) )
+      continue;
+
+    QgsMapLayer *layer = createLayer( element );
+    if ( !layer )
+      continue;
+
+    QString dataSource = layer->decodedSource( source, providerKey, context );
+    if ( interactive && !QFileInfo( dataSource.split( '|' ).at( 0 ) ).isFile() )
+    {
+      // OGR and GDAL also open database connections and remote files
+      delete layer;
+      continue;
+    }
+
+    if ( layer->type() == QgsMapLayer::VectorLayer && providerKey == QLatin1String( "postgres" ) )
+    {
+      // same as QgsVectorLayer::setDataProvider()
+      QgsDataSourceUri uri( dataSource );
+      uri.removeParam( QStringLiteral( "checkPrimaryKeyUnicity" ) );
+      uri.setParam( QStringLiteral( "checkPrimaryKeyUnicity" ), mTrustLayerMetadata ? "0" : "1" );
+      dataSource = uri.uri( false );
+    }
+
+    layer->preloadProvider( providerKey, dataSource, pool );
+    layers.insert( layerId, layer );
+  }
+  return layers;
+}
+
+bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context, QgsMapLayer *layer )
+{
+  QgsMapLayer *mapLayer = layer ? layer : createLayer( layerElem );
   if ( !mapLayer )
   {
     QgsDebugMsg( QStringLiteral( "Unable to create layer" ) );
@@ -946,7 +1045,7 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
   {
     delete mapLayer;
 
-    QgsDebugMsg( "Unable to load " + type + " layer" );
+    QgsDebugMsg( "Unable to load " + layerElem.attribute( QStringLiteral( "type" ) ) + " layer" );
     brokenNodes.push_back( layerElem );
     return false;
   }
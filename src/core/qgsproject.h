@@ -53,6 +53,7 @@ class QFileInfo;
 class QDomDocument;
 class QDomElement;
 class QDomNode;
+class QThreadPool;
 
 class QgsLayerTreeGroup;
 class QgsLayerTreeRegistryBridge;
@@ -1363,10 +1364,29 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     void clearError() SIP_SKIP;
 
     /**
-     * Creates layer and adds it to maplayer registry
+     * Creates an empty layer of the type stored in \a layerElem, or nullptr if the type is unknown
      * \note not available in Python bindings
      */
-    bool addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context ) SIP_SKIP;
+    QgsMapLayer *createLayer( const QDomElement &layerElem ) const SIP_SKIP;
+
+    /**
+     * Starts opening the data providers of the layers in \a layerNodes which can be opened independently
+     * of the other layers, using \a pool. Returns the layers which were created for that, by layer id.
+     *
+     * When a QgsCredentials instance is registered, which may prompt the user on the main thread, only
+     * local files read by OGR or GDAL are preloaded. Otherwise database and web providers are preloaded
+     * too. Preloaded PostgreSQL layers do not share their connections, which are only shared within
+     * the main thread.
+     * \note not available in Python bindings
+     */
+    QHash< QString, QgsMapLayer * > preloadLayerProviders( const QVector<QDomNode> &layerNodes, QThreadPool *pool ) const SIP_SKIP;
+
+    /**
+     * Creates layer and adds it to maplayer registry. If \a layer is set, it is used instead of
+     * creating a new layer, and ownership is transferred to the project.
+     * \note not available in Python bindings
+     */
+    bool addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context, QgsMapLayer *layer = nullptr ) SIP_SKIP;
 
     //! \note not available in Python bindings
     void initializeEmbeddedSubtree( const QString &projectFilePath, QgsLayerTreeGroup *group ) SIP_SKIP;
@@ -1451,6 +1471,8 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
 
     // Required by QGIS Server for switching the current project instance
     friend class QgsConfigCache;
+
+    friend class TestQgsProject;
 };
 
 /**
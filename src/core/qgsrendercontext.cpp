@@ -24,6 +24,7 @@
 #include "qgsfeaturefilterprovider.h"
 #include "qgslogger.h"
 #include "qgspoint.h"
+#include "qgsinterpolatedcoordinatetransform.h"
 
 #define POINTS_TO_MM 2.83464567
 #define INCH_TO_MM 25.4
@@ -41,6 +42,7 @@ QgsRenderContext::QgsRenderContext( const QgsRenderContext &rh )
   : mFlags( rh.mFlags )
   , mPainter( rh.mPainter )
   , mCoordTransform( rh.mCoordTransform )
+  , mApproximateTransform( rh.mApproximateTransform )
   , mDistanceArea( rh.mDistanceArea )
   , mExtent( rh.mExtent )
   , mMapToPixel( rh.mMapToPixel )
@@ -68,6 +70,7 @@ QgsRenderContext &QgsRenderContext::operator=( const QgsRenderContext &rh )
   mFlags = rh.mFlags;
   mPainter = rh.mPainter;
   mCoordTransform = rh.mCoordTransform;
+  mApproximateTransform = rh.mApproximateTransform;
   mExtent = rh.mExtent;
   mMapToPixel = rh.mMapToPixel;
   mRenderingStopped = rh.mRenderingStopped;
@@ -163,6 +166,7 @@ QgsRenderContext QgsRenderContext::fromMapSettings( const QgsMapSettings &mapSet
   ctx.setFlag( Antialiasing, mapSettings.testFlag( QgsMapSettings::Antialiasing ) );
   ctx.setFlag( RenderPartialOutput, mapSettings.testFlag( QgsMapSettings::RenderPartialOutput ) );
   ctx.setFlag( RenderPreviewJob, mapSettings.testFlag( QgsMapSettings::RenderPreviewJob ) );
+  ctx.setFlag( ApproximateTransform, mapSettings.testFlag( QgsMapSettings::ApproximateTransform ) );
   ctx.setScaleFactor( mapSettings.outputDpi() / 25.4 ); // = pixels per mm
   ctx.setRendererScale( mapSettings.scale() );
   ctx.setExpressionContext( mapSettings.expressionContext() );
@@ -207,6 +211,20 @@ bool QgsRenderContext::showSelection() const
 void QgsRenderContext::setCoordinateTransform( const QgsCoordinateTransform &t )
 {
   mCoordTransform = t;
+  mApproximateTransform.reset();
+}
+
+const QgsInterpolatedCoordinateTransform *QgsRenderContext::approximateTransform()
+{
+  if ( !mFlags.testFlag( ApproximateTransform ) || !mCoordTransform.isValid() || mCoordTransform.isShortCircuited() )
+    return nullptr;
+
+  if ( !mApproximateTransform )
+  {
+    const double maxError = 0.25 * mMapToPixel.mapUnitsPerPixel();
+    mApproximateTransform = std::make_shared< QgsInterpolatedCoordinateTransform >( mCoordTransform, mExtent, maxError );
+  }
+  return mApproximateTransform->isValid() ? mApproximateTransform.get() : nullptr;
 }
 
 void QgsRenderContext::setDrawEditingInformation( bool b )
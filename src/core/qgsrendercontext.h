@@ -39,6 +39,7 @@ class QPainter;
 class QgsAbstractGeometry;
 class QgsLabelingEngine;
 class QgsMapSettings;
+class QgsInterpolatedCoordinateTransform;
 
 
 /**
@@ -72,6 +73,7 @@ class CORE_EXPORT QgsRenderContext
       Antialiasing             = 0x80,  //!< Use antialiasing while drawing
       RenderPartialOutput      = 0x100, //!< Whether to make extra effort to update map image with partially rendered layers (better for interactive map canvas). Added in QGIS 3.0
       RenderPreviewJob         = 0x200, //!< Render is a 'canvas preview' render, and shortcuts should be taken to ensure fast rendering
+      ApproximateTransform     = 0x400, //!< Reproject vector vertices by interpolation in a grid of exactly transformed points, with an error below a fraction of a pixel (since QGIS 3.4)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
@@ -127,6 +129,19 @@ class CORE_EXPORT QgsRenderContext
      */
     QgsCoordinateTransform coordinateTransform() const {return mCoordTransform;}
 
+    /**
+     * Returns an approximation of coordinateTransform() for points within the extent()
+     * of the context, or nullptr if vertices must be transformed exactly.
+     *
+     * An approximation is only available when the ApproximateTransform flag is set. It is
+     * built on first use, and interpolates in a grid of exactly transformed points whose
+     * error is bound to a quarter of a pixel, falling back to the exact transform elsewhere.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.4
+     */
+    const QgsInterpolatedCoordinateTransform *approximateTransform() SIP_SKIP;
+
     /**
      * A general purpose distance and area calculator, capable of performing ellipsoid based calculations.
      * \since QGIS 3.0
@@ -227,8 +242,8 @@ class CORE_EXPORT QgsRenderContext
 
     //! Sets coordinate transformation.
     void setCoordinateTransform( const QgsCoordinateTransform &t );
-    void setMapToPixel( const QgsMapToPixel &mtp ) {mMapToPixel = mtp;}
-    void setExtent( const QgsRectangle &extent ) {mExtent = extent;}
+    void setMapToPixel( const QgsMapToPixel &mtp ) {mMapToPixel = mtp; mApproximateTransform.reset();}
+    void setExtent( const QgsRectangle &extent ) {mExtent = extent; mApproximateTransform.reset();}
 
     void setDrawEditingInformation( bool b );
 
@@ -396,6 +411,9 @@ class CORE_EXPORT QgsRenderContext
     //! For transformation between coordinate systems. Can be invalid if on-the-fly reprojection is not used
     QgsCoordinateTransform mCoordTransform;
 
+    //! Lazily built approximation of mCoordTransform within mExtent
+    std::shared_ptr< QgsInterpolatedCoordinateTransform > mApproximateTransform;
+
     /**
      * A general purpose distance and area calculator, capable of performing ellipsoid based calculations.
      * Will be used to convert meter distances to active MapUnit values for QgsUnitTypes::RenderMetersInMapUnits
@@ -21,6 +21,66 @@
 #include "qgslogger.h"
 #include "qgsrenderer.h"
 
+///@cond PRIVATE
+struct QgsSharedPointLocator
+{
+  std::weak_ptr< QgsPointLocator > locator;
+  QgsCoordinateTransformContext transformContext;
+  //! Whether only the features visible at the given scale are indexed
+  bool visibleOnly = false;
+  double scale = 0;
+};
+typedef QMultiHash< QgsVectorLayer *, QgsSharedPointLocator > QgsSharedPointLocators;
+Q_GLOBAL_STATIC( QgsSharedPointLocators, sSharedLocators )
+///@endcond
+
+static bool _sameTransformContext( const QgsCoordinateTransformContext &context1, const QgsCoordinateTransformContext &context2 )
+{
+  return context1.sourceDestinationDatumTransforms() == context2.sourceDestinationDatumTransforms()
+         && context1.sourceDatumTransforms() == context2.sourceDatumTransforms()
+         && context1.destinationDatumTransforms() == context2.destinationDatumTransforms();
+}
+
+/**
+ * Returns a locator for the whole layer, shared by all snapping utils with the same destination CRS and transform context.
+ * If \a visibleOnly is true, only the features visible with the map settings are indexed and the locator is
+ * shared with the snapping utils which also exclude invisible features at the same map scale.
+ */
+static std::shared_ptr< QgsPointLocator > _sharedLocatorForLayer( QgsVectorLayer *vl, const QgsMapSettings &mapSettings, const QgsCoordinateReferenceSystem &destinationCrs, bool visibleOnly )
+{
+  const QgsCoordinateTransformContext transformContext = mapSettings.transformContext();
+  const double scale = visibleOnly ? mapSettings.scale() : 0;
+
+  QgsSharedPointLocators::iterator it = sSharedLocators()->find( vl );
+  while ( it != sSharedLocators()->end() && it.key() == vl )
+  {
+    std::shared_ptr< QgsPointLocator > locator = it->locator.lock();
+    if ( !locator )
+    {
+      it = sSharedLocators()->erase( it );
+      continue;
+    }
+    if ( locator->destinationCrs() == destinationCrs && _sameTransformContext( it->transformContext, transformContext )
+         && it->visibleOnly == visibleOnly && qgsDoubleNear( it->scale, scale ) )
+      return locator;
+    ++it;
+  }
+
+  std::shared_ptr< QgsPointLocator > locator = std::make_shared< QgsPointLocator >( vl, destinationCrs, transformContext );
+  if ( visibleOnly )
+  {
+    QgsRenderContext ctx = QgsRenderContext::fromMapSettings( mapSettings );
+    locator->setRenderContext( &ctx );
+  }
+  QgsSharedPointLocator entry;
+  entry.locator = locator;
+  entry.transformContext = transformContext;
+  entry.visibleOnly = visibleOnly;
+  entry.scale = scale;
+  sSharedLocators()->insert( vl, entry );
+  return locator;
+}
+
 QgsSnappingUtils::QgsSnappingUtils( QObject *parent, bool enableSnappingForInvisibleFeature )
   : QObject( parent )
   , mSnappingConfig( QgsProject::instance() )
@@ -39,19 +99,81 @@ QgsPointLocator *QgsSnappingUtils::locatorForLayer( QgsVectorLayer *vl )
   if ( !vl )
     return nullptr;
 
+  if ( canShareLocator( vl ) )
+  {
+    if ( !mSharedLocators.contains( vl ) )
+    {
+      // a locator restricted to an extent may have been used with another strategy
+      if ( mLocators.contains( vl ) )
+        delete mLocators.take( vl );
+      mSharedLocators.insert( vl, _sharedLocatorForLayer( vl, mMapSettings, destinationCrs(), !mEnableSnappingForInvisibleFeature ) );
+    }
+    return mSharedLocators.value( vl ).get();
+  }
+
   if ( !mLocators.contains( vl ) )
   {
     QgsPointLocator *vlpl = new QgsPointLocator( vl, destinationCrs(), mMapSettings.transformContext() );
     mLocators.insert( vl, vlpl );
+
+    const QString layerId = vl->id();
+    connect( vlpl, &QgsPointLocator::initFinished, this, [this, layerId]( bool ok )
+    {
+      // a partial index built in background went over the feature limit:
+      // let's make the allowed area smaller for the next time
+      if ( !ok && mStrategy == IndexHybrid && mHybridMaxAreaPerLayer.value( layerId, -1 ) > 0 )
+        mHybridMaxAreaPerLayer[layerId] /= 4;
+    } );
   }
   return mLocators.value( vl );
 }
 
+bool QgsSnappingUtils::canShareLocator( QgsVectorLayer *vl )
+{
+  // the locators of other strategies get restricted to an extent
+  switch ( mStrategy )
+  {
+    case IndexAlwaysFull:
+      return true;
+    case IndexHybrid:
+      return hybridMaxAreaForLayer( vl ) == -1;
+    case IndexNeverFull:
+    case IndexExtent:
+      break;
+  }
+  return false;
+}
+
+double QgsSnappingUtils::hybridMaxAreaForLayer( QgsVectorLayer *vl )
+{
+  // first time the layer is used? - let's set an initial guess about indexing
+  if ( !mHybridMaxAreaPerLayer.contains( vl->id() ) )
+  {
+    int totalFeatureCount = vl->featureCount();
+    if ( totalFeatureCount < mHybridPerLayerFeatureLimit )
+    {
+      // index the whole layer
+      mHybridMaxAreaPerLayer[vl->id()] = -1;
+    }
+    else
+    {
+      // estimate for how big area it probably makes sense to build partial index to not exceed the limit
+      // (we may change the limit later)
+      QgsRectangle layerExtent = mMapSettings.layerExtentToOutputExtent( vl, vl->extent() );
+      double totalArea = layerExtent.width() * layerExtent.height();
+      mHybridMaxAreaPerLayer[vl->id()] = totalArea * mHybridPerLayerFeatureLimit / totalFeatureCount / 4;
+    }
+  }
+  return mHybridMaxAreaPerLayer.value( vl->id() );
+}
+
 void QgsSnappingUtils::clearAllLocators()
 {
   qDeleteAll( mLocators );
   mLocators.clear();
 
+  mSharedLocators.clear();
+
   qDeleteAll( mTemporaryLocators );
   mTemporaryLocators.clear();
 }
@@ -360,9 +482,16 @@ void QgsSnappingUtils::prepareIndex( const QList<LayerAndAreaOfInterest> &layers
       QTime tt;
       tt.start();
 
+      if ( !mEnableSnappingForInvisibleFeature && mSharedLocators.contains( vl ) )
+      {
+        // shared locators keep the render context they were created with:
+        // get the one matching the current map scale
+        mSharedLocators.remove( vl );
+      }
+
       QgsPointLocator *loc = locatorForLayer( vl );
 
-      if ( !mEnableSnappingForInvisibleFeature )
+      if ( !mEnableSnappingForInvisibleFeature && !mSharedLocators.contains( vl ) )
       {
         QgsRenderContext ctx = QgsRenderContext::fromMapSettings( mMapSettings );
         loc->setRenderContext( &ctx );
@@ -376,30 +505,11 @@ void QgsSnappingUtils::prepareIndex( const QList<LayerAndAreaOfInterest> &layers
       }
       else if ( mStrategy == IndexHybrid )
       {
-        // first time the layer is used? - let's set an initial guess about indexing
-        if ( !mHybridMaxAreaPerLayer.contains( vl->id() ) )
-        {
-          int totalFeatureCount = vl->featureCount();
-          if ( totalFeatureCount < mHybridPerLayerFeatureLimit )
-          {
-            // index the whole layer
-            mHybridMaxAreaPerLayer[vl->id()] = -1;
-          }
-          else
-          {
-            // estimate for how big area it probably makes sense to build partial index to not exceed the limit
-            // (we may change the limit later)
-            QgsRectangle layerExtent = mMapSettings.layerExtentToOutputExtent( vl, vl->extent() );
-            double totalArea = layerExtent.width() * layerExtent.height();
-            mHybridMaxAreaPerLayer[vl->id()] = totalArea * mHybridPerLayerFeatureLimit / totalFeatureCount / 4;
-          }
-        }
-
-        double indexReasonableArea = mHybridMaxAreaPerLayer[vl->id()];
+        double indexReasonableArea = hybridMaxAreaForLayer( vl );
         if ( indexReasonableArea == -1 )
         {
           // we can safely index the whole layer
-          loc->init();
+          loc->init( -1, mIndexingInBackground );
         }
         else
         {
@@ -410,8 +520,9 @@ void QgsSnappingUtils::prepareIndex( const QList<LayerAndAreaOfInterest> &layers
                              c.x() + halfSide, c.y() + halfSide );
           loc->setExtent( &rect );
 
-          // see if it's possible build index for this area
-          if ( !loc->init( mHybridPerLayerFeatureLimit ) )
+          // see if it's possible build index for this area. In background, the
+          // allowed area is made smaller once the task fails (see locatorForLayer())
+          if ( !loc->init( mHybridPerLayerFeatureLimit, mIndexingInBackground ) )
           {
             // hmm that didn't work out - too many features!
             // let's make the allowed area smaller for the next time
@@ -421,7 +532,7 @@ void QgsSnappingUtils::prepareIndex( const QList<LayerAndAreaOfInterest> &layers
 
       }
       else  // full index strategy
-        loc->init();
+        loc->init( -1, mIndexingInBackground );
 
       QgsDebugMsg( QString( "Index init: %1 ms (%2)" ).arg( tt.elapsed() ).arg( vl->id() ) );
       prepareIndexProgress( ++i );
@@ -438,7 +549,12 @@ QgsSnappingConfig QgsSnappingUtils::config() const
 
 void QgsSnappingUtils::setEnableSnappingForInvisibleFeature( bool enable )
 {
+  if ( mEnableSnappingForInvisibleFeature == enable )
+    return;
+
   mEnableSnappingForInvisibleFeature = enable;
+  // shared locators are specific to the visibility filter
+  mSharedLocators.clear();
 }
 
 void QgsSnappingUtils::setConfig( const QgsSnappingConfig &config )
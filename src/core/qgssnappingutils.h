@@ -24,6 +24,8 @@
 #include "qgspointlocator.h"
 #include "qgssnappingconfig.h"
 
+#include <memory>
+
 class QgsSnappingConfig;
 
 /**
@@ -168,6 +170,25 @@ class CORE_EXPORT QgsSnappingUtils : public QObject
      */
     void setEnableSnappingForInvisibleFeature( bool enable );
 
+    /**
+     * Sets whether the indexes of layers are built in background tasks. Until a
+     * task has finished, snapping only uses the features which have already been indexed.
+     * With the hybrid strategy, a partial index which turns out to exceed the feature limit
+     * is dropped once its task has finished and a smaller area is indexed on the next snap.
+     *
+     * \see isIndexingInBackground()
+     * \since QGIS 3.4
+     */
+    void setIndexingInBackground( bool enabled ) { mIndexingInBackground = enabled; }
+
+    /**
+     * Returns whether the indexes of layers are built in background tasks.
+     *
+     * \see setIndexingInBackground()
+     * \since QGIS 3.4
+     */
+    bool isIndexingInBackground() const { return mIndexingInBackground; }
+
   public slots:
 
     /**
@@ -203,6 +224,11 @@ class CORE_EXPORT QgsSnappingUtils : public QObject
     //! Gets destination CRS from map settings, or an invalid CRS if projections are disabled
     QgsCoordinateReferenceSystem destinationCrs() const;
 
+    //! Returns whether the locator of a layer indexes the whole layer and can be shared with other instances
+    bool canShareLocator( QgsVectorLayer *vl );
+    //! Returns the maximum area to index for a layer with the hybrid strategy (-1 if the whole layer is indexed)
+    double hybridMaxAreaForLayer( QgsVectorLayer *vl );
+
     //! Returns a locator (temporary or not) according to the indexing strategy
     QgsPointLocator *locatorForLayerUsingStrategy( QgsVectorLayer *vl, const QgsPointXY &pointMap, double tolerance );
     //! Returns a temporary locator with index only for a small area (will be replaced by another one on next request)
@@ -230,6 +256,13 @@ class CORE_EXPORT QgsSnappingUtils : public QObject
     typedef QMap<QgsVectorLayer *, QgsPointLocator *> LocatorsMap;
     //! on-demand locators used (locators are owned)
     LocatorsMap mLocators;
+
+    /**
+     * on-demand locators of whole layers (full index or small layers of the hybrid strategy).
+     * They are shared with the other instances using the same destination CRS and transform context,
+     * and if invisible features are excluded, the same map scale.
+     */
+    QMap<QgsVectorLayer *, std::shared_ptr< QgsPointLocator > > mSharedLocators;
     //! temporary locators (indexing just a part of layers). owned by the instance
     LocatorsMap mTemporaryLocators;
     //! list of layer IDs that are too large to be indexed (hybrid strategy will use temporary locators for those)
@@ -255,6 +288,8 @@ class CORE_EXPORT QgsSnappingUtils : public QObject
     //! Disable or not the snapping on all features. By default is always true except for non visible features on map canvas.
     bool mEnableSnappingForInvisibleFeature = true;
 
+    bool mIndexingInBackground = false;
+
 };
 
 
@@ -351,6 +351,15 @@ bool QgsSpatialIndex::deleteFeature( const QgsFeature &f )
   return d->mRTree->deleteData( r, FID_TO_NUMBER( id ) );
 }
 
+bool QgsSpatialIndex::deleteFeature( QgsFeatureId id, const QgsRectangle &bounds )
+{
+  SpatialIndex::Region r( rectToRegion( bounds ) );
+
+  QMutexLocker locker( &d->mMutex );
+  // TODO: handle exceptions
+  return d->mRTree->deleteData( r, FID_TO_NUMBER( id ) );
+}
+
 QList<QgsFeatureId> QgsSpatialIndex::intersects( const QgsRectangle &rect ) const
 {
   QList<QgsFeatureId> list;
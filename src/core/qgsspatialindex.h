@@ -128,6 +128,14 @@ class CORE_EXPORT QgsSpatialIndex
      */
     bool deleteFeature( const QgsFeature &feature );
 
+    /**
+     * Removes a feature \a id from the index. The \a bounds must be the bounding box
+     * the feature was added with.
+     * \returns true if the feature was found and removed from the index.
+     * \since QGIS 3.4
+     */
+    bool deleteFeature( QgsFeatureId id, const QgsRectangle &bounds );
+
 
     /* queries */
 
@@ -17,6 +17,7 @@
 
 #include "qgscurve.h"
 #include "qgsgeometry.h"
+#include "qgslinestring.h"
 #include "qgsmessagelog.h"
 #include "qgsmultipolygon.h"
 #include "qgspoint.h"
@@ -26,6 +27,7 @@
 
 #include "poly2tri.h"
 
+#include <QSet>
 #include <QtDebug>
 #include <QMatrix4x4>
 #include <QVector3D>
@@ -203,33 +205,168 @@ static void _normalVectorToXYVectors( const QVector3D &pNormal, QVector3D &pXVec
 }
 
 
-static void _ringToPoly2tri( const QgsCurve *ring, std::vector<p2t::Point *> &polyline, QHash<p2t::Point *, float> &zHash )
+static void _ringToFlatArrays( const QgsCurve *ring, std::vector<float> &x, std::vector<float> &y, std::vector<float> &z )
 {
-  QgsVertexId::VertexType vt;
-  QgsPoint pt;
+  const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( ring );
+  Q_ASSERT( line );
 
-  const int pCount = ring->numPoints();
+  const int pCount = line->numPoints();
+  x.reserve( x.size() + pCount );
+  y.reserve( y.size() + pCount );
+  z.reserve( z.size() + pCount );
 
-  polyline.reserve( pCount );
+  // the triangulation does not cope with repeated vertices within a ring
+  QSet< QPair< float, float > > seen;
+  seen.reserve( pCount );
 
   for ( int i = 0; i < pCount - 1; ++i )
   {
-    ring->pointAt( i, pt, vt );
-    const float x = pt.x();
-    const float y = pt.y();
-    const float z = pt.z();
+    const float px = line->xAt( i );
+    const float py = line->yAt( i );
+    const QPair< float, float > key( px, py );
+    if ( seen.contains( key ) )
+      continue;
+
+    seen.insert( key );
+    x.push_back( px );
+    y.push_back( py );
+    z.push_back( line->zAt( i ) );
+  }
+}
+
+
+//! Returns twice the signed area of triangle (a, b, c) - positive if the vertices are in counter-clockwise order
+inline double _cross( const std::vector<float> &x, const std::vector<float> &y, int a, int b, int c )
+{
+  return ( static_cast< double >( x[b] ) - x[a] ) * ( static_cast< double >( y[c] ) - y[a] ) -
+         ( static_cast< double >( y[b] ) - y[a] ) * ( static_cast< double >( x[c] ) - x[a] );
+}
+
+
+//! Rings with more vertices are triangulated by poly2tri, as the cost of ear clipping grows quadratically
+static const int EAR_CLIPPING_MAX_VERTICES = 128;
+
+/**
+ * Triangulates a simple ring without holes by ear clipping. The ring is given as flat arrays of coordinates
+ * without repeated vertices. Indices of the resulting triangles are appended to \a triangles,
+ * with the vertices of each triangle in counter-clockwise order.
+ *
+ * Returns false if the ring could not be triangulated, e.g. because it is degenerate.
+ */
+static bool _earClipRing( const std::vector<float> &x, const std::vector<float> &y, std::vector<int> &triangles )
+{
+  const int n = static_cast< int >( x.size() );
+  if ( n < 3 )
+    return false;
+
+  double area = 0;
+  for ( int i = 0, j = n - 1; i < n; j = i++ )
+    area += static_cast< double >( x[j] ) * y[i] - static_cast< double >( x[i] ) * y[j];
+  if ( area == 0 )
+    return false;
+
+  // doubly linked list of the vertices which are not clipped yet, walked in counter-clockwise order
+  std::vector<int> prev( n ), next( n );
+  for ( int i = 0; i < n; ++i )
+  {
+    const int before = ( i + n - 1 ) % n;
+    const int after = ( i + 1 ) % n;
+    prev[i] = area > 0 ? before : after;
+    next[i] = area > 0 ? after : before;
+  }
 
-    const bool found = std::find_if( polyline.begin(), polyline.end(), [x, y]( p2t::Point *&p ) { return *p == p2t::Point( x, y ); } ) != polyline.end();
+  // in a simple ring, only reflex (or collinear) vertices may lie within an ear. Clipping an ear never
+  // makes a convex vertex reflex, so the list only needs to be filtered as vertices turn convex
+  std::vector<bool> clipped( n, false );
+  std::vector<int> reflex;
+  for ( int i = 0; i < n; ++i )
+  {
+    if ( _cross( x, y, prev[i], i, next[i] ) <= 0 )
+      reflex.push_back( i );
+  }
+
+  auto isEar = [&]( int ear )
+  {
+    const int a = prev[ear], c = next[ear];
+    if ( _cross( x, y, a, ear, c ) <= 0 )
+      return false;  // reflex or degenerate vertex
 
-    if ( found )
+    // no other vertex may lie within the triangle or on its edges
+    for ( int p : reflex )
     {
+      if ( p == a || p == ear || p == c || clipped[p] )
+        continue;
+      if ( _cross( x, y, a, ear, p ) >= 0 && _cross( x, y, ear, c, p ) >= 0 && _cross( x, y, c, a, p ) >= 0 )
+        return false;
+    }
+    return true;
+  };
+
+  auto unlink = [&]( int i )
+  {
+    next[prev[i]] = next[i];
+    prev[next[i]] = prev[i];
+    clipped[i] = true;
+
+    // neighbors may have turned convex
+    reflex.erase( std::remove_if( reflex.begin(), reflex.end(), [&]( int p )
+    {
+      return clipped[p] || ( ( p == prev[i] || p == next[i] ) && _cross( x, y, prev[p], p, next[p] ) > 0 );
+    } ), reflex.end() );
+    return next[i];
+  };
+
+  triangles.reserve( triangles.size() + 3 * ( n - 2 ) );
+
+  int remaining = n;
+  int ear = 0;
+  int stop = ear;
+  while ( remaining > 3 )
+  {
+    if ( isEar( ear ) )
+    {
+      triangles.push_back( prev[ear] );
+      triangles.push_back( ear );
+      triangles.push_back( next[ear] );
+      ear = stop = unlink( ear );
+      --remaining;
       continue;
     }
 
-    p2t::Point *pt2 = new p2t::Point( x, y );
-    polyline.push_back( pt2 );
-    zHash[pt2] = z;
+    ear = next[ear];
+    if ( ear == stop )
+    {
+      // no ear in a whole pass over the ring - drop a collinear vertex if there is any,
+      // otherwise give up
+      int i = ear;
+      while ( _cross( x, y, prev[i], i, next[i] ) != 0 )
+      {
+        i = next[i];
+        if ( i == ear )
+          return false;
+      }
+      ear = stop = unlink( i );
+      --remaining;
+    }
   }
+
+  if ( _cross( x, y, prev[ear], ear, next[ear] ) > 0 )
+  {
+    triangles.push_back( prev[ear] );
+    triangles.push_back( ear );
+    triangles.push_back( next[ear] );
+  }
+  return true;
+}
+
+
+//! Makes sure that \a count more values can be appended to \a data without reallocation
+static void _reserveData( QVector<float> &data, int count )
+{
+  // grow geometrically, otherwise the whole buffer would get copied for each added polygon
+  const int required = data.size() + count;
+  if ( required > data.capacity() )
+    data.reserve( std::max( required, 2 * data.capacity() ) );
 }
 
 
@@ -243,8 +380,7 @@ inline double _round_coord( double x )
 static QgsCurve *_transform_ring_to_new_base( const QgsCurve &curve, const QgsPoint &pt0, const QMatrix4x4 *toNewBase )
 {
   int count = curve.numPoints();
-  QVector<QgsPoint> pts;
-  pts.reserve( count );
+  QVector<double> x( count ), y( count ), z( count );
   QgsVertexId::VertexType vt;
   for ( int i = 0; i < count; ++i )
   {
@@ -266,9 +402,11 @@ static QgsCurve *_transform_ring_to_new_base( const QgsCurve &curve, const QgsPo
     //    I suggest you round to 10 decimals for stability and you can live with that
     //    precision.
 
-    pts << QgsPoint( QgsWkbTypes::PointZ, _round_coord( v.x() ), _round_coord( v.y() ), _round_coord( v.z() ) );
+    x[i] = _round_coord( v.x() );
+    y[i] = _round_coord( v.y() );
+    z[i] = _round_coord( v.z() );
   }
-  return new QgsLineString( pts );
+  return new QgsLineString( x, y, z );
 }
 
 
@@ -354,6 +492,15 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
 {
   const QgsCurve *exterior = polygon.exteriorRing();
 
+  // reserve space for all the vertices that will most likely get added
+  int pointCount = exterior->numPoints();
+  for ( int i = 0; i < polygon.numInteriorRings(); ++i )
+    pointCount += polygon.interiorRing( i )->numPoints();
+  int vertexCount = 3 * pointCount * ( mAddBackFaces ? 2 : 1 );
+  if ( extrusionHeight != 0 )
+    vertexCount += 6 * pointCount;
+  _reserveData( mData, vertexCount * ( mAddNormals ? 6 : 3 ) );
+
   const QVector3D pNormal = _calculateNormal( exterior, mOriginX, mOriginY, mInvertNormals );
   const int pCount = exterior->numPoints();
 
@@ -437,85 +584,122 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
       }
     }
 
+    // write the vertices of a triangle given in the new base to the output data array
+    auto addTriangle = [&]( const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &z, const int *indices )
+    {
+      double fx[3], fy[3], fz[3];
+      for ( int j = 0; j < 3; ++j )
+      {
+        const int idx = indices[j];
+        QVector4D pt( x[idx], y[idx], z[idx], 0 );
+        if ( toOldBase )
+          pt = *toOldBase * pt;
+        fx[j] = pt.x() - mOriginX + pt0.x();
+        fy[j] = pt.y() - mOriginY + pt0.y();
+        fz[j] = pt.z() + extrusionHeight + pt0.z();
+      }
+
+      for ( int j = 0; j < 3; ++j )
+      {
+        mData << fx[j] << fz[j] << -fy[j];
+        if ( mAddNormals )
+          mData << pNormal.x() << pNormal.z() << - pNormal.y();
+      }
+
+      if ( mAddBackFaces )
+      {
+        // the same triangle with reversed order of coordinates and inverted normal
+        for ( int j = 2; j >= 0; --j )
+        {
+          mData << fx[j] << fz[j] << -fy[j];
+          if ( mAddNormals )
+            mData << -pNormal.x() << -pNormal.z() << pNormal.y();
+        }
+      }
+    };
+
     if ( !_check_intersecting_rings( *polygonNew ) )
     {
-      // skip the polygon - it would cause a crash inside poly2tri library
+      // skip the polygon - it would cause a crash inside poly2tri library, and ear clipping
+      // would emit overlapping triangles
       QgsMessageLog::logMessage( QObject::tr( "polygon rings self-intersect or intersect each other - skipping" ), QObject::tr( "3D" ) );
       return;
     }
 
-    QList< std::vector<p2t::Point *> > polylinesToDelete;
-    QHash<p2t::Point *, float> z;
-
-    // polygon exterior
-    std::vector<p2t::Point *> polyline;
-    _ringToPoly2tri( polygonNew->exteriorRing(), polyline, z );
-    polylinesToDelete << polyline;
-
-    std::unique_ptr<p2t::CDT> cdt( new p2t::CDT( polyline ) );
-
-    // polygon holes
-    for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
+    bool tessellated = false;
+    if ( polygonNew->numInteriorRings() == 0 && polygonNew->exteriorRing()->numPoints() <= EAR_CLIPPING_MAX_VERTICES + 1 )
     {
-      std::vector<p2t::Point *> holePolyline;
-      const QgsCurve *hole = polygonNew->interiorRing( i );
-
-      _ringToPoly2tri( hole, holePolyline, z );
+      // small polygons without holes are triangulated by ear clipping, which is much cheaper
+      // than building the constrained Delaunay triangulation
+      std::vector<float> x, y, z;
+      _ringToFlatArrays( polygonNew->exteriorRing(), x, y, z );
 
-      cdt->AddHole( holePolyline );
-      polylinesToDelete << holePolyline;
+      std::vector<int> triangles;
+      if ( _earClipRing( x, y, triangles ) )
+      {
+        for ( size_t i = 0; i < triangles.size(); i += 3 )
+          addTriangle( x, y, z, &triangles[i] );
+        tessellated = true;
+      }
     }
 
-    // run triangulation and write vertices to the output data array
-    try
+    if ( !tessellated )
     {
-      cdt->Triangulate();
+      // vertices of all rings are kept in flat arrays, with the points passed to poly2tri
+      // stored in a single block, so that a point's index is given by its address
+      std::vector<float> x, y, z;
+      std::vector<size_t> ringOffsets;
+      ringOffsets.push_back( 0 );
+      _ringToFlatArrays( polygonNew->exteriorRing(), x, y, z );
+      ringOffsets.push_back( x.size() );
+      for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
+      {
+        _ringToFlatArrays( polygonNew->interiorRing( i ), x, y, z );
+        ringOffsets.push_back( x.size() );
+      }
 
-      std::vector<p2t::Triangle *> triangles = cdt->GetTriangles();
+      std::vector<p2t::Point> points;
+      points.reserve( x.size() );
+      for ( size_t i = 0; i < x.size(); ++i )
+        points.emplace_back( x[i], y[i] );
 
-      for ( size_t i = 0; i < triangles.size(); ++i )
+      auto ringPolyline = [&]( size_t ring )
       {
-        p2t::Triangle *t = triangles[i];
-        for ( int j = 0; j < 3; ++j )
-        {
-          p2t::Point *p = t->GetPoint( j );
-          QVector4D pt( p->x, p->y, z[p], 0 );
-          if ( toOldBase )
-            pt = *toOldBase * pt;
-          const double fx = pt.x() - mOriginX + pt0.x();
-          const double fy = pt.y() - mOriginY + pt0.y();
-          const double fz = pt.z() + extrusionHeight + pt0.z();
-          mData << fx << fz << -fy;
-          if ( mAddNormals )
-            mData << pNormal.x() << pNormal.z() << - pNormal.y();
-        }
+        std::vector<p2t::Point *> polyline;
+        polyline.reserve( ringOffsets[ring + 1] - ringOffsets[ring] );
+        for ( size_t i = ringOffsets[ring]; i < ringOffsets[ring + 1]; ++i )
+          polyline.push_back( &points[i] );
+        return polyline;
+      };
+
+      // polygon exterior
+      std::unique_ptr<p2t::CDT> cdt( new p2t::CDT( ringPolyline( 0 ) ) );
+
+      // polygon holes
+      for ( size_t ring = 1; ring < ringOffsets.size() - 1; ++ring )
+        cdt->AddHole( ringPolyline( ring ) );
+
+      // run triangulation and write vertices to the output data array
+      try
+      {
+        cdt->Triangulate();
 
-        if ( mAddBackFaces )
+        std::vector<p2t::Triangle *> triangles = cdt->GetTriangles();
+
+        for ( size_t i = 0; i < triangles.size(); ++i )
         {
-          // the same triangle with reversed order of coordinates and inverted normal
-          for ( int j = 2; j >= 0; --j )
-          {
-            p2t::Point *p = t->GetPoint( j );
-            QVector4D pt( p->x, p->y, z[p], 0 );
-            if ( toOldBase )
-              pt = *toOldBase * pt;
-            const double fx = pt.x() - mOriginX + pt0.x();
-            const double fy = pt.y() - mOriginY + pt0.y();
-            const double fz = pt.z() + extrusionHeight + pt0.z();
-            mData << fx << fz << -fy;
-            if ( mAddNormals )
-              mData << -pNormal.x() << -pNormal.z() << pNormal.y();
-          }
+          p2t::Triangle *t = triangles[i];
+          int indices[3];
+          for ( int j = 0; j < 3; ++j )
+            indices[j] = static_cast< int >( t->GetPoint( j ) - points.data() );
+          addTriangle( x, y, z, indices );
         }
       }
+      catch ( ... )
+      {
+        QgsMessageLog::logMessage( QObject::tr( "Triangulation failed. Skipping polygon…" ), QObject::tr( "3D" ) );
+      }
     }
-    catch ( ... )
-    {
-      QgsMessageLog::logMessage( QObject::tr( "Triangulation failed. Skipping polygon…" ), QObject::tr( "3D" ) );
-    }
-
-    for ( int i = 0; i < polylinesToDelete.count(); ++i )
-      qDeleteAll( polylinesToDelete[i] );
   }
 
   // add walls if extrusion is enabled
@@ -26,6 +26,9 @@
 #include "qgsmarkersymbollayer.h"
 #include "qgspainteffectregistry.h"
 #include <QFontDatabase>
+#include <QCache>
+#include <QPainterPath>
+#include <QMutex>
 
 Q_GUI_EXPORT extern int qt_defaultDpiX();
 Q_GUI_EXPORT extern int qt_defaultDpiY();
@@ -54,6 +57,111 @@ static void _fixQPictureDPI( QPainter *p )
             static_cast< double >( qt_defaultDpiY() ) / p->device()->logicalDpiY() );
 }
 
+typedef QPair< QString, QFont > QgsTextPathKey;
+
+//! Key of the outlines of text buffers
+struct QgsTextBufferPathKey
+{
+  QString text;
+  QFont font;
+  double penWidth;
+  Qt::PenJoinStyle joinStyle;
+
+  bool operator==( const QgsTextBufferPathKey &other ) const
+  {
+    return text == other.text && font == other.font && penWidth == other.penWidth && joinStyle == other.joinStyle;
+  }
+};
+
+uint qHash( const QgsTextBufferPathKey &key )
+{
+  return qHash( key.text ) ^ qHash( key.font ) ^ qHash( key.penWidth ) ^ static_cast< uint >( key.joinStyle );
+}
+
+/**
+ * Glyph outlines of rendered text, shared between render threads. Shaping a string into a
+ * QPainterPath is one of the most expensive parts of drawing labels, and the same strings
+ * are drawn again on every redraw of the map (and twice when a buffer is enabled). Stroking
+ * the outline of a buffer is as expensive, so the stroked buffers are cached too.
+ */
+struct QgsTextPathCache
+{
+  QgsTextPathCache()
+    : paths( 1000000 ) // total number of path elements
+    , bufferPaths( 1000000 )
+  {}
+
+  QMutex mutex;
+  QCache< QgsTextPathKey, QPainterPath > paths;
+  QCache< QgsTextBufferPathKey, QPainterPath > bufferPaths;
+};
+
+Q_GLOBAL_STATIC( QgsTextPathCache, sTextPathCache )
+
+/**
+ * Returns a copy of \a path which does not share its data with it. Implicitly shared copies of
+ * a QPainterPath also share state which is lazily created without locking when the path is
+ * drawn (its bounds and stroker), so the paths of the cache are never handed out directly.
+ */
+static QPainterPath _detachedPath( const QPainterPath &path )
+{
+  QPainterPath copy;
+  copy.setFillRule( path.fillRule() );
+  copy.addPath( path );
+  return copy;
+}
+
+/**
+ * Returns the outline of \a text rendered with \a font, with its baseline starting at the origin.
+ * The font is expected to already be scaled for the render context, so it carries the format and scale.
+ */
+static QPainterPath _textPath( const QFont &font, const QString &text )
+{
+  const QgsTextPathKey key( text, font );
+  QgsTextPathCache *cache = sTextPathCache();
+  QMutexLocker locker( &cache->mutex );
+  if ( const QPainterPath *cached = cache->paths.object( key ) )
+    return _detachedPath( *cached );
+  locker.unlock();
+
+  QPainterPath path;
+  path.setFillRule( Qt::WindingFill );
+  path.addText( 0, 0, font, text );
+  QPainterPath *cachedPath = new QPainterPath( _detachedPath( path ) );
+
+  locker.relock();
+  cache->paths.insert( key, cachedPath, std::max( 1, path.elementCount() ) );
+  return path;
+}
+
+/**
+ * Returns the outline of a buffer around \a text rendered with \a font, i.e. the area covered
+ * by the stroke of the text path with a pen of the given \a penWidth and \a joinStyle.
+ */
+static QPainterPath _textBufferPath( const QFont &font, const QString &text, double penWidth, Qt::PenJoinStyle joinStyle )
+{
+  const QgsTextBufferPathKey key { text, font, penWidth, joinStyle };
+  QgsTextPathCache *cache = sTextPathCache();
+  QMutexLocker locker( &cache->mutex );
+  if ( const QPainterPath *cached = cache->bufferPaths.object( key ) )
+    return _detachedPath( *cached );
+  locker.unlock();
+
+  // same stroke as the one QPainter would draw with a pen
+  const QPen pen;
+  QPainterPathStroker stroker;
+  stroker.setWidth( penWidth );
+  stroker.setJoinStyle( joinStyle );
+  stroker.setCapStyle( pen.capStyle() );
+  stroker.setMiterLimit( pen.miterLimit() );
+  const QPainterPath path = stroker.createStroke( _textPath( font, text ) );
+  QPainterPath *cachedPath = new QPainterPath( _detachedPath( path ) );
+
+  locker.relock();
+  cache->bufferPaths.insert( key, cachedPath, std::max( 1, path.elementCount() ) );
+  return path;
+}
+
 static QColor _readColor( QgsVectorLayer *layer, const QString &property, const QColor &defaultColor = Qt::black, bool withAlpha = true )
 {
   int r = layer->customProperty( property + 'R', QVariant( defaultColor.red() ) ).toInt();
@@ -1878,6 +1986,22 @@ QFontMetricsF QgsTextRenderer::fontMetrics( QgsRenderContext &context, const Qgs
   return QFontMetricsF( format.scaledFont( context ), context.painter() ? context.painter()->device() : nullptr );
 }
 
+//! Draws a text buffer: the interior of \a path filled with \a fillColor, and its stroke with \a pen (pre-stroked in \a bufferPath if not empty)
+static void _drawBufferPath( QPainter *painter, const QPainterPath &path, const QPainterPath &bufferPath, const QPen &pen, const QColor &fillColor )
+{
+  if ( bufferPath.isEmpty() )
+  {
+    painter->setPen( pen );
+    painter->setBrush( fillColor );
+    painter->drawPath( path );
+    return;
+  }
+
+  if ( fillColor.alpha() > 0 )
+    painter->fillPath( path, fillColor );
+  painter->fillPath( bufferPath, pen.color() );
+}
+
 void QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRenderer::Component &component, const QgsTextFormat &format )
 {
   QPainter *p = context.painter();
@@ -1886,9 +2010,10 @@ void QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRender
 
   double penSize = context.convertToPainterUnits( buffer.size(), buffer.sizeUnit(), buffer.sizeMapUnitScale() );
 
-  QPainterPath path;
-  path.setFillRule( Qt::WindingFill );
-  path.addText( 0, 0, format.scaledFont( context ), component.text );
+  const QFont font = format.scaledFont( context );
+  const QPainterPath path = _textPath( font, component.text );
+  // the stroke is cached as a filled outline, a cosmetic pen depends on the painter's transform
+  const QPainterPath bufferPath = penSize > 0 ? _textBufferPath( font, component.text, penSize, buffer.joinStyle() ) : QPainterPath();
   QColor bufferColor = buffer.color();
   bufferColor.setAlphaF( buffer.opacity() );
   QPen pen( bufferColor );
@@ -1911,18 +2036,14 @@ void QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRender
     context.setPainter( &buffp );
 
     buffer.paintEffect()->begin( context );
-    context.painter()->setPen( pen );
-    context.painter()->setBrush( tmpColor );
-    context.painter()->drawPath( path );
+    _drawBufferPath( context.painter(), path, bufferPath, pen, tmpColor );
     buffer.paintEffect()->end( context );
 
     context.setPainter( p );
   }
   else
   {
-    buffp.setPen( pen );
-    buffp.setBrush( tmpColor );
-    buffp.drawPath( path );
+    _drawBufferPath( &buffp, path, bufferPath, pen, tmpColor );
   }
   buffp.end();
 
@@ -2627,9 +2748,7 @@ void QgsTextRenderer::drawTextInternal( TextPart drawType,
     else
     {
       // draw text, QPainterPath method
-      QPainterPath path;
-      path.setFillRule( Qt::WindingFill );
-      path.addText( 0, 0, format.scaledFont( context ), subComponent.text );
+      const QPainterPath path = _textPath( format.scaledFont( context ), subComponent.text );
 
       // store text's drawing in QPicture for drop shadow call
       QPicture textPict;
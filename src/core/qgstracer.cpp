@@ -23,11 +23,13 @@
 #include "qgslogger.h"
 #include "qgsvectorlayer.h"
 #include "qgsexception.h"
+#include "qgscsexception.h"
+#include "qgsspatialindex.h"
 
 #include <queue>
 #include <vector>
 
-typedef std::pair<int, double> DijkstraQueueItem; // first = vertex index, second = distance
+typedef std::pair<int, double> DijkstraQueueItem; // first = vertex index, second = distance (+ estimated remaining distance for A*)
 
 // utility comparator for queue items based on distance
 struct comp
@@ -85,6 +87,39 @@ double closestSegment( const QgsPolylineXY &pl, const QgsPointXY &pt, int &verte
   return sqrDist;
 }
 
+
+// TODO: move to geometry utils
+QgsRectangle lineBoundingBox( const QgsPolylineXY &pl )
+{
+  if ( pl.isEmpty() )
+    return QgsRectangle();
+
+  QgsRectangle bbox( pl[0], pl[0] );
+  for ( const QgsPointXY &pt : pl )
+    bbox.combineExtentWith( pt.x(), pt.y() );
+  return bbox;
+}
+
+
+// like closestSegment(), but only tells whether the point is on the line (within epsilon)
+// and does not examine the segments which are obviously too far
+bool isPointOnLine( const QgsPolylineXY &pl, const QgsPointXY &pt, double epsilon )
+{
+  double segmentPtX, segmentPtY;
+  for ( int i = 1; i < pl.count(); ++i )
+  {
+    const QgsPointXY &p0 = pl.at( i - 1 );
+    const QgsPointXY &p1 = pl.at( i );
+    if ( pt.x() < std::min( p0.x(), p1.x() ) - epsilon || pt.x() > std::max( p0.x(), p1.x() ) + epsilon ||
+         pt.y() < std::min( p0.y(), p1.y() ) - epsilon || pt.y() > std::max( p0.y(), p1.y() ) + epsilon )
+      continue;
+
+    if ( QgsGeometryUtils::sqrDistToLine( pt.x(), pt.y(), p0.x(), p0.y(), p1.x(), p1.y(), segmentPtX, segmentPtY, epsilon * epsilon ) == 0 )
+      return true;
+  }
+  return false;
+}
+
 /////
 
 //! Simple graph structure for shortest path search
@@ -92,15 +127,24 @@ struct QgsTracerGraph
 {
   QgsTracerGraph()  = default;
 
+  //! Identifies a feature of one of the input layers
+  typedef QPair<QgsVectorLayer *, QgsFeatureId> FeatureKey;
+
   struct E  // bidirectional edge
   {
     //! vertices that the edge connects
     int v1, v2;
     //! coordinates of the edge (including endpoints)
     QVector<QgsPointXY> coords;
+    //! length of the edge
+    double length{ 0 };
+    //! features whose linework covers the edge (empty for temporary edges)
+    QVector<FeatureKey> features;
+    //! whether the edge has been removed from the graph after an edit of its features
+    bool removed{ false };
 
     int otherVertex( int v0 ) const { return v1 == v0 ? v2 : v1; }
-    double weight() const { return distance2D( coords ); }
+    double weight() const { return length; }
   };
 
   struct V
@@ -116,6 +160,15 @@ struct QgsTracerGraph
   //! Edges of the graph
   QVector<E> e;
 
+  //! Index of vertices by their location
+  QHash<QgsPointXY, int> vertexIndex;
+  //! Indices of the edges created from each feature
+  QHash<FeatureKey, QVector<int> > featureEdges;
+  //! Spatial index of the edges (temporary edges are not indexed)
+  QgsSpatialIndex edgeIndex;
+  //! Number of edges which have been removed, but are still in the arrays
+  int removedEdges{ 0 };
+
   //! Temporarily removed edges
   QSet<int> inactiveEdges;
   //! Temporarily added vertices (for each there are two extra edges)
@@ -123,56 +176,280 @@ struct QgsTracerGraph
 };
 
 
-QgsTracerGraph *makeGraph( const QVector<QgsPolylineXY> &edges )
+int addVertex( QgsTracerGraph &g, const QgsPointXY &pt )
 {
-  QgsTracerGraph *g = new QgsTracerGraph();
-  g->joinedVertices = 0;
-  QHash<QgsPointXY, int> point2vertex;
+  // get or add vertex
+  auto it = g.vertexIndex.constFind( pt );
+  if ( it != g.vertexIndex.constEnd() )
+    return it.value();
 
-  Q_FOREACH ( const QgsPolylineXY &line, edges )
+  int vIdx = g.v.count();
+  QgsTracerGraph::V v;
+  v.pt = pt;
+  g.v.append( v );
+  g.vertexIndex.insert( pt, vIdx );
+  return vIdx;
+}
+
+
+void addEdge( QgsTracerGraph &g, const QgsPolylineXY &line, const QVector<QgsTracerGraph::FeatureKey> &features )
+{
+  if ( line.count() < 2 )
+    return;
+
+  QgsTracerGraph::E e;
+  e.v1 = addVertex( g, line[0] );
+  e.v2 = addVertex( g, line[line.count() - 1] );
+  e.coords = line;
+  e.length = distance2D( line );
+  e.features = features;
+  g.e.append( e );
+
+  // link edge to vertices and features
+  int eIdx = g.e.count() - 1;
+  g.v[e.v1].edges << eIdx;
+  g.v[e.v2].edges << eIdx;
+  for ( const QgsTracerGraph::FeatureKey &key : features )
+    g.featureEdges[key] << eIdx;
+
+  g.edgeIndex.insertFeature( eIdx, lineBoundingBox( line ) );
+}
+
+
+void removeEdge( QgsTracerGraph &g, int eIdx )
+{
+  QgsTracerGraph::E &e = g.e[eIdx];
+  if ( e.removed )
+    return;
+
+  g.v[e.v1].edges.removeAll( eIdx );
+  g.v[e.v2].edges.removeAll( eIdx );
+
+  for ( const QgsTracerGraph::FeatureKey &key : qgis::as_const( e.features ) )
   {
-    QgsPointXY p1( line[0] );
-    QgsPointXY p2( line[line.count() - 1] );
+    auto it = g.featureEdges.find( key );
+    if ( it == g.featureEdges.end() )
+      continue;
+    it->removeAll( eIdx );
+    if ( it->isEmpty() )
+      g.featureEdges.erase( it );
+  }
+
+  g.edgeIndex.deleteFeature( eIdx, lineBoundingBox( e.coords ) );
+
+  // the edge stays in the arrays so that the indices remain valid, until the graph is compacted
+  e.removed = true;
+  e.features.clear();
+  e.coords.clear();
+  g.removedEdges++;
+}
+
+
+//! Minimum number of removed edges for the graph to be compacted
+static const int COMPACT_MIN_REMOVED_EDGES = 1000;
+
+// rebuilds the graph without its removed edges once they make up half of it,
+// so that the graph does not keep growing while features are edited
+void compactGraph( QgsTracerGraph &g )
+{
+  // the indices of the temporarily added vertices and edges must remain valid
+  if ( g.joinedVertices > 0 || g.removedEdges < COMPACT_MIN_REMOVED_EDGES || g.removedEdges * 2 < g.e.count() )
+    return;
+
+  QgsTracerGraph compacted;
+  compacted.e.reserve( g.e.count() - g.removedEdges );
+  for ( const QgsTracerGraph::E &e : qgis::as_const( g.e ) )
+  {
+    if ( !e.removed )
+      addEdge( compacted, e.coords, e.features );
+  }
+  g = compacted;
+}
+
+
+// joins back the two edges at the vertex if they have been split by the linework of a removed feature
+void mergeEdgesAtVertex( QgsTracerGraph &g, int vIdx )
+{
+  const QgsTracerGraph::V &v = g.v.at( vIdx );
+  if ( v.edges.count() != 2 || v.edges[0] == v.edges[1] )
+    return;
+
+  int e1Idx = v.edges[0], e2Idx = v.edges[1];
+  const QgsTracerGraph::E &e1 = g.e.at( e1Idx );
+  const QgsTracerGraph::E &e2 = g.e.at( e2Idx );
+  if ( e1.v1 == e1.v2 || e2.v1 == e2.v2 || e1.features.isEmpty() ||
+       e1.features.count() != e2.features.count() ||
+       e1.features.toList().toSet() != e2.features.toList().toSet() )
+    return;
 
-    int v1 = -1, v2 = -1;
-    // get or add vertex 1
-    if ( point2vertex.contains( p1 ) )
-      v1 = point2vertex.value( p1 );
-    else
+  QgsPolylineXY coords1 = e1.coords;
+  if ( e1.v2 != vIdx )
+    std::reverse( coords1.begin(), coords1.end() );
+  QgsPolylineXY coords2 = e2.coords;
+  if ( e2.v1 != vIdx )
+    std::reverse( coords2.begin(), coords2.end() );
+
+  // the split point is dropped again unless it is a real vertex of the line
+  QgsPolylineXY coords = coords1;
+  double segmentPtX, segmentPtY;
+  const QgsPointXY &prev = coords1.at( coords1.count() - 2 );
+  const QgsPointXY &next = coords2.at( 1 );
+  if ( QgsGeometryUtils::sqrDistToLine( v.pt.x(), v.pt.y(), prev.x(), prev.y(), next.x(), next.y(), segmentPtX, segmentPtY, 1e-12 ) == 0 )
+    coords.remove( coords.count() - 1 );
+  coords << coords2.mid( 1 );
+
+  const QVector<QgsTracerGraph::FeatureKey> features = e1.features;
+  removeEdge( g, e1Idx );
+  removeEdge( g, e2Idx );
+  addEdge( g, coords, features );
+}
+
+
+void removeFeature( QgsTracerGraph &g, const QgsTracerGraph::FeatureKey &key )
+{
+  const QVector<int> edges = g.featureEdges.take( key );
+  QSet<int> vertices;
+  for ( int eIdx : edges )
+  {
+    QgsTracerGraph::E &e = g.e[eIdx];
+    e.features.removeAll( key );
+    // edges shared with other features are kept
+    if ( e.features.isEmpty() )
     {
-      v1 = g->v.count();
-      QgsTracerGraph::V v;
-      v.pt = p1;
-      g->v.append( v );
-      point2vertex[p1] = v1;
+      vertices << e.v1 << e.v2;
+      removeEdge( g, eIdx );
     }
+  }
+
+  for ( int vIdx : qgis::as_const( vertices ) )
+    mergeEdgesAtVertex( g, vIdx );
 
-    // get or add vertex 2
-    if ( point2vertex.contains( p2 ) )
-      v2 = point2vertex.value( p2 );
-    else
+  compactGraph( g );
+}
+
+
+/**
+ * Resolves intersections of the lines and returns the noded lines, each with the features
+ * of the input lines it lies on. Returns false if the noding failed (the lines are then returned as they are).
+ */
+bool nodeLinework( const QVector<QgsPolylineXY> &lines, const QVector< QVector<QgsTracerGraph::FeatureKey> > &lineFeatures,
+                   QVector<QgsPolylineXY> &nodedLines, QVector< QVector<QgsTracerGraph::FeatureKey> > &nodedFeatures )
+{
+  QgsMultiPolylineXY mpl;
+  mpl.reserve( lines.count() );
+  for ( const QgsPolylineXY &line : lines )
+  {
+    if ( line.count() >= 2 )
+      mpl << line;
+  }
+  if ( mpl.isEmpty() )
+    return true;
+
+  QgsMultiPolylineXY noded;
+  try
+  {
+    QgsGeometry allGeom = QgsGeometry::fromMultiPolylineXY( mpl );
+    // GEOSNode_r may throw an exception
+    geos::unique_ptr allGeomGeos( QgsGeos::asGeos( allGeom ) );
+    geos::unique_ptr allNoded( GEOSNode_r( QgsGeos::getGEOSHandler(), allGeomGeos.get() ) );
+    noded = QgsGeos::geometryFromGeos( allNoded.release() ).asMultiPolyline();
+  }
+  catch ( GEOSException &e )
+  {
+    // no big deal... we will just not have nicely noded linework, potentially
+    // missing some intersections
+    QgsDebugMsg( QString( "Tracer Noding Exception: %1" ).arg( e.what() ) );
+    nodedLines = lines;
+    nodedFeatures = lineFeatures;
+    return false;
+  }
+
+  // the noding does not tell where the output lines come from: find the input lines
+  // which contain an inner point of each output line
+  QgsSpatialIndex linesIndex;
+  for ( int i = 0; i < lines.count(); ++i )
+  {
+    if ( lines[i].count() >= 2 )
+      linesIndex.insertFeature( i, lineBoundingBox( lines[i] ) );
+  }
+
+  const double epsilon = 1e-6;
+  nodedLines.reserve( noded.count() );
+  nodedFeatures.reserve( noded.count() );
+  for ( const QgsPolylineXY &line : qgis::as_const( noded ) )
+  {
+    if ( line.count() < 2 )
+      continue;
+
+    QgsPointXY pt( ( line[0].x() + line[1].x() ) / 2, ( line[0].y() + line[1].y() ) / 2 );
+    QList<QgsFeatureId> candidates = linesIndex.intersects( QgsRectangle( pt.x() - epsilon, pt.y() - epsilon, pt.x() + epsilon, pt.y() + epsilon ) );
+    std::sort( candidates.begin(), candidates.end() );
+
+    QVector<QgsTracerGraph::FeatureKey> features;
+    for ( QgsFeatureId i : qgis::as_const( candidates ) )
     {
-      v2 = g->v.count();
-      QgsTracerGraph::V v;
-      v.pt = p2;
-      g->v.append( v );
-      point2vertex[p2] = v2;
+      if ( candidates.count() > 1 && !isPointOnLine( lines[i], pt, epsilon ) )
+        continue;
+      for ( const QgsTracerGraph::FeatureKey &key : lineFeatures[i] )
+      {
+        if ( !features.contains( key ) )
+          features << key;
+      }
     }
+    if ( features.isEmpty() && !candidates.isEmpty() )
+      features = lineFeatures[candidates.first()];  // rounding errors of the noding
+
+    nodedLines << line;
+    nodedFeatures << features;
+  }
+  return true;
+}
+
 
-    // add edge
-    QgsTracerGraph::E e;
-    e.v1 = v1;
-    e.v2 = v2;
-    e.coords = line;
-    g->e.append( e );
+/**
+ * Adds the lines to the graph, noding them with the existing edges they may intersect.
+ * Returns false if the noding failed.
+ */
+bool addLinework( QgsTracerGraph &g, const QVector<QgsPolylineXY> &lines, const QVector< QVector<QgsTracerGraph::FeatureKey> > &lineFeatures )
+{
+  if ( lines.isEmpty() )
+    return true;
 
-    // link edge to vertices
-    int eIdx = g->e.count() - 1;
-    g->v[v1].edges << eIdx;
-    g->v[v2].edges << eIdx;
+  // existing edges which may intersect the new lines are noded again together with them
+  QSet<int> crossedEdges;
+  if ( !g.e.isEmpty() )
+  {
+    for ( const QgsPolylineXY &line : lines )
+    {
+      const QList<QgsFeatureId> candidates = g.edgeIndex.intersects( lineBoundingBox( line ) );
+      for ( QgsFeatureId eIdx : candidates )
+      {
+        if ( !g.e.at( eIdx ).removed )
+          crossedEdges << eIdx;
+      }
+    }
   }
 
-  return g;
+  QVector<QgsPolylineXY> input = lines;
+  QVector< QVector<QgsTracerGraph::FeatureKey> > inputFeatures = lineFeatures;
+  for ( int eIdx : qgis::as_const( crossedEdges ) )
+  {
+    input << g.e.at( eIdx ).coords;
+    inputFeatures << g.e.at( eIdx ).features;
+  }
+
+  QVector<QgsPolylineXY> noded;
+  QVector< QVector<QgsTracerGraph::FeatureKey> > nodedFeatures;
+  bool res = nodeLinework( input, inputFeatures, noded, nodedFeatures );
+
+  for ( int eIdx : qgis::as_const( crossedEdges ) )
+    removeEdge( g, eIdx );
+
+  for ( int i = 0; i < noded.count(); ++i )
+    addEdge( g, noded[i], nodedFeatures[i] );
+
+  compactGraph( g );
+  return res;
 }
 
 
@@ -181,22 +458,26 @@ QVector<QgsPointXY> shortestPath( const QgsTracerGraph &g, int v1, int v2 )
   if ( v1 == -1 || v2 == -1 )
     return QVector<QgsPointXY>(); // invalid input
 
-  // priority queue to drive Dijkstra:
-  // first of the pair is vertex index, second is distance
+  // A* search: the straight distance to the end vertex never overestimates
+  // the remaining path length, so the first path found is the shortest one
+  const QgsPointXY &target = g.v[v2].pt;
+
+  // priority queue to drive the search:
+  // first of the pair is vertex index, second is distance + estimated remaining distance
   std::priority_queue< DijkstraQueueItem, std::vector< DijkstraQueueItem >, comp > Q;
 
-  // shortest distances to each vertex
-  QVector<double> D( g.v.count(), std::numeric_limits<double>::max() );
+  // shortest distances to each visited vertex (the search usually visits a small part of the graph)
+  QHash<int, double> D;
   D[v1] = 0;
 
-  // whether vertices have been already processed
-  QVector<bool> F( g.v.count() );
+  // vertices that have been already processed
+  QSet<int> F;
 
   // using which edge there is shortest path to each vertex
-  QVector<int> S( g.v.count(), -1 );
+  QHash<int, int> S;
 
   int u = -1;
-  Q.push( DijkstraQueueItem( v1, 0 ) );
+  Q.push( DijkstraQueueItem( v1, g.v[v1].pt.distance( target ) ) );
 
   while ( !Q.empty() )
   {
@@ -206,9 +487,10 @@ QVector<QgsPointXY> shortestPath( const QgsTracerGraph &g, int v1, int v2 )
     if ( u == v2 )
       break; // we can stop now, there won't be a shorter path
 
-    if ( F[u] )
+    if ( F.contains( u ) )
       continue;  // ignore previously added path which is actually longer
 
+    const double du = D.value( u );
     const QgsTracerGraph::V &vu = g.v[u];
     const int *vuEdges = vu.edges.constData();
     int count = vu.edges.count();
@@ -217,15 +499,18 @@ QVector<QgsPointXY> shortestPath( const QgsTracerGraph &g, int v1, int v2 )
       const QgsTracerGraph::E &edge = g.e[ vuEdges[i] ];
       int v = edge.otherVertex( u );
       double w = edge.weight();
-      if ( !F[v] && D[u] + w < D[v] )
+      if ( F.contains( v ) )
+        continue;
+      auto dv = D.find( v );
+      if ( dv == D.end() || du + w < dv.value() )
       {
         // found a shorter way to the vertex
-        D[v] = D[u] + w;
+        D[v] = du + w;
         S[v] = vuEdges[i];
-        Q.push( DijkstraQueueItem( v, D[v] ) );
+        Q.push( DijkstraQueueItem( v, du + w + g.v[v].pt.distance( target ) ) );
       }
     }
-    F[u] = true; // mark the vertex as processed (we know the fastest path to it)
+    F.insert( u ); // mark the vertex as processed (we know the fastest path to it)
   }
 
   if ( u != v2 ) // there's no path to the end vertex
@@ -235,7 +520,7 @@ QVector<QgsPointXY> shortestPath( const QgsTracerGraph &g, int v1, int v2 )
 
   QVector<QgsPointXY> points;
   QList<int> path;
-  while ( S[u] != -1 )
+  while ( S.contains( u ) )
   {
     path << S[u];
     const QgsTracerGraph::E &e = g.e[S[u]];
@@ -259,12 +544,34 @@ QVector<QgsPointXY> shortestPath( const QgsTracerGraph &g, int v1, int v2 )
 
 int point2vertex( const QgsTracerGraph &g, const QgsPointXY &pt, double epsilon = 1e-6 )
 {
-  // TODO: use spatial index
-
-  for ( int i = 0; i < g.v.count(); ++i )
+  auto isVertexAt = [&g, &pt, epsilon]( int i )
   {
     const QgsTracerGraph::V &v = g.v.at( i );
-    if ( v.pt == pt || ( std::fabs( v.pt.x() - pt.x() ) < epsilon && std::fabs( v.pt.y() - pt.y() ) < epsilon ) )
+    return v.pt == pt || ( std::fabs( v.pt.x() - pt.x() ) < epsilon && std::fabs( v.pt.y() - pt.y() ) < epsilon );
+  };
+
+  auto it = g.vertexIndex.constFind( pt );
+  if ( it != g.vertexIndex.constEnd() && !g.v.at( it.value() ).edges.isEmpty() )
+    return it.value();
+
+  // look at the end points of the edges around the point
+  QList<QgsFeatureId> candidates = g.edgeIndex.intersects( QgsRectangle( pt.x() - epsilon, pt.y() - epsilon, pt.x() + epsilon, pt.y() + epsilon ) );
+  std::sort( candidates.begin(), candidates.end() );
+  for ( QgsFeatureId eIdx : qgis::as_const( candidates ) )
+  {
+    const QgsTracerGraph::E &e = g.e.at( eIdx );
+    if ( e.removed )
+      continue;
+    if ( isVertexAt( e.v1 ) )
+      return e.v1;
+    if ( isVertexAt( e.v2 ) )
+      return e.v2;
+  }
+
+  // temporarily added vertices are not indexed
+  for ( int i = g.v.count() - g.joinedVertices; i < g.v.count(); ++i )
+  {
+    if ( isVertexAt( i ) )
       return i;
   }
 
@@ -276,12 +583,24 @@ int point2edge( const QgsTracerGraph &g, const QgsPointXY &pt, int &lineVertexAf
 {
   int vertexAfter;
 
-  for ( int i = 0; i < g.e.count(); ++i )
+  // epsilon is used for squared distances
+  const double tolerance = std::sqrt( epsilon );
+  QList<QgsFeatureId> candidates = g.edgeIndex.intersects( QgsRectangle( pt.x() - tolerance, pt.y() - tolerance, pt.x() + tolerance, pt.y() + tolerance ) );
+  std::sort( candidates.begin(), candidates.end() );
+
+  // temporarily added edges are not indexed
+  for ( int i = g.e.count() - g.joinedVertices * 2; i < g.e.count(); ++i )
+    candidates << i;
+
+  for ( QgsFeatureId i : qgis::as_const( candidates ) )
   {
     if ( g.inactiveEdges.contains( i ) )
       continue;  // ignore temporarily disabled edges
 
     const QgsTracerGraph::E &e = g.e.at( i );
+    if ( e.removed )
+      continue;
+
     double dist = closestSegment( e.coords, pt, vertexAfter, epsilon );
     if ( dist == 0 )
     {
@@ -342,11 +661,13 @@ int joinVertexToGraph( QgsTracerGraph &g, const QgsPointXY &pt )
   e1.v1 = e.v1;
   e1.v2 = vIdx;
   e1.coords = out1;
+  e1.length = distance2D( out1 );
 
   QgsTracerGraph::E e2;
   e2.v1 = vIdx;
   e2.v2 = e.v2;
   e2.coords = out2;
+  e2.length = distance2D( out2 );
 
   // update edge connectivity of existing vertices
   v1.edges.replace( v1.edges.indexOf( eIdx ), e1Idx );
@@ -455,21 +776,99 @@ void extractLinework( const QgsGeometry &g, QgsMultiPolylineXY &mpl )
 
 QgsTracer::QgsTracer() = default;
 
+//! Maximum number of tiles covering the extent, beyond which the graph is built again with bigger tiles
+static const qint64 MAX_EXTENT_TILES = 64;
+
+//! Returns the range of the tiles of size \a tileSize covering \a rect
+static void tileRange( const QgsRectangle &rect, double tileSize, qint64 &xMin, qint64 &yMin, qint64 &xMax, qint64 &yMax )
+{
+  xMin = static_cast< qint64 >( std::floor( rect.xMinimum() / tileSize ) );
+  yMin = static_cast< qint64 >( std::floor( rect.yMinimum() / tileSize ) );
+  xMax = static_cast< qint64 >( std::floor( rect.xMaximum() / tileSize ) );
+  yMax = static_cast< qint64 >( std::floor( rect.yMaximum() / tileSize ) );
+}
+
 bool QgsTracer::initGraph()
 {
   if ( mGraph )
-    return true; // already initialized
+  {
+    if ( mTileSize == 0 )
+      return true; // already initialized with all the features
+
+    if ( !mExtent.isEmpty() && ( mMaxFeatureCount == 0 || mGraph->featureEdges.count() < mMaxFeatureCount ) )
+    {
+      qint64 xMin, yMin, xMax, yMax;
+      tileRange( mExtent, mTileSize, xMin, yMin, xMax, yMax );
+      if ( ( xMax - xMin + 1 ) * ( yMax - yMin + 1 ) <= MAX_EXTENT_TILES )
+      {
+        // extend the graph with the tiles which have not been loaded yet
+        QList< QPair< qint64, qint64 > > missingTiles;
+        QgsRectangle missingRect;
+        for ( qint64 x = xMin; x <= xMax; ++x )
+        {
+          for ( qint64 y = yMin; y <= yMax; ++y )
+          {
+            if ( mLoadedTiles.contains( qMakePair( x, y ) ) )
+              continue;
+
+            QgsRectangle tileRect( x * mTileSize, y * mTileSize, ( x + 1 ) * mTileSize, ( y + 1 ) * mTileSize );
+            if ( mLoadedExtent.contains( tileRect.intersect( mExtent ) ) )
+              continue;  // the needed part of the tile was loaded when the graph was built
+            if ( missingTiles.isEmpty() )
+              missingRect = tileRect;
+            else
+              missingRect.combineExtentWith( tileRect );
+            missingTiles << qMakePair( x, y );
+          }
+        }
+
+        if ( missingTiles.isEmpty() )
+          return true;
+
+        if ( !addFeaturesToGraph( missingRect ) )
+        {
+          mGraph.reset();
+          return false;
+        }
+
+        for ( const QPair< qint64, qint64 > &tile : qgis::as_const( missingTiles ) )
+          mLoadedTiles.insert( tile );
+        return true;
+      }
+    }
+
+    // the graph got too big or its tiles too small for the current extent: start again
+    mGraph.reset();
+  }
 
   mHasTopologyProblem = false;
+  mLoadedTiles.clear();
+  mLoadedExtent = mExtent;
+  // tiles are loaded when the extent gets extended, they are small enough
+  // for a pan to only load a strip along the border of the extent
+  mTileSize = mExtent.isEmpty() ? 0 : std::max( mExtent.width(), mExtent.height() ) / 4;
+
+  mGraph = qgis::make_unique< QgsTracerGraph >();
+  if ( !addFeaturesToGraph( mExtent ) )
+  {
+    mGraph.reset();
+    return false;
+  }
+
+  return true;
+}
 
+bool QgsTracer::addFeaturesToGraph( const QgsRectangle &extent )
+{
   QgsFeature f;
-  QgsMultiPolylineXY mpl;
+  QVector<QgsPolylineXY> lines;
+  QVector< QVector<QgsTracerGraph::FeatureKey> > lineFeatures;
 
   // extract linestrings
 
   // TODO: use QgsPointLocator as a source for the linework
 
-  QTime t1, t2, t2a, t3;
+  QTime t1, t2;
 
   t1.start();
   int featuresCounted = 0;
@@ -478,8 +877,8 @@ bool QgsTracer::initGraph()
     QgsFeatureRequest request;
     request.setSubsetOfAttributes( QgsAttributeList() );
     request.setDestinationCrs( mCRS, mTransformContext );
-    if ( !mExtent.isEmpty() )
-      request.setFilterRect( mExtent );
+    if ( !extent.isEmpty() )
+      request.setFilterRect( extent );
 
     QgsFeatureIterator fi = vl->getFeatures( request );
     while ( fi.nextFeature( f ) )
@@ -487,7 +886,17 @@ bool QgsTracer::initGraph()
       if ( !f.hasGeometry() )
         continue;
 
+      const QgsTracerGraph::FeatureKey key( vl, f.id() );
+      if ( mGraph->featureEdges.contains( key ) )
+        continue;  // already loaded with another tile
+
+      QgsMultiPolylineXY mpl;
       extractLinework( f.geometry(), mpl );
+      for ( const QgsPolylineXY &line : qgis::as_const( mpl ) )
+      {
+        lines << line;
+        lineFeatures << ( QVector<QgsTracerGraph::FeatureKey>() << key );
+      }
 
       ++featuresCounted;
       if ( mMaxFeatureCount != 0 && featuresCounted >= mMaxFeatureCount )
@@ -496,55 +905,51 @@ bool QgsTracer::initGraph()
   }
   int timeExtract = t1.elapsed();
 
-  // resolve intersections
+  // resolve intersections and add the edges
 
   t2.start();
 
-  int timeNodingCall = 0;
-
-#if 0
-  // without noding - if data are known to be noded beforehand
-#else
-  QgsGeometry allGeom = QgsGeometry::fromMultiPolylineXY( mpl );
+  if ( !addLinework( *mGraph, lines, lineFeatures ) )
+    mHasTopologyProblem = true;
 
-  try
-  {
-    t2a.start();
-    // GEOSNode_r may throw an exception
-    geos::unique_ptr allGeomGeos( QgsGeos::asGeos( allGeom ) );
-    geos::unique_ptr allNoded( GEOSNode_r( QgsGeos::getGEOSHandler(), allGeomGeos.get() ) );
-    timeNodingCall = t2a.elapsed();
+  int timeMake = t2.elapsed();
 
-    QgsGeometry noded = QgsGeos::geometryFromGeos( allNoded.release() );
+  Q_UNUSED( timeExtract );
+  Q_UNUSED( timeMake );
+  QgsDebugMsg( QString( "tracer extract %1 ms, noding and make %2 ms (%3 features)" )
+               .arg( timeExtract ).arg( timeMake ).arg( featuresCounted ) );
+  return true;
+}
 
-    mpl = noded.asMultiPolyline();
-  }
-  catch ( GEOSException &e )
-  {
-    // no big deal... we will just not have nicely noded linework, potentially
-    // missing some intersections
+void QgsTracer::updateFeatureInGraph( QgsVectorLayer *layer, QgsFeatureId fid, const QgsGeometry &geometry )
+{
+  const QgsTracerGraph::FeatureKey key( layer, fid );
+  removeFeature( *mGraph, key );
 
-    mHasTopologyProblem = true;
+  if ( geometry.isNull() )
+    return;
 
-    QgsDebugMsg( QString( "Tracer Noding Exception: %1" ).arg( e.what() ) );
+  QgsGeometry geom = geometry;
+  if ( mCRS.isValid() && layer->crs() != mCRS )
+  {
+    try
+    {
+      geom.transform( QgsCoordinateTransform( layer->crs(), mCRS, mTransformContext ) );
+    }
+    catch ( QgsCsException &e )
+    {
+      Q_UNUSED( e );
+      QgsDebugMsg( QStringLiteral( "could not transform geometry to tracer CRS, skipping it (%1)" ).arg( e.what() ) );
+      return;
+    }
   }
-#endif
 
-  int timeNoding = t2.elapsed();
-
-  t3.start();
-
-  mGraph.reset( makeGraph( mpl ) );
-
-  int timeMake = t3.elapsed();
+  QgsMultiPolylineXY mpl;
+  extractLinework( geom, mpl );
 
-  Q_UNUSED( timeExtract );
-  Q_UNUSED( timeNoding );
-  Q_UNUSED( timeNodingCall );
-  Q_UNUSED( timeMake );
-  QgsDebugMsg( QString( "tracer extract %1 ms, noding %2 ms (call %3 ms), make %4 ms" )
-               .arg( timeExtract ).arg( timeNoding ).arg( timeNodingCall ).arg( timeMake ) );
-  return true;
+  QVector< QVector<QgsTracerGraph::FeatureKey> > lineFeatures( mpl.count(), QVector<QgsTracerGraph::FeatureKey>() << key );
+  if ( !addLinework( *mGraph, mpl, lineFeatures ) )
+    mHasTopologyProblem = true;
 }
 
 QgsTracer::~QgsTracer()
@@ -562,6 +967,7 @@ void QgsTracer::setLayers( const QList<QgsVectorLayer *> &layers )
     disconnect( layer, &QgsVectorLayer::featureAdded, this, &QgsTracer::onFeatureAdded );
     disconnect( layer, &QgsVectorLayer::featureDeleted, this, &QgsTracer::onFeatureDeleted );
     disconnect( layer, &QgsVectorLayer::geometryChanged, this, &QgsTracer::onGeometryChanged );
+    disconnect( layer, &QgsVectorLayer::editingStopped, this, &QgsTracer::invalidateGraph );
     disconnect( layer, &QObject::destroyed, this, &QgsTracer::onLayerDestroyed );
   }
 
@@ -572,6 +978,8 @@ void QgsTracer::setLayers( const QList<QgsVectorLayer *> &layers )
     connect( layer, &QgsVectorLayer::featureAdded, this, &QgsTracer::onFeatureAdded );
     connect( layer, &QgsVectorLayer::featureDeleted, this, &QgsTracer::onFeatureDeleted );
     connect( layer, &QgsVectorLayer::geometryChanged, this, &QgsTracer::onGeometryChanged );
+    // committed features get new ids
+    connect( layer, &QgsVectorLayer::editingStopped, this, &QgsTracer::invalidateGraph );
     connect( layer, &QObject::destroyed, this, &QgsTracer::onLayerDestroyed );
   }
 
@@ -590,8 +998,8 @@ void QgsTracer::setExtent( const QgsRectangle &extent )
   if ( mExtent == extent )
     return;
 
+  // the graph is extended lazily when needed
   mExtent = extent;
-  invalidateGraph();
 }
 
 void QgsTracer::setOffset( double offset )
@@ -615,12 +1023,13 @@ void QgsTracer::setOffsetParameters( int quadSegments, int joinStyle, double mit
 
 bool QgsTracer::init()
 {
-  if ( mGraph )
-    return true;
-
-  // configuration from derived class?
-  configure();
+  if ( !mGraph )
+  {
+    // configuration from derived class?
+    configure();
+  }
 
+  // builds the graph or extends it to the current extent
   return initGraph();
 }
 
@@ -632,21 +1041,31 @@ void QgsTracer::invalidateGraph()
 
 void QgsTracer::onFeatureAdded( QgsFeatureId fid )
 {
-  Q_UNUSED( fid );
-  invalidateGraph();
+  QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !mGraph || !vl )
+    return;
+
+  QgsFeature f;
+  if ( vl->getFeatures( QgsFeatureRequest( fid ).setSubsetOfAttributes( QgsAttributeList() ) ).nextFeature( f ) )
+    updateFeatureInGraph( vl, fid, f.geometry() );
 }
 
 void QgsTracer::onFeatureDeleted( QgsFeatureId fid )
 {
-  Q_UNUSED( fid );
-  invalidateGraph();
+  QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !mGraph || !vl )
+    return;
+
+  removeFeature( *mGraph, QgsTracerGraph::FeatureKey( vl, fid ) );
 }
 
 void QgsTracer::onGeometryChanged( QgsFeatureId fid, const QgsGeometry &geom )
 {
-  Q_UNUSED( fid );
-  Q_UNUSED( geom );
-  invalidateGraph();
+  QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !mGraph || !vl )
+    return;
+
+  updateFeatureInGraph( vl, fid, geom );
 }
 
 void QgsTracer::onLayerDestroyed( QObject *obj )
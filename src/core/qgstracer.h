@@ -19,6 +19,7 @@
 class QgsVectorLayer;
 
 #include "qgis_core.h"
+#include <QPair>
 #include <QSet>
 #include <QVector>
 #include <memory>
@@ -35,6 +36,10 @@ struct QgsTracerGraph;
  * layers and provides shortest path search for tracing of existing
  * features.
  *
+ * The graph is updated incrementally when features of the input layers are
+ * added, deleted or changed. When an extent is set, the graph is built tile by tile
+ * and gets extended to the new tiles when the extent changes.
+ *
  * \since QGIS 2.14
  */
 class CORE_EXPORT QgsTracer : public QObject
@@ -67,7 +72,11 @@ class CORE_EXPORT QgsTracer : public QObject
 
     //! Gets extent to which graph's features will be limited (empty extent means no limit)
     QgsRectangle extent() const { return mExtent; }
-    //! Sets extent to which graph's features will be limited (empty extent means no limit)
+
+    /**
+     * Sets extent to which graph's features will be limited (empty extent means no limit).
+     * The existing graph is not discarded: it gets extended to the new extent when needed.
+     */
     void setExtent( const QgsRectangle &extent );
 
     /**
@@ -96,13 +105,20 @@ class CORE_EXPORT QgsTracer : public QObject
      */
     void setOffsetParameters( int quadSegments, int joinStyle, double miterLimit );
 
-    //! Gets maximum possible number of features in graph. If the number is exceeded, graph is not created.
+    /**
+     * Gets maximum possible number of features loaded at once in graph. If the number is exceeded when the graph
+     * is created or extended to a new extent, graph is not created.
+     */
     int maxFeatureCount() const { return mMaxFeatureCount; }
-    //! Gets maximum possible number of features in graph. If the number is exceeded, graph is not created.
+
+    /**
+     * Sets maximum possible number of features loaded at once in graph. If the number is exceeded when the graph
+     * is created or extended to a new extent, graph is not created.
+     */
     void setMaxFeatureCount( int count ) { mMaxFeatureCount = count; }
 
     /**
-     * Build the internal data structures. This may take some time
+     * Build the internal data structures, or extend them to the current extent. This may take some time
      * depending on how big the input layers are. It is not necessary
      * to call this method explicitly - it will be called by findShortestPath()
      * if necessary.
@@ -154,6 +170,10 @@ class CORE_EXPORT QgsTracer : public QObject
 
   private:
     bool initGraph();
+    //! Adds to the graph the features intersecting \a extent which are not in it yet
+    bool addFeaturesToGraph( const QgsRectangle &extent );
+    //! Replaces the linework of a feature of \a layer in the graph
+    void updateFeatureInGraph( QgsVectorLayer *layer, QgsFeatureId fid, const QgsGeometry &geometry );
 
   private slots:
     void onFeatureAdded( QgsFeatureId fid );
@@ -172,6 +192,12 @@ class CORE_EXPORT QgsTracer : public QObject
     QgsCoordinateTransformContext mTransformContext;
     //! Extent for graph building (empty extent means no limit)
     QgsRectangle mExtent;
+    //! Size of the tiles loaded in the graph (0 if the graph was built without extent)
+    double mTileSize = 0;
+    //! Extent loaded when the graph was built
+    QgsRectangle mLoadedExtent;
+    //! Tiles loaded since the graph was built
+    QSet< QPair< qint64, qint64 > > mLoadedTiles;
 
     //! Offset in map units that should be applied to the traced paths
     double mOffset = 0;
@@ -53,6 +53,9 @@
 #include <cpl_string.h>
 #include <gdal.h>
 
+//! Number of features written in each transaction, same as the ogr2ogr default
+static const int FEATURES_PER_TRANSACTION = 100000;
+
 // Thin wrapper around OGROpen() to workaround a bug in GDAL < 2.3.1
 // where a existing BNA file is wrongly reported to be openable in update mode
 // but attempting to add features in it crashes the BNA driver.
@@ -1991,17 +1994,39 @@ bool QgsVectorFileWriter::addFeature( QgsFeature &feature, QgsFeatureSink::Flags
 
 bool QgsVectorFileWriter::addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags )
 {
-  QgsFeatureList::iterator fIt = features.begin();
-  bool result = true;
-  for ( ; fIt != features.end(); ++fIt )
+  if ( mSymbologyExport == SymbolLayerSymbology )
   {
-    result = result && addFeatureWithStyle( *fIt, nullptr, QgsUnitTypes::DistanceMeters );
+    QgsFeatureList::iterator fIt = features.begin();
+    bool result = true;
+    for ( ; fIt != features.end(); ++fIt )
+    {
+      result = result && addFeatureWithStyle( *fIt, nullptr, QgsUnitTypes::DistanceMeters );
+    }
+    return result;
   }
-  return result;
+
+  QgsLocaleNumC l; // Make sure the decimal delimiter is a dot
+  Q_UNUSED( l );
+
+  QgsFeatureList::const_iterator fIt = features.constBegin();
+  for ( ; fIt != features.constEnd(); ++fIt )
+  {
+    if ( !writeReusableFeature( *fIt ) )
+      return false;
+  }
+  return true;
 }
 
 bool QgsVectorFileWriter::addFeatureWithStyle( QgsFeature &feature, QgsFeatureRenderer *renderer, QgsUnitTypes::DistanceUnit outputUnit )
 {
+  if ( mSymbologyExport == NoSymbology || ( mSymbologyExport == FeatureSymbology && !renderer ) )
+  {
+    // no style string, the OGR feature can be reused
+    QgsLocaleNumC l; // Make sure the decimal delimiter is a dot
+    Q_UNUSED( l );
+    return writeReusableFeature( feature );
+  }
+
   // create the feature
   gdal::ogr_feature_unique_ptr poFeature = createFeature( feature );
   if ( !poFeature )
@@ -2072,12 +2097,30 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
   Q_UNUSED( l );
 
   gdal::ogr_feature_unique_ptr poFeature( OGR_F_Create( OGR_L_GetLayerDefn( mLayer ) ) );
+  if ( !populateFeature( poFeature.get(), feature ) )
+    return nullptr;
+
+  return poFeature;
+}
+
+bool QgsVectorFileWriter::writeReusableFeature( const QgsFeature &feature )
+{
+  if ( !mReusableFeature )
+    mReusableFeature.reset( OGR_F_Create( OGR_L_GetLayerDefn( mLayer ) ) );
+
+  return populateFeature( mReusableFeature.get(), feature ) && writeFeature( mLayer, mReusableFeature.get() );
+}
+
+bool QgsVectorFileWriter::populateFeature( OGRFeatureH ogrFeature, const QgsFeature &feature )
+{
+  // the feature may have been written before, which assigned it a FID
+  OGR_F_SetFID( ogrFeature, OGRNullFID );
 
   qint64 fid = FID_TO_NUMBER( feature.id() );
   if ( fid > std::numeric_limits<int>::max() )
   {
     QgsDebugMsg( QString( "feature id %1 too large." ).arg( fid ) );
-    OGRErr err = OGR_F_SetFID( poFeature.get(), static_cast<long>( fid ) );
+    OGRErr err = OGR_F_SetFID( ogrFeature, static_cast<long>( fid ) );
     if ( err != OGRERR_NONE )
     {
       QgsDebugMsg( QString( "Failed to set feature id to %1: %2 (OGR error: %3)" )
@@ -2106,7 +2149,9 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
 // field to not be present at all in the output, and thus on reading to
 // have disappeared. #16812
 #ifdef OGRNullMarker
-      OGR_F_SetFieldNull( poFeature.get(), ogrField );
+      OGR_F_SetFieldNull( ogrFeature, ogrField );
+#else
+      OGR_F_UnsetField( ogrFeature, ogrField );
 #endif
       continue;
     }
@@ -2120,22 +2165,22 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
     switch ( field.type() )
     {
       case QVariant::Int:
-        OGR_F_SetFieldInteger( poFeature.get(), ogrField, attrValue.toInt() );
+        OGR_F_SetFieldInteger( ogrFeature, ogrField, attrValue.toInt() );
         break;
       case QVariant::LongLong:
-        OGR_F_SetFieldInteger64( poFeature.get(), ogrField, attrValue.toLongLong() );
+        OGR_F_SetFieldInteger64( ogrFeature, ogrField, attrValue.toLongLong() );
         break;
       case QVariant::Bool:
-        OGR_F_SetFieldInteger( poFeature.get(), ogrField, attrValue.toInt() );
+        OGR_F_SetFieldInteger( ogrFeature, ogrField, attrValue.toInt() );
         break;
       case QVariant::String:
-        OGR_F_SetFieldString( poFeature.get(), ogrField, mCodec->fromUnicode( attrValue.toString() ).constData() );
+        OGR_F_SetFieldString( ogrFeature, ogrField, mCodec->fromUnicode( attrValue.toString() ).constData() );
         break;
       case QVariant::Double:
-        OGR_F_SetFieldDouble( poFeature.get(), ogrField, attrValue.toDouble() );
+        OGR_F_SetFieldDouble( ogrFeature, ogrField, attrValue.toDouble() );
         break;
       case QVariant::Date:
-        OGR_F_SetFieldDateTime( poFeature.get(), ogrField,
+        OGR_F_SetFieldDateTime( ogrFeature, ogrField,
                                 attrValue.toDate().year(),
                                 attrValue.toDate().month(),
                                 attrValue.toDate().day(),
@@ -2144,11 +2189,11 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
       case QVariant::DateTime:
         if ( mOgrDriverName == QLatin1String( "ESRI Shapefile" ) )
         {
-          OGR_F_SetFieldString( poFeature.get(), ogrField, mCodec->fromUnicode( attrValue.toDateTime().toString( QStringLiteral( "yyyy/MM/dd hh:mm:ss.zzz" ) ) ).constData() );
+          OGR_F_SetFieldString( ogrFeature, ogrField, mCodec->fromUnicode( attrValue.toDateTime().toString( QStringLiteral( "yyyy/MM/dd hh:mm:ss.zzz" ) ) ).constData() );
         }
         else
         {
-          OGR_F_SetFieldDateTime( poFeature.get(), ogrField,
+          OGR_F_SetFieldDateTime( ogrFeature, ogrField,
                                   attrValue.toDateTime().date().year(),
                                   attrValue.toDateTime().date().month(),
                                   attrValue.toDateTime().date().day(),
@@ -2161,11 +2206,11 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
       case QVariant::Time:
         if ( mOgrDriverName == QLatin1String( "ESRI Shapefile" ) )
         {
-          OGR_F_SetFieldString( poFeature.get(), ogrField, mCodec->fromUnicode( attrValue.toString() ).constData() );
+          OGR_F_SetFieldString( ogrFeature, ogrField, mCodec->fromUnicode( attrValue.toString() ).constData() );
         }
         else
         {
-          OGR_F_SetFieldDateTime( poFeature.get(), ogrField,
+          OGR_F_SetFieldDateTime( ogrFeature, ogrField,
                                   0, 0, 0,
                                   attrValue.toTime().hour(),
                                   attrValue.toTime().minute(),
@@ -2174,6 +2219,7 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         }
         break;
       case QVariant::Invalid:
+        OGR_F_UnsetField( ogrFeature, ogrField );
         break;
       default:
         mErrorMessage = QObject::tr( "Invalid variant type for field %1[%2]: received %3 with type %4" )
@@ -2183,7 +2229,7 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
                               attrValue.toString() );
         QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
         mError = ErrFeatureWriteFailed;
-        return nullptr;
+        return false;
     }
   }
 
@@ -2240,7 +2286,7 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
                           .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           mError = ErrFeatureWriteFailed;
           QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-          return nullptr;
+          return false;
         }
 
         QByteArray wkb( geom.asWkb() );
@@ -2251,16 +2297,25 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
                           .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           mError = ErrFeatureWriteFailed;
           QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-          return nullptr;
+          return false;
         }
 
         // pass ownership to geometry
-        OGR_F_SetGeometryDirectly( poFeature.get(), mGeom2 );
+        OGR_F_SetGeometryDirectly( ogrFeature, mGeom2 );
       }
       else // wkb type matches
       {
         QByteArray wkb( geom.asWkb() );
-        OGRGeometryH ogrGeom = createEmptyGeometry( mWkbType );
+
+        // reuse the geometry of a reused feature, it is emptied by the import
+        OGRGeometryH ogrGeom = OGR_F_GetGeometryRef( ogrFeature );
+        if ( !ogrGeom || OGR_G_GetGeometryType( ogrGeom ) != ogrTypeFromWkbType( mWkbType ) )
+        {
+          ogrGeom = createEmptyGeometry( mWkbType );
+          // set geometry (ownership is passed to OGR)
+          OGR_F_SetGeometryDirectly( ogrFeature, ogrGeom );
+        }
+
         OGRErr err = OGR_G_ImportFromWkb( ogrGeom, reinterpret_cast<unsigned char *>( const_cast<char *>( wkb.constData() ) ), wkb.length() );
         if ( err != OGRERR_NONE )
         {
@@ -2268,19 +2323,16 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
                           .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           mError = ErrFeatureWriteFailed;
           QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-          return nullptr;
+          return false;
         }
-
-        // set geometry (ownership is passed to OGR)
-        OGR_F_SetGeometryDirectly( poFeature.get(), ogrGeom );
       }
     }
     else
     {
-      OGR_F_SetGeometryDirectly( poFeature.get(), createEmptyGeometry( mWkbType ) );
+      OGR_F_SetGeometryDirectly( ogrFeature, createEmptyGeometry( mWkbType ) );
     }
   }
-  return poFeature;
+  return true;
 }
 
 void QgsVectorFileWriter::resetMap( const QgsAttributeList &attributes )
@@ -2303,6 +2355,20 @@ bool QgsVectorFileWriter::writeFeature( OGRLayerH layer, OGRFeatureH feature )
     QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
     return false;
   }
+
+  // commit regularly, like ogr2ogr does, so that the size of pending changes stays bounded
+  if ( mUsingTransaction && ++mFeaturesInTransaction >= FEATURES_PER_TRANSACTION )
+  {
+    mFeaturesInTransaction = 0;
+    if ( OGRERR_NONE != OGR_L_CommitTransaction( layer ) )
+    {
+      QgsDebugMsg( "Error while committing transaction on OGRLayer." );
+    }
+    if ( OGRERR_NONE != OGR_L_StartTransaction( layer ) )
+    {
+      mUsingTransaction = false;
+    }
+  }
   return true;
 }
 
@@ -2316,6 +2382,7 @@ QgsVectorFileWriter::~QgsVectorFileWriter()
     }
   }
 
+  mReusableFeature.reset();
   mDS.reset();
 
   if ( mOgrRef )
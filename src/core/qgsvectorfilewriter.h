@@ -888,8 +888,24 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
 
     bool mUsingTransaction = false;
 
+    //! Number of features written since the current transaction was started
+    int mFeaturesInTransaction = 0;
+
+    //! OGR feature reused for features written without a style string
+    gdal::ogr_feature_unique_ptr mReusableFeature;
+
     void createSymbolLayerTable( QgsVectorLayer *vl, const QgsCoordinateTransform &ct, OGRDataSourceH ds );
     gdal::ogr_feature_unique_ptr createFeature( const QgsFeature &feature );
+
+    /**
+     * Sets the FID, attributes and geometry of \a ogrFeature from \a feature. The feature
+     * may have been populated before, the previous values are all overwritten.
+     * The C numeric locale must be set by the caller.
+     */
+    bool populateFeature( OGRFeatureH ogrFeature, const QgsFeature &feature );
+
+    //! Writes \a feature with the reused OGR feature
+    bool writeReusableFeature( const QgsFeature &feature );
     bool writeFeature( OGRLayerH layer, OGRFeatureH feature );
 
     //! Writes features considering symbol level order
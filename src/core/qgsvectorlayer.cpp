@@ -78,6 +78,7 @@
 #include "qgsvectorlayerjoinbuffer.h"
 #include "qgsvectorlayerlabeling.h"
 #include "qgsvectorlayerrenderer.h"
+#include "qgsvectorlayerrendercache_p.h"
 #include "qgsvectorlayerundocommand.h"
 #include "qgsvectorlayerfeaturecounter.h"
 #include "qgspoint.h"
@@ -171,6 +172,24 @@ QgsVectorLayer::QgsVectorLayer( const QString &vectorLayerPath,
 
   connect( this, &QgsVectorLayer::subsetStringChanged, this, &QgsMapLayer::configChanged );
 
+  // features kept by the render cache are outdated as soon as the data changes
+  auto invalidateRenderCache = [ = ]
+  {
+    if ( mRenderCache )
+      mRenderCache->invalidate();
+  };
+  connect( this, &QgsVectorLayer::dataChanged, this, invalidateRenderCache );
+  connect( this, &QgsVectorLayer::layerModified, this, invalidateRenderCache );
+  connect( this, &QgsVectorLayer::editingStopped, this, invalidateRenderCache );
+  connect( this, &QgsVectorLayer::subsetStringChanged, this, invalidateRenderCache );
+  connect( this, &QgsVectorLayer::updatedFields, this, invalidateRenderCache );
+  // deferred repaints come from the auto refresh of layers whose data changes outside of QGIS
+  connect( this, &QgsMapLayer::repaintRequested, this, [ = ]( bool deferredUpdate )
+  {
+    if ( deferredUpdate )
+      invalidateRenderCache();
+  } );
+
   // Default simplify drawing settings
   QgsSettings settings;
   mSimplifyMethod.setSimplifyHints( settings.flagValue( QStringLiteral( "qgis/simplifyDrawingHints" ), mSimplifyMethod.simplifyHints(), QgsSettings::NoSection ) );
@@ -230,6 +249,7 @@ QgsVectorLayer *QgsVectorLayer::clone() const
   layer->setFeatureBlendMode( featureBlendMode() );
   layer->setOpacity( opacity() );
   layer->setReadExtentFromXml( readExtentFromXml() );
+  layer->setRenderCacheEnabled( renderCacheEnabled() );
 
   Q_FOREACH ( const QgsAction &action, actions()->actions() )
   {
@@ -338,6 +358,9 @@ void QgsVectorLayer::reload()
     mDataProvider->reloadData();
     updateFields();
   }
+  // not all providers notify data changes when reloaded
+  if ( mRenderCache )
+    mRenderCache->invalidate();
 }
 
 QgsMapLayerRenderer *QgsVectorLayer::createMapRenderer( QgsRenderContext &rendererContext )
@@ -1459,6 +1482,8 @@ bool QgsVectorLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &c
     legend->readXml( legendElem, context );
   setLegend( legend );
 
+  setRenderCacheEnabled( layer_node.toElement().attribute( QStringLiteral( "renderCache" ) ) == QLatin1String( "1" ) );
+
   // read extent
   if ( mReadExtentFromXml )
   {
@@ -1580,7 +1605,10 @@ bool QgsVectorLayer::setDataProvider( QString const &provider, const QgsDataProv
   }
 
   delete mDataProvider;
-  mDataProvider = qobject_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider( provider, dataSource, options ) );
+  QgsDataProvider *dataProvider = takePreloadedProvider( provider, dataSource );
+  if ( !dataProvider )
+    dataProvider = QgsProviderRegistry::instance()->createProvider( provider, dataSource, options );
+  mDataProvider = qobject_cast<QgsVectorDataProvider *>( dataProvider );
   if ( !mDataProvider )
   {
     QgsDebugMsgLevel( QStringLiteral( "Unable to get data provider" ), 2 );
@@ -1695,6 +1723,9 @@ bool QgsVectorLayer::writeXml( QDomNode &layer_node,
   // set the geometry type
   mapLayerNode.setAttribute( QStringLiteral( "geometry" ), QgsWkbTypes::geometryDisplayString( geometryType() ) );
 
+  if ( mRenderCache )
+    mapLayerNode.setAttribute( QStringLiteral( "renderCache" ), QStringLiteral( "1" ) );
+
   // add provider node
   if ( mDataProvider )
   {
@@ -4806,6 +4837,22 @@ bool QgsVectorLayer::readExtentFromXml() const
   return mReadExtentFromXml;
 }
 
+void QgsVectorLayer::setRenderCacheEnabled( bool enabled )
+{
+  if ( enabled == renderCacheEnabled() )
+    return;
+
+  if ( enabled )
+    mRenderCache = std::make_shared<QgsVectorLayerRenderCache>();
+  else
+    mRenderCache.reset();
+}
+
+bool QgsVectorLayer::renderCacheEnabled() const
+{
+  return static_cast< bool >( mRenderCache );
+}
+
 void QgsVectorLayer::onDirtyTransaction( const QString &sql, const QString &name )
 {
   QgsTransaction *tr = dataProvider()->transaction();
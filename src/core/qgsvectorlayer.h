@@ -73,6 +73,7 @@ class QgsFeedback;
 class QgsAuxiliaryStorage;
 class QgsAuxiliaryLayer;
 class QgsGeometryFixes;
+class QgsVectorLayerRenderCache;
 
 typedef QList<int> QgsAttributeList;
 typedef QSet<int> QgsAttributeIds;
@@ -171,6 +172,7 @@ typedef QSet<int> QgsAttributeIds;
  * - IgnoreAxisOrientation=1: to ignore EPSG axis order for WFS 1.1 or 2.0
  * - InvertAxisOrientation=1: to invert axis order
  * - hideDownloadProgressDialog=1: to hide the download progress dialog
+ * - persistentCache=true: to keep the on-disk feature cache between sessions, and only download again outdated regions
  *
  * The ‘FILTER’ query string parameter can be used to filter
  * the WFS feature type. The ‘FILTER’ key value can either be a QGIS expression
@@ -1998,6 +2000,28 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     bool readExtentFromXml() const;
 
+    /**
+     * Sets whether the features fetched to render the layer are kept in memory, so that
+     * following renders of a nearby extent at the same scale (e.g. small pans of the map)
+     * do not query the data provider again.
+     *
+     * Features are fetched for an extent larger than the rendered one to fill the cache,
+     * and the cache is cleared whenever the data, fields or subset string of the layer change.
+     * This is mostly useful for layers from slow or remote data sources.
+     *
+     * \see renderCacheEnabled()
+     * \since QGIS 3.4
+     */
+    void setRenderCacheEnabled( bool enabled );
+
+    /**
+     * Returns true if the features fetched to render the layer are kept in memory.
+     *
+     * \see setRenderCacheEnabled()
+     * \since QGIS 3.4
+     */
+    bool renderCacheEnabled() const;
+
     /**
      * Test if an edit command is active
      *
@@ -2513,7 +2537,11 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
 
     std::unique_ptr<QgsGeometryFixes> mGeometryFixes;
 
+    //! Features fetched by the last render, null if the render cache is disabled
+    std::shared_ptr<QgsVectorLayerRenderCache> mRenderCache;
+
     friend class QgsVectorLayerFeatureSource;
+    friend class QgsVectorLayerRenderer;
 };
 
 
@@ -21,6 +21,7 @@
 #include "qgsvectorlayereditbuffer.h"
 #include "qgsvectorlayer.h"
 #include "qgsvectorlayerjoinbuffer.h"
+#include "qgsvectorlayerjoincache_p.h"
 #include "qgsexpressioncontext.h"
 #include "qgsdistancearea.h"
 #include "qgsproject.h"
@@ -333,18 +334,8 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
     mProviderIterator.setInterruptionChecker( mInterruptionChecker );
   }
 
-  while ( mProviderIterator.nextFeature( f ) )
+  while ( fetchNextProviderFeature( f ) )
   {
-    if ( mFetchConsidered.contains( f.id() ) )
-      continue;
-
-    // TODO[MD]: just one resize of attributes
-    f.setFields( mSource->mFields );
-
-    // update attributes
-    if ( mSource->mHasEditBuffer )
-      updateChangedAttributes( f );
-
     if ( mHasVirtualAttributes )
       addVirtualAttributes( f );
 
@@ -377,11 +368,66 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
 
 
 
+bool QgsVectorLayerFeatureIterator::fetchNextProviderFeature( QgsFeature &f )
+{
+  if ( mProviderFeatureBlockIndex < mProviderFeatureBlock.size() )
+  {
+    f = mProviderFeatureBlock.at( mProviderFeatureBlockIndex++ );
+    return true;
+  }
+
+  mProviderFeatureBlock.clear();
+  mProviderFeatureBlockIndex = 0;
+  mBlockJoinedAttributes.clear();
+
+  // only read ahead if there are joined attributes to look up - starting with small blocks,
+  // in case just a few features get fetched
+  bool lookupJoins = false;
+  for ( const FetchJoinInfo &info : qgis::as_const( mOrderedJoinInfoList ) )
+  {
+    if ( !info.joinInfo->mCache )
+      lookupJoins = true;
+  }
+  const int blockSize = lookupJoins ? mProviderFeatureBlockSize : 1;
+
+  QgsFeature feature;
+  while ( mProviderFeatureBlock.size() < blockSize && mProviderIterator.nextFeature( feature ) )
+  {
+    if ( mFetchConsidered.contains( feature.id() ) )
+      continue;
+
+    // TODO[MD]: just one resize of attributes
+    feature.setFields( mSource->mFields );
+
+    // update attributes
+    if ( mSource->mHasEditBuffer )
+      updateChangedAttributes( feature );
+
+    mProviderFeatureBlock << feature;
+  }
+
+  if ( mProviderFeatureBlock.isEmpty() )
+    return false;
+
+  if ( lookupJoins )
+  {
+    mProviderFeatureBlockSize = std::min( 2 * mProviderFeatureBlockSize, 1000 );
+    fetchBlockJoinedAttributes();
+  }
+
+  f = mProviderFeatureBlock.at( mProviderFeatureBlockIndex++ );
+  return true;
+}
+
 bool QgsVectorLayerFeatureIterator::rewind()
 {
   if ( mClosed )
     return false;
 
+  mProviderFeatureBlock.clear();
+  mProviderFeatureBlockIndex = 0;
+  mBlockJoinedAttributes.clear();
+
   if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
   {
     mFetchedFid = false;
@@ -825,11 +871,108 @@ void QgsVectorLayerFeatureIterator::addJoinedAttributes( QgsFeature &f )
     if ( !targetFieldValue.isValid() )
       continue;
 
-    const QHash< QString, QgsAttributes> &memoryCache = joinIt->joinInfo->cachedAttributes;
-    if ( memoryCache.isEmpty() )
-      joinIt->addJoinedAttributesDirect( f, targetFieldValue );
-    else
+    if ( joinIt->joinInfo->mCache )
+    {
       joinIt->addJoinedAttributesCached( f, targetFieldValue );
+      continue;
+    }
+
+    // joined attributes may have been fetched together with the rest of the block
+    const auto blockIt = mBlockJoinedAttributes.constFind( joinIt->joinInfo );
+    if ( blockIt != mBlockJoinedAttributes.constEnd() && !targetFieldValue.isNull() )
+    {
+      const auto it = blockIt->constFind( targetFieldValue.toString() );
+      if ( it != blockIt->constEnd() )
+      {
+        int index = joinIt->indexOffset;
+        for ( const QVariant &value : it.value() )
+          f.setAttribute( index++, value );
+        continue;
+      }
+    }
+
+    joinIt->addJoinedAttributesDirect( f, targetFieldValue );
+  }
+}
+
+void QgsVectorLayerFeatureIterator::fetchBlockJoinedAttributes()
+{
+  for ( const FetchJoinInfo &info : qgis::as_const( mOrderedJoinInfoList ) )
+  {
+    if ( info.joinInfo->mCache || info.joinField < 0 )
+      continue;
+
+    // values of joined or expression fields are only known once the features get completed
+    const QgsFields::FieldOrigin targetOrigin = mSource->mFields.fieldOrigin( info.targetField );
+    if ( targetOrigin != QgsFields::OriginProvider && targetOrigin != QgsFields::OriginEdit )
+      continue;
+
+    QHash< QString, QgsAttributes > &joinedAttributes = mBlockJoinedAttributes[ info.joinInfo ];
+    QStringList values;
+    for ( const QgsFeature &feature : qgis::as_const( mProviderFeatureBlock ) )
+    {
+      const QVariant value = feature.attribute( info.targetField );
+      // null values are looked up one by one, with an IS NULL filter
+      if ( value.isNull() )
+        continue;
+
+      const QString key = value.toString();
+      if ( joinedAttributes.contains( key ) )
+        continue;
+
+      joinedAttributes.insert( key, QgsAttributes() );
+      values << QgsExpression::quotedValue( value );
+    }
+
+    if ( values.isEmpty() )
+      continue;
+
+    QVector<int> subsetIndices;
+    if ( info.joinInfo->hasSubset() )
+    {
+      const QStringList subsetNames = QgsVectorLayerJoinInfo::joinFieldNamesSubset( *info.joinInfo );
+      subsetIndices = QgsVectorLayerJoinBuffer::joinSubsetIndices( info.joinLayer, subsetNames );
+    }
+
+    QgsAttributeList attributes = info.attributes;
+    if ( !attributes.contains( info.joinField ) )
+      attributes << info.joinField;
+
+    // select (no geometry)
+    QgsFeatureRequest request;
+    request.setFlags( QgsFeatureRequest::NoGeometry );
+    request.setSubsetOfAttributes( attributes );
+    request.setFilterExpression( QStringLiteral( "%1 IN (%2)" ).arg( QgsExpression::quotedColumnRef( info.joinInfo->joinFieldName() ), values.join( ',' ) ) );
+    QgsFeatureIterator fi = info.joinLayer->getFeatures( request );
+
+    QgsFeature joinFeature;
+    while ( fi.nextFeature( joinFeature ) )
+    {
+      auto it = joinedAttributes.find( joinFeature.attribute( info.joinField ).toString() );
+      // like with single lookups, the first matching feature wins
+      if ( it == joinedAttributes.end() || !it->isEmpty() )
+        continue;
+
+      const QgsAttributes attr = joinFeature.attributes();
+      QgsAttributes joined;
+      if ( info.joinInfo->hasSubset() )
+      {
+        joined.reserve( subsetIndices.count() );
+        for ( int i = 0; i < subsetIndices.count(); ++i )
+          joined << attr.at( subsetIndices.at( i ) );
+      }
+      else
+      {
+        // use all fields except for the one used for join (has same value as exiting field in target layer)
+        joined.reserve( attr.count() - 1 );
+        for ( int i = 0; i < attr.count(); ++i )
+        {
+          if ( i != info.joinField )
+            joined << attr.at( i );
+        }
+      }
+      *it = joined;
+    }
   }
 }
 
@@ -904,18 +1047,8 @@ bool QgsVectorLayerFeatureIterator::providerCanSimplify( QgsSimplifyMethod::Meth
 
 void QgsVectorLayerFeatureIterator::FetchJoinInfo::addJoinedAttributesCached( QgsFeature &f, const QVariant &joinValue ) const
 {
-  const QHash<QString, QgsAttributes> &memoryCache = joinInfo->cachedAttributes;
-  QHash<QString, QgsAttributes>::const_iterator it = memoryCache.find( joinValue.toString() );
-  if ( it == memoryCache.constEnd() )
-    return; // joined value not found -> leaving the attributes empty (null)
-
-  int index = indexOffset;
-
-  const QgsAttributes &featureAttributes = it.value();
-  for ( int i = 0; i < featureAttributes.count(); ++i )
-  {
-    f.setAttribute( index++, featureAttributes.at( i ) );
-  }
+  // if the joined value is not found, the attributes are left empty (null)
+  joinInfo->mCache->setJoinedAttributes( f, joinValue, indexOffset );
 }
 
 
@@ -277,6 +277,28 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
 
     void createOrderedJoinList();
 
+    /**
+     * Fetches the next feature from the provider, with the uncommitted attribute changes applied.
+     * When joined attributes have to be looked up in the join layers, provider features are read
+     * ahead in blocks, so that the joined attributes of a whole block are fetched with a single
+     * request per join.
+     */
+    bool fetchNextProviderFeature( QgsFeature &f );
+
+    //! Fetches the joined attributes for the join values of the features in mProviderFeatureBlock
+    void fetchBlockJoinedAttributes();
+
+    //! Provider features read ahead, see fetchNextProviderFeature()
+    QgsFeatureList mProviderFeatureBlock;
+    int mProviderFeatureBlockIndex = 0;
+    int mProviderFeatureBlockSize = 1;
+
+    /**
+     * Joined attributes for the join values of the current block, by join and stringified join value.
+     * Attributes are empty for values without matching feature in the join layer.
+     */
+    QHash< const QgsVectorLayerJoinInfo *, QHash< QString, QgsAttributes > > mBlockJoinedAttributes;
+
     /**
      * Performs any post-processing (such as transformation) and feature based validity checking, e.g. checking for geometry validity.
      */
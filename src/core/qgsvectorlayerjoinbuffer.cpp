@@ -16,6 +16,7 @@
  ***************************************************************************/
 
 #include "qgsvectorlayerjoinbuffer.h"
+#include "qgsvectorlayerjoincache_p.h"
 
 #include "qgsfeatureiterator.h"
 #include "qgslogger.h"
@@ -120,61 +121,18 @@ bool QgsVectorLayerJoinBuffer::removeJoin( const QString &joinLayerId )
 
 void QgsVectorLayerJoinBuffer::cacheJoinLayer( QgsVectorLayerJoinInfo &joinInfo )
 {
-  //memory cache not required or already done
-  if ( !joinInfo.isUsingMemoryCache() || !joinInfo.cacheDirty )
+  //memory cache not required
+  if ( !joinInfo.isUsingMemoryCache() )
   {
+    joinInfo.mCache.reset();
     return;
   }
 
-  QgsVectorLayer *cacheLayer = joinInfo.joinLayer();
-  if ( cacheLayer )
-  {
-    int joinFieldIndex = cacheLayer->fields().indexFromName( joinInfo.joinFieldName() );
-
-    if ( joinFieldIndex < 0 || joinFieldIndex >= cacheLayer->fields().count() )
-      return;
-
-    joinInfo.cachedAttributes.clear();
-
-    QgsFeatureRequest request;
-    request.setFlags( QgsFeatureRequest::NoGeometry );
-    // maybe user requested just a subset of layer's attributes
-    // so we do not have to cache everything
-    QVector<int> subsetIndices;
-    if ( joinInfo.hasSubset() )
-    {
-      const QStringList subsetNames = QgsVectorLayerJoinInfo::joinFieldNamesSubset( joinInfo );
-      subsetIndices = joinSubsetIndices( cacheLayer, subsetNames );
-
-      // we need just subset of attributes - but make sure to include join field name
-      QgsAttributeList cacheLayerAttrs = subsetIndices.toList();
-      if ( !cacheLayerAttrs.contains( joinFieldIndex ) )
-        cacheLayerAttrs.append( joinFieldIndex );
-      request.setSubsetOfAttributes( cacheLayerAttrs );
-    }
-
-    QgsFeatureIterator fit = cacheLayer->getFeatures( request );
-    QgsFeature f;
-    while ( fit.nextFeature( f ) )
-    {
-      QgsAttributes attrs = f.attributes();
-      QString key = attrs.at( joinFieldIndex ).toString();
-      if ( joinInfo.hasSubset() )
-      {
-        QgsAttributes subsetAttrs( subsetIndices.count() );
-        for ( int i = 0; i < subsetIndices.count(); ++i )
-          subsetAttrs[i] = attrs.at( subsetIndices.at( i ) );
-        joinInfo.cachedAttributes.insert( key, subsetAttrs );
-      }
-      else
-      {
-        QgsAttributes attrs2 = attrs;
-        attrs2.remove( joinFieldIndex );  // skip the join field to avoid double field names (fields often have the same name)
-        joinInfo.cachedAttributes.insert( key, attrs2 );
-      }
-    }
-    joinInfo.cacheDirty = false;
-  }
+  // the cached columns depend on the fields of the join layer, so the cache is looked up
+  // again - it may be shared with other joins, and is only reloaded if outdated
+  joinInfo.mCache = QgsVectorLayerJoinCache::cacheForJoin( joinInfo );
+  if ( joinInfo.mCache )
+    joinInfo.mCache->update();
 }
 
 
@@ -255,7 +213,7 @@ void QgsVectorLayerJoinBuffer::createJoinCaches()
   QList< QgsVectorLayerJoinInfo >::iterator joinIt = mVectorJoins.begin();
   for ( ; joinIt != mVectorJoins.end(); ++joinIt )
   {
-    if ( joinIt->isUsingMemoryCache() && joinIt->cacheDirty )
+    if ( joinIt->isUsingMemoryCache() )
       cacheJoinLayer( *joinIt );
   }
 }
@@ -475,9 +433,6 @@ QgsVectorLayerJoinBuffer *QgsVectorLayerJoinBuffer::clone() const
 
 void QgsVectorLayerJoinBuffer::joinedLayerUpdatedFields()
 {
-  // TODO - check - this whole method is probably not needed anymore,
-  // since the cache handling is covered by joinedLayerModified()
-
   QgsVectorLayer *joinedLayer = qobject_cast<QgsVectorLayer *>( sender() );
   Q_ASSERT( joinedLayer );
 
@@ -486,7 +441,6 @@ void QgsVectorLayerJoinBuffer::joinedLayerUpdatedFields()
   {
     if ( joinedLayer == it->joinLayer() )
     {
-      it->cachedAttributes.clear();
       cacheJoinLayer( *it );
     }
   }
@@ -494,21 +448,6 @@ void QgsVectorLayerJoinBuffer::joinedLayerUpdatedFields()
   emit joinedFieldsChanged();
 }
 
-void QgsVectorLayerJoinBuffer::joinedLayerModified()
-{
-  QgsVectorLayer *joinedLayer = qobject_cast<QgsVectorLayer *>( sender() );
-  Q_ASSERT( joinedLayer );
-
-  // recache the joined layer
-  for ( QgsVectorJoinList::iterator it = mVectorJoins.begin(); it != mVectorJoins.end(); ++it )
-  {
-    if ( joinedLayer == it->joinLayer() )
-    {
-      it->cacheDirty = true;
-    }
-  }
-}
-
 void QgsVectorLayerJoinBuffer::joinedLayerWillBeDeleted()
 {
   QgsVectorLayer *joinedLayer = qobject_cast<QgsVectorLayer *>( sender() );
@@ -520,7 +459,6 @@ void QgsVectorLayerJoinBuffer::joinedLayerWillBeDeleted()
 void QgsVectorLayerJoinBuffer::connectJoinedLayer( QgsVectorLayer *vl )
 {
   connect( vl, &QgsVectorLayer::updatedFields, this, &QgsVectorLayerJoinBuffer::joinedLayerUpdatedFields, Qt::UniqueConnection );
-  connect( vl, &QgsVectorLayer::layerModified, this, &QgsVectorLayerJoinBuffer::joinedLayerModified, Qt::UniqueConnection );
   connect( vl, &QgsVectorLayer::willBeDeleted, this, &QgsVectorLayerJoinBuffer::joinedLayerWillBeDeleted, Qt::UniqueConnection );
 }
 
@@ -222,8 +222,6 @@ class CORE_EXPORT QgsVectorLayerJoinBuffer : public QObject, public QgsFeatureSi
   private slots:
     void joinedLayerUpdatedFields();
 
-    void joinedLayerModified();
-
     void joinedLayerWillBeDeleted();
 
   private:
@@ -236,7 +234,7 @@ class CORE_EXPORT QgsVectorLayerJoinBuffer : public QObject, public QgsFeatureSi
     //! Joined vector layers
     QgsVectorJoinList mVectorJoins;
 
-    //! Caches attributes of join layer in memory if QgsVectorJoinInfo.memoryCache is true (and the cache is not already there)
+    //! Caches attributes of join layer in memory if QgsVectorJoinInfo.memoryCache is true (and the cache is outdated)
     void cacheJoinLayer( QgsVectorLayerJoinInfo &joinInfo );
 
     //! Main mutex to protect most data members that can be modified concurrently
@@ -0,0 +1,452 @@
+/***************************************************************************
+                         qgsvectorlayerjoincache.cpp
+                         ---------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsvectorlayerjoincache_p.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerjoininfo.h"
+#include "qgsvectorlayerjoinbuffer.h"
+#include "qgsfeatureiterator.h"
+#include "qgslogger.h"
+
+#include <QMutex>
+#include <QThread>
+#include <cmath>
+
+///@cond PRIVATE
+
+typedef QHash< QString, std::weak_ptr< QgsVectorLayerJoinCache > > QgsJoinCacheRegistry;
+Q_GLOBAL_STATIC( QgsJoinCacheRegistry, sJoinCaches )
+static QMutex sJoinCachesMutex;
+
+//! Converts a join value to an integer key, without rounding
+static bool toIntegerKey( const QVariant &value, qint64 &key )
+{
+  if ( value.type() == QVariant::Double )
+  {
+    const double d = value.toDouble();
+    if ( !std::isfinite( d ) || d != std::floor( d ) )
+      return false;
+    key = static_cast< qint64 >( d );
+    return true;
+  }
+
+  bool ok = false;
+  key = value.toLongLong( &ok );
+  return ok;
+}
+
+std::shared_ptr< QgsVectorLayerJoinCache > QgsVectorLayerJoinCache::cacheForJoin( const QgsVectorLayerJoinInfo &joinInfo )
+{
+  QgsVectorLayer *layer = joinInfo.joinLayer();
+  if ( !layer || layer->fields().lookupField( joinInfo.joinFieldName() ) < 0 )
+    return nullptr;
+
+  // maybe user requested just a subset of layer's attributes
+  // so we do not have to cache everything
+  QStringList columns;
+  if ( joinInfo.hasSubset() )
+  {
+    columns = QgsVectorLayerJoinInfo::joinFieldNamesSubset( joinInfo );
+  }
+  else
+  {
+    const QgsFields fields = layer->fields();
+    for ( const QgsField &field : fields )
+    {
+      // skip the join field to avoid double field names (fields often have the same name)
+      if ( field.name() != joinInfo.joinFieldName() )
+        columns << field.name();
+    }
+  }
+
+  const QString key = QStringLiteral( "%1\n%2\n%3" ).arg( layer->id(), joinInfo.joinFieldName(), columns.join( '\n' ) );
+
+  QMutexLocker locker( &sJoinCachesMutex );
+  std::shared_ptr< QgsVectorLayerJoinCache > cache = sJoinCaches()->value( key ).lock();
+  if ( !cache )
+  {
+    // the cache may be released from another thread than the one of the join layer,
+    // but it must be deleted in the thread it receives the layer's signals. It is deleted
+    // right away in that thread, which may have no event loop (server, scripts)
+    cache = std::shared_ptr< QgsVectorLayerJoinCache >( new QgsVectorLayerJoinCache( layer, joinInfo.joinFieldName(), columns, key ),
+            []( QgsVectorLayerJoinCache * cache )
+    {
+      if ( cache->thread() == QThread::currentThread() )
+        delete cache;
+      else
+        cache->deleteLater();
+    } );
+    sJoinCaches()->insert( key, cache );
+  }
+  return cache;
+}
+
+QgsVectorLayerJoinCache::QgsVectorLayerJoinCache( QgsVectorLayer *layer, const QString &joinFieldName, const QStringList &columns, const QString &registryKey )
+  : mLayer( layer )
+  , mJoinFieldName( joinFieldName )
+  , mColumns( columns )
+  , mRegistryKey( registryKey )
+{
+  moveToThread( layer->thread() );
+
+  connect( layer, &QgsVectorLayer::featureAdded, this, &QgsVectorLayerJoinCache::featureAdded );
+  connect( layer, &QgsVectorLayer::featureDeleted, this, &QgsVectorLayerJoinCache::featureDeleted );
+  connect( layer, &QgsVectorLayer::attributeValueChanged, this, &QgsVectorLayerJoinCache::attributeValueChanged );
+
+  // ids of added features change on commit, and fields may be moved around
+  connect( layer, &QgsVectorLayer::editingStopped, this, &QgsVectorLayerJoinCache::invalidate );
+  connect( layer, &QgsVectorLayer::updatedFields, this, &QgsVectorLayerJoinCache::invalidate );
+  connect( layer, &QgsVectorLayer::subsetStringChanged, this, &QgsVectorLayerJoinCache::invalidate );
+  connect( layer, &QgsVectorLayer::dataChanged, this, &QgsVectorLayerJoinCache::invalidate );
+}
+
+QgsVectorLayerJoinCache::~QgsVectorLayerJoinCache()
+{
+  QMutexLocker locker( &sJoinCachesMutex );
+  // a new cache may already have replaced this one
+  if ( sJoinCaches()->value( mRegistryKey ).expired() )
+    sJoinCaches()->remove( mRegistryKey );
+}
+
+void QgsVectorLayerJoinCache::update()
+{
+  {
+    QReadLocker locker( &mLock );
+    if ( !mDirty )
+      return;
+  }
+
+  QWriteLocker locker( &mLock );
+  if ( !mDirty || !mLayer )
+    return;
+
+  clear();
+
+  const QgsFields fields = mLayer->fields();
+  mJoinFieldIndex = fields.lookupField( mJoinFieldName );
+  if ( mJoinFieldIndex < 0 )
+    return;
+
+  switch ( fields.at( mJoinFieldIndex ).type() )
+  {
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      mKeyType = IntegerKey;
+      break;
+
+    case QVariant::Double:
+      mKeyType = DoubleKey;
+      break;
+
+    default:
+      mKeyType = StringKey;
+      break;
+  }
+
+  mColumnIndices = QgsVectorLayerJoinBuffer::joinSubsetIndices( mLayer, mColumns ).toList();
+
+  QgsFeatureRequest request;
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  QgsAttributeList attributes = mColumnIndices;
+  if ( !attributes.contains( mJoinFieldIndex ) )
+    attributes.append( mJoinFieldIndex );
+  request.setSubsetOfAttributes( attributes );
+
+  const long count = mLayer->featureCount();
+  if ( count > 0 )
+  {
+    mJoinValues.reserve( count );
+    mValues.reserve( count * mColumnIndices.count() );
+    mFeatureRows.reserve( count );
+  }
+
+  QgsFeatureIterator fit = mLayer->getFeatures( request );
+  QgsFeature f;
+  while ( fit.nextFeature( f ) )
+  {
+    insertRow( f );
+  }
+
+  QgsDebugMsgLevel( QStringLiteral( "Cached %1 features of join layer %2" ).arg( mJoinValues.count() ).arg( mLayer->id() ), 3 );
+  mDirty = false;
+}
+
+bool QgsVectorLayerJoinCache::setJoinedAttributes( QgsFeature &feature, const QVariant &joinValue, int index ) const
+{
+  QReadLocker locker( &mLock );
+  const int row = findRow( joinValue );
+  if ( row < 0 )
+    return false; // joined value not found -> leaving the attributes empty (null)
+
+  const int columnCount = mColumnIndices.count();
+  const QVariant *values = mValues.constData() + row * columnCount;
+  for ( int i = 0; i < columnCount; ++i )
+  {
+    feature.setAttribute( index++, values[i] );
+  }
+  return true;
+}
+
+void QgsVectorLayerJoinCache::featureAdded( QgsFeatureId fid )
+{
+  {
+    QReadLocker locker( &mLock );
+    if ( mDirty || !mLayer )
+      return;
+  }
+
+  QgsFeatureRequest request( fid );
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  QgsFeature feature;
+  if ( !mLayer->getFeatures( request ).nextFeature( feature ) )
+    return;
+
+  QWriteLocker locker( &mLock );
+  if ( mDirty )
+    return;
+
+  removeRow( fid );
+  insertRow( feature );
+}
+
+void QgsVectorLayerJoinCache::featureDeleted( QgsFeatureId fid )
+{
+  QWriteLocker locker( &mLock );
+  if ( mDirty )
+    return;
+
+  removeRow( fid );
+}
+
+void QgsVectorLayerJoinCache::attributeValueChanged( QgsFeatureId fid, int idx, const QVariant &value )
+{
+  QWriteLocker locker( &mLock );
+  if ( mDirty )
+    return;
+
+  const auto it = mFeatureRows.constFind( fid );
+  if ( it == mFeatureRows.constEnd() )
+    return;
+  const int row = it.value();
+
+  if ( idx == mJoinFieldIndex )
+  {
+    if ( mHasDuplicateValues )
+    {
+      // another feature may have to be indexed by the old value
+      mDirty = true;
+      return;
+    }
+
+    unindexRow( mJoinValues.at( row ), row );
+    mJoinValues[row] = value;
+    if ( !indexRow( value, row ) )
+      mHasDuplicateValues = true;
+  }
+
+  const int column = mColumnIndices.indexOf( idx );
+  if ( column >= 0 )
+    mValues[ row * mColumnIndices.count() + column ] = value;
+}
+
+void QgsVectorLayerJoinCache::invalidate()
+{
+  QWriteLocker locker( &mLock );
+  mDirty = true;
+}
+
+int QgsVectorLayerJoinCache::findRow( const QVariant &joinValue ) const
+{
+  if ( joinValue.isNull() )
+    return mNullRow;
+
+  switch ( mKeyType )
+  {
+    case IntegerKey:
+    {
+      qint64 key;
+      if ( !toIntegerKey( joinValue, key ) )
+        return -1;
+      return mIntegerIndex.value( key, -1 );
+    }
+
+    case DoubleKey:
+    {
+      bool ok = false;
+      const double key = joinValue.toDouble( &ok );
+      if ( !ok )
+        return -1;
+      return mDoubleIndex.value( key, -1 );
+    }
+
+    case StringKey:
+      return mStringIndex.value( joinValue.toString(), -1 );
+  }
+  return -1;
+}
+
+void QgsVectorLayerJoinCache::insertRow( const QgsFeature &feature )
+{
+  const int columnCount = mColumnIndices.count();
+  int row;
+  if ( !mFreeRows.isEmpty() )
+  {
+    row = mFreeRows.takeLast();
+  }
+  else
+  {
+    row = mJoinValues.count();
+    mJoinValues.resize( row + 1 );
+    mValues.resize( ( row + 1 ) * columnCount );
+  }
+
+  const QgsAttributes attributes = feature.attributes();
+  QVariant *values = mValues.data() + row * columnCount;
+  for ( int i = 0; i < columnCount; ++i )
+  {
+    values[i] = attributes.value( mColumnIndices.at( i ) );
+  }
+
+  const QVariant joinValue = attributes.value( mJoinFieldIndex );
+  mJoinValues[row] = joinValue;
+  mFeatureRows.insert( feature.id(), row );
+  if ( !indexRow( joinValue, row ) )
+    mHasDuplicateValues = true;
+}
+
+void QgsVectorLayerJoinCache::removeRow( QgsFeatureId fid )
+{
+  const auto it = mFeatureRows.find( fid );
+  if ( it == mFeatureRows.end() )
+    return;
+
+  const int row = it.value();
+  mFeatureRows.erase( it );
+
+  const QVariant joinValue = mJoinValues.at( row );
+  if ( mHasDuplicateValues && findRow( joinValue ) == row )
+  {
+    // another feature may have to be indexed by this value
+    mDirty = true;
+    return;
+  }
+  unindexRow( joinValue, row );
+
+  const int columnCount = mColumnIndices.count();
+  QVariant *values = mValues.data() + row * columnCount;
+  for ( int i = 0; i < columnCount; ++i )
+  {
+    values[i] = QVariant();
+  }
+  mJoinValues[row] = QVariant();
+  mFreeRows << row;
+}
+
+bool QgsVectorLayerJoinCache::indexRow( const QVariant &joinValue, int row )
+{
+  if ( joinValue.isNull() )
+  {
+    if ( mNullRow >= 0 )
+      return false;
+    mNullRow = row;
+    return true;
+  }
+
+  switch ( mKeyType )
+  {
+    case IntegerKey:
+    {
+      qint64 key;
+      if ( !toIntegerKey( joinValue, key ) )
+        return true; // can never be matched
+      if ( mIntegerIndex.contains( key ) )
+        return false;
+      mIntegerIndex.insert( key, row );
+      return true;
+    }
+
+    case DoubleKey:
+    {
+      bool ok = false;
+      const double key = joinValue.toDouble( &ok );
+      if ( !ok )
+        return true;
+      if ( mDoubleIndex.contains( key ) )
+        return false;
+      mDoubleIndex.insert( key, row );
+      return true;
+    }
+
+    case StringKey:
+    {
+      const QString key = joinValue.toString();
+      if ( mStringIndex.contains( key ) )
+        return false;
+      mStringIndex.insert( key, row );
+      return true;
+    }
+  }
+  return true;
+}
+
+void QgsVectorLayerJoinCache::unindexRow( const QVariant &joinValue, int row )
+{
+  if ( findRow( joinValue ) != row )
+    return;
+
+  if ( joinValue.isNull() )
+  {
+    mNullRow = -1;
+    return;
+  }
+
+  switch ( mKeyType )
+  {
+    case IntegerKey:
+    {
+      qint64 key;
+      if ( toIntegerKey( joinValue, key ) )
+        mIntegerIndex.remove( key );
+      break;
+    }
+
+    case DoubleKey:
+      mDoubleIndex.remove( joinValue.toDouble() );
+      break;
+
+    case StringKey:
+      mStringIndex.remove( joinValue.toString() );
+      break;
+  }
+}
+
+void QgsVectorLayerJoinCache::clear()
+{
+  mValues.clear();
+  mJoinValues.clear();
+  mFreeRows.clear();
+  mFeatureRows.clear();
+  mIntegerIndex.clear();
+  mDoubleIndex.clear();
+  mStringIndex.clear();
+  mNullRow = -1;
+  mHasDuplicateValues = false;
+  mColumnIndices.clear();
+}
+
+///@endcond
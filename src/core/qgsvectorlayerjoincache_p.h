@@ -0,0 +1,156 @@
+/***************************************************************************
+                         qgsvectorlayerjoincache_p.h
+                         ---------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSVECTORLAYERJOINCACHE_PRIVATE_H
+#define QGSVECTORLAYERJOINCACHE_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QReadWriteLock>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+class QgsVectorLayer;
+class QgsVectorLayerJoinInfo;
+
+/**
+ * \ingroup core
+ * In-memory cache of the attributes of a join layer, used by joins with memory caching enabled.
+ *
+ * Rows are indexed by the value of the join field, using integer or double keys for numeric
+ * join fields. Only the joined columns are cached, and a single cache is shared between all the
+ * joins using the same join layer, join field and joined columns.
+ *
+ * The cache follows the edits of the join layer incrementally. It is only reloaded
+ * when the fields of the join layer change, or when its edits are committed or rolled back.
+ *
+ * Lookups are thread safe.
+ */
+class CORE_EXPORT QgsVectorLayerJoinCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Returns the cache for the memory cached join \a joinInfo, creating it if no other
+     * join is using the same join layer, join field and joined columns.
+     * Returns nullptr if the join layer or join field do not exist.
+     */
+    static std::shared_ptr< QgsVectorLayerJoinCache > cacheForJoin( const QgsVectorLayerJoinInfo &joinInfo );
+
+    ~QgsVectorLayerJoinCache() override;
+
+    /**
+     * Reloads the cache from the join layer if it is outdated.
+     */
+    void update();
+
+    /**
+     * Sets the cached attributes of the join layer feature matching \a joinValue to
+     * \a feature, starting at attribute \a index. Returns false if no feature matches,
+     * leaving the attributes untouched.
+     */
+    bool setJoinedAttributes( QgsFeature &feature, const QVariant &joinValue, int index ) const;
+
+  private slots:
+
+    void featureAdded( QgsFeatureId fid );
+    void featureDeleted( QgsFeatureId fid );
+    void attributeValueChanged( QgsFeatureId fid, int idx, const QVariant &value );
+    void invalidate();
+
+  private:
+
+    //! Type of the keys used to index the rows
+    enum KeyType
+    {
+      IntegerKey,
+      DoubleKey,
+      StringKey,
+    };
+
+    QgsVectorLayerJoinCache( QgsVectorLayer *layer, const QString &joinFieldName, const QStringList &columns, const QString &registryKey );
+
+    //! Returns the row matching \a joinValue, or -1. Must be called with the lock held
+    int findRow( const QVariant &joinValue ) const;
+
+    //! Adds a row for the join layer feature \a feature. Must be called with the write lock held
+    void insertRow( const QgsFeature &feature );
+
+    //! Removes the row of the join layer feature \a fid. Must be called with the write lock held
+    void removeRow( QgsFeatureId fid );
+
+    //! Indexes \a row by \a joinValue, returns false if another row is already indexed by this value
+    bool indexRow( const QVariant &joinValue, int row );
+
+    //! Removes \a row from the index if it is indexed by \a joinValue
+    void unindexRow( const QVariant &joinValue, int row );
+
+    //! Clears all the rows. Must be called with the write lock held
+    void clear();
+
+    QPointer< QgsVectorLayer > mLayer;
+    QString mJoinFieldName;
+    QStringList mColumns;
+    QString mRegistryKey;
+
+    KeyType mKeyType = StringKey;
+    int mJoinFieldIndex = -1;
+    QgsAttributeList mColumnIndices;
+
+    //! Cached attributes, with mColumnIndices.count() values per row
+    QVector< QVariant > mValues;
+    //! Join value of each row
+    QVector< QVariant > mJoinValues;
+    //! Rows of deleted features, to be reused
+    QVector< int > mFreeRows;
+    QHash< QgsFeatureId, int > mFeatureRows;
+
+    QHash< qint64, int > mIntegerIndex;
+    QHash< double, int > mDoubleIndex;
+    QHash< QString, int > mStringIndex;
+    int mNullRow = -1;
+
+    //! True if several features have the same join value, in which case the first one is indexed
+    bool mHasDuplicateValues = false;
+    bool mDirty = true;
+
+    mutable QReadWriteLock mLock;
+};
+
+/// @endcond
+
+#endif // QGSVECTORLAYERJOINCACHE_PRIVATE_H
@@ -23,6 +23,10 @@
 
 #include "qgsvectorlayerref.h"
 
+#include <memory>
+
+class QgsVectorLayerJoinCache;
+
 /**
  * \ingroup core
  * Defines left outer join from our vector layer to some other vector layer.
@@ -216,8 +220,8 @@ class CORE_EXPORT QgsVectorLayerJoinInfo
     friend class QgsVectorLayerJoinBuffer;
     friend class QgsVectorLayerFeatureIterator;
 
-    //! True if the cached join attributes need to be updated
-    bool cacheDirty = true;
+    //! Cache of the joined attributes, shared with the other joins using the same columns (null if no memory caching)
+    std::shared_ptr< QgsVectorLayerJoinCache > mCache;
 
     bool mDynamicForm = false;
 
@@ -228,10 +232,6 @@ class CORE_EXPORT QgsVectorLayerJoinInfo
     bool mCascadedDelete = false;
 
     QStringList mBlackList;
-
-    //! Cache for joined attributes to provide fast lookup (size is 0 if no memory caching)
-    QHash< QString, QgsAttributes> cachedAttributes;
-
 };
 
 
@@ -0,0 +1,278 @@
+/***************************************************************************
+                         qgsvectorlayerrendercache.cpp
+                         -----------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsvectorlayerrendercache_p.h"
+#include "qgis.h"
+#include "qgsfeaturerequest.h"
+#include "qgsfeedback.h"
+#include "qgsexpression.h"
+#include "qgslogger.h"
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+/**
+ * Fraction of the width and height of the requested extent added on each side of it
+ * when features are fetched to fill the cache, so that small pans are served from memory.
+ */
+static const double EXTENT_MARGIN = 0.5;
+
+/**
+ * Iterates over the features of a cache content which intersect an extent.
+ */
+class QgsRenderCacheFeatureIterator : public QgsAbstractFeatureIterator
+{
+  public:
+    QgsRenderCacheFeatureIterator( const std::shared_ptr< const QgsVectorLayerRenderCache::Content > &content, const QgsRectangle &extent )
+      : QgsAbstractFeatureIterator( QgsFeatureRequest() )
+      , mContent( content )
+      , mExtent( extent )
+    {}
+
+    ~QgsRenderCacheFeatureIterator() override
+    {
+      close();
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+      mIndex = 0;
+      return true;
+    }
+
+    bool close() override
+    {
+      mClosed = true;
+      return true;
+    }
+
+  protected:
+    bool fetchFeature( QgsFeature &f ) override
+    {
+      if ( mClosed )
+        return false;
+
+      while ( mIndex < mContent->features.count() )
+      {
+        const int index = mIndex++;
+        if ( mContent->boundingBoxes.at( index ).intersects( mExtent ) )
+        {
+          f = mContent->features.at( index );
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    std::shared_ptr< const QgsVectorLayerRenderCache::Content > mContent;
+    QgsRectangle mExtent;
+    int mIndex = 0;
+};
+
+/**
+ * Iterates over the features fetched from a source for an enlarged extent, returning
+ * only the ones which intersect the requested extent and recording all of them.
+ * The recorded features are stored in the cache when the end of the iteration is reached.
+ */
+class QgsRenderCacheRecordingIterator : public QgsAbstractFeatureIterator
+{
+  public:
+    QgsRenderCacheRecordingIterator( const std::shared_ptr< QgsVectorLayerRenderCache > &cache, quint64 generation, const QString &key,
+                                     const QgsFeatureIterator &iterator, const QgsRectangle &fetchedExtent, const QgsRectangle &extent )
+      : QgsAbstractFeatureIterator( QgsFeatureRequest() )
+      , mCache( cache )
+      , mGeneration( generation )
+      , mKey( key )
+      , mIterator( iterator )
+      , mFetchedExtent( fetchedExtent )
+      , mExtent( extent )
+      , mContent( std::make_shared< QgsVectorLayerRenderCache::Content >() )
+    {}
+
+    ~QgsRenderCacheRecordingIterator() override
+    {
+      close();
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+      // features may be returned twice, do not record them again
+      mContent.reset();
+      return mIterator.rewind();
+    }
+
+    bool close() override
+    {
+      mClosed = true;
+      mContent.reset();
+      return mIterator.close();
+    }
+
+    void setInterruptionChecker( QgsFeedback *interruptionChecker ) override
+    {
+      mInterruptionChecker = interruptionChecker;
+      mIterator.setInterruptionChecker( interruptionChecker );
+    }
+
+  protected:
+    bool fetchFeature( QgsFeature &f ) override
+    {
+      if ( mClosed )
+        return false;
+
+      while ( mIterator.nextFeature( f ) )
+      {
+        const QgsRectangle boundingBox = f.hasGeometry() ? f.geometry().boundingBox() : QgsRectangle();
+        if ( mContent )
+        {
+          if ( mContent->features.count() < QgsVectorLayerRenderCache::MAXIMUM_FEATURE_COUNT )
+          {
+            mContent->features << f;
+            mContent->boundingBoxes << boundingBox;
+          }
+          else
+          {
+            QgsDebugMsgLevel( QStringLiteral( "Too many features to be kept in the render cache" ), 2 );
+            mContent.reset();
+          }
+        }
+
+        if ( f.hasGeometry() && boundingBox.intersects( mExtent ) )
+          return true;
+      }
+
+      // an interrupted iteration does not return all features
+      if ( mContent && !( mInterruptionChecker && mInterruptionChecker->isCanceled() ) )
+        mCache->store( mGeneration, mKey, mFetchedExtent, mContent );
+      mContent.reset();
+      return false;
+    }
+
+  private:
+    std::shared_ptr< QgsVectorLayerRenderCache > mCache;
+    quint64 mGeneration = 0;
+    QString mKey;
+    QgsFeatureIterator mIterator;
+    QgsRectangle mFetchedExtent;
+    QgsRectangle mExtent;
+    std::shared_ptr< QgsVectorLayerRenderCache::Content > mContent;
+    QgsFeedback *mInterruptionChecker = nullptr;
+};
+
+bool QgsVectorLayerRenderCache::requestIsCacheable( const QgsFeatureRequest &request )
+{
+  if ( request.filterRect().isNull() || request.limit() >= 0 )
+    return false;
+
+  switch ( request.filterType() )
+  {
+    case QgsFeatureRequest::FilterNone:
+      return true;
+
+    case QgsFeatureRequest::FilterExpression:
+      // the result of expressions using variables (e.g. the map scale) may change between renders
+      return request.filterExpression() && request.filterExpression()->referencedVariables().isEmpty();
+
+    case QgsFeatureRequest::FilterFid:
+    case QgsFeatureRequest::FilterFids:
+      return false;
+  }
+  return false;
+}
+
+QString QgsVectorLayerRenderCache::requestKey( const QgsFeatureRequest &request )
+{
+  QStringList key;
+  key << QString::number( static_cast< int >( request.flags() ) );
+
+  QgsAttributeList attributes = request.subsetOfAttributes();
+  std::sort( attributes.begin(), attributes.end() );
+  QStringList attributeKeys;
+  for ( int attribute : qgis::as_const( attributes ) )
+    attributeKeys << QString::number( attribute );
+  key << attributeKeys.join( ',' );
+
+  key << ( request.filterExpression() ? request.filterExpression()->expression() : QString() );
+  key << request.orderBy().dump();
+  key << QString::number( static_cast< int >( request.simplifyMethod().methodType() ) ) << QString::number( request.simplifyMethod().tolerance(), 'g', 17 );
+  key << request.destinationCrs().toWkt();
+  return key.join( '\n' );
+}
+
+quint64 QgsVectorLayerRenderCache::generation() const
+{
+  QMutexLocker locker( &mMutex );
+  return mGeneration;
+}
+
+QgsFeatureIterator QgsVectorLayerRenderCache::getFeatures( QgsAbstractFeatureSource *source, const QgsFeatureRequest &request, quint64 generation )
+{
+  const QString key = requestKey( request );
+  const QgsRectangle extent = request.filterRect();
+
+  {
+    QMutexLocker locker( &mMutex );
+    // the source is outdated, neither its features nor the cached ones belong to the same data
+    if ( generation != mGeneration )
+      return source->getFeatures( request );
+    if ( mContent && key == mKey && mExtent.contains( extent ) )
+      return QgsFeatureIterator( new QgsRenderCacheFeatureIterator( mContent, extent ) );
+  }
+
+  const QgsRectangle fetchedExtent = QgsRectangle( extent.xMinimum() - extent.width() * EXTENT_MARGIN,
+                                     extent.yMinimum() - extent.height() * EXTENT_MARGIN,
+                                     extent.xMaximum() + extent.width() * EXTENT_MARGIN,
+                                     extent.yMaximum() + extent.height() * EXTENT_MARGIN );
+  QgsFeatureRequest fetchRequest( request );
+  fetchRequest.setFilterRect( fetchedExtent );
+  return QgsFeatureIterator( new QgsRenderCacheRecordingIterator( shared_from_this(), generation, key,
+                             source->getFeatures( fetchRequest ), fetchedExtent, extent ) );
+}
+
+void QgsVectorLayerRenderCache::invalidate()
+{
+  QMutexLocker locker( &mMutex );
+  mGeneration++;
+  mKey.clear();
+  mExtent = QgsRectangle();
+  mContent.reset();
+}
+
+bool QgsVectorLayerRenderCache::contains( const QgsFeatureRequest &request ) const
+{
+  const QString key = requestKey( request );
+  QMutexLocker locker( &mMutex );
+  return mContent && key == mKey && mExtent.contains( request.filterRect() );
+}
+
+void QgsVectorLayerRenderCache::store( quint64 generation, const QString &key, const QgsRectangle &extent, const std::shared_ptr< Content > &content )
+{
+  QMutexLocker locker( &mMutex );
+  if ( generation != mGeneration )
+    return;
+
+  mKey = key;
+  mExtent = extent;
+  mContent = content;
+}
+
+///@endcond
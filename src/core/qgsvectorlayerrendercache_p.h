@@ -0,0 +1,122 @@
+/***************************************************************************
+                         qgsvectorlayerrendercache_p.h
+                         -----------------------------
+    begin                : August 2018
+    copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSVECTORLAYERRENDERCACHE_PRIVATE_H
+#define QGSVECTORLAYERRENDERCACHE_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsfeatureiterator.h"
+#include "qgsrectangle.h"
+
+#include <QMutex>
+#include <QVector>
+
+#include <memory>
+
+class QgsAbstractFeatureSource;
+
+/**
+ * \ingroup core
+ * In-memory cache of the features fetched to render a vector layer, used by layers with
+ * the render cache enabled.
+ *
+ * When the cache cannot serve a request, features are fetched from the source for an extent
+ * larger than the requested one and recorded while the renderer iterates over them. Once the
+ * iteration reaches its end, they replace the content of the cache. Later requests with the
+ * same attributes, filter, ordering and simplification whose extent lies within the cached
+ * extent are then served from memory, without querying the source.
+ *
+ * The cache holds the features of a single request and is shared by all render jobs of the
+ * layer. Requests are thread safe.
+ */
+class CORE_EXPORT QgsVectorLayerRenderCache : public std::enable_shared_from_this< QgsVectorLayerRenderCache >
+{
+  public:
+
+    //! Maximum number of features kept in the cache
+    static const int MAXIMUM_FEATURE_COUNT = 100000;
+
+    //! Features cached for one request, shared with the iterators reading them
+    struct Content
+    {
+      QgsFeatureList features;
+      QVector< QgsRectangle > boundingBoxes;
+    };
+
+    /**
+     * Returns true if features for \a request can be served by the cache. Requests must be
+     * restricted to an extent, without limit, feature ids or expression depending on variables.
+     */
+    static bool requestIsCacheable( const QgsFeatureRequest &request );
+
+    /**
+     * Returns the current generation of the cache, incremented each time it is invalidated.
+     * It must be read before taking the snapshot of the layer later passed to getFeatures().
+     */
+    quint64 generation() const;
+
+    /**
+     * Returns an iterator over the features of \a source matching \a request, which
+     * must be cacheable. The iterator reads from the cache if possible, otherwise it
+     * fetches features from \a source and fills the cache. \a source must outlive the iterator.
+     *
+     * \a generation is the generation() of the cache when \a source was created. If the cache
+     * was invalidated since then, features are read from \a source and are not cached.
+     */
+    QgsFeatureIterator getFeatures( QgsAbstractFeatureSource *source, const QgsFeatureRequest &request, quint64 generation );
+
+    /**
+     * Drops the cached features, and discards features being recorded by running iterators.
+     */
+    void invalidate();
+
+    //! Returns true if the features matching \a request would be read from the cache
+    bool contains( const QgsFeatureRequest &request ) const;
+
+  private:
+
+    //! Returns a key identifying the parameters of \a request other than its extent
+    static QString requestKey( const QgsFeatureRequest &request );
+
+    //! Replaces the cached features, unless the cache was invalidated since \a generation
+    void store( quint64 generation, const QString &key, const QgsRectangle &extent, const std::shared_ptr< Content > &content );
+
+    mutable QMutex mMutex;
+    quint64 mGeneration = 0;
+    QString mKey;
+    QgsRectangle mExtent;
+    std::shared_ptr< const Content > mContent;
+
+    friend class QgsRenderCacheRecordingIterator;
+};
+
+/// @endcond
+
+#endif // QGSVECTORLAYERRENDERCACHE_PRIVATE_H
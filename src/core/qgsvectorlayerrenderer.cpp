@@ -30,6 +30,7 @@
 #include "qgsvectorlayerfeatureiterator.h"
 #include "qgsvectorlayerlabeling.h"
 #include "qgsvectorlayerlabelprovider.h"
+#include "qgsvectorlayerrendercache_p.h"
 #include "qgspainteffect.h"
 #include "qgsfeaturefilterprovider.h"
 #include "qgsexception.h"
@@ -48,6 +49,11 @@ QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRender
   , mLabeling( false )
   , mDiagrams( false )
 {
+  // the generation is read before the snapshot of the layer, so that features fetched from a
+  // snapshot older than an invalidation of the cache are not stored
+  mRenderCache = layer->mRenderCache;
+  if ( mRenderCache )
+    mRenderCacheGeneration = mRenderCache->generation();
   mSource = new QgsVectorLayerFeatureSource( layer );
 
   mRenderer = layer->renderer() ? layer->renderer()->clone() : nullptr;
@@ -234,7 +240,12 @@ bool QgsVectorLayerRenderer::render()
     mContext.setVectorSimplifyMethod( vectorMethod );
   }
 
-  QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
+  // access control filters may depend on the user, never serve them from the cache
+  QgsFeatureIterator fit;
+  if ( mRenderCache && !featureFilterProvider && QgsVectorLayerRenderCache::requestIsCacheable( featureRequest ) )
+    fit = mRenderCache->getFeatures( mSource, featureRequest, mRenderCacheGeneration );
+  else
+    fit = mSource->getFeatures( featureRequest );
   // Attach an interruption checker so that iterators that have potentially
   // slow fetchFeature() implementations, such as in the WFS provider, can
   // check it, instead of relying on just the mContext.renderingStopped() check
@@ -26,11 +26,13 @@ class QgsDiagramLayerSettings;
 
 class QgsFeatureIterator;
 class QgsSingleSymbolRenderer;
+class QgsVectorLayerRenderCache;
 
 #define SIP_NO_FILE
 
 #include <QList>
 #include <QPainter>
+#include <memory>
 
 typedef QList<int> QgsAttributeList;
 
@@ -120,6 +122,11 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     QgsFeatureRenderer *mRenderer = nullptr;
 
+    //! Cache of the features fetched for rendering, shared with the layer. Null if disabled
+    std::shared_ptr<QgsVectorLayerRenderCache> mRenderCache;
+    //! Generation of the render cache when the layer snapshot was taken
+    quint64 mRenderCacheGeneration = 0;
+
     bool mDrawVertexMarkers;
     bool mVertexMarkerOnlyForSelection;
     int mVertexMarkerStyle, mVertexMarkerSize;
@@ -607,7 +607,10 @@ void QgsRasterLayer::setDataProvider( QString const &provider, const QgsDataProv
 
   //mBandCount = 0;
 
-  mDataProvider = dynamic_cast< QgsRasterDataProvider * >( QgsProviderRegistry::instance()->createProvider( mProviderKey, mDataSource, options ) );
+  QgsDataProvider *dataProvider = takePreloadedProvider( mProviderKey, mDataSource );
+  if ( !dataProvider )
+    dataProvider = QgsProviderRegistry::instance()->createProvider( mProviderKey, mDataSource, options );
+  mDataProvider = dynamic_cast< QgsRasterDataProvider * >( dataProvider );
   if ( !mDataProvider )
   {
     //QgsMessageLog::logMessage( tr( "Cannot instantiate the data provider" ), tr( "Raster" ) );
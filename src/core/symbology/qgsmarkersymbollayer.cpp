@@ -1939,11 +1939,49 @@ void QgsSvgMarkerSymbolLayer::startRender( QgsSymbolRenderContext &context )
 {
   QgsMarkerSymbolLayer::startRender( context ); // get anchor point expressions
   Q_UNUSED( context );
+  mLastImage = QImage();
 }
 
 void QgsSvgMarkerSymbolLayer::stopRender( QgsSymbolRenderContext &context )
 {
   Q_UNUSED( context );
+  mLastImage = QImage();
+}
+
+QImage QgsSvgMarkerSymbolLayer::markerImage( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
+    double widthScaleFactor, double aspectRatio, double opacity, bool &fitsInCache )
+{
+  fitsInCache = true;
+  if ( !mLastImage.isNull() && path == mLastImagePath && size == mLastImageSize && fill == mLastImageFill && stroke == mLastImageStroke &&
+       strokeWidth == mLastImageStrokeWidth && widthScaleFactor == mLastImageScaleFactor && aspectRatio == mLastImageAspectRatio &&
+       opacity == mLastImageOpacity )
+    return mLastImage;
+
+  QImage img = QgsApplication::svgCache()->svgAsImage( path, size, fill, stroke, strokeWidth, widthScaleFactor, fitsInCache, aspectRatio );
+  if ( !fitsInCache )
+  {
+    // too big to be kept around
+    mLastImage = QImage();
+    return img;
+  }
+
+  //consider transparency
+  if ( !qgsDoubleNear( opacity, 1.0 ) )
+  {
+    img = img.copy();
+    QgsSymbolLayerUtils::multiplyImageOpacity( &img, opacity );
+  }
+
+  mLastImage = img;
+  mLastImagePath = path;
+  mLastImageSize = size;
+  mLastImageFill = fill;
+  mLastImageStroke = stroke;
+  mLastImageStrokeWidth = strokeWidth;
+  mLastImageScaleFactor = widthScaleFactor;
+  mLastImageAspectRatio = aspectRatio;
+  mLastImageOpacity = opacity;
+  return mLastImage;
 }
 
 void QgsSvgMarkerSymbolLayer::renderPoint( QPointF point, QgsSymbolRenderContext &context )
@@ -2013,23 +2051,13 @@ void QgsSvgMarkerSymbolLayer::renderPoint( QPointF point, QgsSymbolRenderContext
   if ( !context.renderContext().forceVectorOutput() && !rotated )
   {
     usePict = false;
-    QImage img = QgsApplication::svgCache()->svgAsImage( path, size, fillColor, strokeColor, strokeWidth,
-                 context.renderContext().scaleFactor(), fitsInCache, aspectRatio );
+    // opacity is already applied to the image
+    QImage img = markerImage( path, size, fillColor, strokeColor, strokeWidth,
+                              context.renderContext().scaleFactor(), aspectRatio, context.opacity(), fitsInCache );
     if ( fitsInCache && img.width() > 1 )
     {
-      //consider transparency
-      if ( !qgsDoubleNear( context.opacity(), 1.0 ) )
-      {
-        QImage transparentImage = img.copy();
-        QgsSymbolLayerUtils::multiplyImageOpacity( &transparentImage, context.opacity() );
-        p->drawImage( -transparentImage.width() / 2.0, -transparentImage.height() / 2.0, transparentImage );
-        hwRatio = static_cast< double >( transparentImage.height() ) / static_cast< double >( transparentImage.width() );
-      }
-      else
-      {
-        p->drawImage( -img.width() / 2.0, -img.height() / 2.0, img );
-        hwRatio = static_cast< double >( img.height() ) / static_cast< double >( img.width() );
-      }
+      p->drawImage( -img.width() / 2.0, -img.height() / 2.0, img );
+      hwRatio = static_cast< double >( img.height() ) / static_cast< double >( img.width() );
     }
   }
 
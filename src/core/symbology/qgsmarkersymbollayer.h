@@ -632,6 +632,20 @@ class CORE_EXPORT QgsSvgMarkerSymbolLayer : public QgsMarkerSymbolLayer
   private:
     double calculateSize( QgsSymbolRenderContext &context, bool &hasDataDefinedSize ) const;
     void calculateOffsetAndRotation( QgsSymbolRenderContext &context, double scaledSize, QPointF &offset, double &angle ) const;
+    //! Returns the marker image from the SVG cache, or the last one if it was rendered with the same parameters
+    QImage markerImage( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
+                        double widthScaleFactor, double aspectRatio, double opacity, bool &fitsInCache );
+    //! Last marker image, with opacity applied, and its parameters. Consecutive features with the same
+    //! parameters reuse it instead of locking the SVG cache for each of them
+    QImage mLastImage;
+    QString mLastImagePath;
+    double mLastImageSize = 0;
+    QColor mLastImageFill;
+    QColor mLastImageStroke;
+    double mLastImageStrokeWidth = 0;
+    double mLastImageScaleFactor = 0;
+    double mLastImageAspectRatio = 0;
+    double mLastImageOpacity = 1.0;
 
 };
 
@@ -76,6 +76,41 @@ int QgsSvgCacheEntry::dataSize() const
   }
   return size;
 }
+
+QgsSvgCacheKey::QgsSvgCacheKey( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
+                                double widthScaleFactor, double fixedAspectRatio )
+  : path( path )
+  , size( size )
+  , fill( fill )
+  , stroke( stroke )
+  , strokeWidth( strokeWidth )
+  , widthScaleFactor( widthScaleFactor )
+  , fixedAspectRatio( fixedAspectRatio )
+{
+}
+
+QgsSvgCacheKey::QgsSvgCacheKey( const QgsSvgCacheEntry &entry )
+  : QgsSvgCacheKey( entry.path, entry.size, entry.fill, entry.stroke, entry.strokeWidth, entry.widthScaleFactor, entry.fixedAspectRatio )
+{
+}
+
+bool QgsSvgCacheKey::operator==( const QgsSvgCacheKey &other ) const
+{
+  return other.path == path && other.size == size && other.fill == fill && other.stroke == stroke &&
+         other.strokeWidth == strokeWidth && other.widthScaleFactor == widthScaleFactor && other.fixedAspectRatio == fixedAspectRatio;
+}
+
+uint qHash( const QgsSvgCacheKey &key )
+{
+  uint h = qHash( key.path );
+  h ^= qHash( key.size ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  h ^= qHash( key.fill.rgba() ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  h ^= qHash( key.stroke.rgba() ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  h ^= qHash( key.strokeWidth ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  h ^= qHash( key.widthScaleFactor ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  h ^= qHash( key.fixedAspectRatio ) + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+  return h;
+}
 ///@endcond
 
 
@@ -103,17 +138,27 @@ QgsSvgCache::QgsSvgCache( QObject *parent )
 
 QgsSvgCache::~QgsSvgCache()
 {
-  qDeleteAll( mEntryLookup );
+  for ( Shard &shard : mShards )
+    qDeleteAll( shard.entries );
+}
+
+QgsSvgCache::Shard &QgsSvgCache::shardForKey( const QgsSvgCacheKey &key )
+{
+  // the hash of the whole key is used, so that the different sizes of a single svg file
+  // do not all end up in the same shard
+  return mShards[ qHash( key ) % SHARD_COUNT ];
 }
 
 
 QImage QgsSvgCache::svgAsImage( const QString &file, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
                                 double widthScaleFactor, bool &fitsInCache, double fixedAspectRatio )
 {
-  QMutexLocker locker( &mMutex );
+  const QgsSvgCacheKey key( file, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  Shard &shard = shardForKey( key );
+  QMutexLocker locker( &shard.mutex );
 
   fitsInCache = true;
-  QgsSvgCacheEntry *currentEntry = cacheEntry( file, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  QgsSvgCacheEntry *currentEntry = cacheEntry( shard, key );
 
   QImage result;
 
@@ -157,7 +202,7 @@ QImage QgsSvgCache::svgAsImage( const QString &file, double size, const QColor &
       cacheImage( currentEntry );
       result = *( currentEntry->image );
     }
-    trimToMaximumSize();
+    trimToMaximumSize( shard );
   }
   else
   {
@@ -170,16 +215,18 @@ QImage QgsSvgCache::svgAsImage( const QString &file, double size, const QColor &
 QPicture QgsSvgCache::svgAsPicture( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
                                     double widthScaleFactor, bool forceVectorOutput, double fixedAspectRatio )
 {
-  QMutexLocker locker( &mMutex );
+  const QgsSvgCacheKey key( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  Shard &shard = shardForKey( key );
+  QMutexLocker locker( &shard.mutex );
 
-  QgsSvgCacheEntry *currentEntry = cacheEntry( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  QgsSvgCacheEntry *currentEntry = cacheEntry( shard, key );
 
   //if current entry picture is 0: cache picture for entry
   //update stats for memory usage
   if ( !currentEntry->picture )
   {
     cachePicture( currentEntry, forceVectorOutput );
-    trimToMaximumSize();
+    trimToMaximumSize( shard );
   }
 
   QPicture p;
@@ -194,49 +241,53 @@ QPicture QgsSvgCache::svgAsPicture( const QString &path, double size, const QCol
 QByteArray QgsSvgCache::svgContent( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
                                     double widthScaleFactor, double fixedAspectRatio )
 {
-  QMutexLocker locker( &mMutex );
+  const QgsSvgCacheKey key( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  Shard &shard = shardForKey( key );
+  QMutexLocker locker( &shard.mutex );
 
-  QgsSvgCacheEntry *currentEntry = cacheEntry( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  QgsSvgCacheEntry *currentEntry = cacheEntry( shard, key );
 
   return currentEntry->svgContent;
 }
 
 QSizeF QgsSvgCache::svgViewboxSize( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth, double widthScaleFactor, double fixedAspectRatio )
 {
-  QMutexLocker locker( &mMutex );
+  const QgsSvgCacheKey key( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  Shard &shard = shardForKey( key );
+  QMutexLocker locker( &shard.mutex );
 
-  QgsSvgCacheEntry *currentEntry = cacheEntry( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+  QgsSvgCacheEntry *currentEntry = cacheEntry( shard, key );
 
   return currentEntry->viewboxSize;
 }
 
-QgsSvgCacheEntry *QgsSvgCache::insertSvg( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
-    double widthScaleFactor, double fixedAspectRatio )
+QgsSvgCacheEntry *QgsSvgCache::insertSvg( Shard &shard, const QgsSvgCacheKey &key )
 {
-  QgsSvgCacheEntry *entry = new QgsSvgCacheEntry( path, size, strokeWidth, widthScaleFactor, fill, stroke, fixedAspectRatio );
+  QgsSvgCacheEntry *entry = new QgsSvgCacheEntry( key.path, key.size, key.strokeWidth, key.widthScaleFactor, key.fill, key.stroke, key.fixedAspectRatio );
   entry->mFileModifiedCheckTimeout = mFileModifiedCheckTimeout;
 
   replaceParamsAndCacheSvg( entry );
 
-  mEntryLookup.insert( path, entry );
+  shard.entries.insert( key, entry );
 
   //insert to most recent place in entry list
-  if ( !mMostRecentEntry ) //inserting first entry
+  touchEntry( entry );
+  if ( !shard.mostRecentEntry ) //inserting first entry
   {
-    mLeastRecentEntry = entry;
-    mMostRecentEntry = entry;
+    shard.leastRecentEntry = entry;
+    shard.mostRecentEntry = entry;
     entry->previousEntry = nullptr;
     entry->nextEntry = nullptr;
   }
   else
   {
-    entry->previousEntry = mMostRecentEntry;
+    entry->previousEntry = shard.mostRecentEntry;
     entry->nextEntry = nullptr;
-    mMostRecentEntry->nextEntry = entry;
-    mMostRecentEntry = entry;
+    shard.mostRecentEntry->nextEntry = entry;
+    shard.mostRecentEntry = entry;
   }
 
-  trimToMaximumSize();
+  trimToMaximumSize( shard );
   return entry;
 }
 
@@ -326,7 +377,7 @@ void QgsSvgCache::replaceParamsAndCacheSvg( QgsSvgCacheEntry *entry )
   entry->svgContent.replace( "\n<tspan", "<tspan" );
   entry->svgContent.replace( "</tspan>\n", "</tspan>" );
 
-  mTotalSize += entry->svgContent.size();
+  mTotalSize.fetchAndAddOrdered( entry->svgContent.size() );
 }
 
 double QgsSvgCache::calcSizeScaleFactor( QgsSvgCacheEntry *entry, const QDomElement &docElem, QSizeF &viewboxSize ) const
@@ -536,7 +587,7 @@ void QgsSvgCache::cacheImage( QgsSvgCacheEntry *entry )
     r.render( &p, rect );
   }
 
-  mTotalSize += ( image->width() * image->height() * 32 );
+  mTotalSize.fetchAndAddOrdered( image->width() * image->height() * 32 );
   entry->image = std::move( image );
 }
 
@@ -579,34 +630,23 @@ void QgsSvgCache::cachePicture( QgsSvgCacheEntry *entry, bool forceVectorOutput
   QPainter p( picture.get() );
   r.render( &p, rect );
   entry->picture = std::move( picture );
-  mTotalSize += entry->picture->size();
+  mTotalSize.fetchAndAddOrdered( entry->picture->size() );
 }
 
-QgsSvgCacheEntry *QgsSvgCache::cacheEntry( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
-    double widthScaleFactor, double fixedAspectRatio )
+QgsSvgCacheEntry *QgsSvgCache::cacheEntry( Shard &shard, const QgsSvgCacheKey &key )
 {
-  //search entries in mEntryLookup
-  QgsSvgCacheEntry *currentEntry = nullptr;
-  QList<QgsSvgCacheEntry *> entries = mEntryLookup.values( path );
-  QDateTime modified;
-  QList<QgsSvgCacheEntry *>::iterator entryIt = entries.begin();
-  for ( ; entryIt != entries.end(); ++entryIt )
+  QgsSvgCacheEntry *currentEntry = shard.entries.value( key );
+  if ( currentEntry && ( mFileModifiedCheckTimeout <= 0 || currentEntry->fileModifiedLastCheckTimer.hasExpired( mFileModifiedCheckTimeout ) ) )
   {
-    QgsSvgCacheEntry *cacheEntry = *entryIt;
-    if ( qgsDoubleNear( cacheEntry->size, size ) && cacheEntry->fill == fill && cacheEntry->stroke == stroke &&
-         qgsDoubleNear( cacheEntry->strokeWidth, strokeWidth ) && qgsDoubleNear( cacheEntry->widthScaleFactor, widthScaleFactor ) &&
-         qgsDoubleNear( cacheEntry->fixedAspectRatio, fixedAspectRatio ) )
+    if ( currentEntry->fileModified != QFileInfo( key.path ).lastModified() )
     {
-      if ( mFileModifiedCheckTimeout <= 0 || cacheEntry->fileModifiedLastCheckTimer.hasExpired( mFileModifiedCheckTimeout ) )
-      {
-        if ( !modified.isValid() )
-          modified = QFileInfo( path ).lastModified();
-
-        if ( cacheEntry->fileModified != modified )
-          continue;
-      }
-      currentEntry = cacheEntry;
-      break;
+      // the file changed since it was cached
+      removeCacheEntry( shard, currentEntry );
+      currentEntry = nullptr;
+    }
+    else
+    {
+      currentEntry->fileModifiedLastCheckTimer.restart();
     }
   }
 
@@ -614,22 +654,25 @@ QgsSvgCacheEntry *QgsSvgCache::cacheEntry( const QString &path, double size, con
   //cache and replace params in svg content
   if ( !currentEntry )
   {
-    currentEntry = insertSvg( path, size, fill, stroke, strokeWidth, widthScaleFactor, fixedAspectRatio );
+    currentEntry = insertSvg( shard, key );
   }
   else
   {
-    takeEntryFromList( currentEntry );
-    if ( !mMostRecentEntry ) //list is empty
+    touchEntry( currentEntry );
+    takeEntryFromList( shard, currentEntry );
+    if ( !shard.mostRecentEntry ) //list is empty
     {
-      mMostRecentEntry = currentEntry;
-      mLeastRecentEntry = currentEntry;
+      currentEntry->previousEntry = nullptr;
+      currentEntry->nextEntry = nullptr;
+      shard.mostRecentEntry = currentEntry;
+      shard.leastRecentEntry = currentEntry;
     }
     else
     {
-      mMostRecentEntry->nextEntry = currentEntry;
-      currentEntry->previousEntry = mMostRecentEntry;
+      shard.mostRecentEntry->nextEntry = currentEntry;
+      currentEntry->previousEntry = shard.mostRecentEntry;
       currentEntry->nextEntry = nullptr;
-      mMostRecentEntry = currentEntry;
+      shard.mostRecentEntry = currentEntry;
     }
   }
 
@@ -905,24 +948,30 @@ void QgsSvgCache::containsElemParams( const QDomElement &elem, bool &hasFillPara
   }
 }
 
-void QgsSvgCache::removeCacheEntry( const QString &s, QgsSvgCacheEntry *entry )
+void QgsSvgCache::removeCacheEntry( Shard &shard, QgsSvgCacheEntry *entry )
 {
+  takeEntryFromList( shard, entry );
+  shard.entries.remove( QgsSvgCacheKey( *entry ) );
+  mTotalSize.fetchAndAddOrdered( -entry->dataSize() );
   delete entry;
-  mEntryLookup.remove( s, entry );
 }
 
 void QgsSvgCache::printEntryList()
 {
   QgsDebugMsg( "****************svg cache entry list*************************" );
-  QgsDebugMsg( "Cache size: " + QString::number( mTotalSize ) );
-  QgsSvgCacheEntry *entry = mLeastRecentEntry;
-  while ( entry )
+  QgsDebugMsg( "Cache size: " + QString::number( mTotalSize.load() ) );
+  for ( Shard &shard : mShards )
   {
-    QgsDebugMsg( "***Entry:" );
-    QgsDebugMsg( "File:" + entry->path );
-    QgsDebugMsg( "Size:" + QString::number( entry->size ) );
-    QgsDebugMsg( "Width scale factor" + QString::number( entry->widthScaleFactor ) );
-    entry = entry->nextEntry;
+    QMutexLocker locker( &shard.mutex );
+    QgsSvgCacheEntry *entry = shard.leastRecentEntry;
+    while ( entry )
+    {
+      QgsDebugMsg( "***Entry:" );
+      QgsDebugMsg( "File:" + entry->path );
+      QgsDebugMsg( "Size:" + QString::number( entry->size ) );
+      QgsDebugMsg( "Width scale factor" + QString::number( entry->widthScaleFactor ) );
+      entry = entry->nextEntry;
+    }
   }
 }
 
@@ -973,27 +1022,49 @@ QImage QgsSvgCache::imageFromCachedPicture( const QgsSvgCacheEntry &entry ) cons
   return image;
 }
 
-void QgsSvgCache::trimToMaximumSize()
+void QgsSvgCache::trimToMaximumSize( Shard &shard )
 {
-  //only one entry in cache
-  if ( mLeastRecentEntry == mMostRecentEntry )
-  {
+  if ( mTotalSize.load() <= MAXIMUM_SIZE )
     return;
+
+  // the limit applies to the whole cache. Shards locked by other threads are skipped
+  // rather than waited for, as waiting while holding a shard could deadlock
+  QVector< Shard * > lockedShards;
+  lockedShards << &shard;
+  for ( Shard &otherShard : mShards )
+  {
+    if ( &otherShard != &shard && otherShard.mutex.tryLock() )
+      lockedShards << &otherShard;
   }
-  QgsSvgCacheEntry *entry = mLeastRecentEntry;
-  while ( entry && ( mTotalSize > MAXIMUM_SIZE ) )
+
+  // the most recent entry of the locked shard is the one being used, it is never removed
+  const QgsSvgCacheEntry *keptEntry = shard.mostRecentEntry;
+  while ( mTotalSize.load() > MAXIMUM_SIZE )
   {
-    QgsSvgCacheEntry *bkEntry = entry;
-    entry = entry->nextEntry;
+    // the least recent entry of the whole cache is the oldest of the least recent entries of the shards
+    Shard *oldestShard = nullptr;
+    for ( Shard *lockedShard : qgis::as_const( lockedShards ) )
+    {
+      const QgsSvgCacheEntry *entry = lockedShard->leastRecentEntry;
+      if ( !entry || entry == keptEntry )
+        continue;
+      if ( !oldestShard || entry->lastUsed < oldestShard->leastRecentEntry->lastUsed )
+        oldestShard = lockedShard;
+    }
+    if ( !oldestShard )
+      break;
+
+    removeCacheEntry( *oldestShard, oldestShard->leastRecentEntry );
+  }
 
-    takeEntryFromList( bkEntry );
-    mEntryLookup.remove( bkEntry->path, bkEntry );
-    mTotalSize -= bkEntry->dataSize();
-    delete bkEntry;
+  for ( Shard *lockedShard : qgis::as_const( lockedShards ) )
+  {
+    if ( lockedShard != &shard )
+      lockedShard->mutex.unlock();
   }
 }
 
-void QgsSvgCache::takeEntryFromList( QgsSvgCacheEntry *entry )
+void QgsSvgCache::takeEntryFromList( Shard &shard, QgsSvgCacheEntry *entry )
 {
   if ( !entry )
   {
@@ -1006,7 +1077,7 @@ void QgsSvgCache::takeEntryFromList( QgsSvgCacheEntry *entry )
   }
   else
   {
-    mLeastRecentEntry = entry->nextEntry;
+    shard.leastRecentEntry = entry->nextEntry;
   }
   if ( entry->nextEntry )
   {
@@ -1014,7 +1085,7 @@ void QgsSvgCache::takeEntryFromList( QgsSvgCacheEntry *entry )
   }
   else
   {
-    mMostRecentEntry = entry->previousEntry;
+    shard.mostRecentEntry = entry->previousEntry;
   }
 }
 
@@ -1027,19 +1098,23 @@ void QgsSvgCache::downloadProgress( qint64 bytesReceived, qint64 bytesTotal )
 
 void QgsSvgCache::onRemoteSvgFetched( const QString &url, bool success )
 {
-  QMutexLocker locker( &mMutex );
-  mPendingRemoteUrls.remove( url );
+  {
+    QMutexLocker locker( &mMutex );
+    mPendingRemoteUrls.remove( url );
+  }
 
-  QgsSvgCacheEntry *nextEntry = mLeastRecentEntry;
-  while ( QgsSvgCacheEntry *entry = nextEntry )
+  // the shards are locked after the remote content, never while holding it
+  for ( Shard &shard : mShards )
   {
-    nextEntry = entry->nextEntry;
-    if ( entry->path == url )
+    QMutexLocker locker( &shard.mutex );
+    QgsSvgCacheEntry *nextEntry = shard.leastRecentEntry;
+    while ( QgsSvgCacheEntry *entry = nextEntry )
     {
-      takeEntryFromList( entry );
-      mEntryLookup.remove( entry->path, entry );
-      mTotalSize -= entry->dataSize();
-      delete entry;
+      nextEntry = entry->nextEntry;
+      if ( entry->path == url )
+      {
+        removeCacheEntry( shard, entry );
+      }
     }
   }
 
@@ -33,6 +33,8 @@
 #include <QImage>
 #include <QCache>
 #include <QSet>
+#include <QHash>
+#include <QAtomicInteger>
 
 #include "qgis_core.h"
 
@@ -102,6 +104,8 @@ class CORE_EXPORT QgsSvgCacheEntry
     //keep entries on a least, sorted by last access
     QgsSvgCacheEntry *nextEntry = nullptr;
     QgsSvgCacheEntry *previousEntry = nullptr;
+    //! Stamp of the last use of the entry, increasing across all the shards of the cache
+    quint64 lastUsed = 0;
 
     //! Don't consider image, picture, last used timestamp for comparison
     bool operator==( const QgsSvgCacheEntry &other ) const;
@@ -115,6 +119,37 @@ class CORE_EXPORT QgsSvgCacheEntry
 
 };
 
+/**
+ * \ingroup core
+ * \class QgsSvgCacheKey
+ * Render parameters identifying an entry of the SVG cache.
+ * \since QGIS 3.4
+ */
+class CORE_EXPORT QgsSvgCacheKey
+{
+  public:
+
+    //! Constructor for QgsSvgCacheKey
+    QgsSvgCacheKey( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
+                    double widthScaleFactor, double fixedAspectRatio );
+
+    //! Constructor for QgsSvgCacheKey, for the parameters of \a entry
+    explicit QgsSvgCacheKey( const QgsSvgCacheEntry &entry );
+
+    QString path;
+    double size = 0.0;
+    QColor fill;
+    QColor stroke;
+    double strokeWidth = 0;
+    double widthScaleFactor = 1.0;
+    double fixedAspectRatio = 0;
+
+    bool operator==( const QgsSvgCacheKey &other ) const;
+};
+
+//! Returns a hash for the render parameters \a key
+CORE_EXPORT uint qHash( const QgsSvgCacheKey &key );
+
 ///@endcond
 #endif
 
@@ -242,43 +277,63 @@ class CORE_EXPORT QgsSvgCache : public QObject
   private:
 
     /**
-     * Creates new cache entry and returns pointer to it
-     * \param path Absolute path to SVG file
-     * \param size size of cached image
-     * \param fill color of fill
-     * \param stroke color of stroke
-     * \param strokeWidth width of stroke
-     * \param widthScaleFactor width scale factor
-     * \param fixedAspectRatio fixed aspect ratio (optional)
+     * Part of the cache holding the entries whose render parameters hash to it.
+     * Each shard has its own lock, so that threads rendering different symbols do not wait for each other.
      */
-    QgsSvgCacheEntry *insertSvg( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
-                                 double widthScaleFactor, double fixedAspectRatio = 0 );
+    struct Shard
+    {
+      //! Mutex to prevent concurrent access to the shard from multiple threads at once (may corrupt the entries otherwise).
+      QMutex mutex;
+      //! Entry pointers accessible by render parameters
+      QHash< QgsSvgCacheKey, QgsSvgCacheEntry * > entries;
+
+      //The shard keeps the entries on a double connected list, moving the current entry to the front.
+      //That way, removing entries for more space can start with the least used objects.
+      QgsSvgCacheEntry *leastRecentEntry = nullptr;
+      QgsSvgCacheEntry *mostRecentEntry = nullptr;
+    };
+
+    //! Returns the shard holding the entry for \a key
+    Shard &shardForKey( const QgsSvgCacheKey &key );
+
+    /**
+     * Creates new cache entry in \a shard for the render parameters \a key and returns pointer to it.
+     * The shard must be locked.
+     */
+    QgsSvgCacheEntry *insertSvg( Shard &shard, const QgsSvgCacheKey &key );
 
     void replaceParamsAndCacheSvg( QgsSvgCacheEntry *entry );
     void cacheImage( QgsSvgCacheEntry *entry );
     void cachePicture( QgsSvgCacheEntry *entry, bool forceVectorOutput = false );
-    //! Returns entry from cache or creates a new entry if it does not exist already
-    QgsSvgCacheEntry *cacheEntry( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
-                                  double widthScaleFactor, double fixedAspectRatio = 0 );
+    //! Returns entry from \a shard or creates a new entry if it does not exist already. The shard must be locked.
+    QgsSvgCacheEntry *cacheEntry( Shard &shard, const QgsSvgCacheKey &key );
 
-    //! Removes the least used items until the maximum size is under the limit
-    void trimToMaximumSize();
+    /**
+     * Removes the least recently used items of all shards until the total size is under the limit.
+     * \a shard must be locked, its most recent entry is kept. The other shards are only trimmed if
+     * they are not in use.
+     */
+    void trimToMaximumSize( Shard &shard );
 
-    //Removes entry from the ordered list (but does not delete the entry itself)
-    void takeEntryFromList( QgsSvgCacheEntry *entry );
+    //! Marks \a entry as the most recently used one of the whole cache
+    void touchEntry( QgsSvgCacheEntry *entry ) { entry->lastUsed = mUseCounter.fetchAndAddOrdered( 1 ) + 1; }
+
+    //Removes entry from the ordered list of the shard (but does not delete the entry itself)
+    void takeEntryFromList( Shard &shard, QgsSvgCacheEntry *entry );
 
     //! Minimum time (in ms) between consecutive svg file modified time checks
     int mFileModifiedCheckTimeout = 30000;
 
-    //! Entry pointers accessible by file name
-    QMultiHash< QString, QgsSvgCacheEntry * > mEntryLookup;
+    //! Number of shards of the cache
+    static const int SHARD_COUNT = 16;
+
+    Shard mShards[SHARD_COUNT];
+
     //! Estimated total size of all images, pictures and svgContent
-    long mTotalSize = 0;
+    QAtomicInteger< qint64 > mTotalSize;
 
-    //The svg cache keeps the entries on a double connected list, moving the current entry to the front.
-    //That way, removing entries for more space can start with the least used objects.
-    QgsSvgCacheEntry *mLeastRecentEntry = nullptr;
-    QgsSvgCacheEntry *mMostRecentEntry = nullptr;
+    //! Counter of the uses of entries, used to compare their recency across the shards
+    QAtomicInteger< quint64 > mUseCounter;
 
     //! Maximum cache size
     static const long MAXIMUM_SIZE = 20000000;
@@ -296,8 +351,8 @@ class CORE_EXPORT QgsSvgCache : public QObject
     //! Calculates scaling for rendered image sizes to SVG logical sizes
     double calcSizeScaleFactor( QgsSvgCacheEntry *entry, const QDomElement &docElem, QSizeF &viewboxSize ) const;
 
-    //! Release memory and remove cache entry from mEntryLookup
-    void removeCacheEntry( const QString &s, QgsSvgCacheEntry *entry );
+    //! Release memory and remove cache entry from \a shard
+    void removeCacheEntry( Shard &shard, QgsSvgCacheEntry *entry );
 
     //! For debugging
     void printEntryList();
@@ -320,7 +375,7 @@ class CORE_EXPORT QgsSvgCache : public QObject
 
     QByteArray mFetchingSvg;
 
-    //! Mutex to prevent concurrent access to the class from multiple threads at once (may corrupt the entries otherwise).
+    //! Mutex to prevent concurrent access to the remote content from multiple threads at once.
     mutable QMutex mMutex;
 
     mutable QCache< QString, QByteArray > mRemoteContentCache;
@@ -48,6 +48,7 @@
 #include <QSvgGenerator>
 
 #include <cmath>
+#include <algorithm>
 #include <map>
 #include <random>
 
@@ -100,11 +101,29 @@ QgsSymbol::QgsSymbol( SymbolType type, const QgsSymbolLayerList &layers )
 }
 Q_NOWARN_DEPRECATED_POP
 
+//! Removes non-finite points, e.g. infinite or NaN points caused by reprojecting errors
+static void removeNonFinitePoints( QPolygonF &pts )
+{
+  const auto firstNonFinite = std::find_if( pts.constBegin(), pts.constEnd(), []( const QPointF point )
+  {
+    return !std::isfinite( point.x() ) || !std::isfinite( point.y() );
+  } );
+  // avoid detaching the polygon if there is nothing to remove
+  if ( firstNonFinite == pts.constEnd() )
+    return;
+
+  pts.erase( std::remove_if( pts.begin() + ( firstNonFinite - pts.constBegin() ), pts.end(),
+                             []( const QPointF point )
+  {
+    return !std::isfinite( point.x() ) || !std::isfinite( point.y() );
+  } ), pts.end() );
+}
+
 QPolygonF QgsSymbol::_getLineString( QgsRenderContext &context, const QgsCurve &curve, bool clipToExtent )
 {
   const unsigned int nPoints = curve.numPoints();
 
-  QgsCoordinateTransform ct = context.coordinateTransform();
+  const QgsCoordinateTransform &ct = context.coordinateTransform();
   const QgsMapToPixel &mtp = context.mapToPixel();
   QPolygonF pts;
 
@@ -123,67 +142,58 @@ QPolygonF QgsSymbol::_getLineString( QgsRenderContext &context, const QgsCurve &
   }
 
   //transform the QPolygonF to screen coordinates
-  if ( ct.isValid() )
+  if ( const QgsInterpolatedCoordinateTransform *approximateTransform = context.approximateTransform() )
   {
-    ct.transformPolygon( pts );
+    approximateTransform->transformPolygon( pts );
   }
-
-  // remove non-finite points, e.g. infinite or NaN points caused by reprojecting errors
-  pts.erase( std::remove_if( pts.begin(), pts.end(),
-                             []( const QPointF point )
-  {
-    return !std::isfinite( point.x() ) || !std::isfinite( point.y() );
-  } ), pts.end() );
-
-  QPointF *ptr = pts.data();
-  for ( int i = 0; i < pts.size(); ++i, ++ptr )
+  else if ( ct.isValid() )
   {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
+    ct.transformPolygon( pts );
   }
 
+  removeNonFinitePoints( pts );
+  mtp.transformInPlace( pts );
+
   return pts;
 }
 
 QPolygonF QgsSymbol::_getPolygonRing( QgsRenderContext &context, const QgsCurve &curve, bool clipToExtent )
 {
-  const QgsCoordinateTransform ct = context.coordinateTransform();
+  if ( curve.numPoints() < 1 )
+    return QPolygonF();
+
+  const QgsCoordinateTransform &ct = context.coordinateTransform();
   const QgsMapToPixel &mtp = context.mapToPixel();
-  const QgsRectangle &e = context.extent();
-  const double cw = e.width() / 10;
-  const double ch = e.height() / 10;
-  QgsRectangle clipRect( e.xMinimum() - cw, e.yMinimum() - ch, e.xMaximum() + cw, e.yMaximum() + ch );
 
   QPolygonF poly = curve.asQPolygonF();
 
-  if ( curve.numPoints() < 1 )
-    return QPolygonF();
-
   //clip close to view extent, if needed
-  const QRectF ptsRect = poly.boundingRect();
-  if ( clipToExtent && !context.extent().contains( ptsRect ) )
+  if ( clipToExtent )
   {
-    QgsClipper::trimPolygon( poly, clipRect );
+    const QRectF ptsRect = poly.boundingRect();
+    if ( !context.extent().contains( ptsRect ) )
+    {
+      const QgsRectangle &e = context.extent();
+      const double cw = e.width() / 10;
+      const double ch = e.height() / 10;
+      const QgsRectangle clipRect( e.xMinimum() - cw, e.yMinimum() - ch, e.xMaximum() + cw, e.yMaximum() + ch );
+      QgsClipper::trimPolygon( poly, clipRect );
+    }
   }
 
   //transform the QPolygonF to screen coordinates
-  if ( ct.isValid() )
+  if ( const QgsInterpolatedCoordinateTransform *approximateTransform = context.approximateTransform() )
   {
-    ct.transformPolygon( poly );
+    approximateTransform->transformPolygon( poly );
   }
-
-  // remove non-finite points, e.g. infinite or NaN points caused by reprojecting errors
-  poly.erase( std::remove_if( poly.begin(), poly.end(),
-                              []( const QPointF point )
-  {
-    return !std::isfinite( point.x() ) || !std::isfinite( point.y() );
-  } ), poly.end() );
-
-  QPointF *ptr = poly.data();
-  for ( int i = 0; i < poly.size(); ++i, ++ptr )
+  else if ( ct.isValid() )
   {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
+    ct.transformPolygon( poly );
   }
 
+  removeNonFinitePoints( poly );
+  mtp.transformInPlace( poly );
+
   return poly;
 }
 
@@ -25,6 +25,7 @@
 #include "qgsfeature.h"
 #include "qgsfields.h"
 #include "qgsrendercontext.h"
+#include "qgsinterpolatedcoordinatetransform.h"
 #include "qgsproperty.h"
 
 class QColor;
@@ -427,7 +428,14 @@ class CORE_EXPORT QgsSymbol
     static inline QPointF _getPoint( QgsRenderContext &context, const QgsPoint &point )
     {
       QPointF pt;
-      if ( context.coordinateTransform().isValid() )
+      if ( const QgsInterpolatedCoordinateTransform *approximateTransform = context.approximateTransform() )
+      {
+        double x = point.x();
+        double y = point.y();
+        approximateTransform->transformInPlace( x, y );
+        pt = QPointF( x, y );
+      }
+      else if ( context.coordinateTransform().isValid() )
       {
         double x = point.x();
         double y = point.y();
@@ -41,7 +41,8 @@ QgsMapCanvasTracer::QgsMapCanvasTracer( QgsMapCanvas *canvas, QgsMessageBar *mes
   connect( canvas, &QgsMapCanvas::destinationCrsChanged, this, &QgsMapCanvasTracer::invalidateGraph );
   connect( canvas, &QgsMapCanvas::transformContextChanged, this, &QgsMapCanvasTracer::invalidateGraph );
   connect( canvas, &QgsMapCanvas::layersChanged, this, &QgsMapCanvasTracer::invalidateGraph );
-  connect( canvas, &QgsMapCanvas::extentsChanged, this, &QgsMapCanvasTracer::invalidateGraph );
+  // the graph is extended to the new extent when needed
+  connect( canvas, &QgsMapCanvas::extentsChanged, this, &QgsMapCanvasTracer::onExtentsChanged );
   connect( canvas, &QgsMapCanvas::currentLayerChanged, this, &QgsMapCanvasTracer::onCurrentLayerChanged );
   connect( canvas->snappingUtils(), &QgsSnappingUtils::configChanged, this, &QgsMapCanvasTracer::invalidateGraph );
 
@@ -133,6 +134,11 @@ void QgsMapCanvasTracer::configure()
   setLayers( layers );
 }
 
+void QgsMapCanvasTracer::onExtentsChanged()
+{
+  setExtent( mCanvas->extent() );
+}
+
 void QgsMapCanvasTracer::onCurrentLayerChanged()
 {
   // no need to bother if we are not snapping
@@ -83,6 +83,7 @@ class GUI_EXPORT QgsMapCanvasTracer : public QgsTracer
     void configure() override;
 
   private slots:
+    void onExtentsChanged();
     void onCurrentLayerChanged();
 
   private:
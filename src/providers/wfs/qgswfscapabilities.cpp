@@ -69,6 +69,7 @@ void QgsWfsCapabilities::Capabilities::clear()
   supportsPaging = false;
   supportsJoins = false;
   version.clear();
+  updateSequence.clear();
   featureTypes.clear();
   spatialPredicatesList.clear();
   functionList.clear();
@@ -163,6 +164,9 @@ void QgsWfsCapabilities::capabilitiesReplyFinished()
     return;
   }
 
+  // Optional, but when present, it allows to detect server-side changes
+  mCaps.updateSequence = doc.attribute( QStringLiteral( "updateSequence" ) );
+
   // WFS 2.0 implementation are supposed to implement resultType=hits, and some
   // implementations (GeoServer) might advertize it, whereas others (MapServer) do not.
   // WFS 1.1 implementation too I think, but in the examples of the GetCapabilities
@@ -89,6 +89,7 @@ class QgsWfsCapabilities : public QgsWfsRequest
       Capabilities();
 
       QString version;
+      QString updateSequence;
       bool supportsHits;
       bool supportsPaging;
       bool supportsJoins;
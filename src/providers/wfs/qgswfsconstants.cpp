@@ -40,6 +40,7 @@ const QString QgsWFSConstants::URI_PARAM_VALIDATESQLFUNCTIONS( QStringLiteral( "
 const QString QgsWFSConstants::URI_PARAM_HIDEDOWNLOADPROGRESSDIALOG( QStringLiteral( "hideDownloadProgressDialog" ) );
 const QString QgsWFSConstants::URI_PARAM_PAGING_ENABLED( "pagingEnabled" );
 const QString QgsWFSConstants::URI_PARAM_PAGE_SIZE( "pageSize" );
+const QString QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE( "persistentCache" );
 
 const QString QgsWFSConstants::VERSION_AUTO( QStringLiteral( "auto" ) );
 
@@ -53,3 +54,6 @@ const QString QgsWFSConstants::FIELD_GEN_COUNTER( QStringLiteral( "__qgis_gen_co
 const QString QgsWFSConstants::FIELD_GMLID( QStringLiteral( "__qgis_gmlid" ) );
 const QString QgsWFSConstants::FIELD_HEXWKB_GEOM( QStringLiteral( "__qgis_hexwkb_geom" ) );
 const QString QgsWFSConstants::FIELD_MD5( QStringLiteral( "__qgis_md5" ) );
+
+const QString QgsWFSConstants::CACHE_TABLE_METADATA( QStringLiteral( "__qgis_wfs_cache_metadata" ) );
+const QString QgsWFSConstants::CACHE_TABLE_REGIONS( QStringLiteral( "__qgis_wfs_cache_regions" ) );
@@ -48,6 +48,7 @@ struct QgsWFSConstants
   static const QString URI_PARAM_HIDEDOWNLOADPROGRESSDIALOG;
   static const QString URI_PARAM_PAGING_ENABLED;
   static const QString URI_PARAM_PAGE_SIZE;
+  static const QString URI_PARAM_PERSISTENT_CACHE;
 
   //
   static const QString VERSION_AUTO;
@@ -64,6 +65,10 @@ struct QgsWFSConstants
   static const QString FIELD_GMLID;
   static const QString FIELD_HEXWKB_GEOM;
   static const QString FIELD_MD5;
+
+  // Special tables of the persistent cache
+  static const QString CACHE_TABLE_METADATA;
+  static const QString CACHE_TABLE_REGIONS;
 };
 
 #endif // QGSWFSCONSTANTS_H
@@ -320,6 +320,13 @@ bool QgsWFSDataSourceURI::hideDownloadProgressDialog() const
   return mURI.hasParam( QgsWFSConstants::URI_PARAM_HIDEDOWNLOADPROGRESSDIALOG );
 }
 
+bool QgsWFSDataSourceURI::persistentCache() const
+{
+  if ( !mURI.hasParam( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE ) )
+    return false;
+  return mURI.param( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE ) == QStringLiteral( "true" );
+}
+
 QString QgsWFSDataSourceURI::build( const QString &baseUri,
                                     const QString &typeName,
                                     const QString &crsString,
@@ -156,6 +156,9 @@ class QgsWFSDataSourceURI
     //! Whether to hide download progress dialog in QGIS main app. Defaults to false
     bool hideDownloadProgressDialog() const;
 
+    //! Whether the on-disk feature cache should be kept between sessions. Defaults to false
+    bool persistentCache() const;
+
     //! Returns authorization parameters
     QgsWFSAuthorization &auth() { return mAuth; }
 
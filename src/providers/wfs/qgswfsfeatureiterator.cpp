@@ -35,6 +35,9 @@
 #include <QTimer>
 #include <QStyle>
 
+//! Maximum number of bytes of a GetFeature response passed at once to the GML parser
+static const int MAX_PARSED_CHUNK_SIZE = 10 * 1024 * 1024;
+
 QgsWFSFeatureHitsAsyncRequest::QgsWFSFeatureHitsAsyncRequest( QgsWFSDataSourceURI &uri )
   : QgsWfsRequest( uri )
   , mNumberMatched( -1 )
@@ -77,6 +80,38 @@ QString QgsWFSFeatureHitsAsyncRequest::errorMessageWithReason( const QString &re
 
 // -------------------------
 
+QgsWFSFeaturePageAsyncRequest::QgsWFSFeaturePageAsyncRequest( QgsWFSDataSourceURI &uri, qint64 startIndex )
+  : QgsWfsRequest( uri )
+  , mStartIndex( startIndex )
+{
+  connect( this, &QgsWfsRequest::downloadFinished, this, &QgsWFSFeaturePageAsyncRequest::pageReplyFinished );
+}
+
+void QgsWFSFeaturePageAsyncRequest::launch( const QUrl &url )
+{
+  mFinished = false;
+  if ( !sendGET( url,
+                 false, /* synchronous */
+                 true, /* forceRefresh */
+                 false /* cache */ ) && mErrorCode != NoError )
+  {
+    // sendGET() failed before issuing the request (e.g authentication error)
+    mFinished = true;
+  }
+}
+
+void QgsWFSFeaturePageAsyncRequest::pageReplyFinished()
+{
+  mFinished = true;
+}
+
+QString QgsWFSFeaturePageAsyncRequest::errorMessageWithReason( const QString &reason )
+{
+  return tr( "Download of features failed: %1" ).arg( reason );
+}
+
+// -------------------------
+
 QgsWFSFeatureDownloader::QgsWFSFeatureDownloader( QgsWFSSharedData *shared )
   : QgsWfsRequest( shared->mURI )
   , mShared( shared )
@@ -90,6 +125,9 @@ QgsWFSFeatureDownloader::QgsWFSFeatureDownloader( QgsWFSSharedData *shared )
 {
   // Needed because used by a signal
   qRegisterMetaType< QVector<QgsWFSFeatureGmlIdPair> >( "QVector<QgsWFSFeatureGmlIdPair>" );
+
+  QgsSettings s;
+  mMaxConcurrentPageRequests = std::max( 1, s.value( QStringLiteral( "wfs/max_concurrent_page_requests" ), 4 ).toInt() );
 }
 
 QgsWFSFeatureDownloader::~QgsWFSFeatureDownloader()
@@ -423,6 +461,42 @@ void QgsWFSFeatureDownloader::gotHitsResponse()
   }
 }
 
+void QgsWFSFeatureDownloader::prefetchPages( qint64 currentStartIndex, qint64 maxTotalFeatures, qint64 featureCountToFetch )
+{
+  if ( mPageSize <= 0 || mShared->mPageSize <= 0 || mMaxConcurrentPageRequests <= 1 || featureCountToFetch <= 0 )
+    return;
+
+  qint64 lastStartIndex = mPrefetchedPages.empty() ? currentStartIndex : mPrefetchedPages.back()->startIndex();
+  // The page being processed counts as one of the concurrent requests
+  while ( static_cast<int>( mPrefetchedPages.size() ) + 1 < mMaxConcurrentPageRequests )
+  {
+    const qint64 startIndex = lastStartIndex + mShared->mPageSize;
+    if ( startIndex >= featureCountToFetch )
+      break;
+    if ( maxTotalFeatures > 0 && startIndex >= maxTotalFeatures )
+      break;
+
+    // Must be consistent with the computation of maxFeaturesThisRequest in run(),
+    // so that the URL is the same as the one that would have been issued serially
+    int maxFeaturesThisRequest = mShared->mPageSize;
+    if ( maxTotalFeatures > 0 )
+    {
+      maxFeaturesThisRequest = static_cast<int>( std::min( static_cast<qint64>( maxFeaturesThisRequest ), maxTotalFeatures - startIndex ) );
+    }
+
+    std::unique_ptr<QgsWFSFeaturePageAsyncRequest> request = qgis::make_unique<QgsWFSFeaturePageAsyncRequest>( mShared->mURI, startIndex );
+    request->launch( buildURL( startIndex, maxFeaturesThisRequest, false ) );
+    mPrefetchedPages.push_back( std::move( request ) );
+    lastStartIndex = startIndex;
+  }
+}
+
+void QgsWFSFeatureDownloader::abortPrefetchedPages()
+{
+  // Deleting the requests aborts them
+  mPrefetchedPages.clear();
+}
+
 // Starts an asynchronous RESULTTYPE=hits request
 void QgsWFSFeatureDownloader::startHitsRequest()
 {
@@ -431,7 +505,7 @@ void QgsWFSFeatureDownloader::startHitsRequest()
     mNumberMatched = mShared->getFeatureCount( false );
   if ( mNumberMatched < 0 )
   {
-    connect( &mFeatureHitsAsyncRequest, &QgsWFSFeatureHitsAsyncRequest::gotHitsResponse, this, &QgsWFSFeatureDownloader::gotHitsResponse );
+    connect( &mFeatureHitsAsyncRequest, &QgsWFSFeatureHitsAsyncRequest::gotHitsResponse, this, &QgsWFSFeatureDownloader::gotHitsResponse, Qt::UniqueConnection );
     mFeatureHitsAsyncRequest.launch( buildURL( 0, -1, true ) );
   }
 }
@@ -473,6 +547,7 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
   int pagingIter = 1;
   QString gmlIdFirstFeatureFirstIter;
   bool disablePaging = false;
+  qint64 numberMatchedForPaging = -1;
   qint64 maxTotalFeatures = 0;
   if ( maxFeatures > 0 && mShared->mMaxFeatures > 0 )
   {
@@ -519,17 +594,46 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
       url.addQueryItem( QStringLiteral( "RETRY" ), QString::number( retryIter ) );
     }
 
-    sendGET( url,
-             false, /* synchronous */
-             true, /* forceRefresh */
-             false /* cache */ );
+    // If the page has already been requested ahead of time, use that request
+    // instead of issuing a new one
+    std::unique_ptr<QgsWFSFeaturePageAsyncRequest> pageRequest;
+    if ( retryIter == 0 && !mPrefetchedPages.empty() &&
+         mPrefetchedPages.front()->startIndex() == mTotalDownloadedFeatureCount )
+    {
+      pageRequest = std::move( mPrefetchedPages.front() );
+      mPrefetchedPages.pop_front();
+      connect( pageRequest.get(), &QgsWfsRequest::downloadFinished, &loop, &QEventLoop::quit );
+    }
+    else
+    {
+      abortPrefetchedPages();
+      sendGET( url,
+               false, /* synchronous */
+               true, /* forceRefresh */
+               false /* cache */ );
+    }
+
+    // Keep mMaxConcurrentPageRequests requests in flight, provided we know
+    // how many features are to be expected.
+    if ( mPageSize > 0 && !disablePaging && maxFeatures != 1 )
+    {
+      qint64 featureCountToFetch = numberMatchedForPaging;
+      if ( mNumberMatched > 0 )
+        featureCountToFetch = mNumberMatched;
+      else if ( featureCountToFetch <= 0 && mShared->isFeatureCountExact() && mShared->mRect.isNull() )
+        featureCountToFetch = mShared->getFeatureCount( false );
+      prefetchPages( mTotalDownloadedFeatureCount, maxTotalFeatures, featureCountToFetch );
+    }
 
     int featureCountForThisResponse = 0;
     bool bytesStillAvailableInReply = false;
+    // Response of a prefetched page, and the size of its part already parsed
+    QByteArray pageResponse;
+    int pageResponseOffset = 0;
     // Loop until there is no data coming from the current request
     while ( true )
     {
-      if ( !bytesStillAvailableInReply )
+      if ( !bytesStillAvailableInReply && !( pageRequest && pageRequest->isFinished() ) )
       {
         loop.exec( QEventLoop::ExcludeUserInputEvents );
       }
@@ -539,7 +643,13 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
         success = false;
         break;
       }
-      if ( mErrorCode != NoError )
+      if ( pageRequest && pageRequest->errorCode() != NoError )
+      {
+        mErrorMessage = pageRequest->errorMessage();
+        success = false;
+        break;
+      }
+      if ( !pageRequest && mErrorCode != NoError )
       {
         success = false;
         break;
@@ -547,11 +657,24 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
 
       QByteArray data;
       bool finished = false;
-      if ( mReply )
+      if ( pageRequest )
+      {
+        if ( !pageRequest->isFinished() )
+          continue;
+        // A prefetched page is received completely before being processed, but it is
+        // parsed in chunks as well, for the same reason as below.
+        if ( pageResponseOffset == 0 )
+          pageResponse = pageRequest->response();
+        data = pageResponse.mid( pageResponseOffset, MAX_PARSED_CHUNK_SIZE );
+        pageResponseOffset += data.size();
+        finished = pageResponseOffset >= pageResponse.size();
+        bytesStillAvailableInReply = !finished;
+      }
+      else if ( mReply )
       {
         // Limit the number of bytes to process at once, to avoid the GML parser to
         // create too many objects.
-        data = mReply->read( 10 * 1024 * 1024 );
+        data = mReply->read( MAX_PARSED_CHUNK_SIZE );
         bytesStillAvailableInReply = mReply->bytesAvailable() > 0;
       }
       else
@@ -747,6 +870,25 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
       }
     }
 
+    // The number of matched features reported in the first page (WFS 2.0)
+    // is used to plan concurrent page requests. If the server didn't report
+    // it, and there are more pages to come, issue the RESULTTYPE=hits request
+    // right now rather than waiting for the progress dialog timer.
+    if ( pagingIter == 1 && success )
+    {
+      if ( parser->numberMatched() > 0 )
+      {
+        numberMatchedForPaging = parser->numberMatched();
+      }
+      else if ( mPageSize > 0 && mMaxConcurrentPageRequests > 1 && mNumberMatched < 0 &&
+                featureCountForThisResponse == mShared->mPageSize && mShared->supportsHits() &&
+                ( timerForHits.isActive() || !mUseProgressDialog ) )
+      {
+        timerForHits.stop();
+        startHitsRequest();
+      }
+    }
+
     delete parser;
 
     if ( mStop )
@@ -777,6 +919,7 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
     ++ pagingIter;
     if ( disablePaging )
     {
+      abortPrefetchedPages();
       mShared->mPageSize = mPageSize = 0;
       mTotalDownloadedFeatureCount = 0;
       mShared->mPageSize = 0;
@@ -789,6 +932,8 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
 
   mStop = true;
 
+  abortPrefetchedPages();
+
   if ( serializeFeatures )
     mShared->endOfDownload( success, mTotalDownloadedFeatureCount, truncatedResponse, interrupted, mErrorMessage );
 
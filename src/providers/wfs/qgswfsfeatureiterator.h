@@ -22,6 +22,7 @@
 #include "qgsgml.h"
 #include "qgsspatialindex.h"
 
+#include <deque>
 #include <memory>
 #include <QProgressDialog>
 #include <QPushButton>
@@ -62,6 +63,36 @@ class QgsWFSFeatureHitsAsyncRequest: public QgsWfsRequest
 };
 
 
+/**
+ * Utility class to issue a GetFeature request for a page that follows the
+ * one being currently processed, so that several pages can be downloaded
+ * concurrently. The response is entirely buffered. */
+class QgsWFSFeaturePageAsyncRequest: public QgsWfsRequest
+{
+    Q_OBJECT
+  public:
+    QgsWFSFeaturePageAsyncRequest( QgsWFSDataSourceURI &uri, qint64 startIndex );
+
+    void launch( const QUrl &url );
+
+    //! Returns the STARTINDEX of the page
+    qint64 startIndex() const { return mStartIndex; }
+
+    //! Returns whether the response has been completely received (or the request failed)
+    bool isFinished() const { return mFinished; }
+
+  private slots:
+    void pageReplyFinished();
+
+  protected:
+    QString errorMessageWithReason( const QString &reason ) override;
+
+  private:
+    qint64 mStartIndex;
+    bool mFinished = false;
+};
+
+
 //! Utility class for QgsWFSFeatureDownloader
 class QgsWFSProgressDialog: public QProgressDialog
 {
@@ -139,6 +170,18 @@ class QgsWFSFeatureDownloader: public QgsWfsRequest
     void pushError( const QString &errorMsg );
     QString sanitizeFilter( QString filter );
 
+    /**
+     * Issues requests for the pages following the one starting at currentStartIndex,
+     * so that at most mMaxConcurrentPageRequests pages are downloaded at the same time.
+     * \param currentStartIndex STARTINDEX of the page being currently processed
+     * \param maxTotalFeatures user-defined limit of features to download, or 0
+     * \param featureCountToFetch number of features the server is expected to return
+     */
+    void prefetchPages( qint64 currentStartIndex, qint64 maxTotalFeatures, qint64 featureCountToFetch );
+
+    //! Aborts and discards all pending page requests
+    void abortPrefetchedPages();
+
     //! Mutable data shared between provider, feature sources and downloader.
     QgsWFSSharedData *mShared = nullptr;
     //! Whether the download should stop
@@ -158,6 +201,10 @@ class QgsWFSFeatureDownloader: public QgsWfsRequest
     QTimer *mTimer = nullptr;
     QgsWFSFeatureHitsAsyncRequest mFeatureHitsAsyncRequest;
     qint64 mTotalDownloadedFeatureCount;
+    //! Maximum number of GetFeature page requests in flight when paging is enabled
+    int mMaxConcurrentPageRequests;
+    //! Pending requests for the pages following the current one, sorted by STARTINDEX
+    std::deque< std::unique_ptr<QgsWFSFeaturePageAsyncRequest> > mPrefetchedPages;
 };
 
 //! Downloader thread
@@ -738,7 +738,7 @@ QgsAbstractFeatureSource *QgsWFSProvider::featureSource() const
 
 void QgsWFSProvider::reloadData()
 {
-  mShared->invalidateCache();
+  mShared->invalidateCache( true /* discardPersistentCache */ );
   QgsVectorDataProvider::reloadData();
 }
 
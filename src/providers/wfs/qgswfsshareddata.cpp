@@ -14,6 +14,7 @@
  ***************************************************************************/
 
 #include <cmath> // M_PI
+#include <limits>
 
 #include "qgswfsconstants.h"
 #include "qgswfsshareddata.h"
@@ -27,8 +28,13 @@
 #include "qgsvectorfilewriter.h"
 #include "qgsproviderregistry.h"
 #include "qgslogger.h"
+#include "qgssettings.h"
 #include "qgsspatialiteutils.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QLockFile>
+
 #include <cpl_vsi.h>
 #include <cpl_conv.h>
 #include <ogr_api.h>
@@ -209,13 +215,231 @@ static QString quotedIdentifier( QString id )
   return id.prepend( '\"' ).append( '\"' );
 }
 
+static QString quotedValue( QString value )
+{
+  value.replace( '\'', QLatin1String( "''" ) );
+  return value.prepend( '\'' ).append( '\'' );
+}
+
+QString QgsWFSSharedData::persistentCacheKey() const
+{
+  QStringList components;
+  components << mURI.baseURL( false ).toString();
+  components << mURI.typeName();
+  components << mWFSVersion;
+  components << srsName();
+  components << mWFSFilter;
+  components << mURI.sql();
+  components << mSortBy;
+  components << mGeometryAttribute;
+  components << ( mDistinctSelect ? QStringLiteral( "distinct" ) : QString() );
+  for ( const QgsField &field : qgis::as_const( mFields ) )
+    components << QStringLiteral( "%1:%2" ).arg( field.name() ).arg( field.type() );
+  return components.join( '\n' );
+}
+
+bool QgsWFSSharedData::acquirePersistentCache()
+{
+  const QByteArray hash = QCryptographicHash::hash( persistentCacheKey().toUtf8(), QCryptographicHash::Sha1 ).toHex();
+  const QString dbname = QDir( QgsWFSUtils::persistentCacheDirectory() ).filePath( QStringLiteral( "wfs_cache_%1.sqlite" ).arg( QString::fromLatin1( hash ) ) );
+
+  std::unique_ptr<QLockFile> lock = qgis::make_unique<QLockFile>( dbname + ".lock" );
+  // Rely only on the process id check to detect stale locks, as the cache may be used for hours
+  lock->setStaleLockTime( 0 );
+  if ( !lock->tryLock( 0 ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Persistent cache %1 is in use by another process. Using a temporary cache" ).arg( dbname ) );
+    return false;
+  }
+
+  mPersistentCacheLock = std::move( lock );
+  mCacheDbname = dbname;
+  mCacheIsPersistent = true;
+  return true;
+}
+
+bool QgsWFSSharedData::openPersistentCache()
+{
+  if ( !QFile::exists( mCacheDbname ) )
+    return false;
+
+  QgsSettings settings;
+  const qint64 maxAge = settings.value( QStringLiteral( "wfs/persistent_cache_max_age" ), 7 * 24 ).toLongLong() * 3600;
+  qint64 oldestValidTimestamp = QDateTime::currentMSecsSinceEpoch() / 1000 - maxAge;
+
+  bool valid = false;
+  bool complete = false;
+  QVector< QgsFeature > regions;
+  {
+    sqlite3_database_unique_ptr database;
+    if ( database.open( mCacheDbname ) == SQLITE_OK )
+    {
+      QMap<QString, QString> metadata;
+      int rc;
+      sqlite3_statement_unique_ptr stmt = database.prepare( QStringLiteral( "SELECT key, value FROM %1" ).arg( QgsWFSConstants::CACHE_TABLE_METADATA ), rc );
+      if ( rc == SQLITE_OK )
+      {
+        while ( stmt.step() == SQLITE_ROW )
+          metadata.insert( stmt.columnAsText( 0 ), stmt.columnAsText( 1 ) );
+      }
+      valid = metadata.value( QStringLiteral( "cache_key" ) ) == persistentCacheKey();
+
+      if ( valid )
+      {
+        // If the server advertizes an update sequence, any change of it means
+        // that all the cached features might be outdated. Otherwise only the
+        // regions older than wfs/persistent_cache_max_age are.
+        const bool serverUpdated = !mCaps.updateSequence.isEmpty() &&
+                                   metadata.value( QStringLiteral( "update_sequence" ) ) != mCaps.updateSequence;
+        if ( serverUpdated )
+          oldestValidTimestamp = std::numeric_limits<qint64>::max();
+
+        complete = metadata.value( QStringLiteral( "complete" ) ).toLongLong() >= oldestValidTimestamp;
+
+        QString sql = QStringLiteral( "DELETE FROM %1 WHERE timestamp < %2" ).arg( QgsWFSConstants::CACHE_TABLE_REGIONS ).arg( oldestValidTimestamp );
+        ( void )sqlite3_exec( database.get(), sql.toUtf8(), nullptr, nullptr, nullptr );
+
+        stmt = database.prepare( QStringLiteral( "SELECT minx, miny, maxx, maxy, download_limit FROM %1" ).arg( QgsWFSConstants::CACHE_TABLE_REGIONS ), rc );
+        if ( rc == SQLITE_OK )
+        {
+          while ( stmt.step() == SQLITE_ROW )
+          {
+            QgsFeature f;
+            f.setGeometry( QgsGeometry::fromRect( QgsRectangle( stmt.columnAsDouble( 0 ), stmt.columnAsDouble( 1 ),
+                           stmt.columnAsDouble( 2 ), stmt.columnAsDouble( 3 ) ) ) );
+            f.setId( regions.size() );
+            f.initAttributes( 1 );
+            f.setAttribute( 0, QVariant( stmt.columnAsInt64( 4 ) != 0 ) );
+            regions.push_back( f );
+          }
+        }
+
+        // Features of the previous session get a negative generation counter,
+        // so that they are returned by all iterators, and that they can be
+        // recognized when they must be downloaded again
+        sql = QStringLiteral( "UPDATE features SET %1 = -1" ).arg( QgsWFSConstants::FIELD_GEN_COUNTER );
+        valid = sqlite3_exec( database.get(), sql.toUtf8(), nullptr, nullptr, nullptr ) == SQLITE_OK;
+      }
+    }
+  }
+
+  if ( valid )
+  {
+    mCacheTablename = QStringLiteral( "features" );
+    valid = openCacheDataProvider();
+  }
+  if ( !valid )
+  {
+    QgsDebugMsg( QStringLiteral( "Discarding outdated or invalid persistent cache %1" ).arg( mCacheDbname ) );
+    QFile::remove( mCacheDbname );
+    QFile::remove( mCacheDbname + "-wal" );
+    QFile::remove( mCacheDbname + "-shm" );
+    return false;
+  }
+
+  for ( const QgsFeature &f : qgis::as_const( regions ) )
+  {
+    mRegions.push_back( f );
+    mCachedRegions.insertFeature( f );
+  }
+  mPersistentCacheComplete = complete;
+  mHasFeaturesFromPreviousSession = true;
+  mFeatureCount = static_cast<int>( mCacheDataProvider->featureCount() );
+  mTotalFeaturesAttemptedToBeCached = mFeatureCount;
+  if ( complete )
+  {
+    mFeatureCountExact = true;
+    mGetFeatureHitsIssued = true;
+  }
+  mComputedExtent = mCacheDataProvider->extent();
+
+  QgsDebugMsgLevel( QStringLiteral( "Reusing persistent cache %1 (%2 features, %3 valid regions, complete=%4)" )
+                    .arg( mCacheDbname ).arg( mFeatureCount ).arg( mRegions.size() ).arg( complete ), 2 );
+  return true;
+}
+
+void QgsWFSSharedData::updatePersistentCacheMetadata( bool downloadLimitReached )
+{
+  sqlite3_database_unique_ptr database;
+  if ( database.open( mCacheDbname ) != SQLITE_OK )
+    return;
+
+  const qint64 timestamp = QDateTime::currentMSecsSinceEpoch() / 1000;
+  QStringList statements;
+  statements << QStringLiteral( "INSERT OR REPLACE INTO %1 (key, value) VALUES ('update_sequence', %2)" )
+             .arg( QgsWFSConstants::CACHE_TABLE_METADATA, quotedValue( mCaps.updateSequence ) );
+  if ( mRect.isEmpty() )
+  {
+    if ( !downloadLimitReached )
+    {
+      statements << QStringLiteral( "INSERT OR REPLACE INTO %1 (key, value) VALUES ('complete', '%2')" )
+                 .arg( QgsWFSConstants::CACHE_TABLE_METADATA ).arg( timestamp );
+    }
+  }
+  else
+  {
+    statements << QStringLiteral( "INSERT INTO %1 (minx, miny, maxx, maxy, download_limit, timestamp) VALUES (%2, %3, %4, %5, %6, %7)" )
+               .arg( QgsWFSConstants::CACHE_TABLE_REGIONS,
+                     qgsDoubleToString( mRect.xMinimum() ), qgsDoubleToString( mRect.yMinimum() ),
+                     qgsDoubleToString( mRect.xMaximum() ), qgsDoubleToString( mRect.yMaximum() ) )
+               .arg( downloadLimitReached ? 1 : 0 ).arg( timestamp );
+  }
+
+  for ( const QString &sql : qgis::as_const( statements ) )
+  {
+    if ( sqlite3_exec( database.get(), sql.toUtf8(), nullptr, nullptr, nullptr ) != SQLITE_OK )
+      QgsDebugMsg( QStringLiteral( "%1 failed" ).arg( sql ) );
+  }
+}
+
+void QgsWFSSharedData::removeFeaturesFromPreviousSession( const QgsRectangle &rect )
+{
+  if ( !mCacheDataProvider )
+    return;
+
+  QgsFeatureRequest request;
+  request.setFilterExpression( QStringLiteral( "%1 < 0" ).arg( QgsWFSConstants::FIELD_GEN_COUNTER ) );
+  request.setSubsetOfAttributes( QgsAttributeList() );
+  if ( !rect.isEmpty() )
+    request.setFilterRect( rect );
+  else
+    request.setFlags( QgsFeatureRequest::NoGeometry );
+
+  QgsFeatureIds ids;
+  QgsFeatureIterator it( mCacheDataProvider->getFeatures( request ) );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    ids.insert( f.id() );
+
+  if ( rect.isEmpty() )
+    mHasFeaturesFromPreviousSession = false;
+
+  if ( ids.isEmpty() )
+    return;
+
+  QgsDebugMsgLevel( QStringLiteral( "Removing %1 features of the previous session before downloading them again" ).arg( ids.size() ), 4 );
+  QMutexLocker lockerWrite( &mCacheWriteMutex );
+  if ( mCacheDataProvider->deleteFeatures( ids ) )
+  {
+    mFeatureCount -= ids.size();
+  }
+}
+
 bool QgsWFSSharedData::createCache()
 {
   Q_ASSERT( mCacheDbname.isEmpty() );
 
-  static QAtomicInt sTmpCounter = 0;
-  int tmpCounter = ++sTmpCounter;
-  mCacheDbname = QDir( QgsWFSUtils::acquireCacheDirectory() ).filePath( QStringLiteral( "wfs_cache_%1.sqlite" ).arg( tmpCounter ) );
+  if ( mURI.persistentCache() && acquirePersistentCache() )
+  {
+    if ( openPersistentCache() )
+      return true;
+  }
+  else
+  {
+    static QAtomicInt sTmpCounter = 0;
+    int tmpCounter = ++sTmpCounter;
+    mCacheDbname = QDir( QgsWFSUtils::acquireCacheDirectory() ).filePath( QStringLiteral( "wfs_cache_%1.sqlite" ).arg( tmpCounter ) );
+  }
   Q_ASSERT( !QFile::exists( mCacheDbname ) );
 
   QgsFields cacheFields;
@@ -430,6 +654,25 @@ bool QgsWFSSharedData::createCache()
       }
     }
 
+    if ( mCacheIsPersistent )
+    {
+      QStringList statements;
+      statements << QStringLiteral( "CREATE TABLE %1 (key TEXT PRIMARY KEY, value TEXT)" ).arg( QgsWFSConstants::CACHE_TABLE_METADATA );
+      statements << QStringLiteral( "INSERT INTO %1 (key, value) VALUES ('cache_key', %2)" )
+                 .arg( QgsWFSConstants::CACHE_TABLE_METADATA, quotedValue( persistentCacheKey() ) );
+      statements << QStringLiteral( "CREATE TABLE %1 (minx REAL, miny REAL, maxx REAL, maxy REAL, download_limit INTEGER, timestamp BIGINT)" )
+                 .arg( QgsWFSConstants::CACHE_TABLE_REGIONS );
+      for ( const QString &statement : qgis::as_const( statements ) )
+      {
+        rc = sqlite3_exec( database.get(), statement.toUtf8(), nullptr, nullptr, nullptr );
+        if ( rc != SQLITE_OK )
+        {
+          QgsDebugMsg( QStringLiteral( "%1 failed" ).arg( statement ) );
+          ret = false;
+        }
+      }
+    }
+
     ( void )sqlite3_exec( database.get(), "COMMIT", nullptr, nullptr, nullptr );
   }
   else
@@ -442,11 +685,17 @@ bool QgsWFSSharedData::createCache()
     return false;
   }
 
+  return openCacheDataProvider();
+}
+
+bool QgsWFSSharedData::openCacheDataProvider()
+{
   // Some pragmas to speed-up writing. We don't need much integrity guarantee
-  // regarding crashes, since this is a temporary DB
+  // regarding crashes, since this is a temporary DB (or a cache that is
+  // discarded if its metadata is not consistent)
   QgsDataSourceUri dsURI;
   dsURI.setDatabase( mCacheDbname );
-  dsURI.setDataSource( QString(), mCacheTablename, geometryFieldname, QString(), fidName );
+  dsURI.setDataSource( QString(), mCacheTablename, QStringLiteral( "__spatialite_geometry" ), QString(), QStringLiteral( "__ogc_fid" ) );
   QStringList pragmas;
   pragmas << QStringLiteral( "synchronous=OFF" );
   pragmas << QStringLiteral( "journal_mode=WAL" ); // WAL is needed to avoid reader to block writers
@@ -489,6 +738,11 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
     }
   }
 
+  // A persistent cache reopened from a previous session may already hold all
+  // the features of the layer, in which case no download is needed
+  if ( !mDownloader && mPersistentCacheComplete )
+    return -1;
+
   // In case the request has a spatial filter, which is not the one currently
   // being downloaded, check if we have already downloaded an area of interest that includes it
   // before deciding to restart a new download with the provided area of interest.
@@ -496,6 +750,7 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
   // when "Only request features overlapping the view extent" : the offline editor
   // want to request all features whereas the map renderer only the view)
   bool newDownloadNeeded = false;
+  bool coveredByCachedRegions = false;
   if ( !rect.isEmpty() && mRect != rect && !( mDownloader && mRect.isEmpty() ) )
   {
     QList<QgsFeatureId> intersectingRequests = mCachedRegions.intersects( rect );
@@ -512,6 +767,7 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
       {
         QgsDebugMsgLevel( QStringLiteral( "Cached features already cover this area of interest" ), 4 );
         newDownloadNeeded = false;
+        coveredByCachedRegions = true;
         break;
       }
 
@@ -523,6 +779,7 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
       {
         QgsDebugMsgLevel( QStringLiteral( "Current request is larger than a smaller request that hit the download limit, so no server download needed." ), 4 );
         newDownloadNeeded = false;
+        coveredByCachedRegions = true;
         break;
       }
     }
@@ -540,6 +797,10 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
     newDownloadNeeded = true;
   }
 
+  // Regions of a persistent cache reopened from a previous session
+  if ( !mDownloader && coveredByCachedRegions )
+    return -1;
+
   if ( newDownloadNeeded || !mDownloader )
   {
     mRect = rect;
@@ -548,6 +809,10 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
     mMutex.unlock();
     delete mDownloader;
     mMutex.lock();
+    // Features of a previous session in the area to download might be
+    // outdated, so replace them by the fresh ones
+    if ( mHasFeaturesFromPreviousSession )
+      removeFeaturesFromPreviousSession( mRect );
     mDownloadFinished = false;
     mComputedExtent = QgsRectangle();
     mDownloader = new QgsWFSThreadedFeatureDownloader( this );
@@ -1055,6 +1320,11 @@ void QgsWFSSharedData::endOfDownload( bool success, int featureCount,
     }
   }
 
+  if ( mCacheIsPersistent && success && mRequestLimit == 0 )
+  {
+    updatePersistentCacheMetadata( bDownloadLimit );
+  }
+
   if ( bDownloadLimit )
   {
     QString msg( tr( "%1: The download limit has been reached." ).arg( mURI.typeName() ) );
@@ -1068,7 +1338,7 @@ void QgsWFSSharedData::endOfDownload( bool success, int featureCount,
 
 // This is called by the destructor or QgsWFSProvider::reloadData(). The effect is to invalid
 // all the caching state, so that a new request results in fresh download
-void QgsWFSSharedData::invalidateCache()
+void QgsWFSSharedData::invalidateCache( bool discardPersistentCache )
 {
   // Cf explanations in registerToCache() for the locking strategy
   QMutexLocker lockerMyself( &mMutexRegisterToCache );
@@ -1101,12 +1371,21 @@ void QgsWFSSharedData::invalidateCache()
 
   if ( !mCacheDbname.isEmpty() )
   {
-    QFile::remove( mCacheDbname );
-    QFile::remove( mCacheDbname + "-wal" );
-    QFile::remove( mCacheDbname + "-shm" );
-    QgsWFSUtils::releaseCacheDirectory();
+    if ( !mCacheIsPersistent || discardPersistentCache )
+    {
+      QFile::remove( mCacheDbname );
+      QFile::remove( mCacheDbname + "-wal" );
+      QFile::remove( mCacheDbname + "-shm" );
+    }
+    if ( mCacheIsPersistent )
+      mPersistentCacheLock.reset();
+    else
+      QgsWFSUtils::releaseCacheDirectory();
     mCacheDbname.clear();
   }
+  mCacheIsPersistent = false;
+  mPersistentCacheComplete = false;
+  mHasFeaturesFromPreviousSession = false;
 }
 
 void QgsWFSSharedData::setFeatureCount( int featureCount )
@@ -21,6 +21,10 @@
 #include "qgswfscapabilities.h"
 #include "qgsogcutils.h"
 
+#include <memory>
+
+class QLockFile;
+
 /**
  * This class holds data, and logic, shared between QgsWFSProvider, QgsWFSFeatureIterator
  *  and QgsWFSFeatureDownloader. It manages the on-disk cache, as a SpatiaLite
@@ -44,6 +48,13 @@
  *
  *  It contains also methods used in WFS-T context to update the cache content,
  *  from the changes initiated by the user.
+ *
+ *  When the persistentCache URI parameter is set, the database is kept between
+ *  sessions, in a file whose name is derived from the URL, typename, filter and
+ *  fields of the layer. It then also contains a metadata table (server
+ *  updateSequence, completeness of the cached layer) and a table of the
+ *  downloaded BBOX regions, with their timestamp, so that only the regions that
+ *  are outdated need to be downloaded again.
  */
 class QgsWFSSharedData : public QObject
 {
@@ -72,8 +83,9 @@ class QgsWFSSharedData : public QObject
 
     /**
      * Used by QgsWFSProvider::reloadData(). The effect is to invalid
-        all the caching state, so that a new request results in fresh download */
-    void invalidateCache();
+        all the caching state, so that a new request results in fresh download.
+        A persistent cache is kept on disk, unless discardPersistentCache is set. */
+    void invalidateCache( bool discardPersistentCache = false );
 
     //! Give a feature id, find the correspond fid/gml.id. Used by WFS-T
     QString findGmlId( QgsFeatureId fid );
@@ -248,6 +260,18 @@ class QgsWFSSharedData : public QObject
     //! Whether we have already tried fetching one feature after realizing that the capabilities extent is wrong
     bool mTryFetchingOneFeature;
 
+    //! Whether mCacheDbname is a cache kept between sessions
+    bool mCacheIsPersistent = false;
+
+    //! Lock preventing several QGIS instances to use the same persistent cache
+    std::unique_ptr<QLockFile> mPersistentCacheLock;
+
+    //! Whether the persistent cache reopened from a previous session holds all the features of the layer
+    bool mPersistentCacheComplete = false;
+
+    //! Whether the cache may contain features downloaded during a previous session
+    bool mHasFeaturesFromPreviousSession = false;
+
     /**
      * Returns the set of gmlIds that have already been downloaded and
         cached, so as to avoid to cache duplicates. */
@@ -261,6 +285,24 @@ class QgsWFSSharedData : public QObject
     //! Create the on-disk cache and connect to it
     bool createCache();
 
+    //! Create mCacheDataProvider from the mCacheDbname database
+    bool openCacheDataProvider();
+
+    //! Returns the string that identifies the content of a persistent cache
+    QString persistentCacheKey() const;
+
+    //! Sets mCacheDbname to the persistent cache filename and locks it. Returns false if it is used by another process
+    bool acquirePersistentCache();
+
+    //! Reuses the persistent cache of a previous session if it is still valid
+    bool openPersistentCache();
+
+    //! Records in the persistent cache the outcome of a successful download
+    void updatePersistentCacheMetadata( bool downloadLimitReached );
+
+    //! Removes features of a previous session that intersect rect (or all of them if rect is empty), before they are downloaded again
+    void removeFeaturesFromPreviousSession( const QgsRectangle &rect );
+
     //! Log error to QgsMessageLog and raise it to the provider
     void pushError( const QString &errorMsg );
 };
@@ -28,6 +28,9 @@
 #include <QSharedMemory>
 #include <QDateTime>
 #include <QCryptographicHash>
+#include <QLockFile>
+
+#include <algorithm>
 
 QMutex QgsWFSUtils::sMutex;
 QThread *QgsWFSUtils::sThread = nullptr;
@@ -116,6 +119,18 @@ void QgsWFSUtils::releaseCacheDirectory()
   }
 }
 
+QString QgsWFSUtils::persistentCacheDirectory()
+{
+  QString baseDirectory( getBaseCacheDirectory( true ) );
+  QMutexLocker locker( &sMutex );
+  if ( !QDir( baseDirectory ).exists( QStringLiteral( "persistent" ) ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Creating persistent cache dir %1/persistent" ).arg( baseDirectory ) );
+    QDir( baseDirectory ).mkpath( QStringLiteral( "persistent" ) );
+  }
+  return QDir( baseDirectory ).filePath( QStringLiteral( "persistent" ) );
+}
+
 bool QgsWFSUtils::removeDir( const QString &dirName )
 {
   QDir dir( dirName );
@@ -293,6 +308,70 @@ void QgsWFSUtils::init()
       }
     }
   }
+
+  prunePersistentCaches();
+}
+
+void QgsWFSUtils::prunePersistentCaches()
+{
+  QDir dir( QDir( getBaseCacheDirectory( false ) ).filePath( QStringLiteral( "persistent" ) ) );
+  if ( !dir.exists() )
+    return;
+
+  // a cache is made of its database and the -wal, -shm and .lock files next to it
+  struct PersistentCache
+  {
+    QString dbname;
+    qint64 size = 0;
+    QDateTime lastModified;
+  };
+  QList< PersistentCache > caches;
+  qint64 totalSize = 0;
+  const QFileInfoList dbList( dir.entryInfoList( QStringList() << QStringLiteral( "wfs_cache_*.sqlite" ), QDir::Files ) );
+  for ( const QFileInfo &dbInfo : dbList )
+  {
+    PersistentCache cache;
+    cache.dbname = dbInfo.absoluteFilePath();
+    cache.lastModified = dbInfo.lastModified();
+    const QFileInfoList fileList( dir.entryInfoList( QStringList() << dbInfo.fileName() + '*', QDir::Files ) );
+    for ( const QFileInfo &info : fileList )
+    {
+      cache.size += info.size();
+      cache.lastModified = std::max( cache.lastModified, info.lastModified() );
+    }
+    totalSize += cache.size;
+    caches << cache;
+  }
+
+  QgsSettings settings;
+  const qint64 maxSize = settings.value( QStringLiteral( "cache/size" ), 50 * 1024 * 1024 ).toLongLong();
+  if ( totalSize <= maxSize )
+    return;
+
+  std::sort( caches.begin(), caches.end(), []( const PersistentCache & a, const PersistentCache & b )
+  {
+    return a.lastModified < b.lastModified;
+  } );
+  for ( const PersistentCache &cache : qgis::as_const( caches ) )
+  {
+    if ( totalSize <= maxSize )
+      break;
+
+    // caches opened by a running QGIS instance are locked, see QgsWFSSharedData
+    QLockFile lock( cache.dbname + ".lock" );
+    lock.setStaleLockTime( 0 );
+    if ( !lock.tryLock( 0 ) )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Persistent cache %1 kept since it is in use" ).arg( cache.dbname ), 4 );
+      continue;
+    }
+
+    QgsDebugMsgLevel( QStringLiteral( "Removing persistent cache %1" ).arg( cache.dbname ), 4 );
+    for ( const QString &suffix : { QString(), QStringLiteral( "-wal" ), QStringLiteral( "-shm" ) } )
+      QFile::remove( cache.dbname + suffix );
+    lock.unlock();
+    totalSize -= cache.size;
+  }
 }
 
 
@@ -34,6 +34,9 @@ class QgsWFSUtils
     //! To be called when a temporary file is removed from the directory
     static void releaseCacheDirectory();
 
+    //! Returns the name of the directory that holds caches kept between sessions. Created if needed.
+    static QString persistentCacheDirectory();
+
     //! Initial cleanup.
     static void init();
 
@@ -62,6 +65,12 @@ class QgsWFSUtils
 
     //! Remove (recursively) a directory.
     static bool removeDir( const QString &dirName );
+
+    /**
+     * Removes the least recently used persistent caches which are not in use, until their
+     * total size is under the "cache/size" setting shared with the network disk cache.
+     */
+    static void prunePersistentCaches();
 };
 
 //! For internal use of QgsWFSUtils
@@ -17,45 +17,124 @@
 
 #include "qgsnetworkaccessmanager.h"
 #include "qgsapplication.h"
+#include "qgssettings.h"
 #include <QAbstractNetworkCache>
 #include <QImage>
 
-QCache<QUrl, QImage> QgsTileCache::sTileCache( 256 );
+#include <algorithm>
+
+//! Default budget of the encoded tile cache, in MB
+static const int DEFAULT_TILE_CACHE_SIZE = 64;
+//! Budget of the decoded tile cache, in KB (about 64 tiles of 256x256 pixels)
+static const int DECODED_TILE_CACHE_SIZE = 16384;
+
+QCache<QUrl, QByteArray> QgsTileCache::sTileCache;
+QCache<QUrl, QImage> QgsTileCache::sDecodedTileCache( DECODED_TILE_CACHE_SIZE );
+bool QgsTileCache::sInitialized = false;
 QMutex QgsTileCache::sTileCacheMutex;
 
+static int dataCost( const QByteArray &data )
+{
+  return std::max( 1, data.size() / 1024 );
+}
+
+static int imageCost( const QImage &image )
+{
+  return std::max( 1, image.bytesPerLine() * image.height() / 1024 );
+}
+
+void QgsTileCache::initialize()
+{
+  if ( sInitialized )
+    return;
+
+  QgsSettings s;
+  int size = s.value( QStringLiteral( "qgis/tileCacheMemorySize" ), DEFAULT_TILE_CACHE_SIZE ).toInt();
+  sTileCache.setMaxCost( std::max( 1, size ) * 1024 );
+  sInitialized = true;
+}
+
+void QgsTileCache::insertTile( const QUrl &url, const QByteArray &data, const QImage &image )
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  sTileCache.insert( url, new QByteArray( data ), dataCost( data ) );
+  sDecodedTileCache.insert( url, new QImage( image ), imageCost( image ) );
+}
+
+void QgsTileCache::insertTile( const QUrl &url, const QByteArray &data )
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  sTileCache.insert( url, new QByteArray( data ), dataCost( data ) );
+  sDecodedTileCache.remove( url );
+}
 
-void QgsTileCache::insertTile( const QUrl &url, const QImage &image )
+bool QgsTileCache::hasTile( const QUrl &url )
 {
   QMutexLocker locker( &sTileCacheMutex );
-  sTileCache.insert( url, new QImage( image ) );
+  return sTileCache.contains( url );
 }
 
 bool QgsTileCache::tile( const QUrl &url, QImage &image )
 {
   QMutexLocker locker( &sTileCacheMutex );
-  bool success = false;
-  if ( QImage *i = sTileCache.object( url ) )
+  initialize();
+  if ( QImage *i = sDecodedTileCache.object( url ) )
   {
     image = *i;
-    success = true;
+    // keep the encoded tile in the LRU order too
+    sTileCache.object( url );
+    return true;
+  }
+
+  QByteArray imageData;
+  bool fromDisk = false;
+  if ( QByteArray *data = sTileCache.object( url ) )
+  {
+    imageData = *data;
   }
   else if ( QgsNetworkAccessManager::instance()->cache()->metaData( url ).isValid() )
   {
     if ( QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( url ) )
     {
-      QByteArray imageData = data->readAll();
+      imageData = data->readAll();
       delete data;
+      fromDisk = true;
+    }
+  }
 
-      image = QImage::fromData( imageData );
+  if ( imageData.isEmpty() )
+    return false;
 
-      // cache it as well (mutex is already locked)
-      // Check for null because it could be a redirect (see: https://issues.qgis.org/issues/16427 )
-      if ( ! image.isNull( ) )
-      {
-        sTileCache.insert( url, new QImage( image ) );
-        success = true;
-      }
-    }
+  // decoding is expensive, let other threads use the cache meanwhile
+  locker.unlock();
+  image = QImage::fromData( imageData );
+  locker.relock();
+
+  // Check for null because it could be a redirect (see: https://issues.qgis.org/issues/16427 )
+  if ( image.isNull() )
+  {
+    if ( !fromDisk )
+      sTileCache.remove( url );
+    return false;
   }
-  return success;
+
+  if ( fromDisk )
+    sTileCache.insert( url, new QByteArray( imageData ), dataCost( imageData ) );
+  sDecodedTileCache.insert( url, new QImage( image ), imageCost( image ) );
+  return true;
+}
+
+int QgsTileCache::totalCost()
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  return sTileCache.totalCost();
+}
+
+int QgsTileCache::maxCost()
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  return sTileCache.maxCost();
 }
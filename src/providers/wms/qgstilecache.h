@@ -17,6 +17,7 @@
 #define QGSTILECACHE_H
 
 
+#include <QByteArray>
 #include <QCache>
 #include <QMutex>
 
@@ -25,9 +26,14 @@ class QUrl;
 
 /**
  * A simple tile cache implementation. Tiles are cached according to their URL.
- * There is a small in-memory cache and a secondary caching in the local disk.
- * The in-memory cache is there to save CPU time otherwise wasted to read and
- * uncompress data saved on the disk.
+ * There is an in-memory cache and a secondary caching in the local disk.
+ *
+ * The in-memory cache keeps tiles encoded as they were received from the server
+ * (e.g. PNG or JPEG data), which are usually an order of magnitude smaller than
+ * the decoded images, so that many more tiles fit within its memory budget. The
+ * budget is read from the "qgis/tileCacheMemorySize" setting (in MB). Tiles are
+ * decoded on demand, and a small cache of decoded images saves CPU time for the
+ * tiles which are drawn repeatedly.
  *
  * The class is thread safe (its methods can be called from any thread).
  */
@@ -35,8 +41,17 @@ class QgsTileCache
 {
   public:
 
-    //! Add a tile image with given URL to the cache
-    static void insertTile( const QUrl &url, const QImage &image );
+    /**
+     * Add a tile with given URL to the cache.  data is the encoded tile as received
+     * from the server and  image the decoded tile.
+     */
+    static void insertTile( const QUrl &url, const QByteArray &data, const QImage &image );
+
+    //! Add an encoded tile with given URL to the cache, it will be decoded when first accessed
+    static void insertTile( const QUrl &url, const QByteArray &data );
+
+    //! Returns true if the tile with given URL is in the in-memory cache
+    static bool hasTile( const QUrl &url );
 
     /**
      * Try to access a tile and load it into "image" argument
@@ -44,14 +59,22 @@ class QgsTileCache
      */
     static bool tile( const QUrl &url, QImage &image );
 
-    //! how many tiles are stored in the in-memory cache
-    static int totalCost() { return sTileCache.totalCost(); }
-    //! how many tiles can be stored in the in-memory cache
-    static int maxCost() { return sTileCache.maxCost(); }
+    //! how many kilobytes of encoded tiles are stored in the in-memory cache
+    static int totalCost();
+    //! how many kilobytes of encoded tiles can be stored in the in-memory cache
+    static int maxCost();
 
   private:
-    //! in-memory cache
-    static QCache<QUrl, QImage> sTileCache;
+
+    //! Reads the memory budget from the settings on first use (mutex must be locked)
+    static void initialize();
+
+    //! in-memory cache of encoded tiles, with costs in kilobytes
+    static QCache<QUrl, QByteArray> sTileCache;
+    //! in-memory cache of recently used decoded tiles, with costs in kilobytes
+    static QCache<QUrl, QImage> sDecodedTileCache;
+    //! whether the memory budget has been read from the settings
+    static bool sInitialized;
     //! mutex to protect the in-memory cache
     static QMutex sTileCacheMutex;
 };
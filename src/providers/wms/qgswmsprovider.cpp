@@ -64,6 +64,7 @@
 #include <QEventLoop>
 #include <QTextCodec>
 #include <QThread>
+#include <QCoreApplication>
 #include <QNetworkDiskCache>
 #include <QTimer>
 
@@ -589,6 +590,103 @@ void QgsWmsProvider::fetchOtherResTiles( QgsTileMode tileMode, const QgsRectangl
                .arg( otherResTiles.count() ) );
 }
 
+void QgsWmsProvider::prefetchTiles( QgsTileMode tileMode, const QgsWmtsTileMatrix *tm, const QgsWmtsTileMatrixLimits *tml, const QgsRectangle &viewExtent, int col0, int row0, int col1, int row1 )
+{
+  // ring of tiles around the view, for panning
+  int minCol = tml ? tml->minTileCol : 0;
+  int maxCol = tml ? tml->maxTileCol : tm->matrixWidth - 1;
+  int minRow = tml ? tml->minTileRow : 0;
+  int maxRow = tml ? tml->maxTileRow : tm->matrixHeight - 1;
+
+  TilePositions tiles;
+  for ( int row = row0 - 1; row <= row1 + 1; row++ )
+  {
+    for ( int col = col0 - 1; col <= col1 + 1; col++ )
+    {
+      if ( row >= row0 && row <= row1 && col >= col0 && col <= col1 )
+        continue;  // visible tile
+      if ( row < minRow || row > maxRow || col < minCol || col > maxCol )
+        continue;
+      tiles << TilePosition( row, col );
+    }
+  }
+
+  TileRequests requests;
+  switch ( tileMode )
+  {
+    case WMSC:
+      createTileRequestsWMSC( tm, tiles, requests );
+      break;
+
+    case WMTS:
+      createTileRequestsWMTS( tm, tiles, requests );
+      break;
+
+    case XYZ:
+      createTileRequestsXYZ( tm, tiles, requests );
+      break;
+  }
+
+  // tiles of the next zoom level, for zooming in around the center of the view
+  const QgsWmtsTileMatrix *tmNext = mTileMatrixSet ? mTileMatrixSet->findOtherResolution( tm->tres, -1 ) : nullptr;
+  if ( tmNext )
+  {
+    const QgsWmtsTileMatrixLimits *tmlNext = nullptr;
+    if ( mTileLayer &&
+         mTileLayer->setLinks.contains( mTileMatrixSet->identifier ) &&
+         mTileLayer->setLinks[ mTileMatrixSet->identifier ].limits.contains( tmNext->identifier ) )
+    {
+      tmlNext = &mTileLayer->setLinks[ mTileMatrixSet->identifier ].limits[ tmNext->identifier ];
+    }
+
+    QgsRectangle nextExtent( viewExtent );
+    nextExtent.scale( tmNext->tres / tm->tres );
+
+    int c0, r0, c1, r1;
+    tmNext->viewExtentIntersection( nextExtent, tmlNext, c0, r0, c1, r1 );
+
+    TilePositions nextTiles;
+    for ( int row = r0; row <= r1; row++ )
+    {
+      for ( int col = c0; col <= c1; col++ )
+      {
+        nextTiles << TilePosition( row, col );
+      }
+    }
+
+    switch ( tileMode )
+    {
+      case WMSC:
+        createTileRequestsWMSC( tmNext, nextTiles, requests );
+        break;
+
+      case WMTS:
+        createTileRequestsWMTS( tmNext, nextTiles, requests );
+        break;
+
+      case XYZ:
+        createTileRequestsXYZ( tmNext, nextTiles, requests );
+        break;
+    }
+  }
+
+  QList<QNetworkRequest> prefetchRequests;
+  Q_FOREACH ( const TileRequest &r, requests )
+  {
+    if ( QgsTileCache::hasTile( r.url ) )
+      continue;
+
+    QNetworkRequest request( r.url );
+    mSettings.authorization().setAuthorization( request );
+    request.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
+    request.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
+    prefetchRequests << request;
+  }
+
+  QgsDebugMsgLevel( QString( "prefetching %1 tiles" ).arg( prefetchRequests.count() ), 2 );
+  QgsWmsTilePrefetcher::instance()->prefetch( prefetchRequests );
+}
+
 uint qHash( QgsWmsProvider::TilePosition tp )
 {
   return ( uint ) tp.col + ( ( uint ) tp.row << 16 );
@@ -865,7 +963,13 @@ QImage *QgsWmsProvider::draw( QgsRectangle const &viewExtent, int pixelWidth, in
       handler.downloadBlocking();
     }
 
-    QgsDebugMsg( QString( "TILE CACHE total: %1 / %2" ).arg( QgsTileCache::totalCost() ).arg( QgsTileCache::maxCost() ) );
+    if ( !( feedback && ( feedback->isPreviewOnly() || feedback->isCanceled() ) ) &&
+         QgsSettings().value( QStringLiteral( "qgis/tilePrefetch" ), false ).toBool() )
+    {
+      prefetchTiles( tileMode, tm, tml, viewExtent, col0, row0, col1, row1 );
+    }
+
+    QgsDebugMsg( QString( "TILE CACHE total: %1 KB / %2 KB" ).arg( QgsTileCache::totalCost() ).arg( QgsTileCache::maxCost() ) );
 
 #if 0
     const QgsWmsStatistics::Stat &stat = QgsWmsStatistics::statForUri( dataSourceUri() );
@@ -3933,7 +4037,8 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
 
       QgsDebugMsg( QString( "tile reply: length %1" ).arg( reply->bytesAvailable() ) );
 
-      QImage myLocalImage = QImage::fromData( reply->readAll() );
+      QByteArray tileData = reply->readAll();
+      QImage myLocalImage = QImage::fromData( tileData );
 
       if ( !myLocalImage.isNull() )
       {
@@ -3951,7 +4056,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
                     .arg( r.width() ).arg( r.height() ) );
 #endif
 
-        QgsTileCache::insertTile( reply->url(), myLocalImage );
+        QgsTileCache::insertTile( reply->url(), tileData, myLocalImage );
 
         if ( mFeedback )
           mFeedback->onNewData();
@@ -4061,6 +4166,68 @@ void QgsWmsTiledImageDownloadHandler::repeatTileRequest( QNetworkRequest const &
   connect( reply, &QNetworkReply::finished, this, &QgsWmsTiledImageDownloadHandler::tileReplyFinished );
 }
 
+
+// ----------
+
+//! Maximum number of prefetch requests running at once, so that they do not compete with rendering
+static const int MAX_PREFETCH_REPLIES = 4;
+
+QgsWmsTilePrefetcher *QgsWmsTilePrefetcher::instance()
+{
+  static QgsWmsTilePrefetcher *sInstance = []
+  {
+    QgsWmsTilePrefetcher *prefetcher = new QgsWmsTilePrefetcher();
+    prefetcher->moveToThread( QCoreApplication::instance()->thread() );
+    return prefetcher;
+  }();
+  return sInstance;
+}
+
+void QgsWmsTilePrefetcher::prefetch( const QList<QNetworkRequest> &requests )
+{
+  {
+    QMutexLocker locker( &mMutex );
+    mPendingRequests = requests;
+  }
+  QMetaObject::invokeMethod( this, "startRequests", Qt::QueuedConnection );
+}
+
+void QgsWmsTilePrefetcher::startRequests()
+{
+  QMutexLocker locker( &mMutex );
+  while ( mReplies.count() < MAX_PREFETCH_REPLIES && !mPendingRequests.isEmpty() )
+  {
+    QNetworkRequest request = mPendingRequests.takeFirst();
+    if ( QgsTileCache::hasTile( request.url() ) )
+      continue;
+
+    QNetworkReply *reply = QgsNetworkAccessManager::instance()->get( request );
+    connect( reply, &QNetworkReply::finished, this, &QgsWmsTilePrefetcher::tileReplyFinished );
+    mReplies << reply;
+  }
+}
+
+void QgsWmsTilePrefetcher::tileReplyFinished()
+{
+  QNetworkReply *reply = qobject_cast<QNetworkReply *>( sender() );
+  mReplies.removeOne( reply );
+  reply->deleteLater();
+
+  QVariant status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute );
+  QString contentType = reply->header( QNetworkRequest::ContentTypeHeader ).toString();
+  // redirects and errors are left to the regular tile requests
+  if ( reply->error() == QNetworkReply::NoError &&
+       reply->attribute( QNetworkRequest::RedirectionTargetAttribute ).isNull() &&
+       ( status.isNull() || status.toInt() < 400 ) &&
+       ( contentType.startsWith( QLatin1String( "image/" ), Qt::CaseInsensitive ) ||
+         contentType.compare( QLatin1String( "application/octet-stream" ), Qt::CaseInsensitive ) == 0 ) )
+  {
+    QgsTileCache::insertTile( reply->url(), reply->readAll() );
+  }
+
+  startRequests();
+}
+
 // Some servers like http://glogow.geoportal2.pl/map/wms/wms.php? do not BBOX
 // to be formatted with excessive precision. As a double is exactly represented
 // with 19 decimal figures, do not attempt to output more
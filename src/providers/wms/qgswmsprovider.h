@@ -30,6 +30,7 @@
 #include <QDomElement>
 #include <QHash>
 #include <QMap>
+#include <QMutex>
 #include <QVector>
 #include <QUrl>
 
@@ -342,6 +343,13 @@ class QgsWmsProvider : public QgsRasterDataProvider
     //! Gets tiles from a different resolution to cover the missing areas
     void fetchOtherResTiles( QgsTileMode tileMode, const QgsRectangle &viewExtent, int imageWidth, QList<QRectF> &missing, double tres, int resOffset, QList<TileImage> &otherResTiles );
 
+    /**
+     * Queues the download of tiles likely to be needed next into the tile cache: the ring
+     * of tiles around the visible tiles \a col0, \a row0, \a col1, \a row1 of tile matrix \a tm,
+     * and the tiles of the next zoom level covering the center of \a viewExtent.
+     */
+    void prefetchTiles( QgsTileMode tileMode, const QgsWmtsTileMatrix *tm, const QgsWmtsTileMatrixLimits *tml, const QgsRectangle &viewExtent, int col0, int row0, int col1, int row1 );
+
     /**
      * Returns the full url to request legend graphic
      * The visibleExtent isi only used if provider supports contextual
@@ -540,6 +548,40 @@ class QgsWmsTiledImageDownloadHandler : public QObject
 };
 
 
+/**
+ * Downloads tiles into the tile cache in the background, ahead of the rendering.
+ *
+ * Its single instance lives in the main thread so that the downloads survive the
+ * rendering jobs which queued them. Queued tiles which were not requested yet are
+ * dropped whenever new tiles are queued, as they belong to a view which is gone.
+ */
+class QgsWmsTilePrefetcher : public QObject
+{
+    Q_OBJECT
+  public:
+
+    //! Returns the prefetcher instance
+    static QgsWmsTilePrefetcher *instance();
+
+    //! Queues tile requests, replacing those not started yet. Can be called from any thread.
+    void prefetch( const QList<QNetworkRequest> &requests );
+
+  private slots:
+    void startRequests();
+    void tileReplyFinished();
+
+  private:
+    QgsWmsTilePrefetcher() = default;
+
+    //! Protects the pending requests
+    QMutex mMutex;
+    QList<QNetworkRequest> mPendingRequests;
+
+    //! Running tile requests
+    QList<QNetworkReply *> mReplies;
+};
+
+
 //! Class keeping simple statistics for WMS provider - per unique URI
 class QgsWmsStatistics
 {
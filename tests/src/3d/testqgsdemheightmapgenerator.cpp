@@ -0,0 +1,114 @@
+/***************************************************************************
+     testqgsdemheightmapgenerator.cpp
+     ----------------------
+    Date                 : August 2018
+    Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+
+#include <QSignalSpy>
+#include <cmath>
+
+#include "qgsapplication.h"
+#include "qgsrasterlayer.h"
+#include "qgsdemterraintileloader_p.h"
+
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the asynchronous reading of DEM tiles
+ */
+class TestQgsDemHeightMapGenerator : public QObject
+{
+    Q_OBJECT
+  public:
+    TestQgsDemHeightMapGenerator() = default;
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+
+    void testConcurrentJobs();
+
+  private:
+    QgsRasterLayer *mLayerDtm = nullptr;
+};
+
+//runs before all tests
+void TestQgsDemHeightMapGenerator::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  QString dataDir( TEST_DATA_DIR );
+  mLayerDtm = new QgsRasterLayer( dataDir + "/3d/dtm.tif", "dtm", "gdal" );
+  QVERIFY( mLayerDtm->isValid() );
+}
+
+//runs after all tests
+void TestQgsDemHeightMapGenerator::cleanupTestCase()
+{
+  delete mLayerDtm;
+  QgsApplication::exitQgis();
+}
+
+void TestQgsDemHeightMapGenerator::testConcurrentJobs()
+{
+  const int resolution = 16;
+  QgsTilingScheme tilingScheme( mLayerDtm->extent(), mLayerDtm->crs() );
+  QgsDemHeightMapGenerator generator( mLayerDtm, tilingScheme, resolution );
+
+  QSignalSpy spy( &generator, &QgsDemHeightMapGenerator::heightMapReady );
+
+  // all four tiles of the first level are read at the same time
+  QMap<int, QPair<int, int> > tiles;
+  for ( int x = 0; x < 2; ++x )
+  {
+    for ( int y = 0; y < 2; ++y )
+      tiles.insert( generator.render( x, y, 1 ), qMakePair( x, y ) );
+  }
+  QCOMPARE( tiles.count(), 4 );
+
+  while ( spy.count() < 4 )
+    QVERIFY( spy.wait() );
+
+  for ( const QList<QVariant> &args : qgis::as_const( spy ) )
+  {
+    const int jobId = args.at( 0 ).toInt();
+    QVERIFY( tiles.contains( jobId ) );
+    const QPair<int, int> tile = tiles.take( jobId );
+
+    const QByteArray heightMap = args.at( 1 ).toByteArray();
+    const QByteArray expected = generator.renderSynchronously( tile.first, tile.second, 1 );
+    QCOMPARE( heightMap.count(), resolution * resolution * static_cast<int>( sizeof( float ) ) );
+    QCOMPARE( heightMap.count(), expected.count() );
+
+    const float *values = reinterpret_cast<const float *>( heightMap.constData() );
+    const float *expectedValues = reinterpret_cast<const float *>( expected.constData() );
+    for ( int i = 0; i < resolution * resolution; ++i )
+    {
+      // no-data cells are turned to NaN by the asynchronous read only
+      if ( !std::isnan( values[i] ) )
+        QCOMPARE( values[i], expectedValues[i] );
+    }
+  }
+  QVERIFY( tiles.isEmpty() );
+
+  // jobs started after the first ones have finished reuse their cloned providers
+  const int jobId = generator.render( 0, 0, 2 );
+  QVERIFY( spy.wait() );
+  QCOMPARE( spy.count(), 5 );
+  QCOMPARE( spy.last().at( 0 ).toInt(), jobId );
+}
+
+
+QGSTEST_MAIN( TestQgsDemHeightMapGenerator )
+#include "testqgsdemheightmapgenerator.moc"
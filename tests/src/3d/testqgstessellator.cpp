@@ -19,8 +19,10 @@
 
 #include "qgspoint.h"
 #include "qgspolygon.h"
+#include "qgslinestring.h"
 #include "qgstessellator.h"
 #include "qgsmultipolygon.h"
+#include "qgsgeometry.h"
 
 static bool qgsVectorNear( const QVector3D &v1, const QVector3D &v2, double eps )
 {
@@ -93,20 +95,23 @@ bool checkTriangleOutput( const QVector<float> &data, bool withNormals, const QL
     return false;
   }
 
-  // TODO: allow arbitrary order of triangles in output
+  // triangles may come in any order
+  QList<TriangleCoords> remaining = expected;
   const float *dataRaw = data.constData();
   for ( int i = 0; i < expected.count(); ++i )
   {
-    const TriangleCoords &exp = expected.at( i );
     TriangleCoords out( dataRaw, withNormals );
-    if ( exp != out )
+    const int index = remaining.indexOf( out );
+    if ( index < 0 )
     {
-      qDebug() << "expected:";
-      exp.dump();
-      qDebug() << "got:";
+      qDebug() << "unexpected triangle:";
       out.dump();
+      qDebug() << "expected one of:";
+      for ( const TriangleCoords &exp : qgis::as_const( remaining ) )
+        exp.dump();
       return false;
     }
+    remaining.removeAt( index );
     dataRaw += withNormals ? 18 : 9;
   }
   return true;
@@ -131,9 +136,13 @@ class TestQgsTessellator : public QObject
     void testWalls();
     void testBackEdges();
     void asMultiPolygon();
+    void testConcavePolygon();
+    void testPolygonWithHole();
     void testBadCoordinates();
     void testIssue17745();
     void testCrashSelfIntersection();
+    void testSelfIntersectingRings();
+    void testLargeRing();
 
   private:
 };
@@ -274,11 +283,51 @@ void TestQgsTessellator::asMultiPolygon()
 
   QgsTessellator t( 0, 0, false );
   t.addPolygon( polygon, 0 );
-  QCOMPARE( t.asMultiPolygon()->asWkt(), QStringLiteral( "MultiPolygonZ (((1 2 0, 2 1 0, 3 2 0, 1 2 0)),((1 2 0, 1 1 0, 2 1 0, 1 2 0)))" ) );
+  QCOMPARE( t.asMultiPolygon()->asWkt(), QStringLiteral( "MultiPolygonZ (((1 2 0, 1 1 0, 2 1 0, 1 2 0)),((1 2 0, 2 1 0, 3 2 0, 1 2 0)))" ) );
 
   QgsTessellator t2( 0, 0, false );
   t2.addPolygon( polygonZ, 0 );
-  QCOMPARE( t2.asMultiPolygon()->asWkt(), QStringLiteral( "MultiPolygonZ (((1 2 4, 2 1 2, 3 2 3, 1 2 4)),((1 2 4, 1 1 1, 2 1 2, 1 2 4)))" ) );
+  QCOMPARE( t2.asMultiPolygon()->asWkt(), QStringLiteral( "MultiPolygonZ (((1 2 4, 1 1 1, 2 1 2, 1 2 4)),((1 2 4, 2 1 2, 3 2 3, 1 2 4)))" ) );
+}
+
+void TestQgsTessellator::testConcavePolygon()
+{
+  // U-shaped polygon with collinear vertices, in both orientations
+  const QStringList wkts = QStringList()
+                           << QStringLiteral( "POLYGON((0 0, 3 0, 3 3, 2 3, 2 1, 1 1, 1 3, 0 3, 0 1.5, 0 0))" )
+                           << QStringLiteral( "POLYGON((0 0, 0 1.5, 0 3, 1 3, 1 1, 2 1, 2 3, 3 3, 3 0, 0 0))" );
+  for ( const QString &wkt : wkts )
+  {
+    QgsPolygon polygon;
+    QVERIFY( polygon.fromWkt( wkt ) );
+
+    QgsTessellator t( 0, 0, true );
+    t.addPolygon( polygon, 0 );
+
+    // all triangles face up and together they cover the polygon exactly
+    std::unique_ptr< QgsMultiPolygon > mp( t.asMultiPolygon() );
+    QCOMPARE( mp->numGeometries(), 7 );
+    QGSCOMPARENEAR( QgsGeometry( mp->clone() ).area(), 7, 1e-6 );
+    QVERIFY( QgsGeometry( mp->clone() ).within( QgsGeometry( polygon.clone() ).buffer( 1e-6, 1 ) ) );
+
+    const float *dataRaw = t.data().constData();
+    for ( int i = 0; i < t.dataVerticesCount() / 2; ++i, dataRaw += 6 )
+      QVERIFY( qgsVectorNear( QVector3D( dataRaw[3], -dataRaw[5], dataRaw[4] ), QVector3D( 0, 0, 1 ), 1e-6 ) );
+  }
+}
+
+void TestQgsTessellator::testPolygonWithHole()
+{
+  QgsPolygon polygon;
+  QVERIFY( polygon.fromWkt( "POLYGON((0 0, 4 0, 4 4, 0 4, 0 0),(1 1, 1 2, 2 2, 2 1, 1 1))" ) );
+
+  QgsTessellator t( 0, 0, false );
+  t.addPolygon( polygon, 0 );
+
+  std::unique_ptr< QgsMultiPolygon > mp( t.asMultiPolygon() );
+  QCOMPARE( mp->numGeometries(), 8 );
+  QGSCOMPARENEAR( QgsGeometry( mp->clone() ).area(), 15, 1e-6 );
+  QVERIFY( !QgsGeometry( mp->clone() ).intersects( QgsGeometry::fromWkt( QStringLiteral( "POINT(1.5 1.5)" ) ) ) );
 }
 
 void TestQgsTessellator::testBadCoordinates()
@@ -335,6 +384,51 @@ void TestQgsTessellator::testCrashSelfIntersection()
   t.addPolygon( p, 0 );   // must not crash - that's all we test here
 }
 
+void TestQgsTessellator::testSelfIntersectingRings()
+{
+  // self-intersecting rings are skipped rather than triangulated into overlapping triangles
+
+  // bow-tie, with a zero signed area
+  QgsTessellator t( 0, 0, false );
+  QgsPolygon bowTie;
+  QVERIFY( bowTie.fromWkt( "POLYGON((0 0, 2 2, 2 0, 0 2, 0 0))" ) );
+  t.addPolygon( bowTie, 0 );
+  QCOMPARE( t.dataVerticesCount(), 0 );
+
+  // figure-eight with lobes of different sizes, with a non zero signed area
+  QgsTessellator t2( 0, 0, false );
+  QgsPolygon figureEight;
+  QVERIFY( figureEight.fromWkt( "POLYGON((0 0, 4 4, 4 0, 0 2, 0 0))" ) );
+  t2.addPolygon( figureEight, 0 );
+  QCOMPARE( t2.dataVerticesCount(), 0 );
+}
+
+void TestQgsTessellator::testLargeRing()
+{
+  // star shaped rings, with alternating convex and reflex vertices. Small rings are ear clipped,
+  // while a ring with many vertices, e.g. a lake or a country border, must not take quadratic time
+  for ( int count : { 100, 20000 } )
+  {
+    QVector< double > x, y;
+    for ( int i = 0; i <= count; ++i )
+    {
+      const double angle = 2 * M_PI * ( i % count ) / count;
+      const double radius = i % 2 ? 900 : 1000;
+      x << radius * std::cos( angle );
+      y << radius * std::sin( angle );
+    }
+    QgsPolygon polygon;
+    polygon.setExteriorRing( new QgsLineString( x, y ) );
+
+    QgsTessellator t( 0, 0, false );
+    t.addPolygon( polygon, 0 );
+
+    std::unique_ptr< QgsMultiPolygon > mp( t.asMultiPolygon() );
+    QCOMPARE( mp->numGeometries(), count - 2 );
+    QGSCOMPARENEAR( QgsGeometry( mp->clone() ).area(), polygon.area(), polygon.area() * 1e-4 );
+  }
+}
+
 
 QGSTEST_MAIN( TestQgsTessellator )
 #include "testqgstessellator.moc"
@@ -22,6 +22,7 @@
 #include "qgsprocessingcontext.h"
 #include "qgsprocessingparametertype.h"
 #include "qgsprocessingmodelalgorithm.h"
+#include "qgsprocessingfeaturestream_p.h"
 #include "qgsnativealgorithms.h"
 #include <QObject>
 #include <QtTest/QSignalSpy>
@@ -550,6 +551,7 @@ class TestQgsProcessing: public QObject
     void asPythonCommand();
     void modelerAlgorithm();
     void modelExecution();
+    void modelStreamedExecution();
     void modelWithProviderWithLimitedTypes();
     void modelVectorOutputIsCompatibleType();
     void modelAcceptableValues();
@@ -6227,6 +6229,119 @@ void TestQgsProcessing::modelExecution()
   QCOMPARE( actualParts, expectedParts );
 }
 
+void TestQgsProcessing::modelStreamedExecution()
+{
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc1 );
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( "cx2" );
+  algc2.setAlgorithmId( "native:translategeometry" );
+  algc2.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  algc2.addParameterSources( "DELTA_X", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( 1 ) );
+  QMap<QString, QgsProcessingModelOutput> outputs;
+  QgsProcessingModelOutput out( "OUT" );
+  out.setChildOutputName( "OUTPUT" );
+  outputs.insert( QStringLiteral( "OUT" ), out );
+  algc2.setModelOutputs( outputs );
+  model.addChildAlgorithm( algc2 );
+
+  // cx1 is only read by cx2, so its features can be streamed
+  QMap< QString, QString > streamed = model.streamedChildInputs( QSet< QString >() << "cx1" << "cx2" );
+  QCOMPARE( streamed.count(), 1 );
+  QCOMPARE( streamed.value( "cx2" ), QStringLiteral( "cx1" ) );
+
+  QString vector = QStringLiteral( TEST_DATA_DIR ) + "/points.shp";
+  QgsVectorLayer source( vector, "source", "ogr" );
+  QVERIFY( source.isValid() );
+
+  QVariantMap modelInputs;
+  modelInputs.insert( "SOURCE_LAYER", vector );
+  modelInputs.insert( "cx2:OUT", "memory:" );
+  QgsProcessingContext context;
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  QVariantMap results = model.run( modelInputs, context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( results.value( "cx2:OUT" ).toString(), context ) );
+  QVERIFY( layer );
+  QCOMPARE( layer->featureCount(), source.featureCount() );
+  QCOMPARE( layer->fields().names(), source.fields().names() );
+  QgsFeatureIterator sourceIt = source.getFeatures();
+  QgsFeatureIterator resultIt = layer->getFeatures();
+  QgsFeature sourceFeature;
+  QgsFeature resultFeature;
+  while ( sourceIt.nextFeature( sourceFeature ) )
+  {
+    QVERIFY( resultIt.nextFeature( resultFeature ) );
+    QCOMPARE( resultFeature.attributes(), sourceFeature.attributes() );
+    QGSCOMPARENEAR( resultFeature.geometry().asPoint().x(), sourceFeature.geometry().asPoint().x() + 1, 0.000001 );
+    QGSCOMPARENEAR( resultFeature.geometry().asPoint().y(), sourceFeature.geometry().asPoint().y(), 0.000001 );
+  }
+
+  // cx1 is also read by cx3, so it must be materialized
+  QgsProcessingModelChildAlgorithm algc3;
+  algc3.setChildId( "cx3" );
+  algc3.setAlgorithmId( "native:centroids" );
+  algc3.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  model.addChildAlgorithm( algc3 );
+  QVERIFY( model.streamedChildInputs( QSet< QString >() << "cx1" << "cx2" << "cx3" ).isEmpty() );
+
+  // only algorithms which support streaming are streamed
+  QgsProcessingModelAlgorithm model2;
+  model2.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+  QgsProcessingModelChildAlgorithm algc4;
+  algc4.setChildId( "cx4" );
+  algc4.setAlgorithmId( "native:addautoincrementalfield" );
+  algc4.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model2.addChildAlgorithm( algc4 );
+  QgsProcessingModelChildAlgorithm algc5;
+  algc5.setChildId( "cx5" );
+  algc5.setAlgorithmId( "native:translategeometry" );
+  algc5.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx4", "OUTPUT" ) );
+  model2.addChildAlgorithm( algc5 );
+  QVERIFY( model2.streamedChildInputs( QSet< QString >() << "cx4" << "cx5" ).isEmpty() );
+
+  // filters of requests are applied to streamed features
+  std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > translate( static_cast< QgsProcessingFeatureBasedAlgorithm * >( QgsApplication::processingRegistry()->createAlgorithmById( "native:translategeometry" ) ) );
+  QVariantMap translateParams;
+  translateParams.insert( "INPUT", vector );
+  translateParams.insert( "DELTA_X", 1 );
+  translateParams.insert( "OUTPUT", "memory:" );
+  QVERIFY( translate->prepare( translateParams, context, &feedback ) );
+  QgsProcessingFeatureStreamSource stream( translate.release(), translateParams, context, &feedback );
+
+  QgsFeature f;
+  QgsFeatureIds ids;
+  QgsFeatureIterator it = stream.getFeatures( QgsFeatureRequest().setFilterFids( QgsFeatureIds() << 2 << 4 << 1000 ) );
+  while ( it.nextFeature( f ) )
+    ids << f.id();
+  QCOMPARE( ids, QgsFeatureIds() << 2 << 4 );
+
+  it = stream.getFeatures( QgsFeatureRequest().setFilterFid( 3 ) );
+  QVERIFY( it.nextFeature( f ) );
+  QCOMPARE( f.id(), 3LL );
+  QVERIFY( !it.nextFeature( f ) );
+
+  QList< QgsAttributes > expectedAttributes;
+  sourceIt = source.getFeatures( QgsFeatureRequest().setFilterExpression( QStringLiteral( "\"Class\" = 'Jet'" ) ) );
+  while ( sourceIt.nextFeature( sourceFeature ) )
+    expectedAttributes << sourceFeature.attributes();
+  QVERIFY( !expectedAttributes.isEmpty() );
+  QVERIFY( expectedAttributes.count() < source.featureCount() );
+
+  QList< QgsAttributes > attributes;
+  it = stream.getFeatures( QgsFeatureRequest().setFilterExpression( QStringLiteral( "\"Class\" = 'Jet'" ) ) );
+  while ( it.nextFeature( f ) )
+    attributes << f.attributes();
+  QCOMPARE( attributes, expectedAttributes );
+}
+
 void TestQgsProcessing::modelWithProviderWithLimitedTypes()
 {
   QgsApplication::processingRegistry()->addProvider( new DummyProvider4() );
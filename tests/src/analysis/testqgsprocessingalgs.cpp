@@ -26,6 +26,11 @@
 #include "qgsalgorithmimportphotos.h"
 #include "qgsalgorithmtransform.h"
 #include "qgsalgorithmkmeansclustering.h"
+#include "qgspreparedgeometrycache.h"
+#include "qgsgeos.h"
+
+#include <QThreadPool>
+#include <cmath>
 
 class TestQgsProcessingAlgs: public QObject
 {
@@ -42,7 +47,13 @@ class TestQgsProcessingAlgs: public QObject
     void parseGeoTags();
     void featureFilterAlg();
     void transformAlg();
+    void parallelFeatureBasedAlg();
+    void parallelGeosAlgs_data();
+    void parallelGeosAlgs();
+    void parallelOverlay();
+    void partitionedDissolve();
     void kmeansCluster();
+    void preparedGeometryCache();
 
   private:
 
@@ -437,6 +448,284 @@ void TestQgsProcessingAlgs::transformAlg()
   QVERIFY( ok );
 }
 
+void TestQgsProcessingAlgs::parallelFeatureBasedAlg()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:translategeometry" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+
+  QgsProcessingFeedback feedback;
+
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:4326&field=col1:integer" ), QStringLiteral( "test" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  // more features than a single block of parallel processing
+  QgsFeatureList features;
+  for ( int i = 0; i < 5000; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, -i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  p.addMapLayer( layer );
+
+  // make sure several threads are used
+  const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "test" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  parameters.insert( QStringLiteral( "DELTA_X" ), 1.0 );
+  parameters.insert( QStringLiteral( "DELTA_Y" ), 2.0 );
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+  QVERIFY( ok );
+
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 5000L );
+
+  // features must come out in the input order
+  QgsFeatureIterator it = output->getFeatures();
+  QgsFeature f;
+  int i = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), i );
+    QCOMPARE( f.geometry().asPoint(), QgsPointXY( i + 1, -i + 2 ) );
+    i++;
+  }
+  QCOMPARE( i, 5000 );
+}
+
+void TestQgsProcessingAlgs::parallelGeosAlgs_data()
+{
+  QTest::addColumn<QString>( "algorithm" );
+
+  QTest::newRow( "boundary" ) << QStringLiteral( "native:boundary" );
+  QTest::newRow( "centroids" ) << QStringLiteral( "native:centroids" );
+  QTest::newRow( "convexhull" ) << QStringLiteral( "native:convexhull" );
+  QTest::newRow( "fixgeometries" ) << QStringLiteral( "native:fixgeometries" );
+  QTest::newRow( "pointonsurface" ) << QStringLiteral( "native:pointonsurface" );
+}
+
+void TestQgsProcessingAlgs::parallelGeosAlgs()
+{
+  QFETCH( QString, algorithm );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( algorithm ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+  QgsProcessingFeedback feedback;
+
+  // concave stars, and some self-intersecting bow ties which need fixing
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "stars" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 3000; ++i )
+  {
+    const double x = ( i % 60 ) * 10;
+    const double y = ( i / 60 ) * 10;
+    QgsPolylineXY ring;
+    if ( i % 10 == 0 )
+    {
+      ring << QgsPointXY( x, y ) << QgsPointXY( x + 4, y + 4 ) << QgsPointXY( x + 4, y ) << QgsPointXY( x, y + 4 );
+    }
+    else
+    {
+      const int spikes = 5 + i % 7;
+      for ( int j = 0; j < spikes * 2; ++j )
+      {
+        const double radius = j % 2 ? 1.5 : 4.0;
+        const double angle = M_PI * j / spikes;
+        ring << QgsPointXY( x + radius * std::cos( angle ), y + radius * std::sin( angle ) );
+      }
+    }
+    ring << ring.at( 0 );
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPolygonXY( QgsPolygonXY() << ring ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  p.addMapLayer( layer );
+
+  auto runAlgorithm = [&]( int threadCount )
+  {
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "stars" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+
+    QStringList output;
+    QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !ok || !outputLayer )
+      return output;
+
+    QgsFeature f;
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    while ( it.nextFeature( f ) )
+      output << QStringLiteral( "%1 %2" ).arg( f.attribute( 0 ).toInt() ).arg( f.geometry().asWkt( 6 ) );
+    return output;
+  };
+
+  // a single thread in the pool disables parallel processing
+  const QStringList serial = runAlgorithm( 1 );
+  QCOMPARE( serial.count(), 3000 );
+  QCOMPARE( runAlgorithm( 4 ), serial );
+}
+
+//! Returns a memory layer with \a count squares of size \a size, laid out in rows of \a rowLength with a \a step between them
+static QgsVectorLayer *squaresLayer( const QString &name, int count, int rowLength, double step, double size )
+{
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857&field=id:integer" ), name, QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < count; ++i )
+  {
+    const double x = ( i % rowLength ) * step;
+    const double y = ( i / rowLength ) * step;
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + size, y + size ) ) );
+    features << f;
+  }
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+void TestQgsProcessingAlgs::parallelOverlay()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:intersection" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+  QgsProcessingFeedback feedback;
+
+  // more input features than a single batch of the overlay utils
+  QgsVectorLayer *layerA = squaresLayer( QStringLiteral( "a" ), 2500, 50, 1.0, 0.8 );
+  QgsVectorLayer *layerB = squaresLayer( QStringLiteral( "b" ), 400, 20, 2.5, 3.1 );
+  p.addMapLayers( QList< QgsMapLayer * >() << layerA << layerB );
+
+  // results computed serially, in the order of the overlay utils: input features first,
+  // then overlay features by ascending id
+  QStringList expected;
+  QgsFeature fA;
+  QgsFeatureIterator itA = layerA->getFeatures();
+  while ( itA.nextFeature( fA ) )
+  {
+    QgsFeature fB;
+    QgsFeatureIterator itB = layerB->getFeatures( QgsFeatureRequest().setFilterRect( fA.geometry().boundingBox() ) );
+    QMap< QgsFeatureId, QgsFeature > sortedB;
+    while ( itB.nextFeature( fB ) )
+      sortedB.insert( fB.id(), fB );
+    for ( const QgsFeature &b : qgis::as_const( sortedB ) )
+    {
+      QgsGeometry intersection = fA.geometry().intersection( b.geometry() );
+      if ( QgsWkbTypes::geometryType( intersection.wkbType() ) != QgsWkbTypes::PolygonGeometry || intersection.isEmpty() )
+        continue;
+      intersection.convertToMultiType();
+      expected << QStringLiteral( "%1 %2 %3" ).arg( fA.attribute( 0 ).toInt() ).arg( b.attribute( 0 ).toInt() ).arg( intersection.asWkt( 6 ) );
+    }
+  }
+  QVERIFY( expected.count() > 2500 );
+
+  auto runIntersection = [&]( int threadCount )
+  {
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "a" ) );
+    parameters.insert( QStringLiteral( "OVERLAY" ), QStringLiteral( "b" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+
+    QStringList actual;
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !ok || !output )
+      return actual;
+
+    QgsFeature f;
+    QgsFeatureIterator it = output->getFeatures();
+    while ( it.nextFeature( f ) )
+      actual << QStringLiteral( "%1 %2 %3" ).arg( f.attribute( 0 ).toInt() ).arg( f.attribute( 1 ).toInt() ).arg( f.geometry().asWkt( 6 ) );
+    return actual;
+  };
+
+  QCOMPARE( runIntersection( 1 ), expected );
+  QCOMPARE( runIntersection( 4 ), expected );
+}
+
+void TestQgsProcessingAlgs::partitionedDissolve()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+  QgsProcessingFeedback feedback;
+
+  // enough overlapping squares for several levels of partitions, with holes between some of them
+  QgsVectorLayer *layer = squaresLayer( QStringLiteral( "squares" ), 3000, 60, 1.0, 1.2 );
+  QgsFeatureIds holes;
+  for ( QgsFeatureId id = 1; id <= 3000; id += 97 )
+    holes << id;
+  layer->dataProvider()->deleteFeatures( holes );
+  p.addMapLayer( layer );
+
+  // result of the single union used before partitioning
+  QVector< QgsGeometry > geometries;
+  QgsFeature f;
+  QgsFeatureIterator it = layer->getFeatures();
+  while ( it.nextFeature( f ) )
+    geometries << f.geometry();
+  const QgsGeometry expected = QgsGeometry::unaryUnion( geometries );
+  QVERIFY( !expected.isNull() );
+
+  for ( int threadCount : { 1, 4 } )
+  {
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "squares" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+    QVERIFY( ok );
+
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    QVERIFY( output );
+    QCOMPARE( output->featureCount(), 1L );
+
+    QgsFeature dissolved;
+    QVERIFY( output->getFeatures().nextFeature( dissolved ) );
+    const QgsGeometry geometry = dissolved.geometry();
+    QCOMPARE( geometry.constGet()->partCount(), expected.constGet()->partCount() );
+    QGSCOMPARENEAR( geometry.area(), expected.area(), 1e-6 );
+    QGSCOMPARENEAR( geometry.symDifference( expected ).area(), 0.0, 1e-6 );
+  }
+}
+
 void TestQgsProcessingAlgs::kmeansCluster()
 {
   // make some features
@@ -495,6 +784,80 @@ void TestQgsProcessingAlgs::kmeansCluster()
   QCOMPARE( features[ 2 ].cluster, -1 );
 }
 
+void TestQgsProcessingAlgs::preparedGeometryCache()
+{
+  // small squares cost 1 kB each, the cache holds 3 of them
+  QgsPreparedGeometryCache cache( 3 );
+  auto square = []( int i )
+  {
+    return QgsGeometry::fromRect( QgsRectangle( i, 0, i + 1, 1 ) );
+  };
+  auto isCached = [&cache, &square]( QgsFeatureId id )
+  {
+    const int misses = cache.misses();
+    cache.engine( nullptr, id, square( id ) );
+    return cache.misses() == misses;
+  };
+
+  QVERIFY( !cache.engine( nullptr, 0, QgsGeometry() ) );
+  QCOMPARE( cache.misses(), 0 );
+
+  for ( QgsFeatureId id = 1; id <= 3; ++id )
+  {
+    const QgsGeos *engine = cache.engine( nullptr, id, square( id ) );
+    QVERIFY( engine );
+    QVERIFY( engine->intersects( QgsGeometry::fromPointXY( QgsPointXY( id + 0.5, 0.5 ) ).constGet() ) );
+  }
+  QCOMPARE( cache.misses(), 3 );
+  QCOMPARE( cache.hits(), 0 );
+  QCOMPARE( cache.memoryKb(), 3 );
+
+  // a hit makes the entry the most recently used one, so the least recently used one is evicted
+  QVERIFY( cache.engine( nullptr, 1, square( 1 ) ) );
+  QCOMPARE( cache.hits(), 1 );
+  QVERIFY( cache.engine( nullptr, 4, square( 4 ) ) );
+  QCOMPARE( cache.misses(), 4 );
+  QCOMPARE( cache.memoryKb(), 3 );
+  QVERIFY( isCached( 1 ) );
+  QVERIFY( isCached( 3 ) );
+  QVERIFY( isCached( 4 ) );
+  QVERIFY( !isCached( 2 ) );
+  QCOMPARE( cache.memoryKb(), 3 );
+
+  // entries are keyed by source too
+  QgsVectorLayer otherSource( QStringLiteral( "Polygon" ), QStringLiteral( "source" ), QStringLiteral( "memory" ) );
+  const int misses = cache.misses();
+  QVERIFY( cache.engine( &otherSource, 2, square( 2 ) ) );
+  QCOMPARE( cache.misses(), misses + 1 );
+
+  // preparing the geometry of an engine converted without preparation is a hit
+  QgsPreparedGeometryCache preparedCache( 3 );
+  QVERIFY( preparedCache.engine( nullptr, 1, square( 1 ), false ) );
+  QVERIFY( preparedCache.engine( nullptr, 1, square( 1 ), true ) );
+  QCOMPARE( preparedCache.misses(), 1 );
+  QCOMPARE( preparedCache.hits(), 1 );
+
+  // an entry larger than the cache is returned without being cached, nor evicting other entries
+  QgsPolylineXY line;
+  for ( int i = 0; i < 1000; ++i )
+    line << QgsPointXY( i, i % 2 );
+  const QgsGeometry largeGeometry = QgsGeometry::fromPolylineXY( line );
+  const int hits = preparedCache.hits();
+  const QgsGeos *largeEngine = preparedCache.engine( nullptr, 2, largeGeometry );
+  QVERIFY( largeEngine );
+  QVERIFY( largeEngine->intersects( QgsGeometry::fromPointXY( QgsPointXY( 10, 0 ) ).constGet() ) );
+  QCOMPARE( preparedCache.memoryKb(), 1 );
+  QVERIFY( preparedCache.engine( nullptr, 2, largeGeometry ) );
+  QCOMPARE( preparedCache.misses(), 3 );
+  QVERIFY( preparedCache.engine( nullptr, 1, square( 1 ) ) );
+  QCOMPARE( preparedCache.hits(), hits + 1 );
+
+  preparedCache.clear();
+  QCOMPARE( preparedCache.hits(), 0 );
+  QCOMPARE( preparedCache.misses(), 0 );
+  QCOMPARE( preparedCache.memoryKb(), 0 );
+}
+
 
 QGSTEST_MAIN( TestQgsProcessingAlgs )
 #include "testqgsprocessingalgs.moc"
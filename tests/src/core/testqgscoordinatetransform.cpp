@@ -23,6 +23,8 @@
 #include "qgstest.h"
 #include "qgsexception.h"
 
+#include <proj_api.h>
+
 class TestQgsCoordinateTransform: public QObject
 {
     Q_OBJECT
@@ -36,6 +38,8 @@ class TestQgsCoordinateTransform: public QObject
     void isValid();
     void isShortCircuited();
     void contextShared();
+    void closedFormKernels_data();
+    void closedFormKernels();
 
   private:
 
@@ -256,5 +260,77 @@ void TestQgsCoordinateTransform::transformBoundingBox()
   QVERIFY( errorObtained );
 }
 
+void TestQgsCoordinateTransform::closedFormKernels_data()
+{
+  QTest::addColumn<QString>( "destAuthId" );
+  QTest::addColumn<QList<double>>( "lon" );
+  QTest::addColumn<QList<double>>( "lat" );
+  QTest::addColumn<double>( "tolerance" );
+
+  QTest::newRow( "web mercator" ) << QStringLiteral( "EPSG:3857" )
+                                  << ( QList<double>() << 0 << 151.2 << -179.9 << 180 << 12.5 )
+                                  << ( QList<double>() << 0 << -33.9 << 85 << -85.05 << 41.9 )
+                                  << 0.0000001;
+  QTest::newRow( "web mercator, wrapped longitudes" ) << QStringLiteral( "EPSG:3857" )
+      << ( QList<double>() << 10 << 190 )
+      << ( QList<double>() << 10 << 20 )
+      << 0.0000001;
+  QTest::newRow( "utm north" ) << QStringLiteral( "EPSG:32631" )
+                               << ( QList<double>() << 3 << 2.3522 << 4.4 << 0.1 )
+                               << ( QList<double>() << 0 << 48.8566 << 60.2 << 12 )
+                               << 0.001;
+  QTest::newRow( "utm south" ) << QStringLiteral( "EPSG:32755" )
+                               << ( QList<double>() << 147 << 145.5 << 148.9 )
+                               << ( QList<double>() << -42.88 << -37.8 << -1 )
+                               << 0.001;
+  QTest::newRow( "utm, outside of zone" ) << QStringLiteral( "EPSG:32633" )
+                                          << ( QList<double>() << 15 << 40 )
+                                          << ( QList<double>() << 45 << 45 )
+                                          << 0.001;
+}
+
+void TestQgsCoordinateTransform::closedFormKernels()
+{
+  QFETCH( QString, destAuthId );
+  QFETCH( QList<double>, lon );
+  QFETCH( QList<double>, lat );
+  QFETCH( double, tolerance );
+
+  QgsCoordinateReferenceSystem source( QStringLiteral( "EPSG:4326" ) );
+  QgsCoordinateReferenceSystem dest( destAuthId );
+  QgsCoordinateTransform ct( source, dest, QgsProject::instance() );
+  QVERIFY( ct.isValid() );
+
+  // reference results straight from PROJ
+  projPJ sourceProj = pj_init_plus( source.toProj4().toUtf8() );
+  projPJ destProj = pj_init_plus( dest.toProj4().toUtf8() );
+  QVERIFY( sourceProj );
+  QVERIFY( destProj );
+
+  for ( int i = 0; i < lon.count(); ++i )
+  {
+    double x = lon.at( i ) * DEG_TO_RAD;
+    double y = lat.at( i ) * DEG_TO_RAD;
+    double z = 0;
+    QCOMPARE( pj_transform( sourceProj, destProj, 1, 0, &x, &y, &z ), 0 );
+
+    const QgsPointXY projected = ct.transform( QgsPointXY( lon.at( i ), lat.at( i ) ) );
+    QGSCOMPARENEAR( projected.x(), x, tolerance );
+    QGSCOMPARENEAR( projected.y(), y, tolerance );
+
+    // and back
+    const QgsPointXY geographic = ct.transform( projected, QgsCoordinateTransform::ReverseTransform );
+    double backX = projected.x();
+    double backY = projected.y();
+    z = 0;
+    QCOMPARE( pj_transform( destProj, sourceProj, 1, 0, &backX, &backY, &z ), 0 );
+    QGSCOMPARENEAR( geographic.x(), backX * RAD_TO_DEG, 0.0000001 );
+    QGSCOMPARENEAR( geographic.y(), backY * RAD_TO_DEG, 0.0000001 );
+  }
+
+  pj_free( sourceProj );
+  pj_free( destProj );
+}
+
 QGSTEST_MAIN( TestQgsCoordinateTransform )
 #include "testqgscoordinatetransform.moc"
@@ -39,6 +39,7 @@
 #include "qgspolygon.h"
 #include "qgstriangle.h"
 #include "qgsgeometryengine.h"
+#include "qgsgeos.h"
 #include "qgscircle.h"
 #include "qgsellipse.h"
 #include "qgsregularpolygon.h"
@@ -133,12 +134,15 @@ class TestQgsGeometry : public QObject
     void smoothCheck();
 
     void unaryUnion();
+    void geosEnginePredicates();
+    void nativePredicates();
 
     void dataStream();
 
     void exportToGeoJSON();
 
     void wkbInOut();
+    void lazyWkb();
 
     void directionNeutralSegmentation();
     void poleOfInaccessibility();
@@ -16448,6 +16452,104 @@ void TestQgsGeometry::unaryUnion()
   Q_UNUSED( result );
 }
 
+void TestQgsGeometry::geosEnginePredicates()
+{
+  const QStringList wkts = QStringList() << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" )
+                           << QStringLiteral( "Polygon ((2 2, 4 2, 4 4, 2 4, 2 2))" )
+                           << QStringLiteral( "Polygon ((10 0, 20 0, 20 10, 10 10, 10 0))" )
+                           << QStringLiteral( "Polygon ((5 5, 15 5, 15 15, 5 15, 5 5))" )
+                           << QStringLiteral( "LineString (-5 5, 15 5)" )
+                           << QStringLiteral( "Point (30 30)" )
+                           << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" );
+  for ( const QString &wktA : wkts )
+  {
+    const QgsGeometry a = QgsGeometry::fromWkt( wktA );
+    for ( bool prepared : { false, true } )
+    {
+      QgsGeos engineA( a.constGet() );
+      if ( prepared )
+        engineA.prepareGeometry();
+
+      for ( const QString &wktB : wkts )
+      {
+        // testing against another engine must give the same results as testing against the geometry
+        const QgsGeometry b = QgsGeometry::fromWkt( wktB );
+        const QgsGeos engineB( b.constGet() );
+        QCOMPARE( engineA.intersects( engineB ), engineA.intersects( b.constGet() ) );
+        QCOMPARE( engineA.touches( engineB ), engineA.touches( b.constGet() ) );
+        QCOMPARE( engineA.crosses( engineB ), engineA.crosses( b.constGet() ) );
+        QCOMPARE( engineA.within( engineB ), engineA.within( b.constGet() ) );
+        QCOMPARE( engineA.overlaps( engineB ), engineA.overlaps( b.constGet() ) );
+        QCOMPARE( engineA.contains( engineB ), engineA.contains( b.constGet() ) );
+        QCOMPARE( engineA.disjoint( engineB ), engineA.disjoint( b.constGet() ) );
+        QCOMPARE( engineA.isEqual( engineB ), engineA.isEqual( b.constGet() ) );
+      }
+    }
+  }
+
+  // null geometries
+  const QgsGeos nullEngine( nullptr );
+  const QgsGeometry point = QgsGeometry::fromWkt( QStringLiteral( "Point (1 1)" ) );
+  const QgsGeos engine( point.constGet() );
+  QVERIFY( !engine.intersects( nullEngine ) );
+  QVERIFY( !nullEngine.intersects( engine ) );
+  QVERIFY( !engine.isEqual( nullEngine ) );
+}
+
+void TestQgsGeometry::nativePredicates()
+{
+  // predicates decided without GEOS must match the GEOS results
+  const QList< QgsGeometry > polygons = QList< QgsGeometry >()
+                                        << QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0),(2 2, 4 2, 4 4, 2 4, 2 2))" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 5 10, 0 0))" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((0 0, 4 0, 4 4, 0 4, 0 0)),((6 6, 10 6, 10 10, 6 10, 6 6)))" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "CurvePolygon (CircularString (0 5, 5 10, 10 5, 5 0, 0 5))" ) );
+
+  QList< QgsPointXY > points;
+  for ( int x = -2; x <= 22; ++x )
+  {
+    for ( int y = -2; y <= 22; ++y )
+    {
+      // vertices, points on edges and points inside and outside of the polygons
+      points << QgsPointXY( x / 2.0, y / 2.0 );
+    }
+  }
+  points << QgsPointXY( 2.5, 5.0 ) << QgsPointXY( 7.5, 5.0 ) << QgsPointXY( 1.0 / 3.0, 0.1 ) << QgsPointXY( 5, 1e-300 );
+
+  for ( const QgsGeometry &polygon : polygons )
+  {
+    const QgsGeos polygonEngine( polygon.constGet() );
+    for ( const QgsPointXY &point : qgis::as_const( points ) )
+    {
+      const QgsGeometry pointGeometry = QgsGeometry::fromPointXY( point );
+      const QgsGeos pointEngine( pointGeometry.constGet() );
+      QCOMPARE( polygon.intersects( pointGeometry ), polygonEngine.intersects( pointGeometry.constGet() ) );
+      QCOMPARE( pointGeometry.intersects( polygon ), pointEngine.intersects( polygon.constGet() ) );
+      QCOMPARE( polygon.contains( pointGeometry ), polygonEngine.contains( pointGeometry.constGet() ) );
+      QCOMPARE( polygon.contains( &point ), polygonEngine.contains( pointGeometry.constGet() ) );
+      QCOMPARE( pointGeometry.within( polygon ), pointEngine.within( polygon.constGet() ) );
+      QCOMPARE( polygon.disjoint( pointGeometry ), polygonEngine.disjoint( pointGeometry.constGet() ) );
+      QCOMPARE( pointGeometry.disjoint( polygon ), pointEngine.disjoint( polygon.constGet() ) );
+    }
+
+    // bounding box shortcuts
+    const QList< QgsGeometry > others = QList< QgsGeometry >()
+                                        << QgsGeometry::fromWkt( QStringLiteral( "LineString (20 20, 30 30)" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "LineString (1 1, 1.5 1.5)" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "LineString (-1 5, 11 5)" ) )
+                                        << QgsGeometry::fromWkt( QStringLiteral( "LineString EMPTY" ) );
+    for ( const QgsGeometry &other : others )
+    {
+      QCOMPARE( polygon.intersects( other ), polygonEngine.intersects( other.constGet() ) );
+      QCOMPARE( polygon.contains( other ), polygonEngine.contains( other.constGet() ) );
+      QCOMPARE( polygon.disjoint( other ), polygonEngine.disjoint( other.constGet() ) );
+      QCOMPARE( other.within( polygon ), polygonEngine.contains( other.constGet() ) );
+    }
+    QVERIFY( polygon.intersects( QgsRectangle( -1, -1, 11, 11 ) ) );
+    QVERIFY( !polygon.intersects( QgsRectangle( 20, 20, 30, 30 ) ) );
+  }
+}
+
 void TestQgsGeometry::dataStream()
 {
   QString wkt = QStringLiteral( "Point (40 50)" );
@@ -16627,6 +16729,61 @@ void TestQgsGeometry::wkbInOut()
   QCOMPARE( badHeader.wkbType(), QgsWkbTypes::Unknown );
 }
 
+void TestQgsGeometry::lazyWkb()
+{
+  const QStringList wkts = QStringList() << QStringLiteral( "Point (1 2)" )
+                           << QStringLiteral( "PointZM (1 2 3 4)" )
+                           << QStringLiteral( "LineString (0 0, 10 5, -3 8)" )
+                           << QStringLiteral( "LineString EMPTY" )
+                           << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 0),(1 1, 2 1, 2 2, 1 1))" )
+                           << QStringLiteral( "MultiPoint ((1 2),(-5 7))" )
+                           << QStringLiteral( "MultiLineStringZ ((0 0 1, 10 5 2),(20 -4 3, 21 3 4))" )
+                           << QStringLiteral( "MultiPolygon (((0 0, 10 0, 10 10, 0 0)),((20 20, 30 20, 30 30, 20 20)))" )
+                           << QStringLiteral( "MultiPolygon EMPTY" )
+                           << QStringLiteral( "CircularString (0 0, 1 1, 2 0)" )
+                           << QStringLiteral( "GeometryCollection (Point (1 2),LineString (0 0, 3 3))" );
+  for ( const QString &wkt : wkts )
+  {
+    const QgsGeometry expected = QgsGeometry::fromWkt( wkt );
+    const QByteArray wkb = expected.asWkb();
+
+    // type, bounding box and WKB must match the parsed geometry
+    QgsGeometry g;
+    g.fromWkb( wkb );
+    QVERIFY( !g.isNull() );
+    QCOMPARE( g.wkbType(), expected.wkbType() );
+    QCOMPARE( g.boundingBox(), expected.boundingBox() );
+    QCOMPARE( g.asWkb(), wkb );
+    QCOMPARE( g.constGet()->boundingBox(), expected.boundingBox() );
+    QCOMPARE( g.asWkt(), expected.asWkt() );
+    QCOMPARE( g.asWkb(), wkb );
+
+    // modifying a copy must not affect the original geometry
+    g.fromWkb( wkb );
+    QgsGeometry copy = g;
+    copy.translate( 100, 200 );
+    QCOMPARE( g.asWkb(), wkb );
+    QCOMPARE( g.asWkt(), expected.asWkt() );
+    QCOMPARE( copy.asWkb(), copy.constGet()->asWkb() );
+    QVERIFY( copy.asWkb() != wkb || expected.isEmpty() );
+
+    // modifying the only reference must not return the stale WKB
+    g.translate( 100, 200 );
+    QCOMPARE( g.asWkb(), copy.asWkb() );
+    QCOMPARE( g.boundingBox(), copy.constGet()->boundingBox() );
+  }
+
+  // big endian WKB is parsed immediately
+  QByteArray bigEndian;
+  QDataStream stream( &bigEndian, QIODevice::WriteOnly );
+  stream.setByteOrder( QDataStream::BigEndian );
+  stream << static_cast< qint8 >( QgsApplication::XDR ) << static_cast< quint32 >( QgsWkbTypes::Point ) << 3.0 << 4.0;
+  QgsGeometry g;
+  g.fromWkb( bigEndian );
+  QCOMPARE( g.asWkt(), QStringLiteral( "Point (3 4)" ) );
+  QCOMPARE( g.boundingBox(), QgsRectangle( 3, 4, 3, 4 ) );
+}
+
 void TestQgsGeometry::directionNeutralSegmentation()
 {
   //Tests, if segmentation of a circularstring is the same in both directions
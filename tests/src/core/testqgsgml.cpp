@@ -62,6 +62,7 @@ class TestQgsGML : public QObject
     void testPointGML3_EPSG_4326_honour_EPSG_invert();
     void testLineStringGML3();
     void testLineStringGML3_LineStringSegment();
+    void testLineStringGML3_NumberFormats();
     void testPolygonGML3();
     void testPolygonGML3_srsDimension_on_Polygon();
     void testMultiLineStringGML3();
@@ -580,6 +581,37 @@ void TestQgsGML::testLineStringGML3_LineStringSegment()
   delete features[0].first;
 }
 
+void TestQgsGML::testLineStringGML3_NumberFormats()
+{
+  QgsFields fields;
+  QgsGmlStreamingParser gmlParser( QStringLiteral( "mytypename" ), QStringLiteral( "mygeom" ), fields );
+  QCOMPARE( gmlParser.processData( QByteArray( "<myns:FeatureCollection "
+                                   "xmlns:myns='http://myns' "
+                                   "xmlns:gml='http://www.opengis.net/gml'>"
+                                   "<gml:featureMember>"
+                                   "<myns:mytypename fid='mytypename.1'>"
+                                   "<myns:mygeom>"
+                                   "<gml:LineString srsName='EPSG:27700'><gml:posList>\n"
+                                   "  -1.5 +2.25e2\n"
+                                   "\t0.1234567890123456789 1E-3\n"
+                                   "  invalid 5 7. .5\n"
+                                   "</gml:posList></gml:LineString>"
+                                   "</myns:mygeom>"
+                                   "</myns:mytypename>"
+                                   "</gml:featureMember>"
+                                   "</myns:FeatureCollection>" ), true ), true );
+  QVector<QgsGmlStreamingParser::QgsGmlFeaturePtrGmlIdPair> features = gmlParser.getAndStealReadyFeatures();
+  QCOMPARE( features.size(), 1 );
+  QVERIFY( features[0].first->hasGeometry() );
+  QgsPolylineXY line = features[0].first->geometry().asPolyline();
+  QCOMPARE( line.size(), 3 );
+  QCOMPARE( line[0], QgsPointXY( -1.5, 225 ) );
+  QCOMPARE( line[1].x(), 0.1234567890123456789 );
+  QCOMPARE( line[1].y(), 0.001 );
+  QCOMPARE( line[2], QgsPointXY( 7, 0.5 ) );
+  delete features[0].first;
+}
+
 void TestQgsGML::testPolygonGML3()
 {
   QgsFields fields;
@@ -0,0 +1,114 @@
+/***************************************************************************
+  testqgsinterpolatedcoordinatetransform.cpp
+  ------------------------------------------
+  Date                 : August 2018
+  Copyright            : (C) 2018 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <cmath>
+
+#include "qgsapplication.h"
+#include "qgscoordinatetransform.h"
+#include "qgsinterpolatedcoordinatetransform.h"
+#include "qgsmaptopixel.h"
+#include "qgsproject.h"
+#include "qgsrendercontext.h"
+
+class TestQgsInterpolatedCoordinateTransform: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void withinErrorBound();
+    void outsideExtent();
+    void renderContext();
+};
+
+void TestQgsInterpolatedCoordinateTransform::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsInterpolatedCoordinateTransform::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsInterpolatedCoordinateTransform::withinErrorBound()
+{
+  // GDA94 / Vicgrid94 to WGS 84 / Pseudo-Mercator
+  QgsCoordinateTransform ct( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3111" ) ),
+                             QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() );
+  const QgsRectangle extent( 2400000, 2300000, 2600000, 2500000 );
+  const double maxError = 1.0;
+  QgsInterpolatedCoordinateTransform approximate( ct, extent, maxError );
+  QVERIFY( approximate.isValid() );
+  QVERIFY( approximate.gridSize() > 0 );
+
+  QPolygonF poly;
+  for ( int i = 0; i <= 20; ++i )
+  {
+    poly << QPointF( 2400000 + i * 10000, 2300000 + ( i * 7 % 20 ) * 10000 );
+  }
+  QPolygonF exact = poly;
+  ct.transformPolygon( exact );
+  approximate.transformPolygon( poly );
+
+  QCOMPARE( poly.size(), exact.size() );
+  for ( int i = 0; i < poly.size(); ++i )
+  {
+    QVERIFY( std::hypot( poly.at( i ).x() - exact.at( i ).x(), poly.at( i ).y() - exact.at( i ).y() ) <= maxError );
+  }
+}
+
+void TestQgsInterpolatedCoordinateTransform::outsideExtent()
+{
+  QgsCoordinateTransform ct( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3111" ) ),
+                             QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() );
+  QgsInterpolatedCoordinateTransform approximate( ct, QgsRectangle( 2400000, 2300000, 2600000, 2500000 ), 1.0 );
+
+  // points outside of the grid are transformed exactly
+  double x = 3000000;
+  double y = 2000000;
+  approximate.transformInPlace( x, y );
+  const QgsPointXY exact = ct.transform( QgsPointXY( 3000000, 2000000 ) );
+  QCOMPARE( x, exact.x() );
+  QCOMPARE( y, exact.y() );
+}
+
+void TestQgsInterpolatedCoordinateTransform::renderContext()
+{
+  QgsRenderContext context;
+  QVERIFY( !context.approximateTransform() );
+
+  context.setCoordinateTransform( QgsCoordinateTransform( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3111" ) ),
+                                  QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() ) );
+  context.setExtent( QgsRectangle( 2400000, 2300000, 2600000, 2500000 ) );
+  context.setMapToPixel( QgsMapToPixel( 100, 16000000, -4500000, 1000, 1000, 0 ) );
+  // opt-in only
+  QVERIFY( !context.approximateTransform() );
+
+  context.setFlag( QgsRenderContext::ApproximateTransform );
+  const QgsInterpolatedCoordinateTransform *approximate = context.approximateTransform();
+  QVERIFY( approximate );
+  QCOMPARE( context.approximateTransform(), approximate );
+
+  // no approximation without reprojection
+  context.setCoordinateTransform( QgsCoordinateTransform() );
+  QVERIFY( !context.approximateTransform() );
+}
+
+QGSTEST_MAIN( TestQgsInterpolatedCoordinateTransform )
+#include "testqgsinterpolatedcoordinatetransform.moc"
@@ -29,6 +29,7 @@ class TestQgsMapToPixel: public QObject
     void getters();
     void fromScale();
     void toMapPoint();
+    void transformPolygonInPlace();
 };
 
 void TestQgsMapToPixel::rotation()
@@ -119,6 +120,28 @@ void TestQgsMapToPixel::toMapPoint()
   QCOMPARE( p, QgsPointXY( 20, 20 ) );
 }
 
+void TestQgsMapToPixel::transformPolygonInPlace()
+{
+  QPolygonF poly;
+  poly << QPointF( 5, 5 ) << QPointF( 5.5, 4.5 ) << QPointF( 1, 7 );
+
+  for ( double rotation : { 0.0, 30.0, 90.0 } )
+  {
+    QgsMapToPixel m2p( 0.1, 5, 5, 10, 10, rotation );
+    QPolygonF transformed = poly;
+    m2p.transformInPlace( transformed );
+    QCOMPARE( transformed.size(), poly.size() );
+    for ( int i = 0; i < poly.size(); ++i )
+    {
+      double x = poly.at( i ).x();
+      double y = poly.at( i ).y();
+      m2p.transformInPlace( x, y );
+      QGSCOMPARENEAR( transformed.at( i ).x(), x, 0.0000001 );
+      QGSCOMPARENEAR( transformed.at( i ).y(), y, 0.0000001 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMapToPixel )
 #include "testqgsmaptopixel.moc"
 
@@ -16,6 +16,7 @@
 #include "qgstest.h"
 #include <QObject>
 #include <QString>
+#include <QSignalSpy>
 
 #include "qgsapplication.h"
 #include "qgsvectorlayer.h"
@@ -23,6 +24,8 @@
 #include "qgsgeometry.h"
 #include "qgsproject.h"
 #include "qgspointlocator.h"
+#include "qgspointlocatorinittask.h"
+#include "qgstaskmanager.h"
 #include "qgspolygon.h"
 
 
@@ -328,6 +331,103 @@ class TestQgsPointLocator : public QObject
 
       delete vlEmptyGeom;
     }
+
+    void testBackgroundIndexing()
+    {
+      QgsPointLocator loc( mVL );
+      QSignalSpy spy( &loc, &QgsPointLocator::initFinished );
+
+      QVERIFY( loc.init( -1, true ) );
+      // queries can be done while the index is being built
+      QVERIFY( loc.hasIndex() );
+      loc.nearestVertex( QgsPointXY( 2, 2 ), 999 );
+
+      loc.waitForIndexingFinished();
+      QVERIFY( !loc.isIndexing() );
+      QCOMPARE( spy.count(), 1 );
+      QVERIFY( spy.at( 0 ).at( 0 ).toBool() );
+      QCOMPARE( loc.cachedGeometryCount(), 1 );
+
+      QgsPointLocator::Match m = loc.nearestVertex( QgsPointXY( 2, 2 ), 999 );
+      QVERIFY( m.isValid() );
+      QCOMPARE( m.point(), QgsPointXY( 1, 1 ) );
+
+      // feature limit
+      QgsPointLocator loc2( mVL );
+      QSignalSpy spy2( &loc2, &QgsPointLocator::initFinished );
+      QVERIFY( loc2.init( 0, true ) );
+      QVERIFY( !loc2.init() );
+      QCOMPARE( spy2.count(), 1 );
+      QVERIFY( !spy2.at( 0 ).at( 0 ).toBool() );
+      QVERIFY( !loc2.hasIndex() );
+
+      // edits made while indexing
+      QgsPointLocator loc3( mVL );
+      QVERIFY( loc3.init( -1, true ) );
+      mVL->startEditing();
+      QgsFeature ff( 0 );
+      QgsPolylineXY polyline;
+      polyline << QgsPointXY( 10, 11 ) << QgsPointXY( 11, 10 ) << QgsPointXY( 11, 11 ) << QgsPointXY( 10, 11 );
+      ff.setGeometry( QgsGeometry::fromPolygonXY( QgsPolygonXY() << polyline ) );
+      QVERIFY( mVL->addFeature( ff ) );
+      QVERIFY( mVL->deleteFeature( 1 ) );
+      loc3.waitForIndexingFinished();
+      QCOMPARE( loc3.cachedGeometryCount(), 1 );
+      m = loc3.nearestVertex( QgsPointXY( 2, 2 ), 999 );
+      QVERIFY( m.isValid() );
+      QCOMPARE( m.point(), QgsPointXY( 10, 11 ) );
+      mVL->rollBack();
+    }
+
+    void testBackgroundIndexingCanceled()
+    {
+      QgsPointLocator loc( mVL );
+      QSignalSpy spy( &loc, &QgsPointLocator::initFinished );
+      QVERIFY( loc.init( -1, true ) );
+
+      QgsPointLocatorInitTask *task = nullptr;
+      for ( QgsTask *t : QgsApplication::taskManager()->tasks() )
+      {
+        if ( QgsPointLocatorInitTask *initTask = qobject_cast< QgsPointLocatorInitTask * >( t ) )
+          task = initTask;
+      }
+      QVERIFY( task );
+      // whether or not the task had time to run, the partial index must not be kept
+      task->cancel();
+
+      loc.waitForIndexingFinished();
+      QVERIFY( !loc.isIndexing() );
+      QCOMPARE( spy.count(), 1 );
+      QVERIFY( !spy.at( 0 ).at( 0 ).toBool() );
+      QVERIFY( !loc.hasIndex() );
+
+      // the termination signal of the task is ignored once it has been waited for
+      QCoreApplication::processEvents();
+      QCOMPARE( spy.count(), 1 );
+
+      // the index can be built again
+      QVERIFY( loc.init() );
+      QVERIFY( loc.nearestVertex( QgsPointXY( 2, 2 ), 999 ).isValid() );
+    }
+
+    void testEmptyLayerUpdates()
+    {
+      QgsVectorLayer vl( QStringLiteral( "Point" ), QStringLiteral( "x" ), QStringLiteral( "memory" ) );
+      QgsPointLocator loc( &vl );
+      QVERIFY( loc.init() );
+      QVERIFY( loc.hasIndex() );
+
+      // the first feature is added to the existing index
+      vl.startEditing();
+      QgsFeature ff( 0 );
+      ff.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 3, 4 ) ) );
+      QVERIFY( vl.addFeature( ff ) );
+      QCOMPARE( loc.cachedGeometryCount(), 1 );
+      QgsPointLocator::Match m = loc.nearestVertex( QgsPointXY( 3, 3 ), 2 );
+      QVERIFY( m.isValid() );
+      QCOMPARE( m.point(), QgsPointXY( 3, 4 ) );
+      vl.rollBack();
+    }
 };
 
 QGSTEST_MAIN( TestQgsPointLocator )
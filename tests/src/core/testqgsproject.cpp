@@ -20,12 +20,17 @@
 #include "qgsmarkersymbollayer.h"
 #include "qgspathresolver.h"
 #include "qgsproject.h"
+#include "qgsrasterlayer.h"
+#include "qgsvectordataprovider.h"
 #include "qgssinglesymbolrenderer.h"
 #include "qgssettings.h"
 #include "qgsunittypes.h"
 #include "qgsvectorlayer.h"
 #include "qgssymbollayerutils.h"
 
+#include <QDomDocument>
+#include <QThreadPool>
+
 class TestQgsProject : public QObject
 {
     Q_OBJECT
@@ -41,6 +46,7 @@ class TestQgsProject : public QObject
     void testProjectUnits();
     void variablesChanged();
     void testRequiredLayers();
+    void testParallelLayerLoading();
 };
 
 void TestQgsProject::init()
@@ -390,6 +396,85 @@ void TestQgsProject::testRequiredLayers()
   QCOMPARE( ( *reqLayersReturned.constBegin() )->name(), QString( "points 2" ) );
 }
 
+void TestQgsProject::testParallelLayerLoading()
+{
+  QString dataDir( TEST_DATA_DIR ); //defined in CmakeLists.txt
+
+  QgsProject prj;
+  const QStringList vectorFiles = QStringList() << QStringLiteral( "points.shp" ) << QStringLiteral( "lines.shp" ) << QStringLiteral( "polys.shp" );
+  for ( const QString &file : vectorFiles )
+  {
+    for ( int i = 0; i < 3; ++i )
+      prj.addMapLayer( new QgsVectorLayer( dataDir + '/' + file, QStringLiteral( "%1 %2" ).arg( file ).arg( i ), QStringLiteral( "ogr" ) ) );
+  }
+  prj.addMapLayer( new QgsRasterLayer( dataDir + "/tenbytenraster.asc", QStringLiteral( "raster" ), QStringLiteral( "gdal" ) ) );
+  prj.addMapLayer( new QgsVectorLayer( QStringLiteral( "Point?field=x:integer" ), QStringLiteral( "memory" ), QStringLiteral( "memory" ) ) );
+
+  QTemporaryFile f( QDir::tempPath() + "/qgis_parallel_loading_XXXXXX.qgs" );
+  QVERIFY( f.open() );
+  f.close();
+  prj.setFileName( f.fileName() );
+  QVERIFY( prj.write() );
+
+  QgsSettings settings;
+  for ( int threads : QList<int>() << 1 << 4 )
+  {
+    settings.setValue( QStringLiteral( "qgis/projectLayerLoadingThreads" ), threads );
+
+    QgsProject prj2;
+    prj2.setFileName( f.fileName() );
+    QVERIFY( prj2.read() );
+    QCOMPARE( prj2.count(), prj.count() );
+
+    for ( QgsMapLayer *layer : prj.mapLayers() )
+    {
+      QgsMapLayer *layer2 = prj2.mapLayer( layer->id() );
+      QVERIFY( layer2 );
+      QVERIFY( layer2->isValid() );
+      QCOMPARE( layer2->name(), layer->name() );
+      QCOMPARE( layer2->source(), layer->source() );
+      QCOMPARE( layer2->dataProvider()->thread(), QThread::currentThread() );
+      QCOMPARE( layer2->dataProvider()->parent(), static_cast< QObject * >( layer2 ) );
+      if ( QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( layer2 ) )
+        QCOMPARE( vl->featureCount(), qobject_cast< QgsVectorLayer * >( layer )->featureCount() );
+    }
+  }
+  settings.remove( QStringLiteral( "qgis/projectLayerLoadingThreads" ) );
+
+  // providers of local files are opened ahead of time, with the key and source their layers ask for
+  QFile projectFile( f.fileName() );
+  QVERIFY( projectFile.open( QIODevice::ReadOnly ) );
+  QDomDocument doc;
+  QVERIFY( doc.setContent( &projectFile ) );
+  QVector< QDomNode > layerNodes;
+  const QDomNodeList nodes = doc.elementsByTagName( QStringLiteral( "maplayer" ) );
+  for ( int i = 0; i < nodes.count(); ++i )
+    layerNodes << nodes.at( i );
+  QCOMPARE( layerNodes.count(), prj.count() );
+
+  QgsProject prj3;
+  prj3.setFileName( f.fileName() );
+  QThreadPool pool;
+  pool.setMaxThreadCount( 4 );
+  QHash< QString, QgsMapLayer * > preloaded = prj3.preloadLayerProviders( layerNodes, &pool );
+  // the memory layer is not preloaded
+  QCOMPARE( preloaded.count(), prj.count() - 1 );
+  for ( QgsMapLayer *layer : prj.mapLayers() )
+  {
+    std::unique_ptr< QgsMapLayer > preloadedLayer( preloaded.take( layer->id() ) );
+    if ( layer->providerType() == QLatin1String( "memory" ) )
+    {
+      QVERIFY( !preloadedLayer );
+      continue;
+    }
+    QVERIFY( preloadedLayer );
+    std::unique_ptr< QgsDataProvider > provider( preloadedLayer->takePreloadedProvider( layer->providerType(), layer->source() ) );
+    QVERIFY( provider );
+    QVERIFY( provider->isValid() );
+    QCOMPARE( provider->thread(), QThread::currentThread() );
+  }
+}
+
 
 QGSTEST_MAIN( TestQgsProject )
 #include "testqgsproject.moc"
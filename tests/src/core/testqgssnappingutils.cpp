@@ -314,6 +314,66 @@ class TestQgsSnappingUtils : public QObject
 
       delete vl;
     }
+
+    void testSharedLocators()
+    {
+      QgsMapSettings mapSettings;
+      mapSettings.setOutputSize( QSize( 100, 100 ) );
+      mapSettings.setExtent( QgsRectangle( 0, 0, 1, 1 ) );
+      QVERIFY( mapSettings.hasValidSettings() );
+
+      // locators of whole layers are shared
+      QgsSnappingUtils u1;
+      u1.setMapSettings( mapSettings );
+      u1.setIndexingStrategy( QgsSnappingUtils::IndexAlwaysFull );
+      QgsSnappingUtils u2;
+      u2.setMapSettings( mapSettings );
+      u2.setIndexingStrategy( QgsSnappingUtils::IndexAlwaysFull );
+      QgsPointLocator *loc = u1.locatorForLayer( mVL );
+      QVERIFY( loc );
+      QCOMPARE( u2.locatorForLayer( mVL ), loc );
+
+      // but not the ones restricted to visible features
+      QgsSnappingUtils u3( nullptr, false );
+      u3.setMapSettings( mapSettings );
+      u3.setIndexingStrategy( QgsSnappingUtils::IndexAlwaysFull );
+      QVERIFY( u3.locatorForLayer( mVL ) != loc );
+
+      // small layers are fully indexed by the default hybrid strategy
+      QgsSnappingUtils u4;
+      u4.setMapSettings( mapSettings );
+      QCOMPARE( u4.indexingStrategy(), QgsSnappingUtils::IndexHybrid );
+      QCOMPARE( u4.locatorForLayer( mVL ), loc );
+
+      // locators restricted to visible features are shared at the same scale
+      QgsSnappingUtils u5( nullptr, false );
+      u5.setMapSettings( mapSettings );
+      QCOMPARE( u5.locatorForLayer( mVL ), u3.locatorForLayer( mVL ) );
+
+      QgsMapSettings zoomedMapSettings = mapSettings;
+      zoomedMapSettings.setExtent( QgsRectangle( 0, 0, 0.5, 0.5 ) );
+      QgsSnappingUtils u6( nullptr, false );
+      u6.setMapSettings( zoomedMapSettings );
+      QVERIFY( u6.locatorForLayer( mVL ) != u3.locatorForLayer( mVL ) );
+
+      // snapping while the index is built in background
+      u2.setIndexingInBackground( true );
+      u2.setCurrentLayer( mVL );
+      QgsSnappingConfig snappingConfig = u2.config();
+      snappingConfig.setEnabled( true );
+      snappingConfig.setType( QgsSnappingConfig::Vertex );
+      snappingConfig.setTolerance( 10 );
+      snappingConfig.setUnits( QgsTolerance::Pixels );
+      snappingConfig.setMode( QgsSnappingConfig::ActiveLayer );
+      u2.setConfig( snappingConfig );
+      u2.snapToMap( QPoint( 100, 100 ) );
+      loc->waitForIndexingFinished();
+      QVERIFY( loc->hasIndex() );
+
+      QgsPointLocator::Match m = u2.snapToMap( QPoint( 100, 100 ) );
+      QVERIFY( m.isValid() );
+      QCOMPARE( m.point(), QgsPointXY( 1, 0 ) );
+    }
 };
 
 QGSTEST_MAIN( TestQgsSnappingUtils )
@@ -97,6 +97,12 @@ class TestQgsSpatialIndex : public QObject
       QVERIFY( fids2.count() == 2 );
       QVERIFY( fids2.contains( 2 ) );
       QVERIFY( fids2.contains( 3 ) );
+
+      QVERIFY( index.deleteFeature( 2, QgsRectangle( 12, 13, 12, 13 ) ) );
+      QVERIFY( !index.deleteFeature( 2, QgsRectangle( 12, 13, 12, 13 ) ) );
+      QList<QgsFeatureId> fids3 = index.intersects( QgsRectangle( 10, 12, 15, 14 ) );
+      QVERIFY( fids3.count() == 1 );
+      QVERIFY( fids3.contains( 3 ) );
     }
 
     void testInitFromEmptyIterator()
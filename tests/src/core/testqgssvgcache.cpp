@@ -50,6 +50,8 @@ class TestQgsSvgCache : public QObject
     void fillCache();
     void threadSafePicture();
     void threadSafeImage();
+    void threadSafeMixedParameters(); //concurrent requests spread over several cache shards
+    void evictLeastRecent(); //check that the size of all shards together stays under the limit
     void changeImage(); //check that cache is updated if svg source file changes
     void base64();
 
@@ -175,6 +177,98 @@ void TestQgsSvgCache::threadSafeImage()
   QtConcurrent::blockingMap( list, RenderImageWrapper( cache, svgPath ) );
 }
 
+struct RenderMixedImageWrapper
+{
+  typedef bool result_type;
+  QgsSvgCache &cache;
+  QString svgPath;
+  explicit RenderMixedImageWrapper( QgsSvgCache &cache, const QString &svgPath )
+    : cache( cache )
+    , svgPath( svgPath )
+  {}
+  bool operator()( int i )
+  {
+    bool fitsInCache = false;
+    const int size = 20 + 10 * ( i % 8 );
+    QImage image = cache.svgAsImage( svgPath, size, QColor( 255, 0, 25 * ( i % 5 ) ), QColor( 0, 255, 0 ), 1, 1, fitsInCache );
+    return fitsInCache && image.width() == size;
+  }
+};
+
+void TestQgsSvgCache::threadSafeMixedParameters()
+{
+  // requests with different sizes and colors end up in different cache shards,
+  // make sure each thread always gets back the image it asked for
+
+  QgsSvgCache cache;
+  QString svgPath = TEST_DATA_DIR + QStringLiteral( "/sample_svg.svg" );
+
+  QVector< int > list;
+  for ( int i = 0; i < 400; ++i )
+    list << i;
+  const QList< bool > results = QtConcurrent::blockingMapped< QList< bool > >( list, RenderMixedImageWrapper( cache, svgPath ) );
+  QCOMPARE( results.count( false ), 0 );
+}
+
+void TestQgsSvgCache::evictLeastRecent()
+{
+  QgsSvgCache cache;
+  QString svgPath = TEST_DATA_DIR + QStringLiteral( "/sample_svg.svg" );
+  bool fitInCache = false;
+
+  auto isCached = [&cache, &svgPath]( double size )
+  {
+    const QgsSvgCacheKey key( svgPath, size, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, 0 );
+    QgsSvgCache::Shard &shard = cache.shardForKey( key );
+    QMutexLocker locker( &shard.mutex );
+    return shard.entries.contains( key );
+  };
+
+  // each image takes about 2 MB, their entries are spread over all the shards
+  QSet< QgsSvgCache::Shard * > usedShards;
+  for ( int i = 0; i < 100; ++i )
+  {
+    const double size = 250 + i;
+    QImage image = cache.svgAsImage( svgPath, size, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache );
+    QVERIFY( !image.isNull() );
+    QVERIFY( fitInCache );
+    QVERIFY( isCached( size ) );
+    QVERIFY( cache.mTotalSize.load() <= QgsSvgCache::MAXIMUM_SIZE );
+    usedShards << &cache.shardForKey( QgsSvgCacheKey( svgPath, size, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, 0 ) );
+  }
+  QVERIFY( usedShards.count() > 1 );
+
+  // the least recently used entries were removed first, whatever their shard:
+  // only the most recent ones are left
+  int firstCached = 350;
+  for ( int size = 250; size < 350; ++size )
+  {
+    if ( isCached( size ) )
+    {
+      firstCached = size;
+      break;
+    }
+  }
+  QVERIFY( firstCached > 250 );
+  QVERIFY( firstCached < 349 );
+  for ( int size = firstCached; size < 350; ++size )
+    QVERIFY( isCached( size ) );
+
+  // using an entry makes it the most recent one
+  QVERIFY( !cache.svgAsImage( svgPath, firstCached, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache ).isNull() );
+  QVERIFY( !cache.svgAsImage( svgPath, 350, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache ).isNull() );
+  QVERIFY( isCached( firstCached ) );
+  QVERIFY( !isCached( firstCached + 1 ) );
+  QVERIFY( isCached( 349 ) );
+  QVERIFY( isCached( 350 ) );
+
+  // the entries which were removed are created again
+  QImage image = cache.svgAsImage( svgPath, 250, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache );
+  QVERIFY( !image.isNull() );
+  QVERIFY( isCached( 250 ) );
+  QVERIFY( cache.mTotalSize.load() <= QgsSvgCache::MAXIMUM_SIZE );
+}
+
 void TestQgsSvgCache::changeImage()
 {
   bool inCache;
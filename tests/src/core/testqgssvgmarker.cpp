@@ -20,6 +20,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDesktopServices>
+#include <QPainter>
 
 //qgis includes...
 #include <qgsmaplayer.h>
@@ -33,6 +34,7 @@
 #include "qgsmarkersymbollayer.h"
 #include "qgsproperty.h"
 #include "qgssymbollayerutils.h"
+#include "qgsrendercontext.h"
 
 //qgis test includes
 #include "qgsrenderchecker.h"
@@ -62,6 +64,7 @@ class TestQgsSvgMarkerSymbol : public QObject
     void dynamicSizeWithAspectRatio();
     void dynamicWidthWithAspectRatio();
     void dynamicAspectRatio();
+    void lastImageReuse();
 
   private:
     bool mTestHasError =  false ;
@@ -252,6 +255,76 @@ void TestQgsSvgMarkerSymbol::dynamicAspectRatio()
   QVERIFY( result );
 }
 
+void TestQgsSvgMarkerSymbol::lastImageReuse()
+{
+  // consecutive points with the same parameters reuse the last marker image, which
+  // must not be reused once a parameter such as the opacity changes
+  QString svgPath = QgsSymbolLayerUtils::svgSymbolNameToPath( QStringLiteral( "/transport/transport_airport.svg" ), QgsPathResolver() );
+  QgsSvgMarkerSymbolLayer layer( svgPath );
+  layer.setStrokeColor( Qt::black );
+  layer.setColor( Qt::blue );
+  layer.setSize( 20 );
+
+  QgsRenderContext context;
+  context.setScaleFactor( 96 / 25.4 );
+  QgsSymbolRenderContext symbolContext( context, QgsUnitTypes::RenderMillimeters );
+
+  auto renderMarker = [&context, &symbolContext]( QgsSvgMarkerSymbolLayer & markerLayer )
+  {
+    QImage image( 100, 100, QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+    QPainter painter( &image );
+    context.setPainter( &painter );
+    markerLayer.renderPoint( QPointF( 50, 50 ), symbolContext );
+    painter.end();
+    context.setPainter( nullptr );
+    return image;
+  };
+  // renders the marker with a layer which has not drawn anything yet
+  auto renderNewMarker = [&symbolContext, &renderMarker]( const QgsSvgMarkerSymbolLayer & markerLayer )
+  {
+    std::unique_ptr< QgsSvgMarkerSymbolLayer > newLayer( static_cast< QgsSvgMarkerSymbolLayer * >( markerLayer.clone() ) );
+    newLayer->startRender( symbolContext );
+    QImage image = renderMarker( *newLayer );
+    newLayer->stopRender( symbolContext );
+    return image;
+  };
+
+  layer.startRender( symbolContext );
+  const QImage opaque = renderMarker( layer );
+  QCOMPARE( renderMarker( layer ), opaque );
+  QCOMPARE( renderNewMarker( layer ), opaque );
+
+  // find a pixel fully covered by the marker
+  QPoint covered( -1, -1 );
+  for ( int y = 0; y < opaque.height() && covered.x() < 0; ++y )
+  {
+    for ( int x = 0; x < opaque.width() && covered.x() < 0; ++x )
+    {
+      if ( qAlpha( opaque.pixel( x, y ) ) == 255 )
+        covered = QPoint( x, y );
+    }
+  }
+  QVERIFY( covered.x() >= 0 );
+
+  symbolContext.setOpacity( 0.5 );
+  const QImage translucent = renderMarker( layer );
+  QVERIFY( translucent != opaque );
+  QVERIFY( qAbs( qAlpha( translucent.pixel( covered ) ) - 128 ) <= 1 );
+  QCOMPARE( renderMarker( layer ), translucent );
+  QCOMPARE( renderNewMarker( layer ), translucent );
+
+  symbolContext.setOpacity( 1.0 );
+  QCOMPARE( renderMarker( layer ), opaque );
+
+  // other parameters are checked too
+  layer.setColor( Qt::red );
+  const QImage red = renderMarker( layer );
+  QVERIFY( red != opaque );
+  QCOMPARE( renderNewMarker( layer ), red );
+  layer.stopRender( symbolContext );
+}
+
 //
 // Private helper functions not called directly by CTest
 //
@@ -33,6 +33,9 @@ class TestQgsTracer : public QObject
     void testButterfly();
     void testLayerUpdates();
     void testExtent();
+    void testExtentExtension();
+    void testIncrementalNoding();
+    void testManyEdits();
     void testReprojection();
     void testCurved();
     void testOffset();
@@ -299,6 +302,152 @@ void TestQgsTracer::testExtent()
   QCOMPARE( points2.count(), 0 );
 }
 
+void TestQgsTracer::testExtentExtension()
+{
+  // check whether the graph gets extended when the extent changes
+
+  // same shape as in testSimple()
+  QStringList wkts;
+  wkts  << QStringLiteral( "LINESTRING(0 0, 0 10)" )
+        << QStringLiteral( "LINESTRING(0 0, 10 0)" )
+        << QStringLiteral( "LINESTRING(0 10, 20 10)" )
+        << QStringLiteral( "LINESTRING(10 0, 20 10)" );
+
+  QgsVectorLayer *vl = make_layer( wkts );
+
+  QgsTracer tracer;
+  tracer.setLayers( QList<QgsVectorLayer *>() << vl );
+  tracer.setExtent( QgsRectangle( 0, 0, 8, 8 ) );
+  tracer.init();
+
+  QgsPolylineXY points1 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 20, 10 ) );
+  QCOMPARE( points1.count(), 0 );
+
+  // the graph is kept and extended with the features of the new extent
+  tracer.setExtent( QgsRectangle( 4, 4, 12, 12 ) );
+  QVERIFY( tracer.isInitialized() );
+
+  QgsPolylineXY points2 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 20, 10 ) );
+  QCOMPARE( points2.count(), 3 );
+  QCOMPARE( points2[0], QgsPointXY( 0, 0 ) );
+  QCOMPARE( points2[1], QgsPointXY( 10, 0 ) );
+  QCOMPARE( points2[2], QgsPointXY( 20, 10 ) );
+
+  // moving back to the first extent does not lose anything
+  tracer.setExtent( QgsRectangle( 0, 0, 8, 8 ) );
+  QgsPolylineXY points3 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 20, 10 ) );
+  QCOMPARE( points3.count(), 3 );
+
+  delete vl;
+}
+
+void TestQgsTracer::testIncrementalNoding()
+{
+  // check whether added features are noded with the existing ones,
+  // and the existing ones joined back once they are deleted
+
+  // same shape as in testSimple()
+  QStringList wkts;
+  wkts  << QStringLiteral( "LINESTRING(0 0, 0 10)" )
+        << QStringLiteral( "LINESTRING(0 0, 10 0)" )
+        << QStringLiteral( "LINESTRING(0 10, 20 10)" )
+        << QStringLiteral( "LINESTRING(10 0, 20 10)" );
+
+  QgsVectorLayer *vl = make_layer( wkts );
+
+  QgsTracer tracer;
+  tracer.setLayers( QList<QgsVectorLayer *>() << vl );
+  tracer.init();
+
+  vl->startEditing();
+
+  // a line crossing the bottom and top lines
+  QgsFeature f( make_feature( QStringLiteral( "LINESTRING(5 -5, 5 15)" ) ) );
+  vl->addFeature( f );
+
+  QgsPolylineXY points1 = tracer.findShortestPath( QgsPointXY( 5, -5 ), QgsPointXY( 0, 0 ) );
+  QCOMPARE( points1.count(), 3 );
+  QCOMPARE( points1[0], QgsPointXY( 5, -5 ) );
+  QCOMPARE( points1[1], QgsPointXY( 5, 0 ) );
+  QCOMPARE( points1[2], QgsPointXY( 0, 0 ) );
+
+  QgsPolylineXY points2 = tracer.findShortestPath( QgsPointXY( 5, 15 ), QgsPointXY( 0, 10 ) );
+  QCOMPARE( points2.count(), 3 );
+  QCOMPARE( points2[0], QgsPointXY( 5, 15 ) );
+  QCOMPARE( points2[1], QgsPointXY( 5, 10 ) );
+  QCOMPARE( points2[2], QgsPointXY( 0, 10 ) );
+
+  vl->deleteFeature( f.id() );
+
+  // no trace of the crossing points
+  QgsPolylineXY points3 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 10, 0 ) );
+  QCOMPARE( points3.count(), 2 );
+  QCOMPARE( points3[0], QgsPointXY( 0, 0 ) );
+  QCOMPARE( points3[1], QgsPointXY( 10, 0 ) );
+
+  QgsPolylineXY points4 = tracer.findShortestPath( QgsPointXY( 5, -5 ), QgsPointXY( 0, 0 ) );
+  QCOMPARE( points4.count(), 0 );
+
+  vl->rollBack();
+
+  delete vl;
+}
+
+void TestQgsTracer::testManyEdits()
+{
+  // check whether the graph stays valid when it gets compacted after many edits
+
+  // same shape as in testSimple()
+  QStringList wkts;
+  wkts  << QStringLiteral( "LINESTRING(0 0, 0 10)" )
+        << QStringLiteral( "LINESTRING(0 0, 10 0)" )
+        << QStringLiteral( "LINESTRING(0 10, 20 10)" )
+        << QStringLiteral( "LINESTRING(10 0, 20 10)" );
+
+  QgsVectorLayer *vl = make_layer( wkts );
+
+  QgsTracer tracer;
+  tracer.setLayers( QList<QgsVectorLayer *>() << vl );
+  tracer.init();
+
+  vl->startEditing();
+
+  // a line crossing the bottom and top lines, moved around many times
+  QgsFeature f( make_feature( QStringLiteral( "LINESTRING(5 -5, 5 15)" ) ) );
+  vl->addFeature( f );
+  for ( int i = 0; i < 1000; ++i )
+  {
+    const double x = 1 + ( i % 8 );
+    vl->changeGeometry( f.id(), QgsGeometry::fromWkt( QStringLiteral( "LINESTRING(%1 -5, %1 15)" ).arg( x ) ) );
+  }
+  vl->changeGeometry( f.id(), QgsGeometry::fromWkt( QStringLiteral( "LINESTRING(5 -5, 5 15)" ) ) );
+  QVERIFY( tracer.isInitialized() );
+
+  QgsPolylineXY points1 = tracer.findShortestPath( QgsPointXY( 5, -5 ), QgsPointXY( 0, 0 ) );
+  QCOMPARE( points1.count(), 3 );
+  QCOMPARE( points1[0], QgsPointXY( 5, -5 ) );
+  QCOMPARE( points1[1], QgsPointXY( 5, 0 ) );
+  QCOMPARE( points1[2], QgsPointXY( 0, 0 ) );
+
+  vl->deleteFeature( f.id() );
+
+  // the bottom line was joined back
+  QgsPolylineXY points2 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 10, 0 ) );
+  QCOMPARE( points2.count(), 2 );
+  QCOMPARE( points2[0], QgsPointXY( 0, 0 ) );
+  QCOMPARE( points2[1], QgsPointXY( 10, 0 ) );
+
+  QgsPolylineXY points3 = tracer.findShortestPath( QgsPointXY( 10, 0 ), QgsPointXY( 10, 10 ) );
+  QCOMPARE( points3.count(), 3 );
+  QCOMPARE( points3[0], QgsPointXY( 10, 0 ) );
+  QCOMPARE( points3[1], QgsPointXY( 20, 10 ) );
+  QCOMPARE( points3[2], QgsPointXY( 10, 10 ) );
+
+  vl->rollBack();
+
+  delete vl;
+}
+
 void TestQgsTracer::testReprojection()
 {
   QStringList wkts;
@@ -33,6 +33,11 @@
 #include <qgsproject.h>
 #include <qgssymbol.h>
 #include <qgssinglesymbolrenderer.h>
+#include "qgsmaprenderersequentialjob.h"
+#include "qgsmarkersymbollayer.h"
+#include "qgsreadwritecontext.h"
+#include "qgsmaplayerrenderer.h"
+#include "qgsrendercontext.h"
 //qgis test includes
 #include "qgsrenderchecker.h"
 
@@ -99,6 +104,7 @@ class TestQgsVectorLayer : public QObject
     void maximumValue();
     void isSpatial();
     void testAddTopologicalPoints();
+    void testRenderCache();
 };
 
 void TestQgsVectorLayer::initTestCase()
@@ -372,5 +378,107 @@ void TestQgsVectorLayer::testAddTopologicalPoints()
   delete layerLine;
 }
 
+static QImage renderLayer( QgsVectorLayer *layer, const QgsRectangle &extent )
+{
+  QgsMapSettings settings;
+  settings.setLayers( QList< QgsMapLayer * >() << layer );
+  settings.setDestinationCrs( layer->crs() );
+  settings.setOutputSize( QSize( 200, 100 ) );
+  settings.setExtent( extent );
+  settings.setBackgroundColor( Qt::white );
+
+  QgsMapRendererSequentialJob job( settings );
+  job.start();
+  job.waitForFinished();
+  return job.renderedImage();
+}
+
+void TestQgsVectorLayer::testRenderCache()
+{
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsSimpleMarkerSymbolLayer *markerLayer = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Square, 5 );
+  markerLayer->setColor( Qt::red );
+  markerLayer->setStrokeColor( Qt::red );
+  layer->setRenderer( new QgsSingleSymbolRenderer( new QgsMarkerSymbol( QgsSymbolLayerList() << markerLayer ) ) );
+
+  QgsFeature f;
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 0, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+
+  QVERIFY( !layer->renderCacheEnabled() );
+  layer->setRenderCacheEnabled( true );
+  QVERIFY( layer->renderCacheEnabled() );
+
+  // 10 pixels per map unit
+  QImage image = renderLayer( layer, QgsRectangle( -5, -5, 15, 5 ) );
+  QCOMPARE( image.pixel( 50, 50 ), QColor( Qt::red ).rgb() );
+
+  // adding features directly to the provider does not notify the layer, reloading it
+  // drops the cached features
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 12, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  layer->reload();
+  image = renderLayer( layer, QgsRectangle( -3, -5, 17, 5 ) );
+  QCOMPARE( image.pixel( 30, 50 ), QColor( Qt::red ).rgb() );
+  QCOMPARE( image.pixel( 150, 50 ), QColor( Qt::red ).rgb() );
+
+  // data change invalidates the cache
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 14, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  emit layer->dataChanged();
+  image = renderLayer( layer, QgsRectangle( -3, -5, 17, 5 ) );
+  QCOMPARE( image.pixel( 170, 50 ), QColor( Qt::red ).rgb() );
+
+  // so does the deferred repaint of the auto refresh
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 16, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  layer->triggerRepaint( true );
+  image = renderLayer( layer, QgsRectangle( -3, -5, 17, 5 ) );
+  QCOMPARE( image.pixel( 190, 50 ), QColor( Qt::red ).rgb() );
+
+  // a renderer created before an invalidation does not fill the cache with outdated features
+  QgsMapSettings mapSettings;
+  mapSettings.setLayers( QList< QgsMapLayer * >() << layer );
+  mapSettings.setDestinationCrs( layer->crs() );
+  mapSettings.setExtent( QgsRectangle( -3, -5, 17, 5 ) );
+  mapSettings.setOutputSize( QSize( 200, 100 ) );
+  QImage outdatedImage( 200, 100, QImage::Format_ARGB32_Premultiplied );
+  QPainter painter( &outdatedImage );
+  QgsRenderContext renderContext = QgsRenderContext::fromMapSettings( mapSettings );
+  renderContext.setPainter( &painter );
+  std::unique_ptr< QgsMapLayerRenderer > outdatedRenderer( layer->createMapRenderer( renderContext ) );
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 6, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  layer->reload();
+  outdatedRenderer->render();
+  painter.end();
+  image = renderLayer( layer, QgsRectangle( -3, -5, 17, 5 ) );
+  QCOMPARE( image.pixel( 90, 50 ), QColor( Qt::red ).rgb() );
+
+  // the cached extent does not cover a far away pan
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 100, 0 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  image = renderLayer( layer, QgsRectangle( 90, -5, 110, 5 ) );
+  QCOMPARE( image.pixel( 100, 50 ), QColor( Qt::red ).rgb() );
+
+  // the setting is kept in project files
+  QDomImplementation DomImplementation;
+  QDomDocumentType documentType = DomImplementation.createDocumentType( QStringLiteral( "qgis" ), QStringLiteral( "http://mrcc.com/qgis.dtd" ), QStringLiteral( "SYSTEM" ) );
+  QDomDocument doc( documentType );
+  QDomElement layerElement = doc.createElement( QStringLiteral( "maplayer" ) );
+  QgsReadWriteContext context;
+  QVERIFY( layer->writeXml( layerElement, doc, context ) );
+  QCOMPARE( layerElement.attribute( QStringLiteral( "renderCache" ) ), QStringLiteral( "1" ) );
+
+  std::unique_ptr< QgsVectorLayer > clone( layer->clone() );
+  QVERIFY( clone->renderCacheEnabled() );
+
+  layer->setRenderCacheEnabled( false );
+  QVERIFY( !layer->renderCacheEnabled() );
+
+  delete layer;
+}
+
 QGSTEST_MAIN( TestQgsVectorLayer )
 #include "testqgsvectorlayer.moc"
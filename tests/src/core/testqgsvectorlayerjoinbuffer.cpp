@@ -28,6 +28,8 @@
 #include <qgslayerdefinition.h>
 #include <qgsproject.h>
 #include "qgslayertree.h"
+#include "qgsvectorlayerjoincache_p.h"
+#include <QPointer>
 
 /**
  * @ingroup UnitTests
@@ -65,6 +67,9 @@ class TestVectorLayerJoinBuffer : public QObject
     void testCacheUpdate();
     void testRemoveJoinOnLayerDelete();
     void testResolveReferences();
+    void testJoinManyFeatures();
+    void testMemoryCacheEdits();
+    void testMemoryCacheRelease();
 
   private:
     QgsProject mProject;
@@ -666,6 +671,206 @@ void TestVectorLayerJoinBuffer::testResolveReferences()
   delete vlA;
 }
 
+void TestVectorLayerJoinBuffer::testJoinManyFeatures()
+{
+  // joined values without memory cache get fetched in blocks of features
+  std::unique_ptr< QgsVectorLayer > vlA( new QgsVectorLayer( QStringLiteral( "None?field=id_a:integer" ), QStringLiteral( "A" ), QStringLiteral( "memory" ) ) );
+  std::unique_ptr< QgsVectorLayer > vlB( new QgsVectorLayer( QStringLiteral( "None?field=id_b:integer&field=value_b:string&field=other_b:integer" ), QStringLiteral( "B" ), QStringLiteral( "memory" ) ) );
+
+  const int count = 2500;
+  QgsFeatureList featuresA;
+  for ( int i = 0; i < count; ++i )
+  {
+    QgsFeature f( vlA->fields() );
+    // a few features without join value, and repeated values
+    f.setAttribute( 0, i % 100 == 0 ? QVariant( QVariant::Int ) : QVariant( i % 1500 ) );
+    featuresA << f;
+  }
+  QVERIFY( vlA->dataProvider()->addFeatures( featuresA ) );
+
+  QgsFeatureList featuresB;
+  for ( int i = 0; i < 1500; i += 2 )
+  {
+    QgsFeature f( vlB->fields() );
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "b%1" ).arg( i ) << i * 10 );
+    featuresB << f;
+  }
+  // only the first matching feature is joined
+  QgsFeature duplicate( vlB->fields() );
+  duplicate.setAttributes( QgsAttributes() << 2 << QStringLiteral( "duplicate" ) << -1 );
+  featuresB << duplicate;
+  QVERIFY( vlB->dataProvider()->addFeatures( featuresB ) );
+
+  QgsVectorLayerJoinInfo joinInfo;
+  joinInfo.setTargetFieldName( QStringLiteral( "id_a" ) );
+  joinInfo.setJoinLayer( vlB.get() );
+  joinInfo.setJoinFieldName( QStringLiteral( "id_b" ) );
+  joinInfo.setUsingMemoryCache( false );
+  joinInfo.setPrefix( QStringLiteral( "B_" ) );
+  joinInfo.setJoinFieldNamesSubset( new QStringList( QStringList() << QStringLiteral( "value_b" ) ) );
+  vlA->addJoin( joinInfo );
+  QCOMPARE( vlA->fields().count(), 2 );
+
+  // changed join value in the edit buffer
+  QgsFeature first;
+  QVERIFY( vlA->getFeatures().nextFeature( first ) );
+  vlA->startEditing();
+  QVERIFY( vlA->changeAttributeValue( first.id() + 1, 0, 1000 ) );
+
+  int fetched = 0;
+  QgsFeature f;
+  QgsFeatureIterator it = vlA->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    const QVariant idA = f.attribute( 0 );
+    if ( f.id() == first.id() + 1 )
+      QCOMPARE( idA.toInt(), 1000 );
+
+    if ( idA.isNull() || idA.toInt() % 2 == 1 )
+      QVERIFY( f.attribute( 1 ).isNull() );
+    else if ( idA.toInt() == 2 )
+      QCOMPARE( f.attribute( 1 ).toString(), QStringLiteral( "b2" ) );
+    else
+      QCOMPARE( f.attribute( 1 ).toString(), QStringLiteral( "b%1" ).arg( idA.toInt() ) );
+    ++fetched;
+  }
+  QCOMPARE( fetched, count );
+
+  // a few features only
+  QgsFeatureRequest request;
+  request.setLimit( 3 );
+  it = vlA->getFeatures( request );
+  fetched = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attributes().count(), 2 );
+    ++fetched;
+  }
+  QCOMPARE( fetched, 3 );
+
+  vlA->rollBack();
+}
+
+
+void TestVectorLayerJoinBuffer::testMemoryCacheEdits()
+{
+  // memory cache with numeric keys, shared by two layers and following the edits of the join layer
+  std::unique_ptr< QgsVectorLayer > vlA( new QgsVectorLayer( QStringLiteral( "None?field=id_a:integer" ), QStringLiteral( "A" ), QStringLiteral( "memory" ) ) );
+  std::unique_ptr< QgsVectorLayer > vlB( new QgsVectorLayer( QStringLiteral( "None?field=id_b:integer&field=value_b:string&field=other_b:integer" ), QStringLiteral( "B" ), QStringLiteral( "memory" ) ) );
+  std::unique_ptr< QgsVectorLayer > vlC( new QgsVectorLayer( QStringLiteral( "None?field=id_c:string" ), QStringLiteral( "C" ), QStringLiteral( "memory" ) ) );
+
+  QgsFeatureList featuresA;
+  QgsFeatureList featuresC;
+  for ( int i = 1; i <= 4; ++i )
+  {
+    QgsFeature fA( vlA->fields() );
+    fA.setAttribute( 0, i );
+    featuresA << fA;
+    QgsFeature fC( vlC->fields() );
+    fC.setAttribute( 0, QString::number( i ) );
+    featuresC << fC;
+  }
+  QVERIFY( vlA->dataProvider()->addFeatures( featuresA ) );
+  QVERIFY( vlC->dataProvider()->addFeatures( featuresC ) );
+
+  QgsFeatureList featuresB;
+  for ( int i = 1; i <= 3; ++i )
+  {
+    QgsFeature f( vlB->fields() );
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "b%1" ).arg( i ) << i * 10 );
+    featuresB << f;
+  }
+  QVERIFY( vlB->dataProvider()->addFeatures( featuresB ) );
+
+  QgsVectorLayerJoinInfo joinInfo;
+  joinInfo.setTargetFieldName( QStringLiteral( "id_a" ) );
+  joinInfo.setJoinLayer( vlB.get() );
+  joinInfo.setJoinFieldName( QStringLiteral( "id_b" ) );
+  joinInfo.setUsingMemoryCache( true );
+  joinInfo.setPrefix( QStringLiteral( "B_" ) );
+  joinInfo.setJoinFieldNamesSubset( new QStringList( QStringList() << QStringLiteral( "value_b" ) ) );
+  vlA->addJoin( joinInfo );
+  joinInfo.setTargetFieldName( QStringLiteral( "id_c" ) );
+  vlC->addJoin( joinInfo );
+  QCOMPARE( vlA->fields().count(), 2 );
+  QCOMPARE( vlC->fields().count(), 2 );
+
+  auto joinedValues = []( QgsVectorLayer * layer )
+  {
+    QMap< QString, QVariant > values;
+    QgsFeature f;
+    QgsFeatureIterator it = layer->getFeatures();
+    while ( it.nextFeature( f ) )
+      values.insert( f.attribute( 0 ).toString(), f.attribute( 1 ) );
+    return values;
+  };
+
+  QMap< QString, QVariant > values = joinedValues( vlA.get() );
+  QCOMPARE( values.value( QStringLiteral( "1" ) ).toString(), QStringLiteral( "b1" ) );
+  QCOMPARE( values.value( QStringLiteral( "3" ) ).toString(), QStringLiteral( "b3" ) );
+  QVERIFY( values.value( QStringLiteral( "4" ) ).isNull() );
+  // string join values are matched with the integer keys
+  QCOMPARE( joinedValues( vlC.get() ), values );
+
+  QgsFeature featureB2;
+  QVERIFY( vlB->getFeatures( QgsFeatureRequest( QgsExpression( QStringLiteral( "id_b = 2" ) ) ) ).nextFeature( featureB2 ) );
+  QgsFeature featureB3;
+  QVERIFY( vlB->getFeatures( QgsFeatureRequest( QgsExpression( QStringLiteral( "id_b = 3" ) ) ) ).nextFeature( featureB3 ) );
+
+  vlB->startEditing();
+  QgsFeature newFeature( vlB->fields() );
+  newFeature.setAttributes( QgsAttributes() << 4 << QStringLiteral( "b4" ) << 40 );
+  QVERIFY( vlB->addFeature( newFeature ) );
+  QVERIFY( vlB->changeAttributeValue( featureB2.id(), 1, QStringLiteral( "changed" ) ) );
+  QVERIFY( vlB->deleteFeature( featureB3.id() ) );
+  // changing a column which is not joined
+  QVERIFY( vlB->changeAttributeValue( featureB2.id(), 2, 0 ) );
+
+  values = joinedValues( vlA.get() );
+  QCOMPARE( values.value( QStringLiteral( "1" ) ).toString(), QStringLiteral( "b1" ) );
+  QCOMPARE( values.value( QStringLiteral( "2" ) ).toString(), QStringLiteral( "changed" ) );
+  QVERIFY( values.value( QStringLiteral( "3" ) ).isNull() );
+  QCOMPARE( values.value( QStringLiteral( "4" ) ).toString(), QStringLiteral( "b4" ) );
+  QCOMPARE( joinedValues( vlC.get() ), values );
+
+  // changed join value
+  QVERIFY( vlB->changeAttributeValue( featureB2.id(), 0, 3 ) );
+  values = joinedValues( vlA.get() );
+  QVERIFY( values.value( QStringLiteral( "2" ) ).isNull() );
+  QCOMPARE( values.value( QStringLiteral( "3" ) ).toString(), QStringLiteral( "changed" ) );
+
+  vlB->rollBack();
+  values = joinedValues( vlA.get() );
+  QCOMPARE( values.value( QStringLiteral( "2" ) ).toString(), QStringLiteral( "b2" ) );
+  QCOMPARE( values.value( QStringLiteral( "3" ) ).toString(), QStringLiteral( "b3" ) );
+  QVERIFY( values.value( QStringLiteral( "4" ) ).isNull() );
+  QCOMPARE( joinedValues( vlC.get() ), values );
+}
+
+void TestVectorLayerJoinBuffer::testMemoryCacheRelease()
+{
+  std::unique_ptr< QgsVectorLayer > vlB( new QgsVectorLayer( QStringLiteral( "None?field=id_b:integer&field=value_b:string" ), QStringLiteral( "B" ), QStringLiteral( "memory" ) ) );
+
+  QgsVectorLayerJoinInfo joinInfo;
+  joinInfo.setJoinLayer( vlB.get() );
+  joinInfo.setJoinFieldName( QStringLiteral( "id_b" ) );
+  joinInfo.setUsingMemoryCache( true );
+
+  std::shared_ptr< QgsVectorLayerJoinCache > cache = QgsVectorLayerJoinCache::cacheForJoin( joinInfo );
+  QVERIFY( cache );
+  QCOMPARE( QgsVectorLayerJoinCache::cacheForJoin( joinInfo ), cache );
+
+  // released in the thread of the join layer, without processing events
+  QPointer< QgsVectorLayerJoinCache > released( cache.get() );
+  cache.reset();
+  QVERIFY( released.isNull() );
+
+  // a new cache is created for the next join
+  cache = QgsVectorLayerJoinCache::cacheForJoin( joinInfo );
+  QVERIFY( cache );
+}
+
+
 
 QGSTEST_MAIN( TestVectorLayerJoinBuffer )
 #include "testqgsvectorlayerjoinbuffer.moc"
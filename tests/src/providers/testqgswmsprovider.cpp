@@ -14,9 +14,31 @@
  ***************************************************************************/
 #include <QFile>
 #include <QObject>
+#include <QBuffer>
+#include <QImage>
 #include "qgstest.h"
 #include <qgswmsprovider.h>
 #include <qgsapplication.h>
+#include <qgssettings.h>
+#include "qgstilecache.h"
+
+//! Returns a tile filled with \a color, encoded as PNG
+static QByteArray encodedTile( const QColor &color )
+{
+  QImage image( 256, 256, QImage::Format_ARGB32 );
+  image.fill( color );
+  QByteArray data;
+  QBuffer buffer( &data );
+  buffer.open( QIODevice::WriteOnly );
+  image.save( &buffer, "PNG" );
+  return data;
+}
+
+//! Returns a data URL holding \a data, for tiles requested without a server
+static QUrl dataUrl( const QString &mimeType, const QByteArray &data )
+{
+  return QUrl( QStringLiteral( "data:%1;base64,%2" ).arg( mimeType, QString::fromLatin1( data.toBase64() ) ) );
+}
 
 /**
  * \ingroup UnitTests
@@ -29,10 +51,19 @@ class TestQgsWmsProvider: public QObject
 
     void initTestCase()
     {
+      QCoreApplication::setOrganizationName( QStringLiteral( "QGIS" ) );
+      QCoreApplication::setOrganizationDomain( QStringLiteral( "qgis.org" ) );
+      QCoreApplication::setApplicationName( QStringLiteral( "QGIS-TEST" ) );
+
       // init QGIS's paths - true means that all path will be inited from prefix
       QgsApplication::init();
       QgsApplication::initQgis();
 
+      // the tile cache reads its budget on first use
+      QgsSettings().setValue( QStringLiteral( "qgis/tileCacheMemorySize" ), 1 );
+      QCOMPARE( QgsTileCache::maxCost(), 1024 );
+      QgsSettings().remove( QStringLiteral( "qgis/tileCacheMemorySize" ) );
+
       QFile file( QStringLiteral( TEST_DATA_DIR ) + "/provider/GetCapabilities.xml" );
       QVERIFY( file.open( QIODevice::ReadOnly | QIODevice::Text ) );
       const QByteArray content = file.readAll();
@@ -76,6 +107,82 @@ class TestQgsWmsProvider: public QObject
       QCOMPARE( provider.getLegendGraphicUrl(), QString( "http://localhost:8380/mapserv?" ) );
     }
 
+    void tileCacheEncodedTiles()
+    {
+      const QUrl url( QStringLiteral( "http://localhost:8380/tile?encoded" ) );
+      QImage image;
+      QVERIFY( !QgsTileCache::hasTile( url ) );
+      QVERIFY( !QgsTileCache::tile( url, image ) );
+
+      // encoded tiles are decoded when first accessed
+      QgsTileCache::insertTile( url, encodedTile( Qt::red ) );
+      QVERIFY( QgsTileCache::hasTile( url ) );
+      QVERIFY( QgsTileCache::tile( url, image ) );
+      QCOMPARE( image.size(), QSize( 256, 256 ) );
+      QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::red ) );
+
+      // decoded tiles are served as they were inserted
+      QImage blueImage( 256, 256, QImage::Format_ARGB32 );
+      blueImage.fill( Qt::blue );
+      QgsTileCache::insertTile( url, encodedTile( Qt::blue ), blueImage );
+      QVERIFY( QgsTileCache::tile( url, image ) );
+      QCOMPARE( image, blueImage );
+
+      // a new encoded tile replaces the decoded one
+      QgsTileCache::insertTile( url, encodedTile( Qt::green ) );
+      QVERIFY( QgsTileCache::tile( url, image ) );
+      QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::green ) );
+
+      // data which cannot be decoded (e.g. a redirect) is dropped
+      const QUrl invalidUrl( QStringLiteral( "http://localhost:8380/tile?invalid" ) );
+      QgsTileCache::insertTile( invalidUrl, QByteArray( "<html>moved</html>" ) );
+      QVERIFY( QgsTileCache::hasTile( invalidUrl ) );
+      QVERIFY( !QgsTileCache::tile( invalidUrl, image ) );
+      QVERIFY( !QgsTileCache::hasTile( invalidUrl ) );
+    }
+
+    void tileCacheMemoryBudget()
+    {
+      // the budget set in initTestCase is 1 MB, tiles of 100 kB are evicted in LRU order
+      QCOMPARE( QgsTileCache::maxCost(), 1024 );
+      auto tileUrl = []( int i ) { return QUrl( QStringLiteral( "http://localhost:8380/tile?budget=%1" ).arg( i ) ); };
+      QByteArray data = encodedTile( Qt::red );
+      data.append( QByteArray( 100 * 1024 - data.size(), 'x' ) );
+      QImage image;
+      for ( int i = 0; i < 30; ++i )
+      {
+        QgsTileCache::insertTile( tileUrl( i ), data );
+        QVERIFY( QgsTileCache::totalCost() <= QgsTileCache::maxCost() );
+        // keeps the first tile recently used
+        QVERIFY( QgsTileCache::tile( tileUrl( 0 ), image ) );
+      }
+      QVERIFY( QgsTileCache::totalCost() >= 900 );
+      QVERIFY( QgsTileCache::hasTile( tileUrl( 0 ) ) );
+      QVERIFY( !QgsTileCache::hasTile( tileUrl( 1 ) ) );
+      QVERIFY( QgsTileCache::hasTile( tileUrl( 29 ) ) );
+    }
+
+    void tilePrefetcher()
+    {
+      const QUrl redUrl = dataUrl( QStringLiteral( "image/png" ), encodedTile( Qt::red ) );
+      const QUrl blueUrl = dataUrl( QStringLiteral( "image/png" ), encodedTile( Qt::blue ) );
+      const QUrl textUrl = dataUrl( QStringLiteral( "text/plain" ), QByteArray( "not a tile" ) );
+      const QUrl droppedUrl = dataUrl( QStringLiteral( "image/png" ), encodedTile( Qt::yellow ) );
+
+      // requests which were not started yet are replaced by the ones queued afterwards
+      QgsWmsTilePrefetcher::instance()->prefetch( QList<QNetworkRequest>() << QNetworkRequest( droppedUrl ) );
+      QgsWmsTilePrefetcher::instance()->prefetch( QList<QNetworkRequest>() << QNetworkRequest( redUrl ) << QNetworkRequest( textUrl ) << QNetworkRequest( blueUrl ) );
+
+      QTRY_VERIFY( QgsTileCache::hasTile( redUrl ) && QgsTileCache::hasTile( blueUrl ) );
+      QImage image;
+      QVERIFY( QgsTileCache::tile( blueUrl, image ) );
+      QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::blue ) );
+
+      // replies which are not images are left to the regular tile requests
+      QVERIFY( !QgsTileCache::hasTile( textUrl ) );
+      QVERIFY( !QgsTileCache::hasTile( droppedUrl ) );
+    }
+
   private:
     QgsWmsCapabilities *mCapabilities = nullptr;
 };
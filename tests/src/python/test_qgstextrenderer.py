@@ -1656,6 +1656,72 @@ class PyQgsTextRenderer(unittest.TestCase):
         assert self.checkRenderPoint(format, 'text_point_center_aligned', text=['test'],
                                      alignment=QgsTextRenderer.AlignCenter, point=QPointF(200, 200))
 
+    def renderText(self, format, text, part=None):
+        image = QImage(400, 400, QImage.Format_RGB32)
+
+        painter = QPainter()
+        ms = QgsMapSettings()
+        ms.setExtent(QgsRectangle(0, 0, 50, 50))
+        ms.setOutputSize(image.size())
+        context = QgsRenderContext.fromMapSettings(ms)
+        context.setPainter(painter)
+        context.setScaleFactor(96 / 25.4)  # 96 DPI
+
+        painter.begin(image)
+        painter.setRenderHint(QPainter.Antialiasing)
+        image.fill(QColor(152, 219, 249))
+
+        if part is not None:
+            QgsTextRenderer.drawPart(QPointF(50, 200), 0, QgsTextRenderer.AlignLeft, text, context, format, part)
+        else:
+            QgsTextRenderer.drawText(QPointF(50, 200), 0, QgsTextRenderer.AlignLeft, text, context, format)
+
+        painter.end()
+        return image
+
+    def testDrawCachedTextPaths(self):
+        """
+        Text outlines are cached between renders, the first render of a string builds its outline
+        while the following ones are drawn from the cache. They must look the same.
+        """
+        format = QgsTextFormat()
+        format.setFont(getTestFont('bold'))
+        format.setSize(40)
+        format.setSizeUnit(QgsUnitTypes.RenderPoints)
+        format.buffer().setEnabled(True)
+        format.buffer().setSize(2)
+        format.buffer().setSizeUnit(QgsUnitTypes.RenderMillimeters)
+
+        # each string is only drawn by this test, so that its first render is not cached
+        for text, part in ((['cached text path'], QgsTextRenderer.Text),
+                           (['cached buffer path'], QgsTextRenderer.Buffer),
+                           (['cached full path', 'second line'], None)):
+            uncached = self.renderText(format, text, part)
+            for i in range(3):
+                self.assertEqual(self.renderText(format, text, part), uncached, '{} {}'.format(text, i))
+
+    def testDrawCachedBufferPaths(self):
+        """
+        Stroked buffer outlines are cached by pen width and join style
+        """
+        format = QgsTextFormat()
+        format.setFont(getTestFont('bold'))
+        format.setSize(40)
+        format.setSizeUnit(QgsUnitTypes.RenderPoints)
+        format.buffer().setEnabled(True)
+        format.buffer().setSizeUnit(QgsUnitTypes.RenderMillimeters)
+        format.buffer().setFillBufferInterior(True)
+
+        text = ['cached buffer styles']
+        renders = []
+        for size, join_style in ((2, Qt.RoundJoin), (2, Qt.MiterJoin), (4, Qt.RoundJoin)):
+            format.buffer().setSize(size)
+            format.buffer().setJoinStyle(join_style)
+            uncached = self.renderText(format, text, QgsTextRenderer.Buffer)
+            self.assertEqual(self.renderText(format, text, QgsTextRenderer.Buffer), uncached, '{} {}'.format(size, join_style))
+            self.assertNotIn(uncached, renders)
+            renders.append(uncached)
+
 
 if __name__ == '__main__':
     unittest.main()
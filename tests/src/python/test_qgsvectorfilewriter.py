@@ -28,7 +28,8 @@ from qgis.core import (QgsVectorLayer,
                        QgsProject,
                        QgsWkbTypes,
                        QgsRectangle,
-                       QgsCoordinateTransform
+                       QgsCoordinateTransform,
+                       QgsFields
                        )
 from qgis.PyQt.QtCore import QDate, QTime, QDateTime, QVariant, QDir
 import os
@@ -939,6 +940,43 @@ class TestQgsVectorFileWriter(unittest.TestCase):
             options)
         self.assertEqual(write_result, QgsVectorFileWriter.NoError, error_message)
 
+    def testAddFeaturesReusesOgrFeature(self):
+        """Test that values of a previously written feature do not leak into the next ones"""
+        fields = QgsFields()
+        fields.append(QgsField('id', QVariant.Int))
+        fields.append(QgsField('name', QVariant.String))
+
+        features = []
+        for i in range(10):
+            f = QgsFeature(fields)
+            if i % 2 == 0:
+                f.setAttributes([i, 'name {}'.format(i)])
+                f.setGeometry(QgsGeometry.fromWkt('Point ({} {})'.format(i, i + 1)))
+            else:
+                f.setAttributes([i, None])
+            features.append(f)
+
+        filehandle, filename = tempfile.mkstemp('.gpkg')
+        writer = QgsVectorFileWriter(filename, 'utf-8', fields, QgsWkbTypes.Point, QgsCoordinateReferenceSystem(), 'GPKG')
+        self.assertEqual(writer.hasError(), QgsVectorFileWriter.NoError)
+        self.assertTrue(writer.addFeatures(features[:5]))
+        for f in features[5:]:
+            self.assertTrue(writer.addFeature(f))
+        del writer
+
+        vl = QgsVectorLayer(filename, 'test', 'ogr')
+        self.assertTrue(vl.isValid())
+        self.assertEqual(vl.featureCount(), 10)
+        name_idx = vl.fields().lookupField('name')
+        for f in vl.getFeatures(QgsFeatureRequest().addOrderBy('id')):
+            i = f['id']
+            if i % 2 == 0:
+                self.assertEqual(f[name_idx], 'name {}'.format(i))
+                self.assertEqual(f.geometry().asWkt(), 'Point ({} {})'.format(i, i + 1))
+            else:
+                self.assertFalse(f[name_idx])
+                self.assertTrue(f.geometry().isNull() or f.geometry().isEmpty())
+
 
 if __name__ == '__main__':
     unittest.main()